@@ -28,6 +28,9 @@
 #define PIPELINE_TRANSPORT_RX(data, size) \
   StreamDecoder_Process(data, size);
 
+#define PIPELINE_TRANSPORT_RX_BUFFER(size) \
+  Transceiver_LoanBuffer(size)
+
 #define PIPELINE_HANDLE_MESSAGE(message) \
   MessageHandler_HandleMessage(message);
 
@@ -37,10 +40,13 @@
 #define PIPELINE_TRANSCEIVER_TX_EVENT(event) \
   MessageHandler_TransceiverEvent(event);
 
+#define PIPELINE_DISCOVERY_COMPLETE(token, result) \
+  MessageHandler_DiscoveryComplete(token, result);
+
 #define PIPELINE_TRANSCEIVER_RX_EVENT(event) \
   Responder_Receive(event);
 
 #define PIPELINE_RDMRESPONDER_SEND(include_break, iov, iov_len) \
-  Transceiver_QueueRDMResponse(include_break, iov, iov_len);
+  Transceiver_QueueRDMResponse(0u, include_break, iov, iov_len);
 
 #endif  // BOARDCFG_DEFAULT_APP_PIPELINE_H_
@@ -111,6 +111,71 @@ extern "C" {
  */
 #define TRANSCEIVER_RX_ENABLE_PORT_BIT PORTS_BIT_POS_10
 
+/**
+ * @brief The number of transceiver ports.
+ *
+ * This may be 1 or 2. Each port has its own USART, timer & input capture
+ * module, and its own TX queues.
+ *
+ * The input capture modules can only use timer 2 or 3, so a second port
+ * requires both timers, and COARSE_TIMER_ID must be moved to another timer.
+ * The second port is configured with TRANSCEIVER_PORT1_UART,
+ * TRANSCEIVER_PORT1_TIMER, TRANSCEIVER_PORT1_IC, TRANSCEIVER_PORT1_PORT,
+ * TRANSCEIVER_PORT1_PORT_BIT, TRANSCEIVER_PORT1_TX_ENABLE_PORT_BIT,
+ * TRANSCEIVER_PORT1_RX_ENABLE_PORT_BIT and TRANSCEIVER_PORT1_DMA_CHANNEL,
+ * which have the same meaning as the settings for the first port.
+ */
+#define TRANSCEIVER_PORT_COUNT 1
+
+/**
+ * @brief Build the transceiver with the settings above as constants.
+ *
+ * This allows the compiler to turn the peripheral library calls in the
+ * transceiver ISRs into direct register accesses. The
+ * TransceiverHardwareSettings passed to Transceiver_Initialize() are ignored.
+ */
+#define TRANSCEIVER_STATIC_HW_SETTINGS
+
+/**
+ * @brief Use DMA to move the slot data between the USART & the buffers.
+ *
+ * This avoids a USART interrupt for every slot sent, and for every slot of a
+ * RDM response received in controller mode.
+ *
+ * This has only been tested in the simulator so far, so it's off by default.
+ */
+// #define TRANSCEIVER_DMA
+
+/**
+ * @brief The DMA channel to use if TRANSCEIVER_DMA is defined.
+ */
+#define TRANSCEIVER_DMA_CHANNEL 0
+
+/**
+ * @brief The number of frames that can be queued for transmission.
+ *
+ * Each port has 2 * TRANSCEIVER_TX_QUEUE_SIZE + 2 buffers of 576 bytes, the
+ * two queues plus the active buffer and one on loan to the host transport. The
+ * buffers use (2 * TRANSCEIVER_TX_QUEUE_SIZE + 2) * 576 *
+ * TRANSCEIVER_PORT_COUNT bytes of RAM in total.
+ */
+#define TRANSCEIVER_TX_QUEUE_SIZE 4
+
+/**
+ * @}
+ *
+ * @name Discovery
+ * Settings for the @ref discovery.h "RDM Discovery" engine.
+ * @{
+ */
+
+/**
+ * @brief The maximum number of UIDs that discovery can find.
+ *
+ * Each UID uses 6 bytes of RAM.
+ */
+#define DISCOVERY_MAX_UIDS 512
+
 /**
  * @}
  *
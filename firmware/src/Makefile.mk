@@ -1,5 +1,6 @@
 noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
                       firmware/src/libdimmermodel.la \
+                      firmware/src/libdiscovery.la \
                       firmware/src/libflags.la \
                       firmware/src/libledmodel.la \
                       firmware/src/libmessagehandler.la \
@@ -17,7 +18,10 @@ noinst_LTLIBRARIES += firmware/src/libcoarsetimer.la \
                       firmware/src/libspi.la \
                       firmware/src/libspirgb.la \
                       firmware/src/libstreamdecoder.la \
+                      firmware/src/libsyslog.la \
                       firmware/src/libtransceiver.la \
+                      firmware/src/libtransceiverdma.la \
+                      firmware/src/libtransceiverstatic.la \
                       firmware/src/libusbtransport.la
 
 firmware_src_libcoarsetimer_la_SOURCES = firmware/src/coarse_timer.c
@@ -26,6 +30,9 @@ firmware_src_libcoarsetimer_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libdimmermodel_la_SOURCES = firmware/src/dimmer_model.c
 firmware_src_libdimmermodel_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libdiscovery_la_SOURCES = firmware/src/discovery.c
+firmware_src_libdiscovery_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libflags_la_SOURCES = firmware/src/flags.c
 firmware_src_libflags_la_CFLAGS = $(BUILD_FLAGS)
 
@@ -77,9 +84,26 @@ firmware_src_libspi_la_CFLAGS = $(BUILD_FLAGS)
 firmware_src_libstreamdecoder_la_SOURCES = firmware/src/stream_decoder.c
 firmware_src_libstreamdecoder_la_CFLAGS = $(BUILD_FLAGS)
 
+firmware_src_libsyslog_la_SOURCES = firmware/src/syslog.c
+firmware_src_libsyslog_la_CFLAGS = $(BUILD_FLAGS)
+
 firmware_src_libtransceiver_la_SOURCES = firmware/src/transceiver.c
 firmware_src_libtransceiver_la_CFLAGS = $(BUILD_FLAGS)
-firmware_src_libtransceiver_la_LIBADD = firmware/src/librandom.la
+firmware_src_libtransceiver_la_LIBADD = firmware/src/librandom.la \
+    firmware/src/librdmutil.la
+
+# The transceiver, built to move the slot data with DMA
+firmware_src_libtransceiverdma_la_SOURCES = firmware/src/transceiver.c
+firmware_src_libtransceiverdma_la_CFLAGS = $(BUILD_FLAGS) -DTRANSCEIVER_DMA
+firmware_src_libtransceiverdma_la_LIBADD = firmware/src/librandom.la \
+    firmware/src/librdmutil.la
+
+# The transceiver, built with the hardware settings from app_settings.h
+firmware_src_libtransceiverstatic_la_SOURCES = firmware/src/transceiver.c
+firmware_src_libtransceiverstatic_la_CFLAGS = \
+    $(BUILD_FLAGS) -DTRANSCEIVER_STATIC_HW_SETTINGS
+firmware_src_libtransceiverstatic_la_LIBADD = firmware/src/librandom.la \
+    firmware/src/librdmutil.la
 
 firmware_src_libusbtransport_la_SOURCES = firmware/src/usb_transport.c
 firmware_src_libusbtransport_la_CFLAGS = $(BUILD_FLAGS)
@@ -23,6 +23,7 @@
 
 #include "coarse_timer.h"
 #include "dimmer_model.h"
+#include "discovery.h"
 #include "led_model.h"
 #include "message_handler.h"
 #include "moving_light.h"
@@ -32,6 +33,7 @@
 #include "rdm_handler.h"
 #include "rdm_responder.h"
 #include "receiver_counters.h"
+#include "responder.h"
 #include "sensor_model.h"
 #include "setting_macros.h"
 #include "spi_rgb.h"
@@ -76,26 +78,32 @@ void APP_Initialize(void) {
 
   Temperature_Init();
 
-  // Initialize the DMX / RDM Transceiver
-  TransceiverHardwareSettings transceiver_settings = {
-    .usart = AS_USART_ID(TRANSCEIVER_UART),
-    .usart_vector = AS_USART_INTERRUPT_VECTOR(TRANSCEIVER_UART),
-    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(TRANSCEIVER_UART),
-    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(TRANSCEIVER_UART),
-    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(TRANSCEIVER_UART),
-    .port = TRANSCEIVER_PORT,
-    .break_bit = TRANSCEIVER_PORT_BIT,
-    .tx_enable_bit = TRANSCEIVER_TX_ENABLE_PORT_BIT,
-    .rx_enable_bit = TRANSCEIVER_RX_ENABLE_PORT_BIT,
-    .input_capture_module = AS_IC_ID(TRANSCEIVER_IC),
-    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(TRANSCEIVER_IC),
-    .input_capture_source = AS_IC_INTERRUPT_SOURCE(TRANSCEIVER_IC),
-    .timer_module_id = AS_TIMER_ID(TRANSCEIVER_TIMER),
-    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(TRANSCEIVER_TIMER),
-    .timer_source = AS_TIMER_INTERRUPT_SOURCE(TRANSCEIVER_TIMER),
-    .input_capture_timer = AS_IC_TMR_ID(TRANSCEIVER_TIMER),
+  // Initialize the DMX / RDM Transceiver ports
+  const TransceiverHardwareSettings transceiver_settings[] = {
+    TRANSCEIVER_HW_SETTINGS(TRANSCEIVER_UART, TRANSCEIVER_TIMER,
+                            TRANSCEIVER_IC, TRANSCEIVER_PORT,
+                            TRANSCEIVER_PORT_BIT,
+                            TRANSCEIVER_TX_ENABLE_PORT_BIT,
+                            TRANSCEIVER_RX_ENABLE_PORT_BIT),
+#if TRANSCEIVER_PORT_COUNT > 1
+    TRANSCEIVER_HW_SETTINGS(TRANSCEIVER_PORT1_UART, TRANSCEIVER_PORT1_TIMER,
+                            TRANSCEIVER_PORT1_IC, TRANSCEIVER_PORT1_PORT,
+                            TRANSCEIVER_PORT1_PORT_BIT,
+                            TRANSCEIVER_PORT1_TX_ENABLE_PORT_BIT,
+                            TRANSCEIVER_PORT1_RX_ENABLE_PORT_BIT),
+#endif
+  };
+  uint8_t i = 0u;
+  for (; i < TRANSCEIVER_PORT_COUNT; i++) {
+    Transceiver_Initialize(i, &transceiver_settings[i], NULL, NULL);
+  }
+
+  // RDM Discovery, used in controller mode.
+  DiscoverySettings discovery_settings = {
+    .complete_callback = NULL
   };
-  Transceiver_Initialize(&transceiver_settings, NULL, NULL);
+  memcpy(discovery_settings.uid, UIDStore_GetUID(), UID_LENGTH);
+  Discovery_Initialize(&discovery_settings);
 
   // Base RDM Responder
   RDMResponderSettings responder_settings = {
@@ -134,6 +142,9 @@ void APP_Initialize(void) {
   DimmerModel_Initialize();
   RDMHandler_AddModel(&DIMMER_MODEL_ENTRY);
 
+  // Once the default model is active.
+  Responder_Initialize();
+
   // Initialize the Host message layers.
   MessageHandler_Initialize(NULL);
   StreamDecoder_Initialize(NULL);
@@ -156,8 +167,11 @@ void APP_Tasks(void) {
   USBTransport_Tasks();
   Transceiver_Tasks();
   USBConsole_Tasks();
+  MessageHandler_Tasks();
+  SysLog_Tasks();
 
-  if (Transceiver_GetMode() == T_MODE_RESPONDER) {
+  // The responder runs on the first port.
+  if (Transceiver_GetMode(0u) == T_MODE_RESPONDER) {
     RDMResponder_Tasks();
     RDMHandler_Tasks();
     SPIRGB_Tasks();
@@ -166,7 +180,10 @@ void APP_Tasks(void) {
 }
 
 void APP_Reset() {
-  Transceiver_Reset();
+  uint8_t i = 0u;
+  for (; i < TRANSCEIVER_PORT_COUNT; i++) {
+    Transceiver_Reset(i);
+  }
   SysLog_Message(SYSLOG_INFO, "Reset Device");
   USBTransport_SoftReset();
 }
@@ -47,6 +47,14 @@
  */
 #define USB_READ_BUFFER_SIZE 576u
 
+/**
+ * @brief The number of responses that can be queued on the bulk IN endpoint.
+ *
+ * USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED in system_config.h must allow for
+ * this many writes, plus the read.
+ */
+#define USB_TX_BUFFER_COUNT 3u
+
 /**
  * @brief The polling interval for the bulk endpoint in milliseconds.
  *
@@ -135,6 +143,18 @@ typedef enum {
    */
   COMMAND_GET_MARK_TIME = 0x13,
 
+  /**
+   * @brief Set the DMX refresh interval of the transceiver.
+   * See @ref message-commands-setrefreshinterval
+   */
+  COMMAND_SET_DMX_REFRESH_INTERVAL = 0x14,
+
+  /**
+   * @brief Fetch the current DMX refresh interval.
+   * See @ref message-commands-getrefreshinterval
+   */
+  COMMAND_GET_DMX_REFRESH_INTERVAL = 0x15,
+
   // Advanced Configuration
   /**
    * @brief Set the RDM Broadcast timeout.
@@ -196,6 +216,18 @@ typedef enum {
    */
   COMMAND_GET_RDM_RESPONDER_JITTER = 0x29,
 
+  /**
+   * @brief Enable or disable the automatic ACK_TIMER follow up.
+   * See @ref message-commands-setacktimer.
+   */
+  COMMAND_SET_ACK_TIMER_FOLLOW_UP = 0x2a,
+
+  /**
+   * @brief Check if the automatic ACK_TIMER follow up is enabled.
+   * See @ref message-commands-getacktimer.
+   */
+  COMMAND_GET_ACK_TIMER_FOLLOW_UP = 0x2b,
+
   // DMX
   TX_DMX = 0x30,  //!< Transmit a DMX frame. See @ref message-commands-txdmx.
 
@@ -218,6 +250,56 @@ typedef enum {
    */
   COMMAND_RDM_BROADCAST_REQUEST = 0x42,
 
+  /**
+   * @brief Run RDM discovery on the device.
+   * See @ref message-commands-rdmdiscovery.
+   */
+  COMMAND_RDM_DISCOVERY = 0x43,
+
+  /**
+   * @brief Fetch the UIDs found by the last RDM discovery.
+   * See @ref message-commands-getuids.
+   */
+  COMMAND_RDM_GET_DISCOVERED_UIDS = 0x44,
+
+  /**
+   * @brief Send an RDM Discovery Unique Branch and return the decoded
+   * response.
+   * See @ref message-commands-txrdmdecodeddub.
+   */
+  COMMAND_RDM_DECODED_DUB_REQUEST = 0x45,
+
+  /**
+   * @brief Fetch the UIDs added and removed by the last RDM discovery.
+   * See @ref message-commands-getchanges.
+   */
+  COMMAND_RDM_GET_DISCOVERY_CHANGES = 0x46,
+
+  // Batching
+  /**
+   * @brief Run several commands and return all the responses at once.
+   * See @ref message-commands-batch.
+   */
+  COMMAND_BATCH = 0x50,
+
+  /**
+   * @brief Send several RDM requests and return all the responses at once.
+   * See @ref message-commands-rdmbatch.
+   */
+  COMMAND_RDM_BATCH = 0x51,
+
+  // Diagnostics
+  /**
+   * @brief Get the RDM responder turnaround statistics.
+   * See @ref message-commands-getturnaround.
+   */
+  COMMAND_GET_RDM_TURNAROUND_STATS = 0x60,
+  /**
+   * @brief Get the controller line time statistics.
+   * See @ref message-commands-getlinestats.
+   */
+  COMMAND_GET_LINE_STATS = 0x61,
+
   // Experimental / testing
   COMMAND_ECHO = 0xf0,  //!< Echo the data back. See @ref message-commands-echo
   GET_FLAGS = 0xf2,  //!< Get the flags state
@@ -250,6 +332,16 @@ typedef enum {
   RC_CANCELLED = 10  //!< The request was preempted or cancelled
 } ReturnCode;
 
+/**
+ * @brief The outcome of a DUB, as returned by
+ * COMMAND_RDM_DECODED_DUB_REQUEST.
+ */
+typedef enum {
+  DUB_NO_RESPONSE = 0,  //!< No responder replied.
+  DUB_VALID_UID = 1,  //!< A single responder replied with a valid UID.
+  DUB_COLLISION = 2  //!< Data was received, but it didn't decode to a UID.
+} DUBResult;
+
 /**
  * @brief The Start of Message identifier.
  */
@@ -260,6 +352,14 @@ typedef enum {
  */
 #define END_OF_MESSAGE_ID 0xa5u
 
+/**
+ * @brief The size of a message header.
+ *
+ * The header is the Start of Message identifier, the token, the command and
+ * the payload length.
+ */
+#define MESSAGE_HEADER_SIZE 6u
+
 /**
  * @brief The maximum payload size in a message.
  */
@@ -308,6 +408,14 @@ typedef enum {
  */
 #define DEFAULT_RDM_RESPONDER_DELAY 1760u
 
+/**
+ * @brief The default interval at which the last DMX frame is re-sent.
+ * @sa Transceiver_SetDMXRefreshInterval.
+ *
+ * Measured in 10ths of a millisecond. 0 means frames are not re-sent.
+ */
+#define DEFAULT_DMX_REFRESH_INTERVAL 0u
+
 #endif  // FIRMWARE_SRC_CONSTANTS_H_
 
 /**
@@ -152,6 +152,7 @@ typedef struct {
   uint8_t curve;
   uint8_t output_response_time;
   uint8_t modulation_frequency;
+  uint8_t level;  // The last level received over DMX512.
   RDMStatusType sd_report_threshold;
 } DimmerSubDevice;
 
@@ -1055,6 +1056,7 @@ void DimmerModel_Initialize() {
     subdevice->curve = 1u;
     subdevice->output_response_time = 1u;
     subdevice->modulation_frequency = 1u;
+    subdevice->level = 0u;
     subdevice->sd_report_threshold = STATUS_ADVISORY;
     subdevice->status_message.is_active = false;
 
@@ -1079,6 +1081,10 @@ void DimmerModel_Initialize() {
   g_status_messages.count = 0u;
 }
 
+const ResponderDefinition *DimmerModel_GetSubDeviceDefinition() {
+  return &SUBDEVICE_RESPONDER_DEFINITION;
+}
+
 static void DimmerModel_Activate() {
   g_responder->def = &ROOT_RESPONDER_DEFINITION;
   RDMResponder_InitResponder();
@@ -1088,6 +1094,70 @@ static void DimmerModel_Activate() {
 
 static void DimmerModel_Deactivate() {}
 
+/*
+ * @brief The DMX slot window spans all the sub devices, which may not be
+ *   contiguous.
+ */
+static int DimmerModel_Ioctl(ModelIoctl command, uint8_t *data,
+                             unsigned int length) {
+  if (command != IOCTL_GET_DMX_WINDOW) {
+    return RDMResponder_Ioctl(command, data, length);
+  }
+  if (length != sizeof(DMXSlotWindow)) {
+    return 0;
+  }
+
+  uint16_t first_slot = MAX_DMX_START_ADDRESS + 1u;
+  uint16_t last_slot = 0u;
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    RDMResponder *responder = &g_subdevices[i].responder;
+    uint16_t footprint = responder->def
+        ->personalities[responder->current_personality - 1u].dmx_footprint;
+    uint16_t start_address = responder->dmx_start_address;
+    if (footprint == 0u || start_address == 0u ||
+        start_address > MAX_DMX_START_ADDRESS) {
+      continue;
+    }
+    uint16_t end = start_address + footprint - 1u;
+    if (end > MAX_DMX_START_ADDRESS) {
+      end = MAX_DMX_START_ADDRESS;
+    }
+    if (start_address < first_slot) {
+      first_slot = start_address;
+    }
+    if (end > last_slot) {
+      last_slot = end;
+    }
+  }
+
+  if (last_slot == 0u) {
+    return 0;
+  }
+  ((DMXSlotWindow*) data)->start_address = first_slot;
+  ((DMXSlotWindow*) data)->footprint = last_slot - first_slot + 1u;
+  return 1;
+}
+
+static void DimmerModel_HandleDMX(const uint8_t *slots, unsigned int length,
+                                  bool changed) {
+  DMXSlotWindow window;
+  if (!changed ||
+      !DimmerModel_Ioctl(IOCTL_GET_DMX_WINDOW, (uint8_t*) &window,
+                         sizeof(window))) {
+    return;
+  }
+
+  unsigned int i = 0u;
+  for (; i < NUMBER_OF_SUB_DEVICES; i++) {
+    unsigned int offset =
+        g_subdevices[i].responder.dmx_start_address - window.start_address;
+    if (offset < length) {
+      g_subdevices[i].level = slots[offset];
+    }
+  }
+}
+
 static int DimmerModel_HandleRequest(const RDMHeader *header,
                                      const uint8_t *param_data) {
   if (!RDMUtil_RequiresAction(g_responder->uid, header->dest_uid)) {
@@ -1229,9 +1299,10 @@ const ModelEntry DIMMER_MODEL_ENTRY = {
   .model_id = DIMMER_MODEL_ID,
   .activate_fn = DimmerModel_Activate,
   .deactivate_fn = DimmerModel_Deactivate,
-  .ioctl_fn = RDMResponder_Ioctl,
+  .ioctl_fn = DimmerModel_Ioctl,
   .request_fn = DimmerModel_HandleRequest,
-  .tasks_fn = DimmerModel_Tasks
+  .tasks_fn = DimmerModel_Tasks,
+  .dmx_fn = DimmerModel_HandleDMX
 };
 
 // Root device definition
@@ -1255,16 +1326,6 @@ static const PIDDescriptor ROOT_PID_DESCRIPTORS[] = {
     RDMResponder_SetDeviceLabel},
   {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
-    RDMResponder_SetIdentifyDevice},
-  {PID_PERFORM_SELFTEST, DimmerModel_GetSelfTest, 0u,
-    DimmerModel_PerformSelfTest},
-  {PID_SELF_TEST_DESCRIPTION, DimmerModel_GetSelfTestDescription, 1u,
-    (PIDCommandHandler) NULL},
-  {PID_CAPTURE_PRESET, (PIDCommandHandler) NULL, 0,
-    DimmerModel_CapturePreset},
-  {PID_PRESET_PLAYBACK, DimmerModel_GetPresetPlayback, 0,
-    DimmerModel_SetPresetPlayback},
   {PID_DMX_BLOCK_ADDRESS, DimmerModel_GetDMXBlockAddress, 0u,
     DimmerModel_SetDMXBlockAddress},
   {PID_DMX_FAIL_MODE, DimmerModel_GetDMXFailMode, 0u,
@@ -1275,6 +1336,16 @@ static const PIDDescriptor ROOT_PID_DESCRIPTORS[] = {
   {PID_LOCK_STATE, DimmerModel_GetLockState, 0u, DimmerModel_SetLockState},
   {PID_LOCK_STATE_DESCRIPTION, DimmerModel_GetLockStateDescription, 1u,
     (PIDCommandHandler) NULL},
+  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
+    RDMResponder_SetIdentifyDevice},
+  {PID_PERFORM_SELFTEST, DimmerModel_GetSelfTest, 0u,
+    DimmerModel_PerformSelfTest},
+  {PID_SELF_TEST_DESCRIPTION, DimmerModel_GetSelfTestDescription, 1u,
+    (PIDCommandHandler) NULL},
+  {PID_CAPTURE_PRESET, (PIDCommandHandler) NULL, 0,
+    DimmerModel_CapturePreset},
+  {PID_PRESET_PLAYBACK, DimmerModel_GetPresetPlayback, 0,
+    DimmerModel_SetPresetPlayback},
   {PID_PRESET_INFO, DimmerModel_GetPresetInfo, 0u,
     (PIDCommandHandler) NULL},
   {PID_PRESET_STATUS, DimmerModel_GetPresetStatus, 2u,
@@ -1326,15 +1397,10 @@ static const PIDDescriptor SUBDEVICE_PID_DESCRIPTORS[] = {
     (PIDCommandHandler) NULL},
   {PID_MANUFACTURER_LABEL, RDMResponder_GetManufacturerLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_DMX_START_ADDRESS, RDMResponder_GetDMXStartAddress, 0u,
-    RDMResponder_SetDMXStartAddress},
   {PID_SOFTWARE_VERSION_LABEL, RDMResponder_GetSoftwareVersionLabel, 0u,
     (PIDCommandHandler) NULL},
-  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
-    RDMResponder_SetIdentifyDevice},
-  {PID_BURN_IN, DimmerModel_GetBurnIn, 0u, DimmerModel_SetBurnIn},
-  {PID_IDENTIFY_MODE, DimmerModel_GetIdentifyMode, 0u,
-    DimmerModel_SetIdentifyMode},
+  {PID_DMX_START_ADDRESS, RDMResponder_GetDMXStartAddress, 0u,
+    RDMResponder_SetDMXStartAddress},
   {PID_DIMMER_INFO, DimmerModel_GetDimmerInfo, 0u,
     (PIDCommandHandler) NULL},
   {PID_MINIMUM_LEVEL, DimmerModel_GetMinimumLevel, 0u,
@@ -1353,6 +1419,11 @@ static const PIDDescriptor SUBDEVICE_PID_DESCRIPTORS[] = {
   {PID_MODULATION_FREQUENCY_DESCRIPTION,
     DimmerModel_GetModulationFrequencyDescription, 1u,
     (PIDCommandHandler) NULL},
+  {PID_BURN_IN, DimmerModel_GetBurnIn, 0u, DimmerModel_SetBurnIn},
+  {PID_IDENTIFY_DEVICE, RDMResponder_GetIdentifyDevice, 0u,
+    RDMResponder_SetIdentifyDevice},
+  {PID_IDENTIFY_MODE, DimmerModel_GetIdentifyMode, 0u,
+    DimmerModel_SetIdentifyMode},
 };
 
 static const ProductDetailIds SUBDEVICE_PRODUCT_DETAIL_ID_LIST = {
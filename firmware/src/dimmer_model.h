@@ -77,6 +77,7 @@
 #define FIRMWARE_SRC_DIMMER_MODEL_H_
 
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +93,12 @@ extern const ModelEntry DIMMER_MODEL_ENTRY;
  */
 void DimmerModel_Initialize();
 
+/**
+ * @brief Return the definition used by the sub-devices.
+ * @note This function should be used for testing only.
+ */
+const ResponderDefinition *DimmerModel_GetSubDeviceDefinition();
+
 #ifdef __cplusplus
 }
 #endif
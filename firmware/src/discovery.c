@@ -0,0 +1,578 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * discovery.c
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "discovery.h"
+
+#include <string.h>
+
+#include "app_pipeline.h"
+#include "constants.h"
+#include "rdm_frame.h"
+#include "rdm_util.h"
+#include "syslog.h"
+#include "utils.h"
+
+#include "app_settings.h"
+
+// The upper bound of the UID space.
+static const uint64_t MAX_UID = 0xffffffffffffull;
+
+// A binary search over 48 bits needs at most 49 pending branches.
+enum { BRANCH_STACK_SIZE = 49 };
+
+// The DUB parameter data is the lower & upper bound UIDs.
+enum { DUB_PARAM_DATA_LENGTH = 2 * UID_LENGTH };
+
+// The largest request we send is a DUB, the extra 2 bytes are the checksum.
+enum { MAX_REQUEST_SIZE = sizeof(RDMHeader) + DUB_PARAM_DATA_LENGTH + 2 };
+
+typedef enum {
+  DISCOVERY_IDLE,
+  DISCOVERY_UNMUTE,  //!< Waiting for the broadcast DISC_UN_MUTE to complete.
+  DISCOVERY_VERIFY,  //!< Waiting for the response to a single-UID DUB.
+  DISCOVERY_DUB,  //!< Waiting for the response to a DUB.
+  DISCOVERY_MUTE  //!< Waiting for the response to a DISC_MUTE.
+} DiscoveryState;
+
+/*
+ * The state of each entry in the UID table during a discovery run.
+ */
+typedef enum {
+  UID_UNVERIFIED,  //!< Known from the last run, not found yet.
+  UID_PRESENT,  //!< Known from the last run, and found again.
+  UID_ADDED  //!< Not known from the last run.
+} UIDState;
+
+typedef struct {
+  uint64_t lower;
+  uint64_t upper;
+} Branch;
+
+typedef struct {
+  DiscoveryState state;
+  int16_t token;  //!< The token passed to Discovery_Start()
+  uint8_t port;  //!< The transceiver port discovery runs on.
+  uint8_t uid[UID_LENGTH];  //!< Our UID.
+  uint8_t transaction_number;
+
+  Branch branches[BRANCH_STACK_SIZE];
+  unsigned int branch_count;
+
+  uint8_t mute_uid[UID_LENGTH];  //!< The UID we're trying to mute.
+  unsigned int mute_attempts;
+  bool verifying;  //!< True while known UIDs are being verified.
+  unsigned int verify_index;  //!< The index of the UID being verified.
+
+  /*
+   * The UID table. Once a run completes the entries are ordered: unchanged,
+   * added, removed. uid_count covers the unchanged & added entries.
+   */
+  unsigned int uid_count;
+  unsigned int added_count;
+  unsigned int removed_count;
+  uint8_t uids[DISCOVERY_MAX_UIDS * UID_LENGTH];
+  uint8_t uid_state[DISCOVERY_MAX_UIDS];
+
+  uint8_t frame[MAX_REQUEST_SIZE];
+
+#ifndef PIPELINE_DISCOVERY_COMPLETE
+  DiscoveryCompleteCallback complete_callback;
+#endif
+} DiscoveryData;
+
+static DiscoveryData g_discovery;
+
+static const uint8_t BROADCAST_UID[UID_LENGTH] = {
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static inline uint64_t UIDToInt(const uint8_t *uid) {
+  uint64_t value = 0u;
+  unsigned int i = 0u;
+  for (; i < UID_LENGTH; i++) {
+    value = (value << 8) + uid[i];
+  }
+  return value;
+}
+
+static inline void IntToUID(uint64_t value, uint8_t *uid) {
+  int i = UID_LENGTH - 1;
+  for (; i >= 0; i--) {
+    uid[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+/*
+ * @brief Find a UID in the table.
+ * @returns The index of the UID, or -1 if it wasn't found.
+ */
+static int FindUID(const uint8_t *uid) {
+  unsigned int i = 0u;
+  for (; i < g_discovery.uid_count; i++) {
+    if (RDMUtil_UIDCompare(uid, g_discovery.uids + i * UID_LENGTH) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*
+ * @brief Check if a UID has already been found during this run.
+ */
+static bool FoundThisRun(const uint8_t *uid) {
+  int index = FindUID(uid);
+  return index >= 0 && g_discovery.uid_state[index] != UID_UNVERIFIED;
+}
+
+static void SwapEntries(unsigned int i, unsigned int j) {
+  uint8_t uid[UID_LENGTH];
+  uint8_t *first = g_discovery.uids + i * UID_LENGTH;
+  uint8_t *second = g_discovery.uids + j * UID_LENGTH;
+  memcpy(uid, first, UID_LENGTH);
+  memcpy(first, second, UID_LENGTH);
+  memcpy(second, uid, UID_LENGTH);
+
+  uint8_t state = g_discovery.uid_state[i];
+  g_discovery.uid_state[i] = g_discovery.uid_state[j];
+  g_discovery.uid_state[j] = state;
+}
+
+/*
+ * @brief Order the UID table as unchanged, added, removed.
+ * @param remove_unverified true if UIDs that weren't found should be removed.
+ */
+static void PartitionTable(bool remove_unverified) {
+  g_discovery.added_count = 0u;
+  g_discovery.removed_count = 0u;
+
+  unsigned int i = 0u;
+  while (i < g_discovery.uid_count) {
+    if (remove_unverified && g_discovery.uid_state[i] == UID_UNVERIFIED) {
+      g_discovery.uid_count--;
+      g_discovery.removed_count++;
+      SwapEntries(i, g_discovery.uid_count);
+    } else {
+      i++;
+    }
+  }
+
+  unsigned int unchanged_count = g_discovery.uid_count;
+  i = 0u;
+  while (i < unchanged_count) {
+    if (g_discovery.uid_state[i] == UID_ADDED) {
+      unchanged_count--;
+      g_discovery.added_count++;
+      SwapEntries(i, unchanged_count);
+    } else {
+      i++;
+    }
+  }
+}
+
+static void Complete(DiscoveryResult result) {
+  g_discovery.state = DISCOVERY_IDLE;
+  // If the run didn't finish, we can't tell if the unverified UIDs are gone.
+  PartitionTable(result == DISCOVERY_OK);
+  SysLog_Print(SYSLOG_INFO, "Discovery done, %d UIDs, +%d, -%d, result %d",
+               g_discovery.uid_count, g_discovery.added_count,
+               g_discovery.removed_count, result);
+#ifdef PIPELINE_DISCOVERY_COMPLETE
+  PIPELINE_DISCOVERY_COMPLETE(g_discovery.token, result);
+#else
+  if (g_discovery.complete_callback) {
+    g_discovery.complete_callback(g_discovery.token, result);
+  }
+#endif
+}
+
+/*
+ * @brief Build a discovery request in g_discovery.frame.
+ * @returns The size of the frame, including the start code.
+ */
+static unsigned int BuildRequest(const uint8_t *dest_uid, uint16_t pid,
+                                 const uint8_t *param_data,
+                                 unsigned int param_data_length) {
+  RDMHeader *header = (RDMHeader*) g_discovery.frame;
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = sizeof(RDMHeader) + param_data_length;
+  memcpy(header->dest_uid, dest_uid, UID_LENGTH);
+  memcpy(header->src_uid, g_discovery.uid, UID_LENGTH);
+  header->transaction_number = g_discovery.transaction_number++;
+  header->port_id = 1u;
+  header->message_count = 0u;
+  header->sub_device = htons(SUBDEVICE_ROOT);
+  header->command_class = DISCOVERY_COMMAND;
+  header->param_id = htons(pid);
+  header->param_data_length = param_data_length;
+  if (param_data_length) {
+    memcpy(g_discovery.frame + sizeof(RDMHeader), param_data,
+           param_data_length);
+  }
+  return RDMUtil_AppendChecksum(g_discovery.frame);
+}
+
+/*
+ * @brief Queue a transceiver operation, or complete with a TX error if the
+ *   transceiver queue is full.
+ */
+static void CheckQueued(bool ok) {
+  if (!ok) {
+    Complete(DISCOVERY_TX_ERROR);
+  }
+}
+
+static bool SendUnMute() {
+  unsigned int size = BuildRequest(BROADCAST_UID, PID_DISC_UN_MUTE, NULL, 0u);
+  g_discovery.state = DISCOVERY_UNMUTE;
+  return Transceiver_QueueRDMRequest(g_discovery.port, DISCOVERY_TOKEN,
+                                     g_discovery.frame + 1, size - 1, true);
+}
+
+static void SendMute() {
+  unsigned int size = BuildRequest(g_discovery.mute_uid, PID_DISC_MUTE, NULL,
+                                   0u);
+  g_discovery.state = DISCOVERY_MUTE;
+  g_discovery.mute_attempts++;
+  CheckQueued(Transceiver_QueueRDMRequest(
+      g_discovery.port, DISCOVERY_TOKEN, g_discovery.frame + 1, size - 1,
+      false));
+}
+
+static unsigned int BuildDUB(uint64_t lower, uint64_t upper) {
+  uint8_t param_data[DUB_PARAM_DATA_LENGTH];
+  IntToUID(lower, param_data);
+  IntToUID(upper, param_data + UID_LENGTH);
+  return BuildRequest(BROADCAST_UID, PID_DISC_UNIQUE_BRANCH, param_data,
+                      DUB_PARAM_DATA_LENGTH);
+}
+
+/*
+ * @brief Send a DUB for the branch on the top of the stack, or complete
+ *   discovery if there are no branches left.
+ */
+static void NextBranch() {
+  if (g_discovery.branch_count == 0u) {
+    Complete(DISCOVERY_OK);
+    return;
+  }
+
+  const Branch *branch = &g_discovery.branches[g_discovery.branch_count - 1u];
+  unsigned int size = BuildDUB(branch->lower, branch->upper);
+  g_discovery.state = DISCOVERY_DUB;
+  CheckQueued(Transceiver_QueueRDMDUB(g_discovery.port, DISCOVERY_TOKEN,
+                                      g_discovery.frame + 1, size - 1));
+}
+
+/*
+ * @brief Start the binary search over the entire UID space.
+ */
+static void StartSearch() {
+  g_discovery.verifying = false;
+  g_discovery.branches[0].lower = 0u;
+  g_discovery.branches[0].upper = MAX_UID;
+  g_discovery.branch_count = 1u;
+  NextBranch();
+}
+
+/*
+ * @brief Send a DUB for the next known UID, or start the search once all
+ *   known UIDs have been checked.
+ */
+static void VerifyNext() {
+  if (g_discovery.verify_index == g_discovery.uid_count) {
+    StartSearch();
+    return;
+  }
+
+  uint64_t uid = UIDToInt(
+      g_discovery.uids + g_discovery.verify_index * UID_LENGTH);
+  unsigned int size = BuildDUB(uid, uid);
+  g_discovery.state = DISCOVERY_VERIFY;
+  CheckQueued(Transceiver_QueueRDMDUB(g_discovery.port, DISCOVERY_TOKEN,
+                                      g_discovery.frame + 1, size - 1));
+}
+
+/*
+ * @brief Move on to the next step once a mute completes or fails.
+ */
+static void Continue() {
+  if (g_discovery.verifying) {
+    VerifyNext();
+  } else {
+    NextBranch();
+  }
+}
+
+/*
+ * @brief Split the branch on the top of the stack.
+ *
+ * This is used when more than one responder replied to a DUB. A branch that
+ * covers a single UID can't be split, so it's dropped.
+ */
+static void SplitBranch() {
+  Branch *branch = &g_discovery.branches[g_discovery.branch_count - 1u];
+  if (branch->lower == branch->upper) {
+    g_discovery.branch_count--;
+    return;
+  }
+
+  uint64_t lower = branch->lower;
+  uint64_t mid = lower + (branch->upper - lower) / 2u;
+  branch->lower = mid + 1u;
+
+  branch = &g_discovery.branches[g_discovery.branch_count++];
+  branch->lower = lower;
+  branch->upper = mid;
+}
+
+static void HandleDUBResponse(const TransceiverEvent *event) {
+  if (event->result == T_RESULT_RX_TIMEOUT) {
+    // No responders in this branch.
+    g_discovery.branch_count--;
+    NextBranch();
+    return;
+  }
+
+  const Branch *branch = &g_discovery.branches[g_discovery.branch_count - 1u];
+  if (event->result == T_RESULT_RX_DATA &&
+      RDMUtil_DecodeDUBResponse(event->data, event->length,
+                                g_discovery.mute_uid)) {
+    uint64_t uid = UIDToInt(g_discovery.mute_uid);
+    if (uid >= branch->lower && uid <= branch->upper &&
+        !FoundThisRun(g_discovery.mute_uid)) {
+      g_discovery.mute_attempts = 0u;
+      SendMute();
+      return;
+    }
+  }
+
+  SplitBranch();
+  NextBranch();
+}
+
+static void HandleVerifyResponse(const TransceiverEvent *event) {
+  if (event->result == T_RESULT_RX_TIMEOUT) {
+    // The responder has gone.
+    g_discovery.verify_index++;
+    VerifyNext();
+    return;
+  }
+
+  // Only one UID is in range, so any response is treated as coming from
+  // the known responder. The mute confirms it.
+  memcpy(g_discovery.mute_uid,
+         g_discovery.uids + g_discovery.verify_index * UID_LENGTH, UID_LENGTH);
+  g_discovery.verify_index++;
+  g_discovery.mute_attempts = 0u;
+  SendMute();
+}
+
+/*
+ * @brief Check if a DISC_MUTE response is a valid ACK from the responder we
+ *   tried to mute.
+ */
+static bool IsMuteAck(const TransceiverEvent *event) {
+  if (event->result != T_RESULT_RX_DATA ||
+      !RDMUtil_VerifyChecksum(event->data, event->length)) {
+    return false;
+  }
+  // For responses, the port_id field holds the response type.
+  const RDMHeader *header = (const RDMHeader*) event->data;
+  return (header->start_code == RDM_START_CODE &&
+          header->sub_start_code == SUB_START_CODE &&
+          header->command_class == DISCOVERY_COMMAND_RESPONSE &&
+          ntohs(header->param_id) == PID_DISC_MUTE &&
+          header->port_id == ACK &&
+          RDMUtil_UIDCompare(header->src_uid, g_discovery.mute_uid) == 0);
+}
+
+/*
+ * @brief Record that the responder we muted was found.
+ * @returns false if the UID table is full.
+ */
+static bool RecordUID() {
+  int index = FindUID(g_discovery.mute_uid);
+  if (index >= 0) {
+    g_discovery.uid_state[index] = UID_PRESENT;
+    return true;
+  }
+
+  if (g_discovery.uid_count == DISCOVERY_MAX_UIDS) {
+    return false;
+  }
+  memcpy(g_discovery.uids + g_discovery.uid_count * UID_LENGTH,
+         g_discovery.mute_uid, UID_LENGTH);
+  g_discovery.uid_state[g_discovery.uid_count] = UID_ADDED;
+  g_discovery.uid_count++;
+  return true;
+}
+
+static void HandleMuteResponse(const TransceiverEvent *event) {
+  if (IsMuteAck(event)) {
+    if (!RecordUID()) {
+      Complete(DISCOVERY_TABLE_FULL);
+      return;
+    }
+    // When searching, there may be more responders in this branch.
+    Continue();
+    return;
+  }
+
+  if (g_discovery.mute_attempts < DISCOVERY_MUTE_ATTEMPTS) {
+    SendMute();
+    return;
+  }
+
+  SysLog_Message(SYSLOG_INFO, "Discovery: mute failed");
+  if (!g_discovery.verifying) {
+    SplitBranch();
+  }
+  Continue();
+}
+
+// Public Functions
+// ----------------------------------------------------------------------------
+void Discovery_Initialize(const DiscoverySettings *settings) {
+  g_discovery.state = DISCOVERY_IDLE;
+  g_discovery.token = 0;
+  g_discovery.port = 0u;
+  memcpy(g_discovery.uid, settings->uid, UID_LENGTH);
+  g_discovery.transaction_number = 0u;
+  g_discovery.branch_count = 0u;
+  g_discovery.mute_attempts = 0u;
+  g_discovery.verifying = false;
+  g_discovery.verify_index = 0u;
+  g_discovery.uid_count = 0u;
+  g_discovery.added_count = 0u;
+  g_discovery.removed_count = 0u;
+#ifndef PIPELINE_DISCOVERY_COMPLETE
+  g_discovery.complete_callback = settings->complete_callback;
+#endif
+}
+
+bool Discovery_Start(int16_t token, uint8_t port, DiscoveryMode mode) {
+  if (g_discovery.state != DISCOVERY_IDLE) {
+    return false;
+  }
+
+  uint8_t last_port = g_discovery.port;
+  g_discovery.port = port;
+  if (!SendUnMute()) {
+    g_discovery.state = DISCOVERY_IDLE;
+    g_discovery.port = last_port;
+    return false;
+  }
+
+  // The UIDs found on another port aren't known on this one.
+  if (port != last_port) {
+    g_discovery.uid_count = 0u;
+  }
+
+  // The UIDs from the last run become the known UIDs.
+  unsigned int i = 0u;
+  for (; i < g_discovery.uid_count; i++) {
+    g_discovery.uid_state[i] = UID_UNVERIFIED;
+  }
+  g_discovery.added_count = 0u;
+  g_discovery.removed_count = 0u;
+  g_discovery.verifying = (mode == DISCOVERY_INCREMENTAL);
+  g_discovery.verify_index = 0u;
+  g_discovery.branch_count = 0u;
+  g_discovery.token = token;
+  return true;
+}
+
+bool Discovery_IsRunning() {
+  return g_discovery.state != DISCOVERY_IDLE;
+}
+
+uint8_t Discovery_GetPort() {
+  return g_discovery.port;
+}
+
+bool Discovery_TransceiverEvent(const TransceiverEvent *event) {
+  if (event->token != DISCOVERY_TOKEN) {
+    return false;
+  }
+
+  if (g_discovery.state == DISCOVERY_IDLE ||
+      event->port != g_discovery.port) {
+    return true;
+  }
+
+  switch (event->result) {
+    case T_RESULT_TX_ERROR:
+      Complete(DISCOVERY_TX_ERROR);
+      return true;
+    case T_RESULT_CANCELLED:
+      Complete(DISCOVERY_CANCELLED);
+      return true;
+    default:
+      {}
+  }
+
+  switch (g_discovery.state) {
+    case DISCOVERY_UNMUTE:
+      if (g_discovery.verifying) {
+        VerifyNext();
+      } else {
+        StartSearch();
+      }
+      break;
+    case DISCOVERY_VERIFY:
+      HandleVerifyResponse(event);
+      break;
+    case DISCOVERY_DUB:
+      HandleDUBResponse(event);
+      break;
+    case DISCOVERY_MUTE:
+      HandleMuteResponse(event);
+      break;
+    case DISCOVERY_IDLE:
+      break;
+  }
+  return true;
+}
+
+unsigned int Discovery_UIDCount() {
+  return g_discovery.uid_count;
+}
+
+const uint8_t *Discovery_GetUIDs() {
+  return g_discovery.uids;
+}
+
+unsigned int Discovery_AddedCount() {
+  return g_discovery.added_count;
+}
+
+const uint8_t *Discovery_GetAddedUIDs() {
+  return g_discovery.uids +
+         (g_discovery.uid_count - g_discovery.added_count) * UID_LENGTH;
+}
+
+unsigned int Discovery_RemovedCount() {
+  return g_discovery.removed_count;
+}
+
+const uint8_t *Discovery_GetRemovedUIDs() {
+  return g_discovery.uids + g_discovery.uid_count * UID_LENGTH;
+}
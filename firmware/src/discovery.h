@@ -0,0 +1,202 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * discovery.h
+ * Copyright (C) 2015 Simon Newton
+ */
+
+/**
+ * @defgroup discovery RDM Discovery
+ * @brief On-device RDM discovery for controller mode.
+ *
+ * The discovery engine runs the binary search DUB / DISC_MUTE /
+ * DISC_UN_MUTE algorithm from E1.20 without involving the host. It
+ * queues one operation at a time with the transceiver, and decides the next
+ * branch when the transceiver event for that operation arrives.
+ *
+ * The transceiver events for discovery operations use DISCOVERY_TOKEN, so they
+ * must be passed to Discovery_TransceiverEvent() before any other handler.
+ *
+ * Once discovery completes, the UIDs that were found can be read with
+ * Discovery_GetUIDs().
+ *
+ * There is a single discovery engine, which runs on the transceiver port
+ * passed to Discovery_Start(). Starting a run on a different port discards the
+ * UIDs found on the previous port.
+ *
+ * The UIDs found by a run are kept as the known UIDs for the next run. An
+ * incremental run first sends a DUB for each known UID on its own, and mutes
+ * the responders that reply, before searching the rest of the UID space. In
+ * both modes, the changes since the last run are available from
+ * Discovery_GetAddedUIDs() and Discovery_GetRemovedUIDs().
+ *
+ * @addtogroup discovery
+ * @{
+ * @file discovery.h
+ * @brief On-device RDM discovery for controller mode.
+ */
+
+#ifndef FIRMWARE_SRC_DISCOVERY_H_
+#define FIRMWARE_SRC_DISCOVERY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rdm.h"
+#include "transceiver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The transceiver token used for discovery operations.
+ *
+ * This is outside the range of the host tokens.
+ */
+#define DISCOVERY_TOKEN 0x100
+
+/**
+ * @brief The number of times to try muting a responder before giving up.
+ */
+#define DISCOVERY_MUTE_ATTEMPTS 3u
+
+/**
+ * @brief The outcome of a discovery run.
+ */
+typedef enum {
+  DISCOVERY_OK,  //!< Discovery completed.
+  DISCOVERY_TABLE_FULL,  //!< More than DISCOVERY_MAX_UIDS were found.
+  DISCOVERY_TX_ERROR,  //!< A transceiver operation failed.
+  DISCOVERY_CANCELLED  //!< Discovery was cancelled, e.g. by a mode change.
+} DiscoveryResult;
+
+/**
+ * @brief The type of discovery run.
+ */
+typedef enum {
+  DISCOVERY_FULL,  //!< Search the entire UID space.
+  DISCOVERY_INCREMENTAL  //!< Verify the known UIDs first, then search.
+} DiscoveryMode;
+
+/**
+ * @brief The callback run when discovery completes.
+ * @param token The token passed to Discovery_Start().
+ * @param result The outcome of the discovery run.
+ */
+typedef void (*DiscoveryCompleteCallback)(int16_t token,
+                                          DiscoveryResult result);
+
+/**
+ * @brief The settings to use for the discovery engine.
+ */
+typedef struct {
+  uint8_t uid[UID_LENGTH];  //!< The UID to use as the source of requests.
+
+  /**
+   * @brief The callback to run when discovery completes.
+   *
+   * If PIPELINE_DISCOVERY_COMPLETE is defined this will override the
+   * complete_callback.
+   */
+  DiscoveryCompleteCallback complete_callback;
+} DiscoverySettings;
+
+/**
+ * @brief Initialize the discovery engine.
+ * @param settings The settings for the discovery engine.
+ */
+void Discovery_Initialize(const DiscoverySettings *settings);
+
+/**
+ * @brief Start a discovery run.
+ * @param token The token to pass to the complete callback.
+ * @param port The index of the transceiver port to run discovery on.
+ * @param mode The type of discovery to run.
+ * @returns true if discovery started, false if discovery was already running
+ *   or the transceiver queue was full.
+ *
+ * The UIDs from the previous run become the known UIDs. Known UIDs that
+ * aren't found by a run which completes with DISCOVERY_OK are removed.
+ */
+bool Discovery_Start(int16_t token, uint8_t port, DiscoveryMode mode);
+
+/**
+ * @brief Check if discovery is running.
+ * @returns true if discovery is running, false otherwise.
+ */
+bool Discovery_IsRunning();
+
+/**
+ * @brief Get the transceiver port used by the last discovery run.
+ * @returns The index of the port.
+ */
+uint8_t Discovery_GetPort();
+
+/**
+ * @brief Handle a transceiver event.
+ * @param event The event to handle.
+ * @returns true if the event was for a discovery operation, false otherwise.
+ */
+bool Discovery_TransceiverEvent(const TransceiverEvent *event);
+
+/**
+ * @brief Get the number of UIDs found by the last discovery run.
+ * @returns The number of UIDs.
+ */
+unsigned int Discovery_UIDCount();
+
+/**
+ * @brief Get the UIDs found by the last discovery run.
+ * @returns A pointer to Discovery_UIDCount() UIDs, stored contiguously.
+ */
+const uint8_t *Discovery_GetUIDs();
+
+/**
+ * @brief Get the number of UIDs the last discovery run added.
+ * @returns The number of UIDs that weren't known before the last run.
+ */
+unsigned int Discovery_AddedCount();
+
+/**
+ * @brief Get the UIDs the last discovery run added.
+ * @returns A pointer to Discovery_AddedCount() UIDs, stored contiguously.
+ *
+ * The added UIDs are also included in Discovery_GetUIDs(), and are
+ * immediately followed by the removed UIDs.
+ */
+const uint8_t *Discovery_GetAddedUIDs();
+
+/**
+ * @brief Get the number of UIDs the last discovery run removed.
+ * @returns The number of known UIDs that weren't found by the last run.
+ */
+unsigned int Discovery_RemovedCount();
+
+/**
+ * @brief Get the UIDs the last discovery run removed.
+ * @returns A pointer to Discovery_RemovedCount() UIDs, stored contiguously.
+ */
+const uint8_t *Discovery_GetRemovedUIDs();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif  // FIRMWARE_SRC_DISCOVERY_H_
@@ -25,6 +25,7 @@
 #include "rdm_frame.h"
 #include "rdm_responder.h"
 #include "rdm_util.h"
+#include "spi_rgb.h"
 #include "utils.h"
 
 // Various constants
@@ -35,6 +36,7 @@ static const char SOFTWARE_LABEL[] = "Alpha";
 static const char DEFAULT_DEVICE_LABEL[] = "Ja Rule";
 enum { MAX_PIXEL_COUNT = 170u };
 enum { DEFAULT_PIXEL_COUNT = 2u };
+enum { SLOTS_PER_PIXEL = 3u };
 
 static const ResponderDefinition RESPONDER_DEFINITION;
 
@@ -162,6 +164,23 @@ static void LEDModel_Activate() {
 
 static void LEDModel_Deactivate() {}
 
+static int LEDModel_Ioctl(ModelIoctl command, uint8_t *data,
+                          unsigned int length) {
+  switch (command) {
+    case IOCTL_GET_DMX_WINDOW:
+      // The pixels always start at slot 1.
+      if (length != sizeof(DMXSlotWindow) || g_model.pixel_count == 0u) {
+        return 0;
+      }
+      ((DMXSlotWindow*) data)->start_address = 1u;
+      ((DMXSlotWindow*) data)->footprint =
+          g_model.pixel_count * SLOTS_PER_PIXEL;
+      return 1;
+    default:
+      return RDMResponder_Ioctl(command, data, length);
+  }
+}
+
 static int LEDModel_HandleRequest(const RDMHeader *header,
                                   const uint8_t *param_data) {
   if (!RDMUtil_RequiresAction(g_responder->uid, header->dest_uid)) {
@@ -189,13 +208,28 @@ static int LEDModel_HandleRequest(const RDMHeader *header,
 
 static void LEDModel_Tasks() {}
 
+static void LEDModel_HandleDMX(const uint8_t *slots, unsigned int length,
+                               bool changed) {
+  if (!changed) {
+    return;
+  }
+
+  SPIRGB_BeginUpdate();
+  unsigned int i = 0u;
+  for (; i < length; i++) {
+    SPIRGB_SetPixel(i / SLOTS_PER_PIXEL, i % SLOTS_PER_PIXEL, slots[i]);
+  }
+  SPIRGB_CompleteUpdate();
+}
+
 const ModelEntry LED_MODEL_ENTRY = {
   .model_id = LED_MODEL_ID,
   .activate_fn = LEDModel_Activate,
   .deactivate_fn = LEDModel_Deactivate,
-  .ioctl_fn = RDMResponder_Ioctl,
+  .ioctl_fn = LEDModel_Ioctl,
   .request_fn = LEDModel_HandleRequest,
-  .tasks_fn = LEDModel_Tasks
+  .tasks_fn = LEDModel_Tasks,
+  .dmx_fn = LEDModel_HandleDMX
 };
 
 static const PIDDescriptor PID_DESCRIPTORS[] = {
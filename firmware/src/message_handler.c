@@ -20,21 +20,119 @@
 #include "message_handler.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "system_definitions.h"
 
 #include "app.h"
 #include "app_pipeline.h"
+#include "coarse_timer.h"
 #include "constants.h"
+#include "discovery.h"
 #include "flags.h"
 #include "peripheral/eth/plib_eth.h"
+#include "rdm.h"
 #include "rdm_frame.h"
 #include "rdm_handler.h"
+#include "rdm_util.h"
 #include "syslog.h"
 #include "transceiver.h"
+#include "utils.h"
 
 #include "app_settings.h"
 
+// The maximum number of UIDs in a discovered UIDs response, after the UID
+// count.
+enum { MAX_UIDS_PER_RESPONSE = (PAYLOAD_SIZE - sizeof(uint16_t)) / UID_LENGTH };
+
+// The maximum number of changed UIDs in a discovery response, after the UID,
+// added & removed counts.
+enum {
+  MAX_CHANGES_PER_RESPONSE = (PAYLOAD_SIZE - 3u * sizeof(uint16_t)) /
+                             UID_LENGTH
+};
+
+// The size of the command and length fields that precede each sub-command in
+// a batch request.
+enum { BATCH_REQUEST_HEADER_SIZE = 4u };
+
+// The size of the command, return code and length fields that precede each
+// sub-command response in a batch response.
+enum { BATCH_RESPONSE_HEADER_SIZE = 5u };
+
+// The transceiver token used for the requests in a RDM batch. This is outside
+// the range of the host tokens, and doesn't overlap with DISCOVERY_TOKEN.
+enum { RDM_BATCH_TOKEN = DISCOVERY_TOKEN + 1 };
+
+typedef struct {
+  bool overflow;  //!< True if a sub-command response didn't fit.
+  unsigned int size;  //!< The number of bytes in data.
+  uint8_t data[PAYLOAD_SIZE];  //!< The aggregated sub-command responses.
+} BatchResponse;
+
+/*
+ * @brief The state of a COMMAND_RDM_BATCH request.
+ *
+ * The RDM requests are sent one at a time, the next is queued once the
+ * transceiver event for the previous one arrives.
+ */
+typedef struct {
+  bool active;  //!< True while the RDM requests are running.
+  uint8_t token;  //!< The token of the host request.
+  uint8_t port;  //!< The transceiver port the requests are sent on.
+  unsigned int offset;  //!< The offset of the next sub-command in request.
+  unsigned int length;  //!< The number of bytes in request.
+  uint8_t request[PAYLOAD_SIZE];  //!< A copy of the host request.
+  BatchResponse response;
+} RDMBatch;
+
+// The number of times to follow up an ACK_TIMER, before the ACK_TIMER is
+// returned to the host.
+enum { MAX_ACK_TIMER_FOLLOW_UPS = 5u };
+
+// The size of a GET QUEUED_MESSAGE request, including the start code. The
+// param data is 1 byte, and the extra 2 bytes are the checksum.
+enum { QUEUED_MESSAGE_REQUEST_SIZE = sizeof(RDMHeader) + 1u + 2u };
+
+typedef enum {
+  FOLLOW_UP_IDLE,
+  FOLLOW_UP_WAITING,  //!< Waiting for the ACK_TIMER delay to pass.
+  FOLLOW_UP_SENT  //!< Waiting for the response to GET QUEUED_MESSAGE.
+} FollowUpState;
+
+/*
+ * @brief The state of the ACK_TIMER follow up.
+ *
+ * Only one follow up can be in progress at once. Any other ACK_TIMER
+ * responses are returned to the host.
+ */
+typedef struct {
+  bool enabled;
+  FollowUpState state;
+  uint8_t token;  //!< The token of the host request.
+  uint8_t port;  //!< The transceiver port of the host request.
+  unsigned int attempts;  //!< The number of GET QUEUED_MESSAGEs sent.
+  CoarseTimer_Value start;  //!< The time the ACK_TIMER was received.
+  uint32_t delay;  //!< The delay, in 10ths of a millisecond.
+  uint8_t frame[QUEUED_MESSAGE_REQUEST_SIZE];  //!< The GET QUEUED_MESSAGE.
+} AckTimerFollowUp;
+
+static BatchResponse g_batch;
+static RDMBatch g_rdm_batch;
+static AckTimerFollowUp g_follow_up;
+
+// While this is non-NULL, responses are appended to it rather than sent.
+static BatchResponse *g_batch_response = NULL;
+
+// The transceiver port of the message or event being handled. Responses are
+// sent with this port in the high byte of the command.
+static uint8_t g_port = 0u;
+
+// The tokens of the outstanding COMMAND_RDM_DECODED_DUB_REQUESTs, one bit per
+// token, for each port.
+static uint8_t g_decoded_dub_tokens[TRANSCEIVER_PORT_COUNT][(UINT8_MAX + 1u) /
+                                                            8u];
+
 #ifndef PIPELINE_TRANSPORT_TX
 static TransportTXFunction g_message_tx_cb;
 #endif
@@ -43,8 +141,56 @@ static inline uint16_t JoinUInt16(uint8_t upper, uint8_t lower) {
   return (upper << 8) + lower;
 }
 
+static inline void SetDecodedDUB(uint8_t token, bool decode) {
+  if (decode) {
+    g_decoded_dub_tokens[g_port][token >> 3] |= (1u << (token & 0x07));
+  } else {
+    g_decoded_dub_tokens[g_port][token >> 3] &= ~(1u << (token & 0x07));
+  }
+}
+
+static inline bool IsDecodedDUB(int16_t token) {
+  return token >= 0 && token <= UINT8_MAX &&
+         (g_decoded_dub_tokens[g_port][token >> 3] & (1u << (token & 0x07)));
+}
+
+/*
+ * @brief Append a sub-command response to the batch response.
+ */
+static void AppendToBatch(BatchResponse *batch, Command command, uint8_t rc,
+                          const IOVec* iov, unsigned int iov_size) {
+  unsigned int length = 0u;
+  unsigned int i = 0u;
+  for (; i != iov_size; i++) {
+    length += iov[i].length;
+  }
+
+  if (batch->overflow ||
+      batch->size + BATCH_RESPONSE_HEADER_SIZE + length > PAYLOAD_SIZE) {
+    batch->overflow = true;
+    return;
+  }
+
+  uint8_t *ptr = batch->data + batch->size;
+  *ptr++ = ShortLSB(command);
+  *ptr++ = g_port;
+  *ptr++ = rc;
+  *ptr++ = ShortLSB(length);
+  *ptr++ = ShortMSB(length);
+  for (i = 0u; i != iov_size; i++) {
+    memcpy(ptr, iov[i].base, iov[i].length);
+    ptr += iov[i].length;
+  }
+  batch->size = ptr - batch->data;
+}
+
 static inline void SendMessage(uint8_t token, Command command, uint8_t rc,
                                const IOVec* iov, unsigned int iov_size) {
+  if (g_batch_response) {
+    AppendToBatch(g_batch_response, command, rc, iov, iov_size);
+    return;
+  }
+  command = (Command) JoinUInt16(g_port, ShortLSB(command));
 #ifdef PIPELINE_TRANSPORT_TX
   PIPELINE_TRANSPORT_TX(token, command, rc, iov, iov_size);
 #else
@@ -59,6 +205,29 @@ static void Echo(const Message *message) {
   SendMessage(message->token, COMMAND_ECHO, RC_OK, &iovec, 1u);
 }
 
+/*
+ * @brief Cancel the ACK_TIMER follow up, if one is in progress.
+ */
+static void CancelFollowUp() {
+  if (g_follow_up.state == FOLLOW_UP_IDLE) {
+    return;
+  }
+  g_follow_up.state = FOLLOW_UP_IDLE;
+  g_port = g_follow_up.port;
+  SendMessage(g_follow_up.token, COMMAND_RDM_REQUEST, RC_CANCELLED, NULL, 0u);
+}
+
+static void ResetDevice(uint8_t token) {
+  // The reset runs the cancelled events for any pending frames, which may be
+  // on other ports. A follow up that's waiting for the ACK_TIMER delay has
+  // nothing queued, so it's cancelled here.
+  uint8_t port = g_port;
+  APP_Reset();
+  CancelFollowUp();
+  g_port = port;
+  SendMessage(token, COMMAND_RESET_DEVICE, RC_OK, NULL, 0u);
+}
+
 static void SetMode(uint8_t token,
                     const uint8_t* payload,
                     unsigned int length) {
@@ -67,7 +236,12 @@ static void SetMode(uint8_t token,
     SendMessage(token, COMMAND_SET_MODE, RC_BAD_PARAM, NULL, 0u);
     return;
   }
-  if (!Transceiver_SetMode(payload[0], token)) {
+  // The responder only runs on the first port, see APP_Tasks().
+  if (payload[0] == T_MODE_RESPONDER && g_port != 0u) {
+    SendMessage(token, COMMAND_SET_MODE, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+  if (!Transceiver_SetMode(g_port, payload[0], token)) {
     SendMessage(token, COMMAND_SET_MODE, RC_INVALID_MODE, NULL, 0u);
     return;
   }
@@ -83,6 +257,7 @@ static void GetHardwareInfo(uint8_t token, unsigned int length) {
     uint16_t model;
     uint8_t uid[UID_LENGTH];
     uint8_t mac[MAC_ADDRESS_SIZE];
+    uint8_t port_count;
   } __attribute__((packed)) HardwareResponse;
 
   HardwareResponse response;
@@ -93,6 +268,7 @@ static void GetHardwareInfo(uint8_t token, unsigned int length) {
   for (; i < MAC_ADDRESS_SIZE; i++) {
     response.mac[i] = PLIB_ETH_StationAddressGet(ETH_ID_0, i + 1);
   }
+  response.port_count = TRANSCEIVER_PORT_COUNT;
 
   IOVec iovec;
   iovec.base = &response;
@@ -106,7 +282,7 @@ static void RunSelfTest(uint8_t token, unsigned int length) {
     return;
   }
 
-  if (!Transceiver_QueueSelfTest(token)) {
+  if (!Transceiver_QueueSelfTest(g_port, token)) {
     SendMessage(token, COMMAND_RUN_SELF_TEST, RC_TEST_FAILED, NULL, 0u);
   }
 }
@@ -121,7 +297,7 @@ static void SetBreakTime(uint8_t token,
   }
 
   break_time = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetBreakTime(break_time);
+  bool ok = Transceiver_SetBreakTime(g_port, break_time);
   SendMessage(token, COMMAND_SET_BREAK_TIME, ok ? RC_OK : RC_BAD_PARAM,
               NULL, 0);
 }
@@ -132,7 +308,7 @@ static void ReturnBreakTime(uint8_t token, unsigned int length) {
     return;
   }
 
-  uint16_t break_time = Transceiver_GetBreakTime();
+  uint16_t break_time = Transceiver_GetBreakTime(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &break_time;
   iovec.length = sizeof(break_time);
@@ -149,7 +325,7 @@ static void SetMarkTime(uint8_t token,
   }
 
   mark_time = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetMarkTime(mark_time);
+  bool ok = Transceiver_SetMarkTime(g_port, mark_time);
   SendMessage(token, COMMAND_SET_MARK_TIME, ok ? RC_OK : RC_BAD_PARAM, NULL,
               0u);
 }
@@ -160,13 +336,42 @@ static void ReturnMarkTime(uint8_t token, unsigned int length) {
     return;
   }
 
-  uint16_t mab_time = Transceiver_GetMarkTime();
+  uint16_t mab_time = Transceiver_GetMarkTime(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &mab_time;
   iovec.length = sizeof(mab_time);
   SendMessage(token, COMMAND_GET_MARK_TIME, RC_OK, &iovec, 1u);
 }
 
+static void SetDMXRefreshInterval(uint8_t token,
+                                  const uint8_t* payload,
+                                  unsigned int length) {
+  uint16_t interval;
+  if (length != sizeof(interval)) {
+    SendMessage(token, COMMAND_SET_DMX_REFRESH_INTERVAL, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+
+  interval = JoinUInt16(payload[1], payload[0]);
+  bool ok = Transceiver_SetDMXRefreshInterval(g_port, interval);
+  SendMessage(token, COMMAND_SET_DMX_REFRESH_INTERVAL,
+              ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
+}
+
+static void ReturnDMXRefreshInterval(uint8_t token, unsigned int length) {
+  if (length) {
+    SendMessage(token, COMMAND_GET_DMX_REFRESH_INTERVAL, RC_BAD_PARAM,
+                NULL, 0u);
+    return;
+  }
+  uint16_t interval = Transceiver_GetDMXRefreshInterval(g_port);
+  IOVec iovec;
+  iovec.base = (uint8_t*) &interval;
+  iovec.length = sizeof(interval);
+  SendMessage(token, COMMAND_GET_DMX_REFRESH_INTERVAL, RC_OK, &iovec, 1u);
+}
+
 static void SetRDMBroadcastTimeout(uint8_t token,
                                    const uint8_t* payload,
                                    unsigned int length) {
@@ -178,7 +383,7 @@ static void SetRDMBroadcastTimeout(uint8_t token,
   }
 
   time = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetRDMBroadcastTimeout(time);
+  bool ok = Transceiver_SetRDMBroadcastTimeout(g_port, time);
   SendMessage(token, COMMAND_SET_RDM_BROADCAST_TIMEOUT,
               ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
 }
@@ -189,7 +394,7 @@ static void ReturnRDMBroadcastTimeout(uint8_t token, unsigned int length) {
                 0u);
     return;
   }
-  uint16_t time = Transceiver_GetRDMBroadcastTimeout();
+  uint16_t time = Transceiver_GetRDMBroadcastTimeout(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &time;
   iovec.length = sizeof(time);
@@ -208,7 +413,7 @@ static void SetRDMResponseTimeout(
   }
 
   timeout = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetRDMResponseTimeout(timeout);
+  bool ok = Transceiver_SetRDMResponseTimeout(g_port, timeout);
   SendMessage(token, COMMAND_SET_RDM_RESPONSE_TIMEOUT,
               ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
 }
@@ -221,7 +426,7 @@ static void ReturnRDMResponseTimeout(
                 0u);
     return;
   }
-  uint16_t timeout = Transceiver_GetRDMResponseTimeout();
+  uint16_t timeout = Transceiver_GetRDMResponseTimeout(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &timeout;
   iovec.length = sizeof(timeout);
@@ -239,7 +444,7 @@ static void SetRDMDUBResponseLimit(uint8_t token,
   }
 
   limit = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetRDMDUBResponseLimit(limit);
+  bool ok = Transceiver_SetRDMDUBResponseLimit(g_port, limit);
   SendMessage(token, COMMAND_SET_RDM_DUB_RESPONSE_LIMIT,
               ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
 }
@@ -250,7 +455,7 @@ static void ReturnRDMDUBResponseLimit(uint8_t token, unsigned int length) {
                 NULL, 0u);
     return;
   }
-  uint16_t limit = Transceiver_GetRDMDUBResponseLimit();
+  uint16_t limit = Transceiver_GetRDMDUBResponseLimit(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &limit;
   iovec.length = sizeof(limit);
@@ -267,7 +472,7 @@ static void SetRDMResponderDelay(uint8_t token,
   }
 
   delay = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetRDMResponderDelay(delay);
+  bool ok = Transceiver_SetRDMResponderDelay(g_port, delay);
   SendMessage(token, COMMAND_SET_RDM_RESPONDER_DELAY,
               ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
 }
@@ -278,7 +483,7 @@ static void ReturnRDMResponderDelay(uint8_t token, unsigned int length) {
                 NULL, 0u);
     return;
   }
-  uint16_t delay = Transceiver_GetRDMResponderDelay();
+  uint16_t delay = Transceiver_GetRDMResponderDelay(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &delay;
   iovec.length = sizeof(delay);
@@ -296,7 +501,7 @@ static void SetRDMResponderJitter(uint8_t token,
   }
 
   jitter = JoinUInt16(payload[1], payload[0]);
-  bool ok = Transceiver_SetRDMResponderJitter(jitter);
+  bool ok = Transceiver_SetRDMResponderJitter(g_port, jitter);
   SendMessage(token, COMMAND_SET_RDM_RESPONDER_JITTER,
               ok ? RC_OK : RC_BAD_PARAM, NULL, 0u);
 }
@@ -307,37 +512,483 @@ static void ReturnRDMResponderJitter(uint8_t token, unsigned int length) {
                 NULL, 0u);
     return;
   }
-  uint16_t jitter = Transceiver_GetRDMResponderJitter();
+  uint16_t jitter = Transceiver_GetRDMResponderJitter(g_port);
   IOVec iovec;
   iovec.base = (uint8_t*) &jitter;
   iovec.length = sizeof(jitter);
   SendMessage(token, COMMAND_GET_RDM_RESPONDER_JITTER, RC_OK, &iovec, 1u);
 }
 
+static void SetAckTimerFollowUp(uint8_t token, const uint8_t* payload,
+                                unsigned int length) {
+  if (length != sizeof(uint8_t) || payload[0] > 1u) {
+    SendMessage(token, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+
+  // A follow up that's already in progress is allowed to complete.
+  g_follow_up.enabled = payload[0];
+  SendMessage(token, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_OK, NULL, 0u);
+}
+
+static void ReturnAckTimerFollowUp(uint8_t token, unsigned int length) {
+  if (length) {
+    SendMessage(token, COMMAND_GET_ACK_TIMER_FOLLOW_UP, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+  uint8_t enabled = g_follow_up.enabled;
+  IOVec iovec;
+  iovec.base = &enabled;
+  iovec.length = sizeof(enabled);
+  SendMessage(token, COMMAND_GET_ACK_TIMER_FOLLOW_UP, RC_OK, &iovec, 1u);
+}
+
+static void ReturnRDMTurnaroundStats(uint8_t token, unsigned int length) {
+  if (length) {
+    SendMessage(token, COMMAND_GET_RDM_TURNAROUND_STATS, RC_BAD_PARAM,
+                NULL, 0u);
+    return;
+  }
+
+  typedef struct {
+    uint32_t count;
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+    uint32_t histogram[TRANSCEIVER_TURNAROUND_BUCKETS];
+  } __attribute__((packed)) TurnaroundResponse;
+
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(g_port, &stats);
+
+  TurnaroundResponse response;
+  response.count = stats.count;
+  response.min = stats.min;
+  response.max = stats.max;
+  response.mean = stats.mean;
+  memcpy(response.histogram, stats.histogram, sizeof(response.histogram));
+
+  IOVec iovec;
+  iovec.base = &response;
+  iovec.length = sizeof(TurnaroundResponse);
+  SendMessage(token, COMMAND_GET_RDM_TURNAROUND_STATS, RC_OK, &iovec, 1u);
+}
+
+static void ReturnLineStats(uint8_t token, unsigned int length) {
+  if (length) {
+    SendMessage(token, COMMAND_GET_LINE_STATS, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  typedef struct {
+    uint32_t dmx_frames;
+    uint32_t dmx_time;
+    uint32_t rdm_frames;
+    uint32_t rdm_time;
+  } __attribute__((packed)) LineStatsResponse;
+
+  TransceiverLineStats stats;
+  Transceiver_GetLineStats(g_port, &stats);
+
+  LineStatsResponse response;
+  response.dmx_frames = stats.dmx_frames;
+  response.dmx_time = stats.dmx_time;
+  response.rdm_frames = stats.rdm_frames;
+  response.rdm_time = stats.rdm_time;
+
+  IOVec iovec;
+  iovec.base = &response;
+  iovec.length = sizeof(LineStatsResponse);
+  SendMessage(token, COMMAND_GET_LINE_STATS, RC_OK, &iovec, 1u);
+}
+
+/*
+ * @brief Get the number of UIDs discovery found on the current port.
+ *
+ * Discovery only keeps the UIDs for the port it last ran on.
+ */
+static uint16_t DiscoveredUIDCount() {
+  return g_port == Discovery_GetPort() ? Discovery_UIDCount() : 0u;
+}
+
+/*
+ * @brief Send the UIDs found by discovery, starting from offset.
+ */
+static void SendDiscoveredUIDs(uint8_t token, Command command, uint8_t rc,
+                               uint16_t offset) {
+  uint16_t uid_count = DiscoveredUIDCount();
+  unsigned int count = uid_count - offset;
+  if (count > MAX_UIDS_PER_RESPONSE) {
+    count = MAX_UIDS_PER_RESPONSE;
+  }
+
+  IOVec iovec[2];
+  iovec[0].base = &uid_count;
+  iovec[0].length = sizeof(uid_count);
+  iovec[1].base = Discovery_GetUIDs() + offset * UID_LENGTH;
+  iovec[1].length = count * UID_LENGTH;
+  SendMessage(token, command, rc, iovec, 2u);
+}
+
+/*
+ * @brief Get the number of UIDs the last discovery on the current port added
+ * or removed.
+ */
+static uint16_t DiscoveryChangeCount() {
+  return g_port == Discovery_GetPort() ?
+      Discovery_AddedCount() + Discovery_RemovedCount() : 0u;
+}
+
+/*
+ * @brief Send the changes found by discovery, starting from offset.
+ *
+ * The added UIDs are immediately followed by the removed UIDs, so the offset
+ * indexes both lists.
+ */
+static void SendDiscoveryChanges(uint8_t token, Command command, uint8_t rc,
+                                 uint16_t offset) {
+  uint16_t counts[3] = {0u, 0u, 0u};
+  if (g_port == Discovery_GetPort()) {
+    counts[0] = Discovery_UIDCount();
+    counts[1] = Discovery_AddedCount();
+    counts[2] = Discovery_RemovedCount();
+  }
+  unsigned int changes = counts[1] + counts[2] - offset;
+  if (changes > MAX_CHANGES_PER_RESPONSE) {
+    changes = MAX_CHANGES_PER_RESPONSE;
+  }
+
+  IOVec iovec[2];
+  iovec[0].base = counts;
+  iovec[0].length = sizeof(counts);
+  iovec[1].base = Discovery_GetAddedUIDs() + offset * UID_LENGTH;
+  iovec[1].length = changes * UID_LENGTH;
+  SendMessage(token, command, rc, iovec, 2u);
+}
+
+/*
+ * @brief Decode the response to a DUB, and send the result to the host.
+ */
+static void SendDecodedDUB(const TransceiverEvent *event) {
+  ReturnCode rc = RC_OK;
+  uint8_t response[1u + UID_LENGTH];
+  unsigned int size = 0u;
+
+  switch (event->result) {
+    case T_RESULT_RX_TIMEOUT:
+      response[0] = DUB_NO_RESPONSE;
+      size = 1u;
+      break;
+    case T_RESULT_OK:
+      // The line was pulled low but no bytes were received, which is usually
+      // a collision.
+    case T_RESULT_RX_DATA:
+    case T_RESULT_RX_INVALID:
+      if (event->data &&
+          RDMUtil_DecodeDUBResponse(event->data, event->length,
+                                    response + 1u)) {
+        response[0] = DUB_VALID_UID;
+        size = sizeof(response);
+      } else {
+        response[0] = DUB_COLLISION;
+        size = 1u;
+      }
+      break;
+    case T_RESULT_TX_ERROR:
+      rc = RC_TX_ERROR;
+      break;
+    case T_RESULT_CANCELLED:
+      rc = RC_CANCELLED;
+      break;
+    default:
+      rc = RC_UNKNOWN;
+  }
+
+  IOVec iovec;
+  iovec.base = response;
+  iovec.length = size;
+  SendMessage(event->token, COMMAND_RDM_DECODED_DUB_REQUEST, rc, &iovec, 1u);
+}
+
+static void ReturnDiscoveredUIDs(uint8_t token,
+                                 const uint8_t* payload,
+                                 unsigned int length) {
+  uint16_t offset;
+  if (length != sizeof(offset)) {
+    SendMessage(token, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+
+  offset = JoinUInt16(payload[1], payload[0]);
+  if (offset > DiscoveredUIDCount()) {
+    SendMessage(token, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+  SendDiscoveredUIDs(token, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_OK, offset);
+}
+
+static void ReturnDiscoveryChanges(uint8_t token,
+                                   const uint8_t* payload,
+                                   unsigned int length) {
+  uint16_t offset;
+  if (length != sizeof(offset)) {
+    SendMessage(token, COMMAND_RDM_GET_DISCOVERY_CHANGES, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+
+  offset = JoinUInt16(payload[1], payload[0]);
+  if (offset > DiscoveryChangeCount()) {
+    SendMessage(token, COMMAND_RDM_GET_DISCOVERY_CHANGES, RC_BAD_PARAM, NULL,
+                0u);
+    return;
+  }
+  SendDiscoveryChanges(token, COMMAND_RDM_GET_DISCOVERY_CHANGES, RC_OK,
+                       offset);
+}
+
 static bool CheckForTXMode(const Message *message) {
-  if (Transceiver_GetMode() == T_MODE_CONTROLLER) {
+  if (Transceiver_GetMode(g_port) == T_MODE_CONTROLLER) {
     return true;
   }
   SendMessage(message->token, message->command, RC_INVALID_MODE, NULL, 0u);
   return false;
 }
 
+static void StartDiscovery(const Message *message) {
+  DiscoveryMode mode = DISCOVERY_FULL;
+  if (message->length > 1u ||
+      (message->length == 1u && message->payload[0] > DISCOVERY_INCREMENTAL)) {
+    SendMessage(message->token, message->command, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+  if (message->length == 1u) {
+    mode = (DiscoveryMode) message->payload[0];
+  }
+
+  if (CheckForTXMode(message) &&
+      !Discovery_Start(message->token, g_port, mode)) {
+    SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
+  }
+}
+
+static void QueueDecodedDUB(const Message *message) {
+  if (!CheckForTXMode(message)) {
+    return;
+  }
+
+  if (Transceiver_QueueRDMDUB(g_port, message->token, message->payload,
+                              message->length)) {
+    SetDecodedDUB(message->token, true);
+  } else {
+    SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
+  }
+}
+
+/*
+ * @brief Check if a command can be run as part of a batch.
+ *
+ * Only commands that respond immediately can be batched. Commands that respond
+ * once a transceiver operation completes, or that respond by some other path,
+ * are rejected.
+ */
+static bool IsBatchable(uint16_t command) {
+  switch (ShortLSB(command)) {
+    case COMMAND_ECHO:
+    case COMMAND_GET_HARDWARE_INFO:
+    case COMMAND_SET_BREAK_TIME:
+    case COMMAND_GET_BREAK_TIME:
+    case COMMAND_SET_MARK_TIME:
+    case COMMAND_GET_MARK_TIME:
+    case COMMAND_SET_DMX_REFRESH_INTERVAL:
+    case COMMAND_GET_DMX_REFRESH_INTERVAL:
+    case COMMAND_SET_RDM_BROADCAST_TIMEOUT:
+    case COMMAND_GET_RDM_BROADCAST_TIMEOUT:
+    case COMMAND_SET_RDM_RESPONSE_TIMEOUT:
+    case COMMAND_GET_RDM_RESPONSE_TIMEOUT:
+    case COMMAND_SET_RDM_DUB_RESPONSE_LIMIT:
+    case COMMAND_GET_RDM_DUB_RESPONSE_LIMIT:
+    case COMMAND_SET_RDM_RESPONDER_DELAY:
+    case COMMAND_GET_RDM_RESPONDER_DELAY:
+    case COMMAND_SET_RDM_RESPONDER_JITTER:
+    case COMMAND_GET_RDM_RESPONDER_JITTER:
+    case COMMAND_GET_RDM_TURNAROUND_STATS:
+    case COMMAND_GET_LINE_STATS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*
+ * @brief Check the framing of the sub-commands in a batch request.
+ */
+static bool CheckBatchFraming(const uint8_t *payload, unsigned int length) {
+  const uint8_t *ptr = payload;
+  const uint8_t *end = payload + length;
+  while (ptr != end) {
+    if (end - ptr < BATCH_REQUEST_HEADER_SIZE) {
+      return false;
+    }
+    uint16_t sub_command_length = JoinUInt16(ptr[3], ptr[2]);
+    if (end - ptr - BATCH_REQUEST_HEADER_SIZE < sub_command_length) {
+      return false;
+    }
+    ptr += BATCH_REQUEST_HEADER_SIZE + sub_command_length;
+  }
+  return true;
+}
+
+static void RunBatch(const Message *message) {
+  // Check the framing of all sub-commands before running any of them.
+  if (!CheckBatchFraming(message->payload, message->length)) {
+    SendMessage(message->token, COMMAND_BATCH, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  g_batch.overflow = false;
+  g_batch.size = 0u;
+  g_batch_response = &g_batch;
+  // Each sub-command may be for a different port.
+  uint8_t port = g_port;
+
+  Message sub_command;
+  sub_command.token = message->token;
+  const uint8_t *ptr = message->payload;
+  const uint8_t *end = message->payload + message->length;
+  while (ptr != end && !g_batch.overflow) {
+    sub_command.command = JoinUInt16(ptr[1], ptr[0]);
+    sub_command.length = JoinUInt16(ptr[3], ptr[2]);
+    sub_command.payload = ptr + BATCH_REQUEST_HEADER_SIZE;
+    if (IsBatchable(sub_command.command)) {
+      MessageHandler_HandleMessage(&sub_command);
+    } else {
+      g_port = ShortMSB(sub_command.command);
+      SendMessage(sub_command.token, sub_command.command, RC_BAD_PARAM, NULL,
+                  0u);
+    }
+    ptr += BATCH_REQUEST_HEADER_SIZE + sub_command.length;
+  }
+
+  g_batch_response = NULL;
+  g_port = port;
+
+  IOVec iovec;
+  iovec.base = g_batch.data;
+  iovec.length = g_batch.size;
+  SendMessage(message->token, COMMAND_BATCH,
+              g_batch.overflow ? RC_BUFFER_FULL : RC_OK, &iovec, 1u);
+}
+
+static void CompleteRDMBatch(ReturnCode rc) {
+  g_rdm_batch.active = false;
+
+  IOVec iovec;
+  iovec.base = g_rdm_batch.response.data;
+  iovec.length = g_rdm_batch.response.size;
+  SendMessage(g_rdm_batch.token, COMMAND_RDM_BATCH, rc, &iovec, 1u);
+}
+
+/*
+ * @brief Queue the next RDM request in the batch, or send the batch response
+ *   if there are no requests left.
+ */
+static void RunNextRDMRequest() {
+  const uint8_t *end = g_rdm_batch.request + g_rdm_batch.length;
+  while (!g_rdm_batch.response.overflow) {
+    const uint8_t *ptr = g_rdm_batch.request + g_rdm_batch.offset;
+    if (ptr == end) {
+      CompleteRDMBatch(RC_OK);
+      return;
+    }
+
+    // The requests are sent on the port of the batch, so the port of each
+    // sub-command is ignored.
+    uint16_t command = ptr[0];
+    uint16_t length = JoinUInt16(ptr[3], ptr[2]);
+    g_rdm_batch.offset += BATCH_REQUEST_HEADER_SIZE + length;
+
+    if (command != COMMAND_RDM_REQUEST &&
+        command != COMMAND_RDM_BROADCAST_REQUEST) {
+      AppendToBatch(&g_rdm_batch.response, command, RC_BAD_PARAM, NULL, 0u);
+      continue;
+    }
+
+    if (Transceiver_QueueRDMRequest(g_rdm_batch.port, RDM_BATCH_TOKEN,
+                                    ptr + BATCH_REQUEST_HEADER_SIZE, length,
+                                    command == COMMAND_RDM_BROADCAST_REQUEST)) {
+      return;
+    }
+    // The remaining requests aren't run.
+    AppendToBatch(&g_rdm_batch.response, command, RC_BUFFER_FULL, NULL, 0u);
+    CompleteRDMBatch(RC_BUFFER_FULL);
+    return;
+  }
+  CompleteRDMBatch(RC_BUFFER_FULL);
+}
+
+static void StartRDMBatch(const Message *message) {
+  if (!CheckBatchFraming(message->payload, message->length)) {
+    SendMessage(message->token, COMMAND_RDM_BATCH, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  if (!CheckForTXMode(message)) {
+    return;
+  }
+
+  if (g_rdm_batch.active) {
+    SendMessage(message->token, COMMAND_RDM_BATCH, RC_BUFFER_FULL, NULL, 0u);
+    return;
+  }
+
+  // The message is invalidated once we return, so take a copy.
+  g_rdm_batch.active = true;
+  g_rdm_batch.token = message->token;
+  g_rdm_batch.port = g_port;
+  g_rdm_batch.offset = 0u;
+  g_rdm_batch.length = message->length;
+  memcpy(g_rdm_batch.request, message->payload, message->length);
+  g_rdm_batch.response.overflow = false;
+  g_rdm_batch.response.size = 0u;
+  RunNextRDMRequest();
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void MessageHandler_Initialize(TransportTXFunction tx_cb) {
 #ifndef PIPELINE_TRANSPORT_TX
   g_message_tx_cb = tx_cb;
 #endif
+  g_batch.overflow = false;
+  g_batch.size = 0u;
+  g_batch_response = NULL;
+  g_rdm_batch.active = false;
+  g_port = 0u;
+  memset(g_decoded_dub_tokens, 0, sizeof(g_decoded_dub_tokens));
+  g_follow_up.enabled = false;
+  g_follow_up.state = FOLLOW_UP_IDLE;
+  g_follow_up.attempts = 0u;
 }
 
 void MessageHandler_HandleMessage(const Message *message) {
-  switch (message->command) {
+  g_port = ShortMSB(message->command);
+  if (g_port >= TRANSCEIVER_PORT_COUNT) {
+    SendMessage(message->token, message->command, RC_BAD_PARAM, NULL, 0u);
+    return;
+  }
+
+  switch (ShortLSB(message->command)) {
     case COMMAND_ECHO:
       Echo(message);
       break;
     case TX_DMX:
       if (CheckForTXMode(message) &&
-          !Transceiver_QueueDMX(message->token, message->payload,
+          !Transceiver_QueueDMX(g_port, message->token, message->payload,
                                 message->length)) {
         SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
       }
@@ -346,8 +997,7 @@ void MessageHandler_HandleMessage(const Message *message) {
       Flags_SendResponse(message->token);
       break;
     case COMMAND_RESET_DEVICE:
-      APP_Reset();
-      SendMessage(message->token, message->command, RC_OK, NULL, 0u);
+      ResetDevice(message->token);
       break;
     case COMMAND_SET_MODE:
       SetMode(message->token, message->payload, message->length);
@@ -360,15 +1010,19 @@ void MessageHandler_HandleMessage(const Message *message) {
       break;
     case COMMAND_RDM_DUB_REQUEST:
       if (CheckForTXMode(message) &&
-          !Transceiver_QueueRDMDUB(message->token, message->payload,
+          !Transceiver_QueueRDMDUB(g_port, message->token, message->payload,
                                    message->length)) {
         SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
       }
       break;
+    case COMMAND_RDM_DECODED_DUB_REQUEST:
+      QueueDecodedDUB(message);
+      break;
     case COMMAND_RDM_REQUEST:
       if (CheckForTXMode(message) &&
-          !Transceiver_QueueRDMRequest(message->token, message->payload,
-                                       message->length, false)) {
+          !Transceiver_QueueRDMRequest(g_port, message->token,
+                                       message->payload, message->length,
+                                       false)) {
         SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
       }
       break;
@@ -384,6 +1038,12 @@ void MessageHandler_HandleMessage(const Message *message) {
     case COMMAND_GET_MARK_TIME:
       ReturnMarkTime(message->token, message->length);
       break;
+    case COMMAND_SET_DMX_REFRESH_INTERVAL:
+      SetDMXRefreshInterval(message->token, message->payload, message->length);
+      break;
+    case COMMAND_GET_DMX_REFRESH_INTERVAL:
+      ReturnDMXRefreshInterval(message->token, message->length);
+      break;
     case COMMAND_SET_RDM_BROADCAST_TIMEOUT:
       SetRDMBroadcastTimeout(message->token, message->payload, message->length);
       break;
@@ -414,14 +1074,43 @@ void MessageHandler_HandleMessage(const Message *message) {
     case COMMAND_GET_RDM_RESPONDER_JITTER:
       ReturnRDMResponderJitter(message->token, message->length);
       break;
+    case COMMAND_SET_ACK_TIMER_FOLLOW_UP:
+      SetAckTimerFollowUp(message->token, message->payload, message->length);
+      break;
+    case COMMAND_GET_ACK_TIMER_FOLLOW_UP:
+      ReturnAckTimerFollowUp(message->token, message->length);
+      break;
 
     case COMMAND_RDM_BROADCAST_REQUEST:
       if (CheckForTXMode(message) &&
-          !Transceiver_QueueRDMRequest(message->token, message->payload,
-                                       message->length, true)) {
+          !Transceiver_QueueRDMRequest(g_port, message->token,
+                                       message->payload, message->length,
+                                       true)) {
         SendMessage(message->token, message->command, RC_BUFFER_FULL, NULL, 0u);
       }
       break;
+    case COMMAND_RDM_DISCOVERY:
+      StartDiscovery(message);
+      break;
+    case COMMAND_RDM_GET_DISCOVERED_UIDS:
+      ReturnDiscoveredUIDs(message->token, message->payload, message->length);
+      break;
+    case COMMAND_RDM_GET_DISCOVERY_CHANGES:
+      ReturnDiscoveryChanges(message->token, message->payload,
+                             message->length);
+      break;
+    case COMMAND_BATCH:
+      RunBatch(message);
+      break;
+    case COMMAND_RDM_BATCH:
+      StartRDMBatch(message);
+      break;
+    case COMMAND_GET_RDM_TURNAROUND_STATS:
+      ReturnRDMTurnaroundStats(message->token, message->length);
+      break;
+    case COMMAND_GET_LINE_STATS:
+      ReturnLineStats(message->token, message->length);
+      break;
 
     default:
       // Just echo the command code back if we don't understand it.
@@ -429,7 +1118,10 @@ void MessageHandler_HandleMessage(const Message *message) {
   }
 }
 
-void MessageHandler_TransceiverEvent(const TransceiverEvent *event) {
+/*
+ * @brief Send the response for a transceiver event.
+ */
+static void SendTransceiverResponse(const TransceiverEvent *event) {
   uint8_t vector_size = 0u;
   IOVec iovec[2];
 
@@ -501,3 +1193,176 @@ void MessageHandler_TransceiverEvent(const TransceiverEvent *event) {
   SysLog_Print(SYSLOG_INFO, "Token %d, op %d, result: %d",
                event->token, event->op, event->result);
 }
+
+/*
+ * @brief Check if a transceiver event is an ACK_TIMER response.
+ * @param event The event to check.
+ * @param delay The delay from the ACK_TIMER, in 10ths of a millisecond.
+ */
+static bool IsAckTimer(const TransceiverEvent *event, uint32_t *delay) {
+  if (event->op != T_OP_RDM_WITH_RESPONSE ||
+      event->result != T_RESULT_RX_DATA ||
+      !RDMUtil_VerifyChecksum(event->data, event->length)) {
+    return false;
+  }
+
+  // For responses, the port_id field holds the response type.
+  const RDMHeader *header = (const RDMHeader*) event->data;
+  if (header->start_code != RDM_START_CODE ||
+      header->sub_start_code != SUB_START_CODE ||
+      (header->command_class != GET_COMMAND_RESPONSE &&
+       header->command_class != SET_COMMAND_RESPONSE) ||
+      header->port_id != ACK_TIMER ||
+      header->param_data_length != sizeof(uint16_t)) {
+    return false;
+  }
+
+  // The ACK_TIMER delay is in 100ms units.
+  const uint8_t *param_data = event->data + sizeof(RDMHeader);
+  *delay = JoinUInt16(param_data[0], param_data[1]) * 1000u;
+  return true;
+}
+
+/*
+ * @brief Build the GET QUEUED_MESSAGE to collect the response for an
+ *   ACK_TIMER.
+ */
+static void BuildQueuedMessageRequest(const RDMHeader *ack_timer) {
+  RDMHeader *header = (RDMHeader*) g_follow_up.frame;
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = sizeof(RDMHeader) + 1u;
+  memcpy(header->dest_uid, ack_timer->src_uid, UID_LENGTH);
+  memcpy(header->src_uid, ack_timer->dest_uid, UID_LENGTH);
+  header->transaction_number = ack_timer->transaction_number + 1u;
+  header->port_id = 1u;
+  header->message_count = 0u;
+  header->sub_device = htons(SUBDEVICE_ROOT);
+  header->command_class = GET_COMMAND;
+  header->param_id = htons(PID_QUEUED_MESSAGE);
+  header->param_data_length = 1u;
+  g_follow_up.frame[sizeof(RDMHeader)] = STATUS_ERROR;
+  RDMUtil_AppendChecksum(g_follow_up.frame);
+}
+
+/*
+ * @brief Schedule a GET QUEUED_MESSAGE if the event is an ACK_TIMER.
+ * @returns true if the follow up was scheduled, false if the event should be
+ *   returned to the host.
+ */
+static bool FollowUpAckTimer(const TransceiverEvent *event) {
+  bool is_follow_up = (g_follow_up.state == FOLLOW_UP_SENT &&
+                       event->token == g_follow_up.token &&
+                       event->port == g_follow_up.port);
+  if (is_follow_up) {
+    g_follow_up.state = FOLLOW_UP_IDLE;
+  }
+
+  uint32_t delay;
+  if (!g_follow_up.enabled || g_follow_up.state != FOLLOW_UP_IDLE ||
+      event->token < 0 || event->token > UINT8_MAX ||
+      !IsAckTimer(event, &delay)) {
+    return false;
+  }
+
+  if (!is_follow_up) {
+    g_follow_up.attempts = 0u;
+  } else if (g_follow_up.attempts == MAX_ACK_TIMER_FOLLOW_UPS) {
+    return false;
+  }
+
+  BuildQueuedMessageRequest((const RDMHeader*) event->data);
+  g_follow_up.state = FOLLOW_UP_WAITING;
+  g_follow_up.token = event->token;
+  g_follow_up.port = event->port;
+  g_follow_up.start = CoarseTimer_GetTime();
+  g_follow_up.delay = delay;
+  return true;
+}
+
+static void RDMBatchEvent(const TransceiverEvent *event) {
+  g_batch_response = &g_rdm_batch.response;
+  SendTransceiverResponse(event);
+  g_batch_response = NULL;
+
+  if (event->result == T_RESULT_CANCELLED) {
+    CompleteRDMBatch(RC_CANCELLED);
+  } else {
+    RunNextRDMRequest();
+  }
+}
+
+void MessageHandler_TransceiverEvent(const TransceiverEvent *event) {
+  if (Discovery_TransceiverEvent(event)) {
+    return;
+  }
+
+  g_port = event->port;
+  if (event->token == RDM_BATCH_TOKEN && g_rdm_batch.active &&
+      event->port == g_rdm_batch.port) {
+    RDMBatchEvent(event);
+    return;
+  }
+
+  if (event->op == T_OP_RDM_DUB && IsDecodedDUB(event->token)) {
+    SetDecodedDUB(event->token, false);
+    SendDecodedDUB(event);
+    return;
+  }
+
+  if (FollowUpAckTimer(event)) {
+    return;
+  }
+
+  SendTransceiverResponse(event);
+}
+
+void MessageHandler_Tasks() {
+  if (g_follow_up.state != FOLLOW_UP_WAITING ||
+      !CoarseTimer_HasElapsed(g_follow_up.start, g_follow_up.delay)) {
+    return;
+  }
+
+  g_port = g_follow_up.port;
+  if (Transceiver_GetMode(g_port) != T_MODE_CONTROLLER) {
+    g_follow_up.state = FOLLOW_UP_IDLE;
+    SendMessage(g_follow_up.token, COMMAND_RDM_REQUEST, RC_CANCELLED, NULL,
+                0u);
+    return;
+  }
+
+  // The frame includes the start code, which the transceiver adds.
+  if (Transceiver_QueueRDMRequest(g_port, g_follow_up.token,
+                                  g_follow_up.frame + 1u,
+                                  QUEUED_MESSAGE_REQUEST_SIZE - 1u, false)) {
+    g_follow_up.state = FOLLOW_UP_SENT;
+    g_follow_up.attempts++;
+  } else {
+    g_follow_up.state = FOLLOW_UP_IDLE;
+    SendMessage(g_follow_up.token, COMMAND_RDM_REQUEST, RC_BUFFER_FULL, NULL,
+                0u);
+  }
+}
+
+void MessageHandler_DiscoveryComplete(int16_t token, DiscoveryResult result) {
+  ReturnCode rc;
+  switch (result) {
+    case DISCOVERY_OK:
+      rc = RC_OK;
+      break;
+    case DISCOVERY_TABLE_FULL:
+      rc = RC_BUFFER_FULL;
+      break;
+    case DISCOVERY_TX_ERROR:
+      rc = RC_TX_ERROR;
+      break;
+    case DISCOVERY_CANCELLED:
+      rc = RC_CANCELLED;
+      break;
+    default:
+      rc = RC_UNKNOWN;
+  }
+
+  g_port = Discovery_GetPort();
+  SendDiscoveryChanges(token, COMMAND_RDM_DISCOVERY, rc, 0u);
+}
@@ -30,6 +30,7 @@
 #ifndef FIRMWARE_SRC_MESSAGE_HANDLER_H_
 #define FIRMWARE_SRC_MESSAGE_HANDLER_H_
 
+#include "discovery.h"
 #include "stream_decoder.h"
 #include "transceiver.h"
 #include "transport.h"
@@ -51,9 +52,20 @@ void MessageHandler_Initialize(TransportTXFunction tx_cb);
  * @brief Handle messages from the Host System
  * @param message The message to handle, ownership is not transferred.
  *   Invalidated once the call completes.
+ *
+ * The low byte of the command is the Command, the high byte is the index of
+ * the transceiver port the message is for. Responses carry the same port.
  */
 void MessageHandler_HandleMessage(const Message* message);
 
+/**
+ * @brief Perform the periodic tasks.
+ *
+ * This sends the GET QUEUED_MESSAGE requests that follow an ACK_TIMER, once
+ * the delay has passed.
+ */
+void MessageHandler_Tasks();
+
 /**
  * @brief Handle notifications when the transceiver operations complete.
  * @param event the TransceiverEvent.
@@ -61,6 +73,14 @@ void MessageHandler_HandleMessage(const Message* message);
  */
 void MessageHandler_TransceiverEvent(const TransceiverEvent *event);
 
+/**
+ * @brief Handle the completion of RDM discovery.
+ * @param token The token of the RDM discovery request.
+ * @param result The outcome of the discovery run.
+ * @sa DiscoveryCompleteCallback.
+ */
+void MessageHandler_DiscoveryComplete(int16_t token, DiscoveryResult result);
+
 #ifdef __cplusplus
 }
 #endif
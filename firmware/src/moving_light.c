@@ -19,6 +19,7 @@
 #include "moving_light.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "coarse_timer.h"
 #include "constants.h"
@@ -33,6 +34,7 @@
 enum { SOFTWARE_VERSION = 0x00000000 };
 enum { PERSONALITY_COUNT = 2 };
 enum { NUMBER_OF_LANGUAGES = 2 };
+enum { MAX_DMX_FOOTPRINT = 6 };
 
 static const unsigned int LAMP_STRIKE_DELAY = 50000u;
 static const uint32_t ONE_SECOND = 10000;
@@ -75,6 +77,9 @@ typedef struct {
   uint8_t hour;
   uint8_t minute;
   uint8_t second;
+
+  // The last slot values received over DMX512, in personality order.
+  uint8_t slots[MAX_DMX_FOOTPRINT];
 } MovingLightModel;
 
 static const char *LANGUAGES[NUMBER_OF_LANGUAGES] = {
@@ -460,6 +465,7 @@ static void MovingLightModel_Activate() {
   g_responder->def = &RESPONDER_DEFINITION;
   RDMResponder_InitResponder();
   g_moving_light.clock_timer = CoarseTimer_GetTime();
+  memset(g_moving_light.slots, 0, MAX_DMX_FOOTPRINT);
 }
 
 static void MovingLightModel_Deactivate() {
@@ -525,13 +531,24 @@ static void MovingLightModel_Tasks() {
   }
 }
 
+static void MovingLightModel_HandleDMX(const uint8_t *slots,
+                                       unsigned int length,
+                                       bool changed) {
+  if (!changed) {
+    return;
+  }
+  memcpy(g_moving_light.slots, slots,
+         length < MAX_DMX_FOOTPRINT ? length : MAX_DMX_FOOTPRINT);
+}
+
 const ModelEntry MOVING_LIGHT_MODEL_ENTRY = {
   .model_id = MOVING_LIGHT_MODEL_ID,
   .activate_fn = MovingLightModel_Activate,
   .deactivate_fn = MovingLightModel_Deactivate,
   .ioctl_fn = RDMResponder_Ioctl,
   .request_fn = MovingLightModel_HandleRequest,
-  .tasks_fn = MovingLightModel_Tasks
+  .tasks_fn = MovingLightModel_Tasks,
+  .dmx_fn = MovingLightModel_HandleDMX
 };
 
 static const PIDDescriptor PID_DESCRIPTORS[] = {
@@ -269,6 +269,10 @@ void ProxyModel_Initialize() {
   RDMResponder_RestoreResponder();
 }
 
+const ResponderDefinition *ProxyModel_GetChildDefinition() {
+  return &CHILD_DEVICE_RESPONDER_DEFINITION;
+}
+
 static void ProxyModel_Activate() {
   g_responder->def = &ROOT_RESPONDER_DEFINITION;
   RDMResponder_InitResponder();
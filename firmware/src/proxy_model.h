@@ -42,6 +42,7 @@
 #define FIRMWARE_SRC_PROXY_MODEL_H_
 
 #include "rdm_model.h"
+#include "rdm_responder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +58,12 @@ extern const ModelEntry PROXY_MODEL_ENTRY;
  */
 void ProxyModel_Initialize();
 
+/**
+ * @brief Return the definition used by the child devices.
+ * @note This function should be used for testing only.
+ */
+const ResponderDefinition *ProxyModel_GetChildDefinition();
+
 #ifdef __cplusplus
 }
 #endif
@@ -379,7 +379,8 @@ typedef enum {
   PID_DEVICE_MODEL_LIST = 0x8003,
   // 8004 is reserved for MODEL_ID_DESCRIPTION if we ever implement it
   PID_PIXEL_TYPE = 0x8005,
-  PID_PIXEL_COUNT = 0x8006
+  PID_PIXEL_COUNT = 0x8006,
+  PID_RESPONDER_TURNAROUND = 0x8007
 } OpenLightingManufacturerPID;
 
 /**
@@ -29,6 +29,7 @@
 #include "rdm_frame.h"
 #include "rdm_util.h"
 #include "syslog.h"
+#include "transceiver.h"
 #include "utils.h"
 
 enum { MAX_RDM_MODELS = 6 };
@@ -39,6 +40,7 @@ typedef struct {
   uint16_t default_model;
   ModelEntry *active_model;
   RDMHandlerSendCallback send_callback;
+  bool dmx_changed;  // Set when the active model changes.
 } RDMHandlerState;
 
 static RDMHandlerState g_rdm_handler;
@@ -133,12 +135,71 @@ static int GetModelList(const RDMHeader *header) {
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
 
+/*
+ * @brief Handle GET / SET PID_RESPONDER_TURNAROUND.
+ *
+ * A GET returns the turnaround statistics, a SET resets them.
+ */
+static int GetSetTurnaroundStats(const RDMHeader *header) {
+  uint8_t our_uid[UID_LENGTH];
+  RDMHandler_GetUID(our_uid);
+
+  if (!RDMUtil_RequiresAction(our_uid, header->dest_uid)) {
+    return RDM_RESPONDER_NO_RESPONSE;
+  }
+
+  uint16_t sub_device = ntohs(header->sub_device);
+  // No subdevice support for now.
+  if (sub_device != SUBDEVICE_ROOT && sub_device != SUBDEVICE_ALL) {
+    return RDMResponder_BuildNack(header, NR_SUB_DEVICE_OUT_OF_RANGE);
+  } else if (sub_device == SUBDEVICE_ALL &&
+             header->command_class == GET_COMMAND) {
+    return RDMResponder_BuildNack(header, NR_SUB_DEVICE_OUT_OF_RANGE);
+  }
+
+  if (header->param_data_length) {
+    if (RDMUtil_UIDCompare(our_uid, header->dest_uid)) {
+      return RDM_RESPONDER_NO_RESPONSE;
+    }
+    return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
+  }
+
+  if (header->command_class == GET_COMMAND) {
+    if (RDMUtil_UIDCompare(our_uid, header->dest_uid)) {
+      return RDM_RESPONDER_NO_RESPONSE;
+    }
+
+    TransceiverTurnaroundStats stats;
+    Transceiver_GetTurnaroundStats(0u, &stats);
+
+    uint8_t *ptr = g_rdm_buffer + sizeof(RDMHeader);
+    ptr = PushUInt32(ptr, stats.count);
+    ptr = PushUInt16(ptr, stats.min);
+    ptr = PushUInt16(ptr, stats.max);
+    ptr = PushUInt16(ptr, stats.mean);
+    unsigned int i = 0u;
+    for (; i < TRANSCEIVER_TURNAROUND_BUCKETS; i++) {
+      ptr = PushUInt32(ptr, stats.histogram[i]);
+    }
+    return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
+  } else if (header->command_class == SET_COMMAND) {
+    Transceiver_ResetTurnaroundStats(0u);
+
+    if (RDMUtil_UIDCompare(our_uid, header->dest_uid)) {
+      return RDM_RESPONDER_NO_RESPONSE;
+    }
+    return RDMResponder_BuildSetAck(header);
+  }
+  return RDM_RESPONDER_NO_RESPONSE;
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void RDMHandler_Initialize(const RDMHandlerSettings *settings) {
   g_rdm_handler.default_model = settings->default_model;
   g_rdm_handler.active_model = NULL;
   g_rdm_handler.send_callback = settings->send_callback;
+  g_rdm_handler.dmx_changed = true;
 
   unsigned int i = 0u;
   for (; i < MAX_RDM_MODELS; i++) {
@@ -160,9 +221,11 @@ bool RDMHandler_AddModel(const ModelEntry *entry) {
       g_models[i].ioctl_fn = entry->ioctl_fn;
       g_models[i].request_fn = entry->request_fn;
       g_models[i].tasks_fn = entry->tasks_fn;
+      g_models[i].dmx_fn = entry->dmx_fn;
       if (entry->model_id == g_rdm_handler.default_model) {
         g_rdm_handler.active_model = &g_models[i];
         g_rdm_handler.active_model->activate_fn();
+        g_rdm_handler.dmx_changed = true;
       }
       return true;
     }
@@ -193,6 +256,7 @@ bool RDMHandler_SetActiveModel(uint16_t model_id) {
       }
       g_rdm_handler.active_model = &g_models[i];
       g_rdm_handler.active_model->activate_fn();
+      g_rdm_handler.dmx_changed = true;
       return true;
     }
   }
@@ -214,6 +278,8 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
     response_size = GetSetModelId(header, param_data);
   } else if (ntohs(header->param_id) == PID_DEVICE_MODEL_LIST) {
     response_size = GetModelList(header);
+  } else if (ntohs(header->param_id) == PID_RESPONDER_TURNAROUND) {
+    response_size = GetSetTurnaroundStats(header);
   } else {
     if (!g_rdm_handler.active_model) {
       return;
@@ -243,6 +309,34 @@ void RDMHandler_GetUID(uint8_t *uid) {
   }
 }
 
+bool RDMHandler_GetDMXWindow(DMXSlotWindow *window) {
+  if (g_rdm_handler.active_model == NULL ||
+      g_rdm_handler.active_model->dmx_fn == NULL) {
+    return false;
+  }
+  return g_rdm_handler.active_model->ioctl_fn(
+      IOCTL_GET_DMX_WINDOW, (uint8_t*) window, sizeof(DMXSlotWindow));
+}
+
+bool RDMHandler_GetDUBResponse(uint8_t *uid, uint8_t *response) {
+  if (g_rdm_handler.active_model == NULL) {
+    return false;
+  }
+  const ModelEntry *model = g_rdm_handler.active_model;
+  return model->ioctl_fn(IOCTL_GET_UID, uid, UID_LENGTH) &&
+         model->ioctl_fn(IOCTL_GET_DUB_RESPONSE, response,
+                         DUB_RESPONSE_LENGTH);
+}
+
+void RDMHandler_HandleDMX(const uint8_t *slots, unsigned int length,
+                          bool changed) {
+  if (g_rdm_handler.active_model && g_rdm_handler.active_model->dmx_fn) {
+    g_rdm_handler.active_model->dmx_fn(slots, length,
+                                       changed || g_rdm_handler.dmx_changed);
+    g_rdm_handler.dmx_changed = false;
+  }
+}
+
 void RDMHandler_Tasks() {
   if (g_rdm_handler.active_model) {
     g_rdm_handler.active_model->tasks_fn();
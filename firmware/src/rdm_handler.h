@@ -122,6 +122,39 @@ void RDMHandler_HandleRequest(const RDMHeader *header,
  */
 void RDMHandler_GetUID(uint8_t *uid);
 
+/**
+ * @brief Get the DMX slot window of the active model.
+ * @param[out] window The window to fill in.
+ * @returns true if the active model has a dmx_fn and a DMX slot window, false
+ *   otherwise.
+ */
+bool RDMHandler_GetDMXWindow(DMXSlotWindow *window);
+
+/**
+ * @brief Get the encoded DUB response of the active model.
+ * @param[out] uid A pointer to copy the UID to; should be at least UID_LENGTH.
+ * @param[out] response A pointer to copy the response to; should be at least
+ *   DUB_RESPONSE_LENGTH.
+ * @returns true if the active model would answer a DUB request that covers
+ *   the UID with the response, false if there is no active model, or it's
+ *   muted or doesn't support IOCTL_GET_DUB_RESPONSE.
+ */
+bool RDMHandler_GetDUBResponse(uint8_t *uid, uint8_t *response);
+
+/**
+ * @brief Deliver the DMX slots in the window to the active model.
+ * @param slots The slot data, starting at the window's start address.
+ * @param length The number of slots.
+ * @param changed false if the slots are the same as the previous call.
+ *
+ * The first call after the active model changes is always passed to the model
+ * as changed.
+ *
+ * @sa ModelEntry::dmx_fn.
+ */
+void RDMHandler_HandleDMX(const uint8_t *slots, unsigned int length,
+                          bool changed);
+
 /**
  * @brief Perform the periodic RDM Handler tasks.
  *
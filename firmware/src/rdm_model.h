@@ -106,8 +106,38 @@ typedef enum {
    * @returns Returns 1 on success or 0 if length didn't match UID_LENGTH.
    */
   IOCTL_GET_UID,
+
+  /**
+   * @brief Copies the model's DMX slot window into the data pointer.
+   * @param data, a pointer to a DMXSlotWindow.
+   * @param length should be set to sizeof(DMXSlotWindow).
+   * @returns Returns 1 if the model uses DMX slots, or 0 if it doesn't or
+   *   length didn't match.
+   */
+  IOCTL_GET_DMX_WINDOW,
+
+  /**
+   * @brief Copies the model's encoded DUB response into the data pointer.
+   * @param data, a memory location to copy the response to.
+   * @param length should be set to DUB_RESPONSE_LENGTH.
+   * @returns Returns 1 if the model will answer a DUB request that covers its
+   *   UID, or 0 if it's muted, doesn't support the fast path or length didn't
+   *   match.
+   *
+   * The response is handed to the transceiver, which answers matching DUB
+   * requests from the ISR.
+   */
+  IOCTL_GET_DUB_RESPONSE,
 } ModelIoctl;
 
+/**
+ * @brief The range of DMX512 slots used by a model.
+ */
+typedef struct {
+  uint16_t start_address;  //!< The first slot, from 1 to 512.
+  uint16_t footprint;  //!< The number of slots, at least 1.
+} DMXSlotWindow;
+
 /**
  * @brief The function table entry for a particular responder model.
  *
@@ -157,6 +187,22 @@ typedef struct {
    * This is called periodically by RDMHandler_Tasks().
    */
   void (*tasks_fn)();
+
+  /**
+   * @brief The function used to deliver DMX512 slot data.
+   * @param slots The slot data, starting at the model's start address.
+   * @param length The number of slots. This is less than the footprint if the
+   *   frame was shorter than the window.
+   * @param changed false if the slots are the same as the ones passed in the
+   *   previous call, in which case the model can skip updating its outputs.
+   *
+   * This is called at most once per DMX512 frame, with the window returned
+   * from IOCTL_GET_DMX_WINDOW at the start of the frame. The slot data is
+   * stable while the handler runs, but the receive buffer is reused once it
+   * returns, so copy any slots that are needed later. This may be NULL if the
+   * model doesn't use DMX512 data.
+   */
+  void (*dmx_fn)(const uint8_t *slots, unsigned int length, bool changed);
 } ModelEntry;
 
 #ifdef __cplusplus
@@ -146,6 +146,29 @@ static inline uint16_t GetControlField() {
          (g_responder->is_proxied_device ? MUTE_PROXY_FLAG : 0);
 }
 
+/*
+ * @brief Build the encoded DUB response for the current responder.
+ */
+static void BuildDUBResponse() {
+  uint8_t *response = g_responder->dub_response;
+  memset(response, FE_CONSTANT, 7);
+  response[7] = AA_CONSTANT;
+
+  uint16_t checksum = 0u;
+  unsigned int i;
+  for (i = 0u; i < UID_LENGTH; i++) {
+    response[8u + 2u * i] = g_responder->uid[i] | AA_CONSTANT;
+    response[9u + 2u * i] = g_responder->uid[i] | FIVE5_CONSTANT;
+    checksum += response[8u + 2u * i] + response[9u + 2u * i];
+  }
+
+  response[20] = ShortMSB(checksum) | AA_CONSTANT;
+  response[21] = ShortMSB(checksum) | FIVE5_CONSTANT;
+  response[22] = ShortLSB(checksum) | AA_CONSTANT;
+  response[23] = ShortLSB(checksum) | FIVE5_CONSTANT;
+  g_responder->dub_response_valid = true;
+}
+
 // Public Functions
 // ----------------------------------------------------------------------------
 void RDMResponder_Initialize(const RDMResponderSettings *settings) {
@@ -206,6 +229,7 @@ void RDMResponder_InitResponder() {
   g_responder->is_subdevice = false;
   g_responder->is_managed_proxy = false;
   g_responder->is_proxied_device = false;
+  g_responder->dub_response_valid = false;
 
   RDMResponder_ResetToFactoryDefaults();
 }
@@ -235,9 +259,36 @@ void RDMResponder_GetUID(uint8_t *uid) {
   memcpy(uid, g_responder->uid, UID_LENGTH);
 }
 
+bool RDMResponder_GetDMXWindow(DMXSlotWindow *window) {
+  const PersonalityDefinition *personality = CurrentPersonality();
+  uint16_t start_address = g_responder->dmx_start_address;
+  if (personality == NULL || personality->dmx_footprint == 0u ||
+      start_address == 0u || start_address > MAX_DMX_START_ADDRESS) {
+    return false;
+  }
+  window->start_address = start_address;
+  window->footprint = personality->dmx_footprint;
+  if (window->footprint > MAX_DMX_START_ADDRESS - start_address + 1u) {
+    window->footprint = MAX_DMX_START_ADDRESS - start_address + 1u;
+  }
+  return true;
+}
+
+bool RDMResponder_GetDUBResponse(uint8_t *response) {
+  if (g_responder->is_muted) {
+    return false;
+  }
+
+  if (!g_responder->dub_response_valid) {
+    BuildDUBResponse();
+  }
+  memcpy(response, g_responder->dub_response, DUB_RESPONSE_LENGTH);
+  return true;
+}
+
 int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
                                   unsigned int param_data_length) {
-  if (g_responder->is_muted || param_data_length != 2 * UID_LENGTH) {
+  if (param_data_length != 2 * UID_LENGTH) {
     return RDM_RESPONDER_NO_RESPONSE;
   }
 
@@ -246,33 +297,9 @@ int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
     return RDM_RESPONDER_NO_RESPONSE;
   }
 
-  uint8_t *response = (uint8_t*) g_rdm_buffer;
-  memset(response, FE_CONSTANT, 7);
-  response[7] = AA_CONSTANT;
-  response[8] = g_responder->uid[0] | AA_CONSTANT;
-  response[9] = g_responder->uid[0] | FIVE5_CONSTANT;
-  response[10] = g_responder->uid[1] | AA_CONSTANT;
-  response[11] = g_responder->uid[1] | FIVE5_CONSTANT;
-
-  response[12] = g_responder->uid[2] | AA_CONSTANT;
-  response[13] = g_responder->uid[2] | FIVE5_CONSTANT;
-  response[14] = g_responder->uid[3] | AA_CONSTANT;
-  response[15] = g_responder->uid[3] | FIVE5_CONSTANT;
-  response[16] = g_responder->uid[4] | AA_CONSTANT;
-  response[17] = g_responder->uid[4] | FIVE5_CONSTANT;
-  response[18] = g_responder->uid[5] | AA_CONSTANT;
-  response[19] = g_responder->uid[5] | FIVE5_CONSTANT;
-
-  uint16_t checksum = 0u;
-  unsigned int i;
-  for (i = 8u; i < 20u; i++) {
-    checksum += response[i];
+  if (!RDMResponder_GetDUBResponse(g_rdm_buffer)) {
+    return RDM_RESPONDER_NO_RESPONSE;
   }
-
-  response[20] = ShortMSB(checksum) | AA_CONSTANT;
-  response[21] = ShortMSB(checksum) | FIVE5_CONSTANT;
-  response[22] = ShortLSB(checksum) | AA_CONSTANT;
-  response[23] = ShortLSB(checksum) | FIVE5_CONSTANT;
   return -DUB_RESPONSE_LENGTH;
 }
 
@@ -373,40 +400,62 @@ int RDMResponder_BuildParamDescription(
   return RDMResponder_AddHeaderAndChecksum(header, ACK, ptr - g_rdm_buffer);
 }
 
+bool RDMResponder_DescriptorsAreSorted(const ResponderDefinition *definition) {
+  unsigned int i = 1u;
+  for (; i < definition->descriptor_count; i++) {
+    if (definition->descriptors[i - 1u].pid >= definition->descriptors[i].pid) {
+      return false;
+    }
+  }
+  return true;
+}
+
 int RDMResponder_DispatchPID(const RDMHeader *header,
                              const uint8_t *param_data) {
   const ResponderDefinition *definition = g_responder->def;
   uint16_t pid = ntohs(header->param_id);
-  unsigned int i = 0u;
-  // TODO(simon): convert to binary search if the list gets long.
-  // We'll need to add a check to ensure it's sorted though.
-  for (; i < definition->descriptor_count; i++) {
-    if (pid == definition->descriptors[i].pid) {
-      if (header->command_class == GET_COMMAND) {
-        if (RDMUtil_IsUnicast(header->dest_uid)) {\
-          if (definition->descriptors[i].get_handler) {
-            if (header->param_data_length ==
-                definition->descriptors[i].get_param_size) {
-              return definition->descriptors[i].get_handler(header, param_data);
-            } else {
-              return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
-            }
-          } else {
-            return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
-          }
+
+  // The descriptors are sorted by PID, so we can binary search.
+  const PIDDescriptor *descriptor = NULL;
+  unsigned int lower = 0u;
+  unsigned int upper = definition->descriptor_count;
+  while (lower < upper) {
+    unsigned int middle = lower + (upper - lower) / 2u;
+    if (definition->descriptors[middle].pid < pid) {
+      lower = middle + 1u;
+    } else if (definition->descriptors[middle].pid > pid) {
+      upper = middle;
+    } else {
+      descriptor = &definition->descriptors[middle];
+      break;
+    }
+  }
+
+  if (!descriptor) {
+    return RDMResponder_BuildNack(header, NR_UNKNOWN_PID);
+  }
+
+  if (header->command_class == GET_COMMAND) {
+    if (RDMUtil_IsUnicast(header->dest_uid)) {
+      if (descriptor->get_handler) {
+        if (header->param_data_length == descriptor->get_param_size) {
+          return descriptor->get_handler(header, param_data);
         } else {
-          return RDM_RESPONDER_NO_RESPONSE;
+          return RDMResponder_BuildNack(header, NR_FORMAT_ERROR);
         }
       } else {
-        if (definition->descriptors[i].set_handler) {
-          return definition->descriptors[i].set_handler(header, param_data);
-        } else {
-          return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
-        }
+        return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
       }
+    } else {
+      return RDM_RESPONDER_NO_RESPONSE;
+    }
+  } else {
+    if (descriptor->set_handler) {
+      return descriptor->set_handler(header, param_data);
+    } else {
+      return RDMResponder_BuildNack(header, NR_UNSUPPORTED_COMMAND_CLASS);
     }
   }
-  return RDMResponder_BuildNack(header, NR_UNKNOWN_PID);
 }
 
 int RDMResponder_Ioctl(ModelIoctl command, uint8_t *data, unsigned int length) {
@@ -417,6 +466,16 @@ int RDMResponder_Ioctl(ModelIoctl command, uint8_t *data, unsigned int length) {
       }
       RDMResponder_GetUID(data);
       return 1;
+    case IOCTL_GET_DMX_WINDOW:
+      if (length != sizeof(DMXSlotWindow)) {
+        return 0;
+      }
+      return RDMResponder_GetDMXWindow((DMXSlotWindow*) data);
+    case IOCTL_GET_DUB_RESPONSE:
+      if (length != DUB_RESPONSE_LENGTH) {
+        return 0;
+      }
+      return RDMResponder_GetDUBResponse(data);
     default:
       return 0;
   }
@@ -232,6 +232,8 @@ typedef struct {
 typedef struct {
   /**
    * @brief The descriptor table.
+   *
+   * This must be sorted by PID, see RDMResponder_DescriptorsAreSorted().
    */
   const PIDDescriptor *descriptors;
 
@@ -311,6 +313,19 @@ typedef struct {
   bool is_subdevice;  // true if this is a subdevice.
   bool is_managed_proxy;  // true if this is a managed proxy.
   bool is_proxied_device;  // true if this is a proxied device.
+
+  /**
+   * @brief True if dub_response holds the encoded response for the uid.
+   *
+   * This is cleared by RDMResponder_InitResponder(), which must be called
+   * whenever the UID or the active model changes.
+   */
+  bool dub_response_valid;
+
+  /**
+   * @brief The cached DUB response, built on the first DUB that matches.
+   */
+  uint8_t dub_response[DUB_RESPONSE_LENGTH];
 } RDMResponder;
 
 /**
@@ -374,12 +389,33 @@ void RDMResponder_ResetToFactoryDefaults();
  */
 void RDMResponder_GetUID(uint8_t *uid);
 
+/**
+ * @brief Get the DMX slot window of the responder.
+ * @param[out] window The window to fill in.
+ * @returns true if the responder has a DMX start address and a personality
+ *   with a non-zero footprint, false otherwise.
+ *
+ * The footprint is truncated if it would extend past slot 512.
+ */
+bool RDMResponder_GetDMXWindow(DMXSlotWindow *window);
+
+/**
+ * @brief Get the encoded DUB response of the responder.
+ * @param[out] response The buffer to copy the response to, should be at least
+ *   DUB_RESPONSE_LENGTH.
+ * @returns true if the response was copied, false if the responder is muted.
+ */
+bool RDMResponder_GetDUBResponse(uint8_t *response);
+
 /**
  * @brief Handle a Discovery-unique-branch request.
  * @param param_data The DUB request param_data.
  * @param param_data_length The size of the param_data.
  * @returns The size of the RDM response frame, this will be negative to
  *   indicate no break should be sent.
+ *
+ * The encoded response is cached in the RDMResponder, so a DUB that matches
+ * only costs the range check and a copy into g_rdm_buffer.
  */
 int RDMResponder_HandleDUBRequest(const uint8_t *param_data,
                                   unsigned int param_data_length);
@@ -448,6 +484,14 @@ int RDMResponder_BuildParamDescription(const RDMHeader *incoming_header,
                                        uint16_t param_id,
                                        const ParameterDescription *description);
 
+/**
+ * @brief Check that the descriptor table of a ResponderDefinition is sorted.
+ * @param definition The ResponderDefinition to check.
+ * @returns true if the descriptors are in ascending PID order, with no
+ *   duplicates.
+ */
+bool RDMResponder_DescriptorsAreSorted(const ResponderDefinition *definition);
+
 /**
  * @brief Invoke a PID handler from the ResponderDefinition.
  * @param incoming_header The header of the incoming frame.
@@ -456,7 +500,8 @@ int RDMResponder_BuildParamDescription(const RDMHeader *incoming_header,
  *
  * This checks the ResponderDefinition for a matching PID handler of the
  * correct command class. If one isn't found, it'll NACK with
- * NR_UNSUPPORTED_COMMAND_CLASS or NR_UNKNOWN_PID.
+ * NR_UNSUPPORTED_COMMAND_CLASS or NR_UNKNOWN_PID. The descriptors are binary
+ * searched, so they must be sorted.
  */
 int RDMResponder_DispatchPID(const RDMHeader *incoming_header,
                              const uint8_t *param_data);
@@ -26,6 +26,14 @@
 #include "constants.h"
 #include "utils.h"
 
+// The DUB response preamble & separator, see Section 7.5 of E1.20.
+enum { DUB_PREAMBLE_BYTE = 0xfe };
+enum { DUB_PREAMBLE_MAX_SIZE = 7 };
+enum { DUB_SEPARATOR_BYTE = 0xaa };
+
+// The size of the encoded UID & checksum that follows the separator.
+enum { DUB_ENCODED_SIZE = 16 };
+
 static uint16_t Checksum(const uint8_t *data, unsigned int length) {
   uint16_t checksum = 0u;
   unsigned int i;
@@ -74,6 +82,30 @@ int RDMUtil_AppendChecksum(uint8_t *frame) {
   return message_length + RDM_CHECKSUM_LENGTH;
 }
 
+bool RDMUtil_DecodeDUBResponse(const uint8_t *data, unsigned int length,
+                               uint8_t uid[UID_LENGTH]) {
+  unsigned int offset = 0u;
+  while (offset < length && offset < DUB_PREAMBLE_MAX_SIZE &&
+         data[offset] == DUB_PREAMBLE_BYTE) {
+    offset++;
+  }
+
+  if (offset == length || data[offset] != DUB_SEPARATOR_BYTE ||
+      length - offset - 1u < DUB_ENCODED_SIZE) {
+    return false;
+  }
+
+  const uint8_t *encoded = data + offset + 1u;
+  uint16_t checksum = Checksum(encoded, 2u * UID_LENGTH);
+  unsigned int i = 0u;
+  for (; i < UID_LENGTH; i++) {
+    uid[i] = encoded[2u * i] & encoded[2u * i + 1u];
+  }
+  const uint8_t *expected = encoded + 2u * UID_LENGTH;
+  return ShortMSB(checksum) == (expected[0] & expected[1]) &&
+         ShortLSB(checksum) == (expected[2] & expected[3]);
+}
+
 unsigned int RDMUtil_StringCopy(char *dst, unsigned int dest_size,
                                 const char *src, unsigned int src_size) {
   unsigned int size = 0u;
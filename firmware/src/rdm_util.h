@@ -94,6 +94,20 @@ bool RDMUtil_VerifyChecksum(const uint8_t *frame, unsigned int size);
  */
 int RDMUtil_AppendChecksum(uint8_t *frame);
 
+/**
+ * @brief Decode the response to a DUB request.
+ * @param data The received DUB response, which may include the preamble.
+ * @param length The size of the response data.
+ * @param[out] uid The decoded UID.
+ * @returns true if a single, valid UID was decoded, false if the response was
+ *   malformed or the checksum didn't match, which usually indicates a
+ *   collision.
+ * Up to 7 0xfe preamble bytes may precede the 0xaa separator. Any data after
+ * the checksum is ignored.
+ */
+bool RDMUtil_DecodeDUBResponse(const uint8_t *data, unsigned int length,
+                               uint8_t uid[UID_LENGTH]);
+
 /**
  * @brief Copy a string from one location to another.
  * @param dst The location to copy to.
@@ -33,6 +33,7 @@ void ReceiverCounters_ResetCounters() {
   ReceiverCounters_ResetCommsStatusCounters();
 
   g_responder_counters.dmx_frames = 0u;
+  g_responder_counters.dmx_changed_frames = 0u;
   g_responder_counters.asc_frames = 0u;
   g_responder_counters.rdm_frames = 0u;
   g_responder_counters.rdm_sub_start_code_invalid = 0u;
@@ -44,6 +44,7 @@ typedef struct {
   uint32_t rdm_msg_len_invalid;
   uint32_t rdm_param_data_len_invalid;
   uint32_t rdm_checksum_invalid;
+  uint32_t dmx_changed_frames;
   uint8_t dmx_last_checksum;
   uint16_t dmx_last_slot_count;
   uint16_t dmx_min_slot_count;
@@ -74,6 +75,16 @@ static inline uint32_t ReceiverCounters_DMXFrames() {
   return g_responder_counters.dmx_frames;
 }
 
+/**
+ * @brief The number of DMX512 frames that changed the active model's slots.
+ *
+ * This counts the frames passed to the active model with the changed flag
+ * set. Frames that repeat the previous slot values aren't counted.
+ */
+static inline uint32_t ReceiverCounters_DMXChangedFrames() {
+  return g_responder_counters.dmx_changed_frames;
+}
+
 /**
  * @brief The number of ASC frames received.
  */
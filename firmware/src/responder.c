@@ -27,7 +27,6 @@
 #include "rdm_handler.h"
 #include "receiver_counters.h"
 #include "rdm_util.h"
-#include "spi_rgb.h"
 #include "syslog.h"
 #include "transceiver.h"
 #include "utils.h"
@@ -68,6 +67,85 @@ static ResponderState g_state = STATE_START_CODE;
  */
 static unsigned int g_offset = 0u;
 
+/*
+ * @brief The running checksum of the RDM frame, updated as each byte arrives.
+ */
+static uint16_t g_checksum = 0u;
+
+/*
+ * @brief The DMX slot window of the active model, for the current frame.
+ */
+static DMXSlotWindow g_dmx_window;
+
+/*
+ * @brief The offset of the last slot in the window, or 0 if the window has
+ *   already been delivered, or there isn't one.
+ */
+static unsigned int g_dmx_window_end = 0u;
+
+/*
+ * @brief The window used for the last delivery.
+ */
+static DMXSlotWindow g_dmx_last_window;
+
+/*
+ * @brief The number of slots in the last delivery, or 0 if there wasn't one.
+ */
+static unsigned int g_dmx_last_length = 0u;
+
+/*
+ * @brief The slot values from the last delivery, indexed from the start of
+ *   the window.
+ */
+static uint8_t g_dmx_last_slots[DMX_FRAME_SIZE];
+
+/*
+ * @brief True if a slot in the window differs from the last delivery.
+ */
+static bool g_dmx_changed = true;
+
+/*
+ * @brief Pass the window to the active model.
+ */
+static inline void DeliverDMXWindow(const uint8_t *slots,
+                                    unsigned int length) {
+  bool changed = g_dmx_changed || length != g_dmx_last_length;
+  if (changed) {
+    g_responder_counters.dmx_changed_frames++;
+  }
+  g_dmx_last_length = length;
+  g_dmx_window_end = 0u;
+  RDMHandler_HandleDMX(slots, length, changed);
+}
+
+/*
+ * @brief Deliver the part of the DMX window that arrived in a short frame.
+ */
+static inline void DeliverShortDMXWindow(const uint8_t *frame,
+                                         unsigned int length) {
+  if (g_dmx_window_end && length > g_dmx_window.start_address) {
+    DeliverDMXWindow(frame + g_dmx_window.start_address,
+                     length - g_dmx_window.start_address);
+  }
+  g_dmx_window_end = 0u;
+}
+
+/*
+ * @brief Pass the active model's DUB response to the transceiver, so it can
+ * answer DUB requests from the ISR.
+ *
+ * The fast path is disabled if the model is muted or doesn't support it.
+ */
+static void UpdateDUBFastPath() {
+  uint8_t uid[UID_LENGTH];
+  uint8_t response[DUB_RESPONSE_LENGTH];
+  if (RDMHandler_GetDUBResponse(uid, response)) {
+    Transceiver_SetDUBResponse(0u, uid, response);
+  } else {
+    Transceiver_SetDUBResponse(0u, NULL, NULL);
+  }
+}
+
 /*
  * @brief Call the RDM handler when we have a complete and valid frame.
  */
@@ -76,7 +154,13 @@ static inline void DispatchRDMRequest(const uint8_t *frame) {
   RDMHandler_HandleRequest(
       header,
       header->param_data_length ? frame + RDM_PARAM_DATA_OFFSET : NULL);
-  SysLog_Print(
+  // GET requests can't change the mute state or the active model, the model
+  // only changes with a SET MODEL_ID. The response has already been queued,
+  // so this doesn't delay it.
+  if (header->command_class != GET_COMMAND) {
+    UpdateDUBFastPath();
+  }
+  SysLog_Event(
       SYSLOG_INFO,
       "RDM: break %dus, mark %dus, TN %d CC 0x%x, PID 0x%x, PDL %d",
       g_timing.request.break_time / 10u,
@@ -115,12 +199,20 @@ static inline void PossiblyIncrementLengthMismatchCounter(
 
 // Public Functions
 // ----------------------------------------------------------------------------
-void Responder_Initialize() {}
+void Responder_Initialize() {
+  g_dmx_window_end = 0u;
+  g_dmx_last_length = 0u;
+  g_dmx_changed = true;
+  // The default model was activated when it was added, so enable the fast
+  // path now rather than waiting for the first SET.
+  UpdateDUBFastPath();
+}
 
 void Responder_Receive(const TransceiverEvent *event) {
-  // While this function is running, UART interrupts are disabled.
-  // Try to keep things short.
-  if (event->op != T_OP_RX) {
+  // The transceiver keeps receiving while this function runs, but if the
+  // next frame ends before we return, it's dropped. Try to keep things short.
+  // The responder only runs on the first port.
+  if (event->op != T_OP_RX || event->port != 0u) {
     return;
   }
 
@@ -150,7 +242,9 @@ void Responder_Receive(const TransceiverEvent *event) {
   }
 
   if (event->result == T_RESULT_RX_FRAME_TIMEOUT) {
-    SPIRGB_CompleteUpdate();
+    if (g_state == STATE_DMX_DATA) {
+      DeliverShortDMXWindow(event->data, event->length);
+    }
     return;
   }
 
@@ -164,12 +258,25 @@ void Responder_Receive(const TransceiverEvent *event) {
           SysLog_Message(SYSLOG_DEBUG, "DMX frame");
           g_responder_counters.dmx_frames++;
           g_state = STATE_DMX_DATA;
-          SPIRGB_BeginUpdate();
+          // If the last frame ended without delivering the window, the
+          // stored slots may not match what the model has.
+          g_dmx_changed = g_dmx_window_end != 0u;
+          g_dmx_window_end = 0u;
+          if (RDMHandler_GetDMXWindow(&g_dmx_window)) {
+            g_dmx_window_end = g_dmx_window.start_address +
+                               g_dmx_window.footprint - 1u;
+            if (g_dmx_window.start_address != g_dmx_last_window.start_address ||
+                g_dmx_window.footprint != g_dmx_last_window.footprint) {
+              g_dmx_changed = true;
+              g_dmx_last_window = g_dmx_window;
+            }
+          }
         } else if (b == RDM_START_CODE) {
           g_responder_counters.rdm_frames++;
+          g_checksum = b;
           g_state = STATE_RDM_SUB_START_CODE;
         } else {
-          SysLog_Print(SYSLOG_DEBUG, "ASC frame: %d", (int) b);
+          SysLog_Event(SYSLOG_DEBUG, "ASC frame: %d", (int) b);
           g_responder_counters.asc_frames++;
           g_state = STATE_DISCARD;
         }
@@ -181,6 +288,7 @@ void Responder_Receive(const TransceiverEvent *event) {
           g_responder_counters.rdm_sub_start_code_invalid++;
           g_state = STATE_DISCARD;
         } else {
+          g_checksum += b;
           g_state = STATE_RDM_MESSAGE_LENGTH;
         }
         break;
@@ -190,6 +298,7 @@ void Responder_Receive(const TransceiverEvent *event) {
           g_responder_counters.rdm_msg_len_invalid++;
           g_state = STATE_DISCARD;
         } else {
+          g_checksum += b;
           g_state = STATE_RDM_BODY;
         }
         break;
@@ -204,6 +313,7 @@ void Responder_Receive(const TransceiverEvent *event) {
             continue;
           }
         }
+        g_checksum += b;
         if (g_offset + 1u == event->data[MESSAGE_LENGTH_OFFSET]) {
           g_state = STATE_RDM_CHECKSUM_LO;
         }
@@ -212,7 +322,11 @@ void Responder_Receive(const TransceiverEvent *event) {
         g_state = STATE_RDM_CHECKSUM_HI;
         break;
       case STATE_RDM_CHECKSUM_HI:
-        if (RDMUtil_VerifyChecksum(event->data, event->length)) {
+        // The checksum is sent MSB first. A frame with extra bytes already
+        // received is treated as invalid.
+        if (event->length == g_offset + 1u &&
+            event->data[g_offset - 1u] == ShortMSB(g_checksum) &&
+            b == ShortLSB(g_checksum)) {
           DispatchRDMRequest(event->data);
         } else {
           PossiblyIncrementChecksumCounter(event->data);
@@ -224,11 +338,20 @@ void Responder_Receive(const TransceiverEvent *event) {
         g_state = STATE_DISCARD;
         break;
       case STATE_DMX_DATA:
-        // TODO(simon): configure this with DMX_START_ADDRESS and footprints.
-        if (g_offset - 1u < 6u) {
-          SPIRGB_SetPixel((g_offset - 1u) / 3u, (g_offset - 1u) % 3u, b);
-        } else if (g_offset - 1u == 6u) {
-          SPIRGB_CompleteUpdate();
+        // The slot offset matches the slot number, since the start code is
+        // at offset 0.
+        if (g_dmx_window_end &&
+            g_offset - g_dmx_window.start_address < g_dmx_window.footprint) {
+          uint8_t *last = &g_dmx_last_slots[
+              g_offset - g_dmx_window.start_address];
+          if (*last != b) {
+            *last = b;
+            g_dmx_changed = true;
+          }
+          if (g_offset == g_dmx_window_end) {
+            DeliverDMXWindow(event->data + g_dmx_window.start_address,
+                             g_dmx_window.footprint);
+          }
         }
 
         g_responder_counters.dmx_last_checksum += b;
@@ -24,6 +24,15 @@
  * The responder receives data from the transceiver module and de-mulitplexes
  * based on start code.
  *
+ * For DMX512 frames, the slots in the active model's DMX slot window are
+ * passed to RDMHandler_HandleDMX() as a single span, once the last slot in the
+ * window arrives. If the frame is shorter than the window, the slots that did
+ * arrive are passed when the frame times out.
+ *
+ * As each slot in the window arrives it's compared with the value from the
+ * last delivery, so the model can be told if the window changed. Frames that
+ * changed the window are counted by ReceiverCounters_DMXChangedFrames().
+ *
  * @addtogroup responder
  * @{
  * @file responder.h
@@ -41,12 +50,17 @@ extern "C" {
 
 /**
  * @brief Initialize the Responder sub-system.
+ *
+ * This should be called once the transceiver is initialized and the default
+ * model has been added, since it enables the DUB fast path for that model.
  */
 void Responder_Initialize();
 
 /**
  * @brief Called when data is received.
  * @param event The transceiver event.
+ *
+ * Events from ports other than the first port are ignored.
  */
 void Responder_Receive(const TransceiverEvent *event);
 
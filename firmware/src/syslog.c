@@ -21,16 +21,33 @@
 
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "app_pipeline.h"
 
 enum { SYSLOG_PRINT_BUFFER_SIZE = 256 };
 
+// The number of events that can be waiting to be formatted.
+enum { SYSLOG_EVENT_QUEUE_SIZE = 16 };
+
+/*
+ * @brief A log event, waiting to be formatted.
+ */
+typedef struct {
+  const char* format;
+  int args[SYSLOG_EVENT_MAX_ARGS];
+} SysLogEvent;
+
 typedef struct {
   uint8_t log_level;
   SysLogWriteFn write_fn;
   char printf_buffer[SYSLOG_PRINT_BUFFER_SIZE];
+
+  SysLogEvent events[SYSLOG_EVENT_QUEUE_SIZE];
+  uint8_t event_head;  //!< The index of the oldest event.
+  uint8_t event_count;  //!< The number of events in the queue.
+  uint16_t dropped_events;  //!< Events dropped since the last report.
 } SysLogData;
 
 SysLogData g_syslog;
@@ -38,6 +55,9 @@ SysLogData g_syslog;
 void SysLog_Initialize(SysLogWriteFn write_fn) {
   g_syslog.log_level = SYSLOG_INFO;
   g_syslog.write_fn = write_fn;
+  g_syslog.event_head = 0u;
+  g_syslog.event_count = 0u;
+  g_syslog.dropped_events = 0u;
 }
 
 static inline void SysLog_Write(const char* msg) {
@@ -59,16 +79,57 @@ void SysLog_Print(SysLogLevel level, const char* format, ...) {
     return;
   }
 
-  size_t padding = 0;
   va_list args;
-
   va_start(args, format);
-  size_t len = vsnprintf(g_syslog.printf_buffer, SYSLOG_PRINT_BUFFER_SIZE,
-                         format, args);
+  vsnprintf(g_syslog.printf_buffer, SYSLOG_PRINT_BUFFER_SIZE, format, args);
   va_end(args);
   SysLog_Write(g_syslog.printf_buffer);
 }
 
+void SysLog_QueueEvent(SysLogLevel level, const char* format, ...) {
+  if (level < g_syslog.log_level) {
+    return;
+  }
+
+  if (g_syslog.event_count == SYSLOG_EVENT_QUEUE_SIZE) {
+    if (g_syslog.dropped_events != UINT16_MAX) {
+      g_syslog.dropped_events++;
+    }
+    return;
+  }
+
+  SysLogEvent *event = &g_syslog.events[
+      (g_syslog.event_head + g_syslog.event_count) % SYSLOG_EVENT_QUEUE_SIZE];
+  event->format = format;
+
+  va_list args;
+  va_start(args, format);
+  unsigned int i = 0u;
+  for (; i < SYSLOG_EVENT_MAX_ARGS; i++) {
+    event->args[i] = va_arg(args, int);
+  }
+  va_end(args);
+  g_syslog.event_count++;
+}
+
+void SysLog_Tasks() {
+  if (g_syslog.event_count) {
+    const SysLogEvent *event = &g_syslog.events[g_syslog.event_head];
+    // Unused arguments are ignored by snprintf.
+    snprintf(g_syslog.printf_buffer, SYSLOG_PRINT_BUFFER_SIZE, event->format,
+             event->args[0], event->args[1], event->args[2], event->args[3],
+             event->args[4], event->args[5]);
+    g_syslog.event_head = (g_syslog.event_head + 1u) % SYSLOG_EVENT_QUEUE_SIZE;
+    g_syslog.event_count--;
+    SysLog_Write(g_syslog.printf_buffer);
+  } else if (g_syslog.dropped_events) {
+    snprintf(g_syslog.printf_buffer, SYSLOG_PRINT_BUFFER_SIZE,
+             "Dropped %d log events", g_syslog.dropped_events);
+    g_syslog.dropped_events = 0u;
+    SysLog_Write(g_syslog.printf_buffer);
+  }
+}
+
 SysLogLevel SysLog_GetLevel() {
   return g_syslog.log_level;
 }
@@ -35,6 +35,10 @@
  * To log messages to the console, use SysLog_Message() and SysLog_Print().
  * This should not be called within interrupt context.
  *
+ * Code on a hot path, e.g. code that runs for every frame, should use
+ * SysLog_Event() instead. This only records the format string and the raw
+ * arguments, the formatting is deferred until SysLog_Tasks() runs.
+ *
  * @addtogroup logging
  * @{
  * @file syslog.h
@@ -95,6 +99,45 @@ void SysLog_Message(SysLogLevel level, const char* msg);
  */
 void SysLog_Print(SysLogLevel level, const char* format, ...);
 
+/**
+ * @brief The maximum number of arguments to SysLog_Event().
+ */
+#define SYSLOG_EVENT_MAX_ARGS 6
+
+/**
+ * @brief Queue a log event, which is formatted later by SysLog_Tasks().
+ * @param level the log level of the event.
+ * @param ... The format string, followed by up to SYSLOG_EVENT_MAX_ARGS
+ *   arguments.
+ *
+ * The arguments must be integer types no larger than an int, and the format
+ * string must remain valid until the event is written, i.e. a string literal.
+ * The cost of this doesn't depend on the format string. If the event queue is
+ * full, the event is dropped and the number of dropped events is logged
+ * instead.
+ *
+ * @note This should not be called within interrupt context.
+ */
+#define SysLog_Event(level, ...) \
+  SysLog_QueueEvent((level), __VA_ARGS__, 0, 0, 0, 0, 0, 0)
+
+/**
+ * @brief Queue a log event.
+ * @param level the log level of the event.
+ * @param format The format string.
+ *
+ * This must be followed by at least SYSLOG_EVENT_MAX_ARGS int arguments, use
+ * SysLog_Event() rather than calling this directly.
+ */
+void SysLog_QueueEvent(SysLogLevel level, const char* format, ...);
+
+/**
+ * @brief Format and write the next queued log event.
+ *
+ * This should be called from the main event loop.
+ */
+void SysLog_Tasks();
+
 /**
  * @brief Return the current log level.
  * @return The current log level.
@@ -174,8 +174,9 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
    function driver */
 #define USB_DEVICE_CDC_QUEUE_DEPTH_COMBINED 3
 
-/* Endpoint Transfer Queue Size combined for Read and write */
-#define USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED    2
+/* Endpoint Transfer Queue Size combined for Read and write. This is one read
+   plus USB_TX_BUFFER_COUNT writes. */
+#define USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED    4
 
 
 
@@ -33,6 +33,8 @@
 #include "peripheral/ic/plib_ic.h"
 #include "peripheral/tmr/plib_tmr.h"
 #include "peripheral/usart/plib_usart.h"
+#include "rdm_frame.h"
+#include "rdm_util.h"
 #include "setting_macros.h"
 #include "syslog.h"
 #include "system_definitions.h"
@@ -41,10 +43,34 @@
 
 #include "app_settings.h"
 
+#ifdef TRANSCEIVER_DMA
+#include "peripheral/dma/plib_dma.h"
+#include "sys/kmem.h"
+#endif
+
 enum { BUFFER_SIZE = DMX_FRAME_SIZE + 1u };
 
-// The number of buffers we maintain for overlapping I/O
-enum { NUMBER_OF_BUFFERS = 2};
+// A buffer can be loaned to the host transport, which reads a complete
+// message into it. The storage is large enough to hold a full USB read, and
+// the slot data is offset so that it lines up with the message payload. The
+// start code, data[0], overlaps the last byte of the message header.
+enum { BUFFER_STORAGE_SIZE = USB_READ_BUFFER_SIZE };
+enum { BUFFER_DATA_OFFSET = MESSAGE_HEADER_SIZE - 1u };
+
+// The number of buffers each port maintains for overlapping I/O. This is the
+// DMX and RDM TX queues plus the active buffer, and one on loan to the host
+// transport. If DMX refresh is enabled, one of these holds the last DMX frame.
+// In responder mode, one holds the DUB response if the fast path is enabled.
+enum { NUMBER_OF_BUFFERS = 2u * TRANSCEIVER_TX_QUEUE_SIZE + 2u };
+
+// A DUB request is the header, the lower & upper UIDs and the checksum.
+enum { DUB_REQUEST_LENGTH = sizeof(RDMHeader) + 2u * UID_LENGTH + 2u };
+
+// The input capture modules can only use timers 2 & 3 as a time base, so at
+// most two ports can be supported.
+#if TRANSCEIVER_PORT_COUNT < 1 || TRANSCEIVER_PORT_COUNT > 2
+#error "TRANSCEIVER_PORT_COUNT must be 1 or 2"
+#endif
 
 const int16_t TRANSCEIVER_NO_NOTIFICATION = -1;
 
@@ -58,6 +84,13 @@ static const uint16_t RESPONSE_TIME_RX_FUDGE_FACTOR = 13u;
 static const uint8_t SELF_TEST_VALUE = 0xa5;
 static const uint32_t SELF_TEST_TIMEOUT = 100;  // 10ms
 
+// The interval over which we measure the TX frame rate.
+static const uint32_t FRAME_RATE_INTERVAL = 10000;  // 1s
+
+// The responder timer wraps after this long, so longer turnaround times can't
+// be measured with it.
+static const uint32_t TURNAROUND_TIMER_LIMIT = 65;  // 6.5ms
+
 typedef enum {
   // Controller states
   STATE_C_INITIALIZE = 0,  //!< Initialize controller state.
@@ -116,10 +149,41 @@ typedef struct {
   uint16_t size;
   InternalOperation op;
   int16_t token;
-  uint8_t data[BUFFER_SIZE];
+  uint8_t *data;  //!< Points into storage, data[0] is the start code.
+  uint8_t storage[BUFFER_STORAGE_SIZE];
 } TransceiverBuffer;
 
+/**
+ * @brief A queue of buffers waiting to be transmitted.
+ *
+ * This is a ring, head is the index of the oldest buffer.
+ */
+typedef struct {
+  TransceiverBuffer* buffers[TRANSCEIVER_TX_QUEUE_SIZE];
+  uint8_t head;  //!< The index of the next buffer to transmit.
+  uint8_t size;  //!< The number of buffers in the queue, may be 0.
+} TXQueue;
+
 typedef struct {
+  // Timing params
+  uint16_t break_time;
+  uint16_t break_ticks;
+  uint16_t mark_time;
+  uint16_t mark_ticks;
+  uint16_t rdm_broadcast_timeout;
+  uint16_t rdm_response_timeout;
+  uint16_t rdm_dub_response_limit;
+  uint16_t rdm_responder_delay;
+  uint16_t rdm_responder_jitter;
+  uint16_t dmx_refresh_interval;
+} TimingSettings;
+
+/**
+ * @brief The state of a transceiver port.
+ */
+typedef struct {
+  uint8_t id;  //!< The index of this port.
+  bool initialized;  //!< True once Transceiver_Initialize() has been called.
   TransceiverState state;  //!< The current state of the transceiver.
   TransceiverMode mode;  //!< The operating mode of the transceiver.
   TransceiverMode desired_mode;  //!< The mode we'd like to be operating in.
@@ -137,8 +201,8 @@ typedef struct {
   /**
    * @brief The time to wait for the RDM response.
    *
-   * This is set to either g_timing_settings.rdm_response_timeout or
-   * g_timing_settings.rdm_broadcast_timeout depending on the type of request.
+   * This is set to either settings.rdm_response_timeout or
+   * settings.rdm_broadcast_timeout depending on the type of request.
    */
   uint16_t rdm_response_timeout;
 
@@ -188,47 +252,253 @@ typedef struct {
    */
   int16_t mode_change_token;
 
+  /**
+   * @brief The start of the current frame rate measurement interval.
+   */
+  CoarseTimer_Value frame_rate_start;
+
+  uint16_t frame_count;  //!< Frames sent in the current interval.
+  uint16_t frame_rate;  //!< Frames sent in the last complete interval.
+
   /**
    * @brief The buffer current used for transmit / receive.
    */
   TransceiverBuffer* active;
-  TransceiverBuffer* next;  //!< The next buffer ready to be transmitted
+
+  /**
+   * @brief In responder mode, the buffer the ISR switches to when the frame in
+   * the active buffer ends.
+   *
+   * This is NULL while rx_complete holds the other RX buffer.
+   */
+  TransceiverBuffer* rx_spare;
+
+  /**
+   * @brief A received frame waiting to be delivered by the tasks function, or
+   * NULL.
+   *
+   * The ISR won't touch this buffer until the tasks function returns it to
+   * rx_spare.
+   */
+  TransceiverBuffer* rx_complete;
+  uint16_t rx_complete_length;  //!< The number of slots in rx_complete.
+  TransceiverTiming rx_complete_timing;  //!< The timing for rx_complete.
+
+  /**
+   * @brief The number of frames dropped because rx_complete was still busy.
+   */
+  uint32_t rx_overruns;
+
+  /**
+   * @brief True if the ISR should answer DUB requests that cover dub_uid.
+   */
+  bool dub_enabled;
+  uint8_t dub_uid[UID_LENGTH];  //!< The UID for the DUB fast path.
+  uint8_t dub_response[DUB_RESPONSE_LENGTH];  //!< The encoded DUB response.
+
+  /**
+   * @brief The buffer the ISR sends the DUB response from, or NULL.
+   *
+   * This is taken from the free list before each frame, so the ISR never
+   * touches the free list.
+   */
+  TransceiverBuffer* dub_buffer;
+
+  /**
+   * @brief The buffer to receive into once the ISR has sent the DUB response,
+   * or NULL.
+   */
+  TransceiverBuffer* dub_rx_buffer;
+
+  /**
+   * @brief The DMX and ASC frames ready to be transmitted.
+   */
+  TXQueue dmx_queue;
+
+  /**
+   * @brief The RDM and self test frames ready to be transmitted.
+   *
+   * In responder mode, this holds the RDM response.
+   */
+  TXQueue rdm_queue;
+
+  /**
+   * @brief The approximate time of the start of the last DMX frame.
+   *
+   * This is used to keep the DMX refresh rate above the refresh interval when
+   * RDM frames are also queued.
+   */
+  CoarseTimer_Value dmx_frame_start;
+
+  /**
+   * @brief True if a DMX frame has been sent since entering controller mode.
+   */
+  bool dmx_started;
+
+  /**
+   * @brief True if the DMX queue is next in turn, when both TX queues have
+   * frames.
+   */
+  bool dmx_turn;
+
+  /**
+   * @brief The last DMX frame sent, or NULL if DMX refresh is disabled.
+   *
+   * This is re-sent if the refresh interval has passed and no other DMX frame
+   * is queued.
+   */
+  TransceiverBuffer* refresh;
+
+  /**
+   * @brief The buffer on loan to the host transport, or NULL.
+   *
+   * This is kept out of the free list until it's queued for transmit. Only
+   * the first port loans buffers.
+   */
+  TransceiverBuffer* loan;
 
   TransceiverBuffer* free_list[NUMBER_OF_BUFFERS];
   uint8_t free_size;  //!< The number of buffers in the free list, may be 0.
-} TransceiverData;
 
-typedef struct {
-  // Timing params
-  uint16_t break_time;
-  uint16_t break_ticks;
-  uint16_t mark_time;
-  uint16_t mark_ticks;
-  uint16_t rdm_broadcast_timeout;
-  uint16_t rdm_response_timeout;
-  uint16_t rdm_dub_response_limit;
-  uint16_t rdm_responder_delay;
-  uint16_t rdm_responder_jitter;
-} TimingSettings;
+  TransceiverBuffer buffers[NUMBER_OF_BUFFERS];  //!< The TX / RX buffers.
+
+  TimingSettings settings;  //!< The timing settings.
+
+  TransceiverTiming timing;  //!< The timing information for the current op.
+
+  TransceiverState logged_state;  //!< The last state that was logged.
+
+  // The event callbacks, or NULL if there isn't one.
+  TransceiverEventCallback tx_callback;
+  TransceiverEventCallback rx_callback;
+
+  /**
+   * @brief The RDM responder turnaround statistics.
+   *
+   * The mean is computed on demand.
+   */
+  TransceiverTurnaroundStats turnaround;
 
-// The TX / RX buffers
-static TransceiverBuffer buffers[NUMBER_OF_BUFFERS];
+  // The sum of all turnaround times, in 10ths of a microsecond.
+  uint64_t turnaround_total;
 
-// The transceiver state
-TransceiverData g_transceiver;
+  // The line time used by each class of controller frame.
+  TransceiverLineStats line_stats;
 
-// The hardware settings
-static TransceiverHardwareSettings g_hw_settings;
+#ifndef TRANSCEIVER_STATIC_HW_SETTINGS
+  TransceiverHardwareSettings hw_settings;  //!< The hardware settings.
+#endif
+
+#ifdef TRANSCEIVER_DMA
+  /**
+   * @brief True if the DMA channel is moving received slots into the active
+   * buffer.
+   */
+  bool dma_rx;
+
+  /**
+   * @brief The data_index when the DMA RX transfer started.
+   *
+   * The channel's destination pointer is relative to this.
+   */
+  uint16_t dma_rx_start;
+#endif
+} TransceiverPort;
+
+
+// The transceiver ports
+TransceiverPort g_ports[TRANSCEIVER_PORT_COUNT];
+
+// The hardware settings.
+//
+// If TRANSCEIVER_STATIC_HW_SETTINGS is defined, the values from app_settings.h
+// are used directly. Since these are constants, the compiler can reduce the
+// PLIB calls in the ISRs to direct register accesses. Otherwise the values
+// passed to Transceiver_Initialize() are used.
+#ifdef TRANSCEIVER_STATIC_HW_SETTINGS
+
+static const TransceiverHardwareSettings STATIC_HW_SETTINGS[] = {
+  TRANSCEIVER_HW_SETTINGS(TRANSCEIVER_UART, TRANSCEIVER_TIMER, TRANSCEIVER_IC,
+                          TRANSCEIVER_PORT, TRANSCEIVER_PORT_BIT,
+                          TRANSCEIVER_TX_ENABLE_PORT_BIT,
+                          TRANSCEIVER_RX_ENABLE_PORT_BIT),
+#if TRANSCEIVER_PORT_COUNT > 1
+  TRANSCEIVER_HW_SETTINGS(TRANSCEIVER_PORT1_UART, TRANSCEIVER_PORT1_TIMER,
+                          TRANSCEIVER_PORT1_IC, TRANSCEIVER_PORT1_PORT,
+                          TRANSCEIVER_PORT1_PORT_BIT,
+                          TRANSCEIVER_PORT1_TX_ENABLE_PORT_BIT,
+                          TRANSCEIVER_PORT1_RX_ENABLE_PORT_BIT),
+#endif
+};
 
-// The timing information for the current operation.
-static TransceiverTiming g_timing;
+#if TRANSCEIVER_PORT_COUNT == 1
+// With a single port the index is a constant. The port is still referenced so
+// the helpers that take it don't trigger unused parameter warnings.
+#define HW_SETTINGS(port) STATIC_HW_SETTINGS[0 * sizeof(*(port))]
+#else
+// Use the port's position in g_ports rather than loading port->id. Once the
+// handlers are inlined into the per-port ISRs this is a constant, so the PLIB
+// calls still fold.
+#define HW_SETTINGS(port) STATIC_HW_SETTINGS[(port) - g_ports]
+#endif
 
-// The event callback, or NULL if there isn't one.
-static TransceiverEventCallback g_tx_callback = NULL;
-static TransceiverEventCallback g_rx_callback = NULL;
+#else
 
-// The timing settings
-static TimingSettings g_timing_settings;
+#define HW_SETTINGS(port) (port)->hw_settings
+
+#endif  // TRANSCEIVER_STATIC_HW_SETTINGS
+
+#define HW_USART(port) HW_SETTINGS(port).usart
+#define HW_USART_VECTOR(port) HW_SETTINGS(port).usart_vector
+#define HW_USART_TX_SOURCE(port) HW_SETTINGS(port).usart_tx_source
+#define HW_USART_RX_SOURCE(port) HW_SETTINGS(port).usart_rx_source
+#define HW_USART_ERROR_SOURCE(port) HW_SETTINGS(port).usart_error_source
+#define HW_PORT(port) HW_SETTINGS(port).port
+#define HW_BREAK_BIT(port) HW_SETTINGS(port).break_bit
+#define HW_TX_ENABLE_BIT(port) HW_SETTINGS(port).tx_enable_bit
+#define HW_RX_ENABLE_BIT(port) HW_SETTINGS(port).rx_enable_bit
+#define HW_INPUT_CAPTURE_MODULE(port) HW_SETTINGS(port).input_capture_module
+#define HW_INPUT_CAPTURE_VECTOR(port) HW_SETTINGS(port).input_capture_vector
+#define HW_INPUT_CAPTURE_SOURCE(port) HW_SETTINGS(port).input_capture_source
+#define HW_TIMER_MODULE_ID(port) HW_SETTINGS(port).timer_module_id
+#define HW_TIMER_VECTOR(port) HW_SETTINGS(port).timer_vector
+#define HW_TIMER_SOURCE(port) HW_SETTINGS(port).timer_source
+#define HW_INPUT_CAPTURE_TIMER(port) HW_SETTINGS(port).input_capture_timer
+
+#ifdef TRANSCEIVER_DMA
+// The DMA channel for each port. A port is only ever sending or receiving, so
+// the channel is shared between TX and RX.
+typedef struct {
+  DMA_CHANNEL channel;
+  INT_VECTOR vector;
+  INT_SOURCE source;
+} TransceiverDMASettings;
+
+static const TransceiverDMASettings DMA_SETTINGS[] = {
+  {
+    AS_DMA_CHANNEL(TRANSCEIVER_DMA_CHANNEL),
+    AS_DMA_INTERRUPT_VECTOR(TRANSCEIVER_DMA_CHANNEL),
+    AS_DMA_INTERRUPT_SOURCE(TRANSCEIVER_DMA_CHANNEL)
+  },
+#if TRANSCEIVER_PORT_COUNT > 1
+  {
+    AS_DMA_CHANNEL(TRANSCEIVER_PORT1_DMA_CHANNEL),
+    AS_DMA_INTERRUPT_VECTOR(TRANSCEIVER_PORT1_DMA_CHANNEL),
+    AS_DMA_INTERRUPT_SOURCE(TRANSCEIVER_PORT1_DMA_CHANNEL)
+  },
+#endif
+};
+
+#if TRANSCEIVER_PORT_COUNT == 1
+#define DMA_SETTINGS_INDEX(port) (0 * sizeof(*(port)))
+#else
+#define DMA_SETTINGS_INDEX(port) ((port) - g_ports)
+#endif
+
+#define HW_DMA_CHANNEL(port) DMA_SETTINGS[DMA_SETTINGS_INDEX(port)].channel
+#define HW_DMA_VECTOR(port) DMA_SETTINGS[DMA_SETTINGS_INDEX(port)].vector
+#define HW_DMA_SOURCE(port) DMA_SETTINGS[DMA_SETTINGS_INDEX(port)].source
+#endif  // TRANSCEIVER_DMA
 
 // Timer Functions
 // ----------------------------------------------------------------------------
@@ -246,10 +516,10 @@ static inline uint16_t MicroSecondsToTicks(uint16_t micro_seconds) {
  * when the last event occurred. We use this to time packets, since often we
  * don't know what's a break until after the event.
  */
-static inline void RebaseTimer(uint16_t last_event) {
+static inline void RebaseTimer(TransceiverPort *port, uint16_t last_event) {
   PLIB_TMR_Counter16BitSet(
-      g_hw_settings.timer_module_id,
-      PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) - last_event);
+      HW_TIMER_MODULE_ID(port),
+      PLIB_TMR_Counter16BitGet(HW_TIMER_MODULE_ID(port)) - last_event);
 }
 
 // I/O Functions
@@ -258,51 +528,51 @@ static inline void RebaseTimer(uint16_t last_event) {
 /*
  * @brief Switch the transceiver to TX mode.
  */
-static inline void EnableTX() {
+static inline void EnableTX(TransceiverPort *port) {
   PLIB_PORTS_PinSet(PORTS_ID_0,
-                    g_hw_settings.port,
-                    g_hw_settings.tx_enable_bit);
+                    HW_PORT(port),
+                    HW_TX_ENABLE_BIT(port));
   PLIB_PORTS_PinSet(PORTS_ID_0,
-                    g_hw_settings.port,
-                    g_hw_settings.rx_enable_bit);
+                    HW_PORT(port),
+                    HW_RX_ENABLE_BIT(port));
 }
 
 /*
  * @brief Switch the transceiver to RX mode.
  */
-static inline void EnableRX() {
+static inline void EnableRX(TransceiverPort *port) {
   PLIB_PORTS_PinClear(PORTS_ID_0,
-                      g_hw_settings.port,
-                      g_hw_settings.rx_enable_bit);
+                      HW_PORT(port),
+                      HW_RX_ENABLE_BIT(port));
   PLIB_PORTS_PinClear(PORTS_ID_0,
-                      g_hw_settings.port,
-                      g_hw_settings.tx_enable_bit);
+                      HW_PORT(port),
+                      HW_TX_ENABLE_BIT(port));
 }
 
 /*
  * @brief Set the line to a break.
  */
-static inline void SetBreak() {
+static inline void SetBreak(TransceiverPort *port) {
   PLIB_PORTS_PinClear(PORTS_ID_0,
-                      g_hw_settings.port,
-                      g_hw_settings.break_bit);
+                      HW_PORT(port),
+                      HW_BREAK_BIT(port));
 }
 
 /*
  * @brief Set the line to a mark.
  */
-static inline void SetMark() {
+static inline void SetMark(TransceiverPort *port) {
   PLIB_PORTS_PinSet(PORTS_ID_0,
-                    g_hw_settings.port,
-                    g_hw_settings.break_bit);
+                    HW_PORT(port),
+                    HW_BREAK_BIT(port));
 }
 
 /*
  * @brief Put us into a MARK state
  */
-static inline void ResetToMark() {
-  SetMark();
-  EnableTX();
+static inline void ResetToMark(TransceiverPort *port) {
+  SetMark(port);
+  EnableTX(port);
 }
 
 // UART Helpers
@@ -310,57 +580,200 @@ static inline void ResetToMark() {
 /*
  * @brief Push data into the UART TX queue.
  */
-static void UART_TXBytes() {
-  while (!PLIB_USART_TransmitterBufferIsFull(g_hw_settings.usart) &&
-         g_transceiver.data_index != g_transceiver.active->size) {
+static void UART_TXBytes(TransceiverPort *port) {
+  while (!PLIB_USART_TransmitterBufferIsFull(HW_USART(port)) &&
+         port->data_index != port->active->size) {
     PLIB_USART_TransmitterByteSend(
-        g_hw_settings.usart,
-        g_transceiver.active->data[g_transceiver.data_index]);
-    g_transceiver.data_index++;
+        HW_USART(port),
+        port->active->data[port->data_index]);
+    port->data_index++;
   }
 }
 
-void UART_FlushRX() {
-  while (PLIB_USART_ReceiverDataIsAvailable(g_hw_settings.usart)) {
-    PLIB_USART_ReceiverByteReceive(g_hw_settings.usart);
+static void UART_FlushRX(TransceiverPort *port) {
+  while (PLIB_USART_ReceiverDataIsAvailable(HW_USART(port))) {
+    PLIB_USART_ReceiverByteReceive(HW_USART(port));
   }
 }
 
+/*
+ * @brief Process newly received slots.
+ *
+ * This completes a RDM response once the expected number of slots have
+ * arrived, and records the time of the last slot.
+ */
+static void RXBytesReceived(TransceiverPort *port) {
+  if (port->active->op == OP_RDM_WITH_RESPONSE ||
+      port->active->op == OP_RDM_BROADCAST) {
+    if (!port->found_expected_length && port->data_index >= 3u) {
+      if (port->active->data[0] == RDM_START_CODE &&
+          port->active->data[1] == RDM_SUB_START_CODE) {
+        port->found_expected_length = true;
+        // Add two bytes for the checksum
+        port->expected_length = port->active->data[2] + 2;
+      }
+    }
+    if (port->found_expected_length &&
+        port->data_index >= port->expected_length) {
+      // We've got enough data to move on
+      PLIB_USART_ReceiverDisable(HW_USART(port));
+      ResetToMark(port);
+      port->state = STATE_C_COMPLETE;
+    }
+  }
+  port->last_byte = PLIB_TMR_Counter16BitGet(
+      HW_TIMER_MODULE_ID(port));
+  port->last_byte_coarse = CoarseTimer_GetTime();
+}
+
 /*
  * @brief Pull data out of the UART RX queue.
  * @returns true if the RX buffer is now full.
  */
-bool UART_RXBytes() {
-  while (PLIB_USART_ReceiverDataIsAvailable(g_hw_settings.usart) &&
-         g_transceiver.data_index != BUFFER_SIZE) {
-    g_transceiver.active->data[g_transceiver.data_index] =
-        PLIB_USART_ReceiverByteReceive(g_hw_settings.usart);
-    g_transceiver.data_index++;
-  }
-  if (g_transceiver.active->op == OP_RDM_WITH_RESPONSE ||
-      g_transceiver.active->op == OP_RDM_BROADCAST) {
-    if (g_transceiver.found_expected_length) {
-      if (g_transceiver.data_index == g_transceiver.expected_length) {
-        // We've got enough data to move on
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
-      }
-    } else {
-      if (g_transceiver.data_index >= 3u) {
-        if (g_transceiver.active->data[0] == RDM_START_CODE &&
-            g_transceiver.active->data[1] == RDM_SUB_START_CODE) {
-          g_transceiver.found_expected_length = true;
-          // Add two bytes for the checksum
-          g_transceiver.expected_length = g_transceiver.active->data[2] + 2;
-        }
-      }
+static bool UART_RXBytes(TransceiverPort *port) {
+  while (PLIB_USART_ReceiverDataIsAvailable(HW_USART(port)) &&
+         port->data_index != BUFFER_SIZE) {
+    port->active->data[port->data_index] =
+        PLIB_USART_ReceiverByteReceive(HW_USART(port));
+    port->data_index++;
+  }
+  RXBytesReceived(port);
+  return port->data_index >= BUFFER_SIZE;
+}
+
+#ifdef TRANSCEIVER_DMA
+// DMA Helpers
+// ----------------------------------------------------------------------------
+/*
+ * @brief Enable the port's DMA channel.
+ * @param trigger The USART interrupt which starts each single slot transfer.
+ *
+ * The trigger's interrupt flag is cleared, so the first transfer occurs on the
+ * next USART event.
+ */
+static void DMA_Start(TransceiverPort *port, INT_SOURCE trigger) {
+  PLIB_DMA_ChannelXStartIRQSet(DMA_ID_0, HW_DMA_CHANNEL(port),
+                               (DMA_TRIGGER_SOURCE) trigger);
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  SYS_INT_SourceStatusClear(HW_DMA_SOURCE(port));
+  SYS_INT_SourceEnable(HW_DMA_SOURCE(port));
+  SYS_INT_SourceStatusClear(trigger);
+  PLIB_DMA_ChannelXEnable(DMA_ID_0, HW_DMA_CHANNEL(port));
+}
+
+/*
+ * @brief Move the remainder of the active buffer into the USART using DMA.
+ *
+ * The DMA ISR runs once the last slot is in the USART TX buffer.
+ */
+static void DMA_StartTX(TransceiverPort *port) {
+  PLIB_DMA_ChannelXSourceStartAddressSet(
+      DMA_ID_0, HW_DMA_CHANNEL(port),
+      KVA_TO_PA(&port->active->data[port->data_index]));
+  PLIB_DMA_ChannelXSourceSizeSet(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                 port->active->size - port->data_index);
+  PLIB_DMA_ChannelXDestinationStartAddressSet(
+      DMA_ID_0, HW_DMA_CHANNEL(port),
+      KVA_TO_PA(PLIB_USART_TransmitterAddressGet(HW_USART(port))));
+  PLIB_DMA_ChannelXDestinationSizeSet(DMA_ID_0, HW_DMA_CHANNEL(port), 1u);
+  DMA_Start(port, HW_USART_TX_SOURCE(port));
+}
+
+/*
+ * @brief Move received slots into the active buffer using DMA.
+ *
+ * The DMA ISR only runs if the buffer fills up, otherwise the progress is
+ * checked with DMA_RXBytes().
+ */
+static void DMA_StartRX(TransceiverPort *port) {
+  PLIB_DMA_ChannelXSourceStartAddressSet(
+      DMA_ID_0, HW_DMA_CHANNEL(port),
+      KVA_TO_PA(PLIB_USART_ReceiverAddressGet(HW_USART(port))));
+  PLIB_DMA_ChannelXSourceSizeSet(DMA_ID_0, HW_DMA_CHANNEL(port), 1u);
+  PLIB_DMA_ChannelXDestinationStartAddressSet(
+      DMA_ID_0, HW_DMA_CHANNEL(port),
+      KVA_TO_PA(&port->active->data[port->data_index]));
+  PLIB_DMA_ChannelXDestinationSizeSet(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                      BUFFER_SIZE - port->data_index);
+  port->dma_rx = true;
+  port->dma_rx_start = port->data_index;
+  DMA_Start(port, HW_USART_RX_SOURCE(port));
+}
+
+/*
+ * @brief Process the slots the DMA channel has received so far.
+ *
+ * @pre The DMA interrupt is disabled.
+ */
+static void DMA_RXBytes(TransceiverPort *port) {
+  if (!port->dma_rx) {
+    return;
+  }
+  uint16_t received = port->dma_rx_start +
+      PLIB_DMA_ChannelXDestinationPointerGet(DMA_ID_0, HW_DMA_CHANNEL(port));
+  if (received > port->data_index) {
+    port->data_index = received;
+    RXBytesReceived(port);
+    // The DMA channel doesn't stop at the end of the response, so drop any
+    // trailing slots.
+    if (port->found_expected_length &&
+        port->data_index > port->expected_length) {
+      port->data_index = port->expected_length;
     }
   }
-  g_transceiver.last_byte = PLIB_TMR_Counter16BitGet(
-      g_hw_settings.timer_module_id);
-  g_transceiver.last_byte_coarse = CoarseTimer_GetTime();
-  return g_transceiver.data_index >= BUFFER_SIZE;
+}
+
+/*
+ * @brief Stop receiving with DMA, and update the data_index.
+ */
+static void DMA_StopRX(TransceiverPort *port) {
+  SYS_INT_SourceDisable(HW_DMA_SOURCE(port));
+  if (!port->dma_rx) {
+    return;
+  }
+  PLIB_DMA_ChannelXDisable(DMA_ID_0, HW_DMA_CHANNEL(port));
+  if (PLIB_DMA_ChannelXINTSourceFlagGet(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                        DMA_INT_BLOCK_TRANSFER_COMPLETE)) {
+    port->data_index = BUFFER_SIZE;
+  } else {
+    DMA_RXBytes(port);
+  }
+  port->dma_rx = false;
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  SYS_INT_SourceStatusClear(HW_DMA_SOURCE(port));
+}
+#endif  // TRANSCEIVER_DMA
+
+/*
+ * @brief Start moving the remainder of the active buffer into the USART.
+ *
+ * This uses DMA if it's enabled, otherwise the USART TX interrupt.
+ */
+static inline void StartTXData(TransceiverPort *port) {
+#ifdef TRANSCEIVER_DMA
+  if (port->data_index != port->active->size) {
+    DMA_StartTX(port);
+    return;
+  }
+#endif
+  SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
+  SYS_INT_SourceEnable(HW_USART_TX_SOURCE(port));
+}
+
+/*
+ * @brief Start receiving the controller's response data.
+ *
+ * This uses DMA if it's enabled, otherwise the USART RX interrupt.
+ */
+static inline void StartRXData(TransceiverPort *port) {
+#ifdef TRANSCEIVER_DMA
+  DMA_StartRX(port);
+#else
+  SYS_INT_SourceStatusClear(HW_USART_RX_SOURCE(port));
+  SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
+#endif
 }
 
 // Memory Buffer Management
@@ -372,51 +785,374 @@ bool UART_RXBytes() {
  *
  * This is exposed for testing purposes.
  */
-uint8_t Transceiver_FreeBufferCount() {
-  return g_transceiver.free_size;
+uint8_t Transceiver_FreeBufferCount(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->free_size;
 }
 
+#ifdef TRANSCEIVER_DMA
+/*
+ * @brief Stop the DMA RX transfer and start it again from the current slot.
+ *
+ * This is exposed for testing purposes.
+ */
+void Transceiver_RestartDMARX(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  if (port->dma_rx) {
+    DMA_StopRX(port);
+    DMA_StartRX(port);
+  }
+}
+#endif
+
 /*
  * @brief Setup the transceiver buffers.
  */
-static void InitializeBuffers() {
-  g_transceiver.active = NULL;
-  g_transceiver.next = NULL;
+static void InitializeBuffers(TransceiverPort *port) {
+  port->active = NULL;
+  port->rx_spare = NULL;
+  port->rx_complete = NULL;
+  port->dub_buffer = NULL;
+  port->dub_rx_buffer = NULL;
+  port->refresh = NULL;
+  port->dmx_queue.head = 0u;
+  port->dmx_queue.size = 0u;
+  port->rdm_queue.head = 0u;
+  port->rdm_queue.size = 0u;
+  port->dmx_started = false;
+  port->dmx_turn = true;
+  port->free_size = 0u;
 
   unsigned int i = 0u;
   for (; i < NUMBER_OF_BUFFERS; i++) {
-    g_transceiver.free_list[i] = &buffers[i];
+    TransceiverBuffer *buffer = &port->buffers[i];
+    buffer->data = &buffer->storage[BUFFER_DATA_OFFSET];
+    // The host transport may still be reading into the loaned buffer.
+    if (buffer != port->loan) {
+      port->free_list[port->free_size] = buffer;
+      port->free_size++;
+    }
   }
-  g_transceiver.free_size = NUMBER_OF_BUFFERS;
 }
 
 /*
  * @brief Return the active buffer to the free list.
  */
-static void FreeActiveBuffer() {
-  if (g_transceiver.active) {
-    g_transceiver.free_list[g_transceiver.free_size] = g_transceiver.active;
-    g_transceiver.free_size++;
-    g_transceiver.active = NULL;
+static void FreeActiveBuffer(TransceiverPort *port) {
+  if (port->active &&
+      port->active != port->refresh &&
+      port->active != port->dub_buffer) {
+    port->free_list[port->free_size] = port->active;
+    port->free_size++;
+  }
+  port->active = NULL;
+}
+
+/*
+ * @brief Hold on to the active buffer so it can be re-sent.
+ *
+ * The previously held buffer, if any, is returned to the free list.
+ */
+static void RetainActiveBuffer(TransceiverPort *port) {
+  if (port->refresh &&
+      port->refresh != port->active) {
+    port->free_list[port->free_size] = port->refresh;
+    port->free_size++;
+  }
+  port->refresh = port->active;
+}
+
+/*
+ * @brief Hand the frame in the active buffer over to the tasks function.
+ *
+ * This is called from the ISR when a break or a full buffer ends the frame.
+ * Reception continues in the spare buffer, so the RX handler has until the
+ * end of the next frame to finish with this one. If it's still busy, the newer
+ * frame is dropped and counted as an overrun.
+ */
+static void PublishRXFrame(TransceiverPort *port) {
+  if (port->data_index != 0u) {
+    if (port->rx_complete) {
+      port->rx_overruns++;
+    } else {
+      port->rx_complete = port->active;
+      port->rx_complete_length = port->data_index;
+      port->rx_complete_timing = port->timing;
+      port->active = port->rx_spare;
+      port->rx_spare = NULL;
+    }
+  }
+  port->data_index = 0u;
+}
+
+/*
+ * @brief Check if the frame in the active buffer is a DUB request that the
+ * fast path should answer.
+ *
+ * This mirrors the checks in Responder_Receive() and
+ * RDMResponder_HandleDUBRequest().
+ */
+static inline bool IsFastPathDUB(const TransceiverPort *port) {
+  if (!port->dub_enabled || !port->dub_buffer ||
+      port->data_index != DUB_REQUEST_LENGTH) {
+    return false;
+  }
+
+  const uint8_t *frame = port->active->data;
+  const RDMHeader *header = (const RDMHeader*) frame;
+  const uint8_t *pid = (const uint8_t*) &header->param_id;
+  if (header->start_code != RDM_START_CODE ||
+      header->sub_start_code != RDM_SUB_START_CODE ||
+      header->message_length != DUB_REQUEST_LENGTH - 2u ||
+      header->command_class != DISCOVERY_COMMAND ||
+      pid[0] != (PID_DISC_UNIQUE_BRANCH >> 8) ||
+      pid[1] != (PID_DISC_UNIQUE_BRANCH & 0xff) ||
+      header->sub_device != 0u ||
+      header->param_data_length != 2u * UID_LENGTH ||
+      !RDMUtil_RequiresAction(port->dub_uid, header->dest_uid)) {
+    return false;
+  }
+
+  const uint8_t *lower = frame + sizeof(RDMHeader);
+  const uint8_t *upper = lower + UID_LENGTH;
+  return RDMUtil_UIDCompare(lower, port->dub_uid) <= 0 &&
+         RDMUtil_UIDCompare(port->dub_uid, upper) <= 0 &&
+         RDMUtil_VerifyChecksum(frame, DUB_REQUEST_LENGTH);
+}
+
+/*
+ * @brief Return the queued RDM response, if any, to the free list.
+ */
+static void DropRDMResponse(TransceiverPort *port) {
+  TXQueue *queue = &port->rdm_queue;
+  for (; queue->size; queue->size--) {
+    port->free_list[port->free_size] = queue->buffers[queue->head];
+    port->free_size++;
+    queue->head = (queue->head + 1u) % TRANSCEIVER_TX_QUEUE_SIZE;
+  }
+}
+
+/*
+ * @brief Check if a DMX frame is due to keep up the refresh rate.
+ *
+ * This is never true if DMX refresh is disabled, or if no DMX frame has been
+ * sent yet.
+ */
+static inline bool DMXDue(TransceiverPort *port) {
+  return port->settings.dmx_refresh_interval &&
+         port->dmx_started &&
+         CoarseTimer_HasElapsed(port->dmx_frame_start,
+                                port->settings.dmx_refresh_interval);
+}
+
+/*
+ * @brief Pick the TX queue the next controller frame should come from.
+ * @param[out] use_refresh Set to true if the held DMX frame should be re-sent
+ *   instead.
+ * @returns The queue to take the next frame from, or NULL.
+ *
+ * A DMX frame is always sent once the refresh interval has passed, so a busy
+ * RDM queue can't drop the DMX refresh rate below the configured rate. At
+ * other times the two queues take turns, so RDM gets the remaining line time.
+ */
+static TXQueue* NextControllerQueue(TransceiverPort *port, bool *use_refresh) {
+  TXQueue *dmx_queue = &port->dmx_queue;
+  TXQueue *rdm_queue = &port->rdm_queue;
+  *use_refresh = false;
+
+  if (DMXDue(port)) {
+    if (dmx_queue->size) {
+      return dmx_queue;
+    }
+    if (port->refresh) {
+      *use_refresh = true;
+      return NULL;
+    }
+  }
+
+  if (dmx_queue->size && (!rdm_queue->size || port->dmx_turn)) {
+    return dmx_queue;
+  }
+  return rdm_queue->size ? rdm_queue : NULL;
+}
+
+/*
+ * @brief Check if there is a controller frame ready to send.
+ */
+static inline bool ControllerFrameReady(TransceiverPort *port) {
+  bool use_refresh;
+  return NextControllerQueue(port, &use_refresh) || use_refresh;
+}
+
+/*
+ * @brief Take a buffer and append it to a TX queue.
+ * @param queue The queue to append to.
+ * @param data The slot data that will be queued, may be NULL.
+ * @returns The buffer, or NULL if the queue is full.
+ *
+ * If data is the slot data of the loaned buffer, the loaned buffer is used,
+ * otherwise a buffer is taken from the free list.
+ */
+static TransceiverBuffer* EnqueueBuffer(TransceiverPort *port, TXQueue *queue,
+                                        const uint8_t *data) {
+  if (queue->size == TRANSCEIVER_TX_QUEUE_SIZE) {
+    return NULL;
+  }
+
+  TransceiverBuffer *buffer;
+  if (port->loan && data == &port->loan->data[1]) {
+    buffer = port->loan;
+    port->loan = NULL;
+  } else if (port->free_size) {
+    port->free_size--;
+    buffer = port->free_list[port->free_size];
+  } else {
+    return NULL;
+  }
+  queue->buffers[(queue->head + queue->size) % TRANSCEIVER_TX_QUEUE_SIZE] =
+      buffer;
+  queue->size++;
+  return buffer;
+}
+
+/*
+ * @brief Move the buffer at the head of a TX queue to the active buffer.
+ * @param queue The queue to take the buffer from.
+ */
+static void TakeNextBuffer(TransceiverPort *port, TXQueue *queue) {
+  FreeActiveBuffer(port);
+  if (queue->size) {
+    port->active = queue->buffers[queue->head];
+    queue->head = (queue->head + 1u) % TRANSCEIVER_TX_QUEUE_SIZE;
+    queue->size--;
+  }
+  port->data_index = 0u;
+}
+
+/*
+ * @brief Update the TX frame rate if the measurement interval has passed.
+ */
+static inline void UpdateFrameRate(TransceiverPort *port) {
+  if (CoarseTimer_HasElapsed(port->frame_rate_start,
+                             FRAME_RATE_INTERVAL)) {
+    port->frame_rate = port->frame_count;
+    port->frame_count = 0u;
+    port->frame_rate_start = CoarseTimer_GetTime();
+  }
+}
+
+/*
+ * @brief Reset the TX frame rate counters.
+ */
+static void ResetFrameRate(TransceiverPort *port) {
+  port->frame_rate_start = CoarseTimer_GetTime();
+  port->frame_count = 0u;
+  port->frame_rate = 0u;
+}
+
+/*
+ * @brief Record the turnaround time for an RDM response.
+ * @param turnaround The time from the end of the request until the response
+ *   was ready, in 10ths of a microsecond.
+ *
+ * This is called from the UART ISR for fast path DUB responses, so it needs to
+ * be fast.
+ */
+static inline void RecordTurnaround(TransceiverPort *port,
+                                    uint16_t turnaround) {
+  if (port->turnaround.count == 0u || turnaround < port->turnaround.min) {
+    port->turnaround.min = turnaround;
+  }
+  if (turnaround > port->turnaround.max) {
+    port->turnaround.max = turnaround;
+  }
+  port->turnaround.count++;
+  port->turnaround_total += turnaround;
+
+  unsigned int bucket = turnaround / RESPONDER_TURNAROUND_BUCKET_WIDTH;
+  if (bucket >= TRANSCEIVER_TURNAROUND_BUCKETS) {
+    bucket = TRANSCEIVER_TURNAROUND_BUCKETS - 1u;
+  }
+  port->turnaround.histogram[bucket]++;
+}
+
+#ifdef TRANSCEIVER_DMA
+enum { PORT_INTERRUPT_SOURCE_COUNT = 6u };
+#else
+enum { PORT_INTERRUPT_SOURCE_COUNT = 5u };
+#endif
+
+/*
+ * @brief Populate the interrupt sources used by a port.
+ */
+static inline void GetPortInterruptSources(
+    TransceiverPort *port, INT_SOURCE sources[PORT_INTERRUPT_SOURCE_COUNT]) {
+  sources[0] = HW_USART_TX_SOURCE(port);
+  sources[1] = HW_USART_RX_SOURCE(port);
+  sources[2] = HW_USART_ERROR_SOURCE(port);
+  sources[3] = HW_INPUT_CAPTURE_SOURCE(port);
+  sources[4] = HW_TIMER_SOURCE(port);
+#ifdef TRANSCEIVER_DMA
+  sources[5] = HW_DMA_SOURCE(port);
+#endif
+}
+
+/*
+ * @brief Stop the ISRs for a port from running.
+ * @returns A bit mask of the sources that were enabled, to pass to
+ *   RestorePortInterrupts().
+ *
+ * The ISRs enable and disable each other's sources, so all of them are
+ * masked, otherwise restoring one could undo a change made by another.
+ */
+static uint8_t DisablePortInterrupts(TransceiverPort *port) {
+  INT_SOURCE sources[PORT_INTERRUPT_SOURCE_COUNT];
+  GetPortInterruptSources(port, sources);
+  uint8_t enabled = 0u;
+  unsigned int i = 0u;
+  for (; i < PORT_INTERRUPT_SOURCE_COUNT; i++) {
+    if (SYS_INT_SourceDisable(sources[i])) {
+      enabled |= 1u << i;
+    }
+  }
+  return enabled;
+}
+
+/*
+ * @brief Re-enable the sources disabled by DisablePortInterrupts().
+ */
+static void RestorePortInterrupts(TransceiverPort *port, uint8_t enabled) {
+  INT_SOURCE sources[PORT_INTERRUPT_SOURCE_COUNT];
+  GetPortInterruptSources(port, sources);
+  unsigned int i = 0u;
+  for (; i < PORT_INTERRUPT_SOURCE_COUNT; i++) {
+    if (enabled & (1u << i)) {
+      SYS_INT_SourceEnable(sources[i]);
+    }
   }
 }
 
 /*
- * @brief Move the next buffer to the active buffer.
+ * @brief Record the line time used by the active controller frame.
+ *
+ * The line time runs from the start of the break to the end of the backoff
+ * period, when the next frame may start.
  */
-static void TakeNextBuffer() {
-  if (g_transceiver.active) {
-    g_transceiver.free_list[g_transceiver.free_size] = g_transceiver.active;
-    g_transceiver.free_size++;
+static inline void RecordLineTime(TransceiverPort *port) {
+  uint32_t line_time = CoarseTimer_ElapsedTime(port->tx_frame_start);
+  if (port->active->op == OP_TX_ONLY) {
+    port->line_stats.dmx_frames++;
+    port->line_stats.dmx_time += line_time;
+  } else {
+    port->line_stats.rdm_frames++;
+    port->line_stats.rdm_time += line_time;
   }
-  g_transceiver.active = g_transceiver.next;
-  g_transceiver.next = NULL;
-  g_transceiver.data_index = 0u;
 }
 
 // Event Handler functions
 // ----------------------------------------------------------------------------
-static inline void RunTXEventHandler(TransceiverEvent *event) {
+static inline void RunTXEventHandler(TransceiverPort *port,
+                                     TransceiverEvent *event) {
   if (event->token < 0) {
     return;
   }
@@ -424,18 +1160,19 @@ static inline void RunTXEventHandler(TransceiverEvent *event) {
 #ifdef PIPELINE_TRANSCEIVER_TX_EVENT
   PIPELINE_TRANSCEIVER_TX_EVENT(event);
 #else
-  if (g_tx_callback) {
-    g_tx_callback(event);
+  if (port->tx_callback) {
+    port->tx_callback(event);
   }
 #endif
 }
 
-static inline void RunRXEventHandler(TransceiverEvent *event) {
+static inline void RunRXEventHandler(TransceiverPort *port,
+                                     TransceiverEvent *event) {
 #ifdef PIPELINE_TRANSCEIVER_RX_EVENT
   PIPELINE_TRANSCEIVER_RX_EVENT(event);
 #else
-  if (g_rx_callback) {
-    g_rx_callback(event);
+  if (port->rx_callback) {
+    port->rx_callback(event);
   }
 #endif
 }
@@ -443,256 +1180,463 @@ static inline void RunRXEventHandler(TransceiverEvent *event) {
 /*
  * @brief Run the completion callback.
  */
-static inline void FrameComplete() {
+static inline void FrameComplete(TransceiverPort *port) {
   const uint8_t* data = NULL;
   unsigned int length = 0u;
-  if (g_transceiver.active->op != OP_TX_ONLY &&
-      g_transceiver.data_index != 0u) {
+  if (port->active->op != OP_TX_ONLY &&
+      port->data_index != 0u) {
     // We actually got some data.
-    data = g_transceiver.active->data;
-    length = g_transceiver.data_index;
-    g_transceiver.result = T_RESULT_RX_DATA;
+    data = port->active->data;
+    length = port->data_index;
+    port->result = T_RESULT_RX_DATA;
   }
 
   TransceiverEvent event = {
-    g_transceiver.active->token,
-    (TransceiverOperation) g_transceiver.active->op,
-    g_transceiver.result,
+    port->active->token,
+    (TransceiverOperation) port->active->op,
+    port->result,
     data,
     length,
-    &g_timing
+    &port->timing,
+    port->id
   };
-  RunTXEventHandler(&event);
+  RunTXEventHandler(port, &event);
 }
 
 /*
  * @brief Run the RX callback.
+ * @param buffer The buffer holding the frame.
+ * @param length The number of slots received so far.
+ * @param timing The break and mark timing for the frame.
  */
-static inline void RXFrameEvent() {
+static inline void RXFrameEvent(TransceiverPort *port,
+                                const TransceiverBuffer *buffer,
+                                uint16_t length,
+                                TransceiverTiming *timing) {
   TransceiverEvent event = {
     0u,
     T_OP_RX,
-    g_transceiver.event_index == 0u ? T_RESULT_RX_START_FRAME :
+    port->event_index == 0u ? T_RESULT_RX_START_FRAME :
         T_RESULT_RX_CONTINUE_FRAME,
-    g_transceiver.active->data,
-    g_transceiver.data_index,
-    &g_timing
+    buffer->data,
+    length,
+    timing,
+    port->id
   };
-  RunRXEventHandler(&event);
+  RunRXEventHandler(port, &event);
+}
+
+/*
+ * @brief Deliver the rest of the frame the ISR published.
+ *
+ * The ISR is receiving into the other buffer, so this runs with the UART
+ * interrupts enabled. Any RDM response queued for the frame is dropped, since
+ * the next frame has already started. Once done, the buffer becomes the spare
+ * again.
+ */
+static void DeliverCompleteFrame(TransceiverPort *port) {
+  TransceiverBuffer *buffer = port->rx_complete;
+  if (!buffer) {
+    return;
+  }
+
+  if (port->event_index != port->rx_complete_length) {
+    RXFrameEvent(port, buffer, port->rx_complete_length,
+                 &port->rx_complete_timing);
+  }
+  DropRDMResponse(port);
+  port->event_index = 0u;
+  port->rx_spare = buffer;
+  // This must be last, the ISR can publish the active buffer from here on.
+  port->rx_complete = NULL;
 }
 
 /*
  * @brief Run the RX callback with an end-of-frame event.
  */
-static inline void RXEndFrameEvent() {
+static inline void RXEndFrameEvent(TransceiverPort *port) {
   TransceiverEvent event = {
     0u,
     T_OP_RX,
     T_RESULT_RX_FRAME_TIMEOUT,
-    g_transceiver.active->data,
-    g_transceiver.data_index,
-    &g_timing
+    port->active->data,
+    port->data_index,
+    &port->timing,
+    port->id
   };
-  RunRXEventHandler(&event);
+  RunRXEventHandler(port, &event);
 }
 
 // Operating Mode management
 // ----------------------------------------------------------------------------
-static void SwitchMode() {
-  g_transceiver.mode = g_transceiver.desired_mode;
-  switch (g_transceiver.mode) {
+/*
+ * @brief Run the cancelled event for each buffer in a TX queue.
+ * @param queue The queue to cancel.
+ */
+static void CancelQueue(TransceiverPort *port, const TXQueue *queue) {
+  unsigned int i = 0u;
+  for (; i < queue->size; i++) {
+    const TransceiverBuffer *buffer = queue->buffers[
+        (queue->head + i) % TRANSCEIVER_TX_QUEUE_SIZE];
+    TransceiverEvent event = {
+      buffer->token,
+      (TransceiverOperation) buffer->op,
+      T_RESULT_CANCELLED,
+      NULL,
+      0,
+      &port->timing,
+      port->id
+    };
+    RunTXEventHandler(port, &event);
+  }
+}
+
+/*
+ * @brief Run the cancelled event for the frame in progress, if any.
+ *
+ * Only frames sent by the controller or self-test modes have a pending
+ * event; responder mode never notifies the sender.
+ */
+static void CancelActive(TransceiverPort *port) {
+  switch (port->state) {
+    case STATE_C_IN_BREAK:
+    case STATE_C_IN_MARK:
+    case STATE_C_TX_DATA:
+    case STATE_C_TX_DRAIN:
+    case STATE_C_RX_WAIT_FOR_BREAK:
+    case STATE_C_RX_IN_BREAK:
+    case STATE_C_RX_IN_MARK:
+    case STATE_C_RX_DATA:
+    case STATE_C_RX_WAIT_FOR_DUB:
+    case STATE_C_RX_IN_DUB:
+    case STATE_C_RX_TIMEOUT:
+    case STATE_C_COMPLETE:
+    case STATE_T_RX_WAIT:
+    case STATE_T_VERIFY:
+      break;
+    default:
+      return;
+  }
+
+  TransceiverEvent event = {
+    port->active->token,
+    (TransceiverOperation) port->active->op,
+    T_RESULT_CANCELLED,
+    NULL,
+    0,
+    &port->timing,
+    port->id
+  };
+  RunTXEventHandler(port, &event);
+}
+
+static void SwitchMode(TransceiverPort *port) {
+  port->mode = port->desired_mode;
+  switch (port->mode) {
     case T_MODE_CONTROLLER:
       SysLog_Message(SYSLOG_INFO, "Changed to Controller mode");
-      g_transceiver.state = STATE_C_INITIALIZE;
+      port->state = STATE_C_INITIALIZE;
       break;
     case T_MODE_RESPONDER:
       SysLog_Message(SYSLOG_INFO, "Changed to Responder mode");
-      g_transceiver.state = STATE_R_INITIALIZE;
+      port->state = STATE_R_INITIALIZE;
       break;
     case T_MODE_SELF_TEST:
       SysLog_Message(SYSLOG_INFO, "Changed to self-test mode");
-      g_transceiver.state = STATE_T_INITIALIZE;
+      port->state = STATE_T_INITIALIZE;
       break;
     default:
       SysLog_Print(SYSLOG_INFO, "Unknown mode: %d",
-                   g_transceiver.desired_mode);
+                   port->desired_mode);
       return;
   }
   // Reset in case there were any pending commands
-  if (g_transceiver.next) {
+  CancelQueue(port, &port->dmx_queue);
+  CancelQueue(port, &port->rdm_queue);
+  InitializeBuffers(port);
+  ResetFrameRate(port);
+  if (port->mode_change_token != TRANSCEIVER_NO_NOTIFICATION) {
     TransceiverEvent event = {
-      g_transceiver.next->token,
-      (TransceiverOperation) g_transceiver.next->op,
-      T_RESULT_CANCELLED,
-      NULL,
-      0,
-      &g_timing
-    };
-    RunTXEventHandler(&event);
-  }
-  InitializeBuffers();
-  if (g_transceiver.mode_change_token != TRANSCEIVER_NO_NOTIFICATION) {
-    TransceiverEvent event = {
-      g_transceiver.mode_change_token,
+      port->mode_change_token,
       T_OP_MODE_CHANGE,
       T_RESULT_OK,
-      NULL, 0, NULL
+      NULL, 0, NULL, port->id
     };
-    RunTXEventHandler(&event);
-    g_transceiver.mode_change_token = TRANSCEIVER_NO_NOTIFICATION;
+    RunTXEventHandler(port, &event);
+    port->mode_change_token = TRANSCEIVER_NO_NOTIFICATION;
   }
 }
 
 // ----------------------------------------------------------------------------
-static inline void PrepareRDMResponse() {
+/*
+ * @brief Start the responder delay for the response in the active buffer.
+ */
+static inline void ScheduleRDMResponse(TransceiverPort *port) {
   // Rebase the timer to when the last byte was received
-  RebaseTimer(g_transceiver.last_byte);
+  RebaseTimer(port, port->last_byte);
 
-  g_transceiver.state = STATE_R_TX_WAITING;
-  PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-  PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
-                                            USART_TRANSMIT_FIFO_EMPTY);
+  // The counter is now the time taken to prepare the response.
+  RecordTurnaround(
+      port,
+      CoarseTimer_HasElapsed(port->last_byte_coarse, TURNAROUND_TIMER_LIMIT) ?
+      UINT16_MAX : PLIB_TMR_Counter16BitGet(HW_TIMER_MODULE_ID(port)));
 
-  TakeNextBuffer();
+  port->state = STATE_R_TX_WAITING;
+  PLIB_USART_ReceiverDisable(HW_USART(port));
+  PLIB_USART_TransmitterInterruptModeSelect(HW_USART(port),
+                                            USART_TRANSMIT_FIFO_EMPTY);
 
   // Enable the timer to trigger when we send the RDM response.
   unsigned int jitter = 0u;
-  if (g_timing_settings.rdm_responder_jitter) {
-    jitter = Random_PseudoGet() % g_timing_settings.rdm_responder_jitter;
+  if (port->settings.rdm_responder_jitter) {
+    jitter = Random_PseudoGet() % port->settings.rdm_responder_jitter;
   }
+  uint16_t delay = port->settings.rdm_responder_delay -
+                   RESPONSE_FUDGE_FACTOR + jitter;
   // It's important to stop the timer before changing the period, see 14.3.11
-  PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-  PLIB_TMR_Period16BitSet(
-      g_hw_settings.timer_module_id,
-      g_timing_settings.rdm_responder_delay - RESPONSE_FUDGE_FACTOR + jitter);
-  PLIB_TMR_Start(g_hw_settings.timer_module_id);
-  SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
-  SYS_INT_SourceEnable(g_hw_settings.timer_source);
-}
-
-static inline void StartSendingRDMResponse() {
-  PLIB_USART_TransmitterEnable(g_hw_settings.usart);
-  if (!PLIB_USART_TransmitterBufferIsFull(g_hw_settings.usart) &&
-       g_transceiver.data_index != g_transceiver.active->size) {
-    PLIB_USART_TransmitterByteSend(
-        g_hw_settings.usart,
-        g_transceiver.active->data[g_transceiver.data_index]);
-    g_transceiver.data_index++;
+  PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+  PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port), delay);
+  PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
+  SYS_INT_SourceStatusClear(HW_TIMER_SOURCE(port));
+  SYS_INT_SourceEnable(HW_TIMER_SOURCE(port));
+}
+
+static inline void PrepareRDMResponse(TransceiverPort *port) {
+  TakeNextBuffer(port, &port->rdm_queue);
+  ScheduleRDMResponse(port);
+}
+
+/*
+ * @brief Answer the DUB request in the active buffer from the ISR.
+ *
+ * The request is published like any other complete frame, so the RX handler
+ * still sees it, and counts it. The handler can't queue a response for a
+ * published frame, so only this one is sent. If the handler is still busy
+ * with the last frame, the request is dropped as an overrun and its buffer is
+ * reused once the response completes.
+ */
+static inline void SendFastPathDUBResponse(TransceiverPort *port) {
+  SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+  TransceiverBuffer *buffer = port->dub_buffer;
+  memcpy(buffer->data, port->dub_response, DUB_RESPONSE_LENGTH);
+  buffer->size = DUB_RESPONSE_LENGTH;
+  buffer->op = OP_RDM_DUB_RESPONSE;
+  if (port->rx_complete) {
+    port->rx_overruns++;
+    port->dub_rx_buffer = port->active;
+  } else {
+    port->rx_complete = port->active;
+    port->rx_complete_length = port->data_index;
+    port->rx_complete_timing = port->timing;
+    port->dub_rx_buffer = port->rx_spare;
+    port->rx_spare = NULL;
   }
-  g_transceiver.state = STATE_R_TX_DATA;
+  port->active = buffer;
+  port->data_index = 0u;
+  ScheduleRDMResponse(port);
+}
 
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-  SYS_INT_SourceEnable(g_hw_settings.usart_tx_source);
+static inline void StartSendingRDMResponse(TransceiverPort *port) {
+  PLIB_USART_TransmitterEnable(HW_USART(port));
+  if (!PLIB_USART_TransmitterBufferIsFull(HW_USART(port)) &&
+       port->data_index != port->active->size) {
+    PLIB_USART_TransmitterByteSend(
+        HW_USART(port),
+        port->active->data[port->data_index]);
+    port->data_index++;
+  }
+  port->state = STATE_R_TX_DATA;
+  StartTXData(port);
 }
 
-static inline void LogStateChange() {
-  static TransceiverState last_state = STATE_RESET;
+/*
+ * @brief Start sending the next controller frame.
+ *
+ * The frame is chosen by NextControllerQueue(), this may be the held DMX frame.
+ *
+ * @pre Timer is not running.
+ * @pre UART is disabled
+ * @pre TX is enabled.
+ * @pre RX is disabled.
+ * @pre RX InputCapture is disabled.
+ * @pre line in marking state
+ */
+static void StartControllerFrame(TransceiverPort *port) {
+  bool use_refresh;
+  TXQueue *queue = NextControllerQueue(port, &use_refresh);
+  if (queue) {
+    TakeNextBuffer(port, queue);
+  } else {
+    port->active = port->refresh;
+    // The original sender has already been notified.
+    port->active->token = TRANSCEIVER_NO_NOTIFICATION;
+    port->data_index = 0u;
+  }
+  port->dmx_turn = port->active->op != OP_TX_ONLY;
 
-  if (g_transceiver.state != last_state) {
-    SysLog_Print(SYSLOG_DEBUG, "Changed to %d", g_transceiver.state);
-    last_state = g_transceiver.state;
+  // Reset state
+  port->found_expected_length = false;
+  port->expected_length = 0u;
+  port->result = T_RESULT_OK;
+  memset(&port->timing, 0, sizeof(port->timing));
+
+  // Prepare the UART
+  // Set UART Interrupts when the buffer is empty.
+  PLIB_USART_TransmitterInterruptModeSelect(HW_USART(port),
+                                            USART_TRANSMIT_FIFO_EMPTY);
+
+  // Set break and start timer.
+  port->state = STATE_C_IN_BREAK;
+  PLIB_TMR_PrescaleSelect(HW_TIMER_MODULE_ID(port),
+                          TMR_PRESCALE_VALUE_1);
+  port->tx_frame_start = CoarseTimer_GetTime();
+  if (port->active->op == OP_TX_ONLY &&
+      port->active->data[0] == NULL_START_CODE) {
+    port->dmx_frame_start = port->tx_frame_start;
+    port->dmx_started = true;
+  }
+  PLIB_TMR_Counter16BitClear(HW_TIMER_MODULE_ID(port));
+  PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port),
+                          port->settings.break_ticks);
+  SYS_INT_SourceStatusClear(HW_TIMER_SOURCE(port));
+  SYS_INT_SourceEnable(HW_TIMER_SOURCE(port));
+  SetBreak(port);
+  PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
+}
+
+static inline void LogStateChange(TransceiverPort *port) {
+  if (port->state != port->logged_state) {
+    SysLog_Event(SYSLOG_DEBUG, "Port %d changed to %d", port->id, port->state);
+    port->logged_state = port->state;
   }
 }
 
 /*
  * @brief Reset the settings to their default values.
  */
-static void ResetTimingSettings() {
-  Transceiver_SetBreakTime(DEFAULT_BREAK_TIME);
-  Transceiver_SetMarkTime(DEFAULT_MARK_TIME);
-  Transceiver_SetRDMBroadcastTimeout(DEFAULT_RDM_BROADCAST_TIMEOUT);
-  Transceiver_SetRDMResponseTimeout(DEFAULT_RDM_RESPONSE_TIMEOUT);
-  Transceiver_SetRDMDUBResponseLimit(DEFAULT_RDM_DUB_RESPONSE_LIMIT);
-  Transceiver_SetRDMResponderDelay(DEFAULT_RDM_RESPONDER_DELAY);
-  Transceiver_SetRDMResponderJitter(0u);
+static void ResetTimingSettings(TransceiverPort *port) {
+  Transceiver_SetBreakTime(port->id, DEFAULT_BREAK_TIME);
+  Transceiver_SetMarkTime(port->id, DEFAULT_MARK_TIME);
+  Transceiver_SetRDMBroadcastTimeout(port->id, DEFAULT_RDM_BROADCAST_TIMEOUT);
+  Transceiver_SetRDMResponseTimeout(port->id, DEFAULT_RDM_RESPONSE_TIMEOUT);
+  Transceiver_SetRDMDUBResponseLimit(port->id, DEFAULT_RDM_DUB_RESPONSE_LIMIT);
+  Transceiver_SetRDMResponderDelay(port->id, DEFAULT_RDM_RESPONDER_DELAY);
+  Transceiver_SetRDMResponderJitter(port->id, 0u);
+  Transceiver_SetDMXRefreshInterval(port->id, DEFAULT_DMX_REFRESH_INTERVAL);
 }
 
 // Interrupt Handlers
 // ----------------------------------------------------------------------------
+/*
+ * @brief Restart the input capture from the next edge of the given type.
+ *
+ * The capture runs in every edge mode, which doesn't report the edge type, so
+ * the responder states rely on the edges alternating. This discards any
+ * captured edges and lines the capture back up with the state machine.
+ */
+static inline void RestartInputCapture(TransceiverPort *port,
+                                       IC_EDGE_TYPES edge) {
+  PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+  PLIB_IC_FirstCaptureEdgeSelect(HW_INPUT_CAPTURE_MODULE(port), edge);
+  PLIB_IC_Enable(HW_INPUT_CAPTURE_MODULE(port));
+}
+
+// The handlers are shared by the ports, each port has its own set of ISRs
+// below.
 /*
  * @brief Called when an input capture event occurs.
  */
-void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_IC), ipl6AUTO)
-    InputCaptureEvent(void) {
-  while (!PLIB_IC_BufferIsEmpty(g_hw_settings.input_capture_module)) {
-    uint16_t value = PLIB_IC_Buffer16BitGet(g_hw_settings.input_capture_module);
-    switch (g_transceiver.state) {
+static inline void InputCaptureHandler(TransceiverPort *port) {
+  while (!PLIB_IC_BufferIsEmpty(HW_INPUT_CAPTURE_MODULE(port))) {
+    uint16_t value = PLIB_IC_Buffer16BitGet(HW_INPUT_CAPTURE_MODULE(port));
+    switch (port->state) {
       case STATE_C_RX_WAIT_FOR_DUB:
-        g_timing.dub_response.start = value;
-        g_transceiver.state = STATE_C_RX_IN_DUB;
+        port->timing.dub_response.start = value;
+        port->state = STATE_C_RX_IN_DUB;
         break;
       case STATE_C_RX_IN_DUB:
-        g_timing.dub_response.end = value;
+        port->timing.dub_response.end = value;
         break;
       case STATE_C_RX_WAIT_FOR_BREAK:
-        g_timing.get_set_response.break_start = value;
-        g_transceiver.state = STATE_C_RX_IN_BREAK;
+        port->timing.get_set_response.break_start = value;
+        port->state = STATE_C_RX_IN_BREAK;
         break;
       case STATE_C_RX_IN_BREAK:
-        if ((uint16_t) (value - g_timing.get_set_response.break_start) <
+        if ((uint16_t) (value - port->timing.get_set_response.break_start) <
             CONTROLLER_RX_BREAK_TIME_MIN) {
           // The break was too short, keep looking for a break
-          g_timing.get_set_response.break_start = value;
-          g_transceiver.state = STATE_C_RX_WAIT_FOR_BREAK;
+          port->timing.get_set_response.break_start = value;
+          port->state = STATE_C_RX_WAIT_FOR_BREAK;
+        } else if ((uint16_t) (value -
+                               port->timing.get_set_response.break_start) >
+                   CONTROLLER_RX_BREAK_TIME_MAX) {
+          // The break was too long. This is also checked in the tasks
+          // function, but that may not run before the break ends.
+          SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+          PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+          port->result = T_RESULT_RX_INVALID;
+          PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+          ResetToMark(port);
+          port->state = STATE_C_COMPLETE;
         } else {
-          g_timing.get_set_response.mark_start = value;
+          port->timing.get_set_response.mark_start = value;
           // Break was good, enable UART
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_error_source);
-          PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-          g_transceiver.state = STATE_C_RX_IN_MARK;
+          StartRXData(port);
+          SYS_INT_SourceStatusClear(HW_USART_ERROR_SOURCE(port));
+          SYS_INT_SourceEnable(HW_USART_ERROR_SOURCE(port));
+          PLIB_USART_ReceiverEnable(HW_USART(port));
+          port->state = STATE_C_RX_IN_MARK;
         }
         break;
       case STATE_C_RX_IN_MARK:
-        g_timing.get_set_response.mark_end = value;
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        g_transceiver.state = STATE_C_RX_DATA;
+        port->timing.get_set_response.mark_end = value;
+        SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+        PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+        port->state = STATE_C_RX_DATA;
         break;
 
       case STATE_R_RX_MBB:
         // Rebase the timer to when the falling edge occured.
-        RebaseTimer(value);
-        g_transceiver.state = STATE_R_RX_BREAK;
+        RebaseTimer(port, value);
+        port->state = STATE_R_RX_BREAK;
         break;
       case STATE_R_RX_BREAK:
         if (value >= RESPONDER_RX_BREAK_TIME_MIN &&
             value <= RESPONDER_RX_BREAK_TIME_MAX) {
           // Break was good, enable UART
-          g_timing.request.break_time = value;
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-          PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-          g_transceiver.state = STATE_R_RX_MARK;
+          port->timing.request.break_time = value;
+          SYS_INT_SourceStatusClear(HW_USART_RX_SOURCE(port));
+          SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
+          PLIB_USART_ReceiverEnable(HW_USART(port));
+          port->state = STATE_R_RX_MARK;
         } else {
           // Break was out of range.
-          g_transceiver.state = STATE_R_RX_MBB;
+          port->state = STATE_R_RX_MBB;
         }
         break;
       case STATE_R_RX_MARK:
-        if ((uint16_t) (value - g_timing.request.break_time) <
+        if ((uint16_t) (value - port->timing.request.break_time) <
               RESPONDER_RX_MARK_TIME_MIN ||
-            (uint16_t) (value - g_timing.request.break_time) >
+            (uint16_t) (value - port->timing.request.break_time) >
               RESPONDER_RX_MARK_TIME_MAX) {
           // Mark was out of range, rebase timer & switch back to BREAK
-          RebaseTimer(value);
+          RebaseTimer(port, value);
 
           // Disable UART
-          PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-          SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          g_transceiver.state = STATE_R_RX_BREAK;
+          PLIB_USART_ReceiverDisable(HW_USART(port));
+          SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+          SYS_INT_SourceStatusClear(HW_USART_RX_SOURCE(port));
+          port->state = STATE_R_RX_BREAK;
         } else {
-          g_timing.request.mark_time = value - g_timing.request.break_time;
-          g_transceiver.state = STATE_R_RX_DATA;
+          port->timing.request.mark_time =
+              value - port->timing.request.break_time;
+          port->state = STATE_R_RX_DATA;
         }
-        g_transceiver.last_change = value;
+        port->last_change = value;
         break;
 
       case STATE_R_RX_DATA:
-        g_transceiver.last_change = value;
+        port->last_change = value;
         break;
 
       case STATE_C_INITIALIZE:
@@ -723,72 +1667,70 @@ void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_IC), ipl6AUTO)
         {};
     }
   }
-  SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
+  SYS_INT_SourceStatusClear(HW_INPUT_CAPTURE_SOURCE(port));
 }
 
 /*
  * @brief Called when the timer expires.
  */
-void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6AUTO)
-    Transceiver_TimerEvent() {
-  switch (g_transceiver.state) {
+static inline void TimerHandler(TransceiverPort *port) {
+  switch (port->state) {
     case STATE_C_IN_BREAK:
     case STATE_R_TX_BREAK:
       // Transition to MAB.
-      SetMark();
-      g_transceiver.state = g_transceiver.state == STATE_C_IN_BREAK ?
+      SetMark(port);
+      port->state = port->state == STATE_C_IN_BREAK ?
           STATE_C_IN_MARK : STATE_R_TX_MARK;
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id,
-                              g_timing_settings.mark_ticks);
+      PLIB_TMR_Counter16BitClear(HW_TIMER_MODULE_ID(port));
+      PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port),
+                              port->settings.mark_ticks);
       break;
     case STATE_C_IN_MARK:
       // Stop the timer.
-      SYS_INT_SourceDisable(g_hw_settings.timer_source);
-      PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+      SYS_INT_SourceDisable(HW_TIMER_SOURCE(port));
+      PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
 
       // Transition to sending the data.
       // Only push a single byte into the TX queue at the beginning, otherwise
       // we blow our timing budget.
-      if (!PLIB_USART_TransmitterBufferIsFull(g_hw_settings.usart) &&
-          g_transceiver.data_index != g_transceiver.active->size) {
+      if (!PLIB_USART_TransmitterBufferIsFull(HW_USART(port)) &&
+          port->data_index != port->active->size) {
         PLIB_USART_TransmitterByteSend(
-            g_hw_settings.usart,
-            g_transceiver.active->data[g_transceiver.data_index]);
-        g_transceiver.data_index++;
+            HW_USART(port),
+            port->active->data[port->data_index]);
+        port->data_index++;
       }
-      PLIB_USART_Enable(g_hw_settings.usart);
-      PLIB_USART_TransmitterEnable(g_hw_settings.usart);
-      g_transceiver.state = STATE_C_TX_DATA;
-      SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-      SYS_INT_SourceEnable(g_hw_settings.usart_tx_source);
+      PLIB_USART_Enable(HW_USART(port));
+      PLIB_USART_TransmitterEnable(HW_USART(port));
+      port->state = STATE_C_TX_DATA;
+      StartTXData(port);
       break;
     case STATE_R_TX_WAITING:
-      EnableTX();
+      EnableTX(port);
 
-      if (g_transceiver.active->op == OP_RDM_WITH_RESPONSE) {
-        SetBreak();
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      if (port->active->op == OP_RDM_WITH_RESPONSE) {
+        SetBreak(port);
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        PLIB_TMR_PrescaleSelect(HW_TIMER_MODULE_ID(port),
                                 TMR_PRESCALE_VALUE_1);
-        PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
-        PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id,
-                                g_timing_settings.break_ticks);
-        PLIB_TMR_Start(g_hw_settings.timer_module_id);
-        g_transceiver.state = STATE_R_TX_BREAK;
+        PLIB_TMR_Counter16BitClear(HW_TIMER_MODULE_ID(port));
+        PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port),
+                                port->settings.break_ticks);
+        PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
+        port->state = STATE_R_TX_BREAK;
       } else {
-        SYS_INT_SourceDisable(g_hw_settings.timer_source);
-        StartSendingRDMResponse();
+        SYS_INT_SourceDisable(HW_TIMER_SOURCE(port));
+        StartSendingRDMResponse(port);
       }
       break;
     case STATE_R_TX_MARK:
-      SYS_INT_SourceDisable(g_hw_settings.timer_source);
-      PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      SYS_INT_SourceDisable(HW_TIMER_SOURCE(port));
+      PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+      PLIB_TMR_PrescaleSelect(HW_TIMER_MODULE_ID(port),
                               TMR_PRESCALE_VALUE_8);
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
 
-      StartSendingRDMResponse();
+      StartSendingRDMResponse(port);
       break;
     case STATE_C_INITIALIZE:
     case STATE_C_TX_READY:
@@ -821,7 +1763,7 @@ void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6AUTO)
       // Should never happen
       {}
   }
-  SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
+  SYS_INT_SourceStatusClear(HW_TIMER_SOURCE(port));
 }
 
 /*
@@ -832,169 +1774,174 @@ void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6AUTO)
  *  - The USART RX buffer has data.
  *  - A USART RX error has occurred.
  */
-void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6AUTO)
-    Transceiver_UARTEvent() {
+static inline void UARTHandler(TransceiverPort *port) {
   // TX
-  if (SYS_INT_SourceStatusGet(g_hw_settings.usart_tx_source)) {
-    if (g_transceiver.state == STATE_C_TX_DATA) {
-      UART_TXBytes();
-      if (g_transceiver.data_index == g_transceiver.active->size) {
+  if (SYS_INT_SourceStatusGet(HW_USART_TX_SOURCE(port))) {
+    if (port->state == STATE_C_TX_DATA) {
+      UART_TXBytes(port);
+      if (port->data_index == port->active->size) {
         PLIB_USART_TransmitterInterruptModeSelect(
-            g_hw_settings.usart, USART_TRANSMIT_FIFO_IDLE);
-        g_transceiver.state = STATE_C_TX_DRAIN;
+            HW_USART(port), USART_TRANSMIT_FIFO_IDLE);
+        port->state = STATE_C_TX_DRAIN;
       }
-    } else if (g_transceiver.state == STATE_C_TX_DRAIN) {
+    } else if (port->state == STATE_C_TX_DRAIN) {
       // The last byte has been transmitted. This event occurs around 1.5us
       // after the actual UART event, so we use a fudge factor.
-      PLIB_TMR_Counter16BitSet(g_hw_settings.timer_module_id,
+      PLIB_TMR_Counter16BitSet(HW_TIMER_MODULE_ID(port),
                                RESPONSE_TIME_RX_FUDGE_FACTOR);
       // 6.5 ms until overflow.
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id, 65535u);
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port), 65535u);
+      PLIB_TMR_PrescaleSelect(HW_TIMER_MODULE_ID(port),
                               TMR_PRESCALE_VALUE_8);
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
 
-      g_transceiver.tx_frame_end = CoarseTimer_GetTime();
-      SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
+      port->tx_frame_end = CoarseTimer_GetTime();
+      SYS_INT_SourceDisable(HW_USART_TX_SOURCE(port));
+      PLIB_USART_TransmitterDisable(HW_USART(port));
 
-      if (g_transceiver.active->op == OP_TX_ONLY) {
-        PLIB_USART_Disable(g_hw_settings.usart);
-        SetMark();
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        g_transceiver.state = STATE_C_COMPLETE;
+      if (port->active->op == OP_TX_ONLY) {
+        PLIB_USART_Disable(HW_USART(port));
+        SetMark(port);
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        port->state = STATE_C_COMPLETE;
       } else {
         // Switch to RX Mode.
-        if (g_transceiver.active->op == OP_RDM_DUB) {
-          g_transceiver.state = STATE_C_RX_WAIT_FOR_DUB;
-          g_transceiver.data_index = 0u;
+        if (port->active->op == OP_RDM_DUB) {
+          port->state = STATE_C_RX_WAIT_FOR_DUB;
+          port->data_index = 0u;
 
           // Turn around the line
-          EnableRX();
-          UART_FlushRX();
+          EnableRX(port);
+          UART_FlushRX(port);
 
-          PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
+          PLIB_IC_FirstCaptureEdgeSelect(HW_INPUT_CAPTURE_MODULE(port),
                                          IC_EDGE_FALLING);
-          PLIB_IC_Enable(g_hw_settings.input_capture_module);
-          SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-          SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
-
-          PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-          SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
-          SYS_INT_SourceEnable(g_hw_settings.usart_error_source);
-
-        } else if (g_transceiver.active->op == OP_RDM_BROADCAST &&
-                   g_timing_settings.rdm_broadcast_timeout == 0u) {
+          PLIB_IC_Enable(HW_INPUT_CAPTURE_MODULE(port));
+          SYS_INT_SourceStatusClear(HW_INPUT_CAPTURE_SOURCE(port));
+          SYS_INT_SourceEnable(HW_INPUT_CAPTURE_SOURCE(port));
+
+          PLIB_USART_ReceiverEnable(HW_USART(port));
+          StartRXData(port);
+          SYS_INT_SourceStatusClear(HW_USART_ERROR_SOURCE(port));
+          SYS_INT_SourceEnable(HW_USART_ERROR_SOURCE(port));
+
+        } else if (port->active->op == OP_RDM_BROADCAST &&
+                   port->settings.rdm_broadcast_timeout == 0u) {
           // Go directly to the complete state.
-          PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-          g_transceiver.data_index = 0u;
-          g_transceiver.state = STATE_C_COMPLETE;
+          PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+          port->data_index = 0u;
+          port->state = STATE_C_COMPLETE;
         } else {
           // Either T_OP_RDM_WITH_RESPONSE or a non-0 broadcast listen time.
-          g_transceiver.rdm_response_timeout = (
-              g_transceiver.active->op == OP_RDM_BROADCAST ?
-              g_timing_settings.rdm_broadcast_timeout :
-              g_timing_settings.rdm_response_timeout);
-          g_transceiver.state = STATE_C_RX_WAIT_FOR_BREAK;
-          g_transceiver.data_index = 0u;
+          port->rdm_response_timeout = (
+              port->active->op == OP_RDM_BROADCAST ?
+              port->settings.rdm_broadcast_timeout :
+              port->settings.rdm_response_timeout);
+          port->state = STATE_C_RX_WAIT_FOR_BREAK;
+          port->data_index = 0u;
 
-          EnableRX();
-          UART_FlushRX();
+          EnableRX(port);
+          UART_FlushRX(port);
 
-          PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
+          PLIB_IC_FirstCaptureEdgeSelect(HW_INPUT_CAPTURE_MODULE(port),
                                          IC_EDGE_FALLING);
-          PLIB_IC_Enable(g_hw_settings.input_capture_module);
-          SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-          SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+          PLIB_IC_Enable(HW_INPUT_CAPTURE_MODULE(port));
+          SYS_INT_SourceStatusClear(HW_INPUT_CAPTURE_SOURCE(port));
+          SYS_INT_SourceEnable(HW_INPUT_CAPTURE_SOURCE(port));
         }
       }
-    } else if (g_transceiver.state == STATE_R_TX_DATA) {
-      UART_TXBytes();
-      if (g_transceiver.data_index == g_transceiver.active->size) {
+    } else if (port->state == STATE_R_TX_DATA) {
+      UART_TXBytes(port);
+      if (port->data_index == port->active->size) {
         PLIB_USART_TransmitterInterruptModeSelect(
-            g_hw_settings.usart, USART_TRANSMIT_FIFO_IDLE);
-        g_transceiver.state = STATE_R_TX_DRAIN;
+            HW_USART(port), USART_TRANSMIT_FIFO_IDLE);
+        port->state = STATE_R_TX_DRAIN;
       }
-    } else if (g_transceiver.state == STATE_R_TX_DRAIN) {
-      EnableRX();
-      SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      g_transceiver.state = STATE_R_TX_COMPLETE;
-    } else if (g_transceiver.state == STATE_T_RX_WAIT) {
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
+    } else if (port->state == STATE_R_TX_DRAIN) {
+      EnableRX(port);
+      SYS_INT_SourceDisable(HW_USART_TX_SOURCE(port));
+      PLIB_USART_TransmitterDisable(HW_USART(port));
+      port->state = STATE_R_TX_COMPLETE;
+    } else if (port->state == STATE_T_RX_WAIT) {
+      PLIB_USART_TransmitterDisable(HW_USART(port));
     }
-    SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
+    SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
   }
 
   // RX
-  if (SYS_INT_SourceStatusGet(g_hw_settings.usart_rx_source)) {
-    if (g_transceiver.state == STATE_C_RX_IN_DUB ||
-        g_transceiver.state == STATE_C_RX_DATA) {
+  if (SYS_INT_SourceStatusGet(HW_USART_RX_SOURCE(port))) {
+    if (port->state == STATE_C_RX_IN_DUB ||
+        port->state == STATE_C_RX_DATA) {
       // For the DUB case, It's impossible to overflow the buffer here, because
       // each byte is 44uS and the DUB Response limit
-      // (g_timing_settings.rdm_dub_response_limit) is at most 3500us. This
+      // (port->settings.rdm_dub_response_limit) is at most 3500us. This
       // means even with 0 interslot delay, the maximum bytes we can receive is
       // 79.
 
-     if (UART_RXBytes()) {
+     if (UART_RXBytes(port)) {
        // Protect against a responder sending us more than 512 bytes of data.
        // The maximum RDM frame size is 257 so this *should* never happen.
-       PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-       SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-       SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-       PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-       ResetToMark();
-       g_transceiver.state = STATE_C_COMPLETE;
+       PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+       SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+       SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+       PLIB_USART_ReceiverDisable(HW_USART(port));
+       ResetToMark(port);
+       port->state = STATE_C_COMPLETE;
      }
-    } else if (g_transceiver.state == STATE_R_RX_DATA) {
-      if (PLIB_USART_ErrorsGet(g_hw_settings.usart) & USART_ERROR_FRAMING) {
+    } else if (port->state == STATE_R_RX_DATA) {
+      if (PLIB_USART_ErrorsGet(HW_USART(port)) & USART_ERROR_FRAMING) {
         // A framing error indicates a possible break.
-        // Switch out of RX mode and back into the break state.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        UART_FlushRX();
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        RebaseTimer(g_transceiver.last_change);
-        g_transceiver.data_index = 0u;
-        g_transceiver.event_index = 0u;
-        g_transceiver.state = STATE_R_RX_BREAK;
-      } else if (UART_RXBytes()) {
+        // Switch out of RX mode and back into the break state. The line may
+        // be high if this was noise, so wait for a rising edge to end the
+        // break rather than taking the next edge.
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        UART_FlushRX(port);
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        RebaseTimer(port, port->last_change);
+        RestartInputCapture(port, IC_EDGE_RISING);
+        PublishRXFrame(port);
+        port->state = STATE_R_RX_BREAK;
+      } else if (UART_RXBytes(port)) {
         // RX buffer is full.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        g_transceiver.state = STATE_R_TX_COMPLETE;
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        PublishRXFrame(port);
+        port->state = STATE_R_TX_COMPLETE;
+      } else if (IsFastPathDUB(port)) {
+        SendFastPathDUBResponse(port);
       }
-    } else if (g_transceiver.state == STATE_T_RX_WAIT) {
-      UART_RXBytes();
-      g_transceiver.state = STATE_T_VERIFY;
+    } else if (port->state == STATE_T_RX_WAIT) {
+      UART_RXBytes(port);
+      port->state = STATE_T_VERIFY;
     }
-    SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
+    SYS_INT_SourceStatusClear(HW_USART_RX_SOURCE(port));
   }
 
   // Error
-  if (SYS_INT_SourceStatusGet(g_hw_settings.usart_error_source)) {
-    switch (g_transceiver.state) {
+  if (SYS_INT_SourceStatusGet(HW_USART_ERROR_SOURCE(port))) {
+    switch (port->state) {
       case STATE_C_RX_IN_DUB:
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
+        SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+        PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
         // Fall through
       case STATE_C_RX_DATA:
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        ResetToMark(port);
+        port->state = STATE_C_COMPLETE;
         break;
       case STATE_R_RX_DATA:
         // This is probably a new break
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        RebaseTimer(g_transceiver.last_change);
-        g_transceiver.state = STATE_R_RX_BREAK;
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        RebaseTimer(port, port->last_change);
+        RestartInputCapture(port, IC_EDGE_RISING);
+        PublishRXFrame(port);
+        port->state = STATE_R_RX_BREAK;
         break;
 
       case STATE_C_INITIALIZE:
@@ -1030,92 +1977,210 @@ void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6AUTO)
         // Should never happen.
         {}
     }
-    SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
+    SYS_INT_SourceStatusClear(HW_USART_ERROR_SOURCE(port));
+  }
+}
+
+#ifdef TRANSCEIVER_DMA
+/*
+ * @brief DMA Interrupt handler.
+ *
+ * This is called when the DMA channel completes a block, which is either the
+ * end of the TX data or a full RX buffer.
+ */
+static inline void DMAHandler(TransceiverPort *port) {
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  SYS_INT_SourceDisable(HW_DMA_SOURCE(port));
+
+  if (port->state == STATE_C_TX_DATA || port->state == STATE_R_TX_DATA) {
+    // All the data is in the USART, wait for the last byte to be sent.
+    port->data_index = port->active->size;
+    PLIB_USART_TransmitterInterruptModeSelect(HW_USART(port),
+                                              USART_TRANSMIT_FIFO_IDLE);
+    port->state = port->state == STATE_C_TX_DATA ?
+        STATE_C_TX_DRAIN : STATE_R_TX_DRAIN;
+    SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
+    SYS_INT_SourceEnable(HW_USART_TX_SOURCE(port));
+  } else if (port->state == STATE_C_RX_IN_DUB ||
+             port->state == STATE_C_RX_DATA) {
+    // The RX buffer is full, see the comment in UARTHandler().
+    port->data_index = BUFFER_SIZE;
+    port->dma_rx = false;
+    PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+    SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+    PLIB_USART_ReceiverDisable(HW_USART(port));
+    ResetToMark(port);
+    port->state = STATE_C_COMPLETE;
   }
+  SYS_INT_SourceStatusClear(HW_DMA_SOURCE(port));
+}
+#endif
+
+// ISRs
+// ----------------------------------------------------------------------------
+// The vector numbers are required at compile time, so these can't be part of
+// TransceiverHardwareSettings.
+void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_IC), ipl6AUTO)
+    InputCaptureEvent(void) {
+  InputCaptureHandler(&g_ports[0]);
+}
+
+void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_TIMER), ipl6AUTO)
+    Transceiver_TimerEvent() {
+  TimerHandler(&g_ports[0]);
+}
+
+void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_UART), ipl6AUTO)
+    Transceiver_UARTEvent() {
+  UARTHandler(&g_ports[0]);
+}
+
+#ifdef TRANSCEIVER_DMA
+void __ISR(AS_DMA_ISR_VECTOR(TRANSCEIVER_DMA_CHANNEL), ipl6AUTO)
+    Transceiver_DMAEvent() {
+  DMAHandler(&g_ports[0]);
+}
+#endif
+
+#if TRANSCEIVER_PORT_COUNT > 1
+void __ISR(AS_IC_ISR_VECTOR(TRANSCEIVER_PORT1_IC), ipl6AUTO)
+    Transceiver_Port1InputCaptureEvent(void) {
+  InputCaptureHandler(&g_ports[1]);
+}
+
+void __ISR(AS_TIMER_ISR_VECTOR(TRANSCEIVER_PORT1_TIMER), ipl6AUTO)
+    Transceiver_Port1TimerEvent() {
+  TimerHandler(&g_ports[1]);
 }
 
+void __ISR(AS_USART_ISR_VECTOR(TRANSCEIVER_PORT1_UART), ipl6AUTO)
+    Transceiver_Port1UARTEvent() {
+  UARTHandler(&g_ports[1]);
+}
+
+#ifdef TRANSCEIVER_DMA
+void __ISR(AS_DMA_ISR_VECTOR(TRANSCEIVER_PORT1_DMA_CHANNEL), ipl6AUTO)
+    Transceiver_Port1DMAEvent() {
+  DMAHandler(&g_ports[1]);
+}
+#endif
+#endif
+
 // Public API Functions
 // ----------------------------------------------------------------------------
-void Transceiver_Initialize(const TransceiverHardwareSettings* settings,
+void Transceiver_Initialize(uint8_t port_index,
+                            const TransceiverHardwareSettings* settings,
                             TransceiverEventCallback tx_callback,
                             TransceiverEventCallback rx_callback) {
-  g_hw_settings = *settings;
-  g_tx_callback = tx_callback;
-  g_rx_callback = rx_callback;
-
-  g_transceiver.state = STATE_R_INITIALIZE;
-  g_transceiver.mode = T_MODE_RESPONDER;
-  g_transceiver.desired_mode = T_MODE_RESPONDER;
-  g_transceiver.data_index = 0u;
-  g_transceiver.mode_change_token = TRANSCEIVER_NO_NOTIFICATION;
-
-  InitializeBuffers();
-  ResetTimingSettings();
+  TransceiverPort *port = &g_ports[port_index];
+  port->id = port_index;
+#ifdef TRANSCEIVER_STATIC_HW_SETTINGS
+  (void) settings;
+#else
+  port->hw_settings = *settings;
+#endif
+  port->tx_callback = tx_callback;
+  port->rx_callback = rx_callback;
+
+  port->initialized = true;
+  port->state = STATE_R_INITIALIZE;
+  port->logged_state = STATE_RESET;
+  port->mode = T_MODE_RESPONDER;
+  port->desired_mode = T_MODE_RESPONDER;
+  port->data_index = 0u;
+  port->mode_change_token = TRANSCEIVER_NO_NOTIFICATION;
+  port->loan = NULL;
+  port->rx_overruns = 0u;
+  port->dub_enabled = false;
+
+  InitializeBuffers(port);
+  ResetTimingSettings(port);
+  ResetFrameRate(port);
+  Transceiver_ResetTurnaroundStats(port_index);
+  Transceiver_ResetLineStats(port_index);
 
   // Setup the Break, TX Enable & RX Enable I/O Pins
   PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
-                                   g_hw_settings.port,
-                                   g_hw_settings.break_bit);
+                                   HW_PORT(port),
+                                   HW_BREAK_BIT(port));
   PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
-                                   g_hw_settings.port,
-                                   g_hw_settings.tx_enable_bit);
+                                   HW_PORT(port),
+                                   HW_TX_ENABLE_BIT(port));
   PLIB_PORTS_PinDirectionOutputSet(PORTS_ID_0,
-                                   g_hw_settings.port,
-                                   g_hw_settings.rx_enable_bit);
+                                   HW_PORT(port),
+                                   HW_RX_ENABLE_BIT(port));
 
   // Setup the timer
-  PLIB_TMR_ClockSourceSelect(g_hw_settings.timer_module_id,
+  PLIB_TMR_ClockSourceSelect(HW_TIMER_MODULE_ID(port),
                              TMR_CLOCK_SOURCE_PERIPHERAL_CLOCK);
-  PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id, TMR_PRESCALE_VALUE_1);
-  PLIB_TMR_Mode16BitEnable(g_hw_settings.timer_module_id);
-  SYS_INT_VectorPrioritySet(g_hw_settings.timer_vector, INT_PRIORITY_LEVEL1);
-  SYS_INT_VectorSubprioritySet(g_hw_settings.timer_vector,
+  PLIB_TMR_PrescaleSelect(HW_TIMER_MODULE_ID(port), TMR_PRESCALE_VALUE_1);
+  PLIB_TMR_Mode16BitEnable(HW_TIMER_MODULE_ID(port));
+  SYS_INT_VectorPrioritySet(HW_TIMER_VECTOR(port), INT_PRIORITY_LEVEL1);
+  SYS_INT_VectorSubprioritySet(HW_TIMER_VECTOR(port),
                                INT_SUBPRIORITY_LEVEL0);
 
   // Setup the UART
-  PLIB_USART_BaudRateSet(g_hw_settings.usart,
+  PLIB_USART_BaudRateSet(HW_USART(port),
                          SYS_CLK_PeripheralFrequencyGet(CLK_BUS_PERIPHERAL_1),
                          DMX_BAUD);
-  PLIB_USART_HandshakeModeSelect(g_hw_settings.usart,
+  PLIB_USART_HandshakeModeSelect(HW_USART(port),
                                  USART_HANDSHAKE_MODE_SIMPLEX);
-  PLIB_USART_OperationModeSelect(g_hw_settings.usart,
+  PLIB_USART_OperationModeSelect(HW_USART(port),
                                  USART_ENABLE_TX_RX_USED);
-  PLIB_USART_LineControlModeSelect(g_hw_settings.usart, USART_8N2);
-  PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
+  PLIB_USART_LineControlModeSelect(HW_USART(port), USART_8N2);
+  PLIB_USART_TransmitterInterruptModeSelect(HW_USART(port),
                                             USART_TRANSMIT_FIFO_EMPTY);
 
-  SYS_INT_VectorPrioritySet(g_hw_settings.usart_vector,
+  SYS_INT_VectorPrioritySet(HW_USART_VECTOR(port),
                             INT_PRIORITY_LEVEL6);
-  SYS_INT_VectorSubprioritySet(g_hw_settings.usart_vector,
+  SYS_INT_VectorSubprioritySet(HW_USART_VECTOR(port),
                                INT_SUBPRIORITY_LEVEL0);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
+  SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
 
   // Setup input capture
-  PLIB_IC_Disable(g_hw_settings.input_capture_module);
-  PLIB_IC_ModeSelect(g_hw_settings.input_capture_module,
+  PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+  PLIB_IC_ModeSelect(HW_INPUT_CAPTURE_MODULE(port),
                      IC_INPUT_CAPTURE_EVERY_EDGE_MODE);
-  PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
+  PLIB_IC_FirstCaptureEdgeSelect(HW_INPUT_CAPTURE_MODULE(port),
                                  IC_EDGE_RISING);
-  PLIB_IC_TimerSelect(g_hw_settings.input_capture_module,
-                      g_hw_settings.input_capture_timer);
-  PLIB_IC_BufferSizeSelect(g_hw_settings.input_capture_module,
+  PLIB_IC_TimerSelect(HW_INPUT_CAPTURE_MODULE(port),
+                      HW_INPUT_CAPTURE_TIMER(port));
+  PLIB_IC_BufferSizeSelect(HW_INPUT_CAPTURE_MODULE(port),
                            IC_BUFFER_SIZE_16BIT);
-  PLIB_IC_EventsPerInterruptSelect(g_hw_settings.input_capture_module,
+  PLIB_IC_EventsPerInterruptSelect(HW_INPUT_CAPTURE_MODULE(port),
                                    IC_INTERRUPT_ON_EVERY_CAPTURE_EVENT);
 
-  SYS_INT_VectorPrioritySet(g_hw_settings.input_capture_vector,
+  SYS_INT_VectorPrioritySet(HW_INPUT_CAPTURE_VECTOR(port),
                             INT_PRIORITY_LEVEL6);
-  SYS_INT_VectorSubprioritySet(g_hw_settings.input_capture_vector,
+  SYS_INT_VectorSubprioritySet(HW_INPUT_CAPTURE_VECTOR(port),
                                INT_SUBPRIORITY_LEVEL0);
+
+#ifdef TRANSCEIVER_DMA
+  // Setup DMA. Each USART event moves a single slot.
+  port->dma_rx = false;
+  PLIB_DMA_Enable(DMA_ID_0);
+  PLIB_DMA_ChannelXDisable(DMA_ID_0, HW_DMA_CHANNEL(port));
+  PLIB_DMA_ChannelXTriggerEnable(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                 DMA_CHANNEL_TRIGGER_TRANSFER_START);
+  PLIB_DMA_ChannelXCellSizeSet(DMA_ID_0, HW_DMA_CHANNEL(port), 1u);
+  PLIB_DMA_ChannelXINTSourceEnable(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                   DMA_INT_BLOCK_TRANSFER_COMPLETE);
+
+  SYS_INT_VectorPrioritySet(HW_DMA_VECTOR(port), INT_PRIORITY_LEVEL6);
+  SYS_INT_VectorSubprioritySet(HW_DMA_VECTOR(port), INT_SUBPRIORITY_LEVEL0);
+#endif
 }
 
-bool Transceiver_SetMode(TransceiverMode mode, int16_t token) {
-  if (g_transceiver.mode != g_transceiver.desired_mode) {
+bool Transceiver_SetMode(uint8_t port_index,
+                         TransceiverMode mode, int16_t token) {
+  TransceiverPort *port = &g_ports[port_index];
+  if (port->mode != port->desired_mode) {
     SysLog_Message(SYSLOG_WARN, "Mode change already pending");
     return false;
   }
 
-  if (g_transceiver.mode == mode) {
+  if (port->mode == mode) {
     return false;
   }
 
@@ -1133,71 +2198,47 @@ bool Transceiver_SetMode(TransceiverMode mode, int16_t token) {
       SysLog_Print(SYSLOG_INFO, "Unknown mode: %d", mode);
       return false;
   }
-  g_transceiver.desired_mode = mode;
-  g_transceiver.mode_change_token = token;
+  port->desired_mode = mode;
+  port->mode_change_token = token;
   return true;
 }
 
-TransceiverMode Transceiver_GetMode() {
-  return g_transceiver.mode;
+TransceiverMode Transceiver_GetMode(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->mode;
 }
 
-void Transceiver_Tasks() {
+/*
+ * @brief Perform the periodic tasks for a port.
+ */
+static void PortTasks(TransceiverPort *port) {
   bool ok;
-  LogStateChange();
+  LogStateChange(port);
+  UpdateFrameRate(port);
+  DeliverCompleteFrame(port);
 
-  switch (g_transceiver.state) {
+  switch (port->state) {
     // Controller States
     case STATE_C_INITIALIZE:
-      PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-      PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      PLIB_USART_Disable(g_hw_settings.usart);
-      PLIB_IC_Disable(g_hw_settings.input_capture_module);
-      ResetToMark();
-      g_transceiver.state = STATE_C_TX_READY;
+      PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+      PLIB_USART_ReceiverDisable(HW_USART(port));
+      PLIB_USART_TransmitterDisable(HW_USART(port));
+      PLIB_USART_Disable(HW_USART(port));
+      PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+      ResetToMark(port);
+      port->state = STATE_C_TX_READY;
       // Fall through
     case STATE_C_TX_READY:
-      if (g_transceiver.desired_mode != T_MODE_CONTROLLER) {
-        SwitchMode();
+      if (port->desired_mode != T_MODE_CONTROLLER) {
+        SwitchMode(port);
         break;
       }
 
-      if (!g_transceiver.next) {
+      if (!ControllerFrameReady(port)) {
         return;
       }
-      // @pre Timer is not running.
-      // @pre UART is disabled
-      // @pre TX is enabled.
-      // @pre RX is disabled.
-      // @pre RX InputCapture is disabled.
-      // @pre line in marking state
-
-      TakeNextBuffer();
-
-      // Reset state
-      g_transceiver.found_expected_length = false;
-      g_transceiver.expected_length = 0u;
-      g_transceiver.result = T_RESULT_OK;
-      memset(&g_timing, 0, sizeof(g_timing));
-
-      // Prepare the UART
-      // Set UART Interrupts when the buffer is empty.
-      PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
-                                                USART_TRANSMIT_FIFO_EMPTY);
-
-      // Set break and start timer.
-      g_transceiver.state = STATE_C_IN_BREAK;
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
-                              TMR_PRESCALE_VALUE_1);
-      g_transceiver.tx_frame_start = CoarseTimer_GetTime();
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id,
-                              g_timing_settings.break_ticks);
-      SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
-      SYS_INT_SourceEnable(g_hw_settings.timer_source);
-      SetBreak();
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      StartControllerFrame(port);
+      break;
 
     case STATE_C_IN_BREAK:
     case STATE_C_IN_MARK:
@@ -1209,52 +2250,52 @@ void Transceiver_Tasks() {
       break;
 
     case STATE_C_RX_WAIT_FOR_BREAK:
-      if (CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
-                                 g_transceiver.rdm_response_timeout)) {
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
+      if (CoarseTimer_HasElapsed(port->tx_frame_end,
+                                 port->rdm_response_timeout)) {
+        SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
         // Note: the IC ISR may have run between the case check and the
         // SourceDisable and switched us to STATE_C_RX_IN_BREAK.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        ResetToMark();
-        g_transceiver.state = STATE_C_RX_TIMEOUT;
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+        PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        ResetToMark(port);
+        port->state = STATE_C_RX_TIMEOUT;
       }
       break;
 
     case STATE_C_RX_IN_BREAK:
       // Disable interupts so we don't race
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      if (g_transceiver.state == STATE_C_RX_IN_BREAK &&
-          ((uint16_t) (PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) -
-            g_timing.get_set_response.break_start) >
+      SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+      if (port->state == STATE_C_RX_IN_BREAK &&
+          ((uint16_t) (PLIB_TMR_Counter16BitGet(HW_TIMER_MODULE_ID(port)) -
+            port->timing.get_set_response.break_start) >
             CONTROLLER_RX_BREAK_TIME_MAX)) {
         // Break was too long
-        g_transceiver.result = T_RESULT_RX_INVALID;
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        port->result = T_RESULT_RX_INVALID;
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        ResetToMark(port);
+        port->state = STATE_C_COMPLETE;
         return;
       }
-      SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+      SYS_INT_SourceEnable(HW_INPUT_CAPTURE_SOURCE(port));
       break;
 
     case STATE_C_RX_IN_MARK:
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      if (g_transceiver.state == STATE_C_RX_IN_MARK &&
-          ((uint16_t) (PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) -
-            g_timing.get_set_response.mark_start) >
+      SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+      if (port->state == STATE_C_RX_IN_MARK &&
+          ((uint16_t) (PLIB_TMR_Counter16BitGet(HW_TIMER_MODULE_ID(port)) -
+            port->timing.get_set_response.mark_start) >
             CONTROLLER_RX_MARK_TIME_MAX)) {
         // Break was too long
-        g_transceiver.result = T_RESULT_RX_INVALID;
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        port->result = T_RESULT_RX_INVALID;
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        ResetToMark(port);
+        port->state = STATE_C_COMPLETE;
         return;
       }
-      SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+      SYS_INT_SourceEnable(HW_INPUT_CAPTURE_SOURCE(port));
       break;
 
     case STATE_C_RX_DATA:
@@ -1270,79 +2311,100 @@ void Transceiver_Tasks() {
       //
       // With an inter-slot timeout of 2.1ms and a buffer size of 512, a single
       // responder can block us for up to 1.04s.
-      SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-      SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-      if (g_transceiver.data_index > 0 &&
-          CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
+#ifdef TRANSCEIVER_DMA
+      // The slots are moved by the DMA channel, so check how far it's got.
+      SYS_INT_SourceDisable(HW_DMA_SOURCE(port));
+      SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+      DMA_RXBytes(port);
+      if (port->state != STATE_C_RX_DATA) {
+        // Either the response is complete, or one of the ISRs ended it.
+        return;
+      }
+#else
+      SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+      SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+#endif
+      if (port->data_index > 0 &&
+          CoarseTimer_HasElapsed(port->last_byte_coarse,
                                  CONTROLLER_RECEIVE_RDM_INTERSLOT_TIMEOUT)) {
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        ResetToMark();
-        g_transceiver.state = STATE_C_COMPLETE;
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        ResetToMark(port);
+        port->state = STATE_C_COMPLETE;
         return;
       }
-      SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-      SYS_INT_SourceEnable(g_hw_settings.usart_error_source);
+#ifdef TRANSCEIVER_DMA
+      SYS_INT_SourceEnable(HW_DMA_SOURCE(port));
+#else
+      SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
+#endif
+      SYS_INT_SourceEnable(HW_USART_ERROR_SOURCE(port));
       break;
 
     case STATE_C_RX_WAIT_FOR_DUB:
-      if (CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
-                                 g_timing_settings.rdm_response_timeout)) {
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
+      if (CoarseTimer_HasElapsed(port->tx_frame_end,
+                                 port->settings.rdm_response_timeout)) {
+        SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
         // Note: the IC ISR may have run between the case check and the
         // SourceDisable and switched us to STATE_C_RX_IN_DUB.
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        ResetToMark();
-        g_transceiver.state = STATE_C_RX_TIMEOUT;
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+        PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        ResetToMark(port);
+        port->state = STATE_C_RX_TIMEOUT;
       }
       break;
     case STATE_C_RX_IN_DUB:
-      if ((uint16_t) (PLIB_TMR_Counter16BitGet(g_hw_settings.timer_module_id) -
-                      g_timing.dub_response.start) >
-           g_timing_settings.rdm_dub_response_limit) {
+      if ((uint16_t) (PLIB_TMR_Counter16BitGet(HW_TIMER_MODULE_ID(port)) -
+                      port->timing.dub_response.start) >
+           port->settings.rdm_dub_response_limit) {
         // The UART Error interupt may have fired, putting us into
         // STATE_C_COMPLETE, already.
-        SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        ResetToMark();
+        SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+        PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+        PLIB_USART_ReceiverDisable(HW_USART(port));
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        ResetToMark(port);
         // We got at least a falling edge, so this should probably be
         // considered a collision, rather than a timeout.
-        g_transceiver.state = STATE_C_COMPLETE;
+        port->state = STATE_C_COMPLETE;
       }
       break;
 
     case STATE_C_RX_TIMEOUT:
       SysLog_Message(SYSLOG_INFO, "RX timeout");
-      g_transceiver.state = STATE_C_COMPLETE;
-      g_transceiver.result = T_RESULT_RX_TIMEOUT;
+      port->state = STATE_C_COMPLETE;
+      port->result = T_RESULT_RX_TIMEOUT;
       break;
     case STATE_C_COMPLETE:
-      if (g_transceiver.active->op == OP_RDM_DUB) {
-        SysLog_Print(SYSLOG_INFO, "First DUB: %d", g_timing.dub_response.start);
-        SysLog_Print(SYSLOG_INFO, "Last DUB: %d", g_timing.dub_response.end);
+#ifdef TRANSCEIVER_DMA
+      DMA_StopRX(port);
+#endif
+      if (port->active->op == OP_RDM_DUB) {
+        SysLog_Event(SYSLOG_INFO, "First DUB: %d",
+                     port->timing.dub_response.start);
+        SysLog_Event(SYSLOG_INFO, "Last DUB: %d",
+                     port->timing.dub_response.end);
       }
-      if (g_transceiver.active->op == OP_RDM_WITH_RESPONSE) {
-        SysLog_Print(SYSLOG_INFO, "break: %d",
-                     g_timing.get_set_response.break_start);
-        SysLog_Print(SYSLOG_INFO, "mark start: %d, end: %d",
-                     g_timing.get_set_response.mark_start,
-                     g_timing.get_set_response.mark_end);
-        SysLog_Print(SYSLOG_INFO, "Break: %d, Mark: %d",
-                     (uint16_t) (g_timing.get_set_response.mark_start -
-                      g_timing.get_set_response.break_start),
-                     (uint16_t) (g_timing.get_set_response.mark_end -
-                      g_timing.get_set_response.mark_start));
+      if (port->active->op == OP_RDM_WITH_RESPONSE) {
+        SysLog_Event(SYSLOG_INFO, "break: %d",
+                     port->timing.get_set_response.break_start);
+        SysLog_Event(SYSLOG_INFO, "mark start: %d, end: %d",
+                     port->timing.get_set_response.mark_start,
+                     port->timing.get_set_response.mark_end);
+        SysLog_Event(SYSLOG_INFO, "Break: %d, Mark: %d",
+                     (uint16_t) (port->timing.get_set_response.mark_start -
+                      port->timing.get_set_response.break_start),
+                     (uint16_t) (port->timing.get_set_response.mark_end -
+                      port->timing.get_set_response.mark_start));
       }
-      FrameComplete();
-      g_transceiver.state = STATE_C_BACKOFF;
+      FrameComplete(port);
+      port->frame_count++;
+      port->state = STATE_C_BACKOFF;
       // Fall through
     case STATE_C_BACKOFF:
       // From E1.11, the min break-to-break time is 1.204ms.
@@ -1352,23 +2414,23 @@ void Transceiver_Tasks() {
       //  - If bcast, the min EOF to break is 0.176ms
       //  - If lost response, the min EOF to break is 3.0ms
       //  - Any other packet, min EOF to break is 176uS.
-      ok = CoarseTimer_HasElapsed(g_transceiver.tx_frame_start,
+      ok = CoarseTimer_HasElapsed(port->tx_frame_start,
                                   CONTROLLER_MIN_BREAK_TO_BREAK);
 
-      switch (g_transceiver.active->op) {
+      switch (port->active->op) {
         case OP_TX_ONLY:
           // 176uS min, rounds to 0.2ms.
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(port->tx_frame_end,
                                        CONTROLLER_NON_RDM_BACKOFF);
           break;
         case OP_RDM_DUB:
           // It would be nice to be able to reduce this if we didn't get a
           // response, but the standard doesn't allow this.
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(port->tx_frame_end,
                                        CONTROLLER_DUB_BACKOFF);
           break;
         case OP_RDM_BROADCAST:
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(port->tx_frame_end,
                                        CONTROLLER_BROADCAST_BACKOFF);
           break;
         case OP_RDM_WITH_RESPONSE:
@@ -1376,7 +2438,7 @@ void Transceiver_Tasks() {
           // We can probably make this faster, since the 3ms only
           // applies for no responses. If we do get a response, then it's only
           // a 0.176ms delay, from the end of the response frame.
-          ok &= CoarseTimer_HasElapsed(g_transceiver.tx_frame_end,
+          ok &= CoarseTimer_HasElapsed(port->tx_frame_end,
                                        CONTROLLER_MISSING_RESPONSE_BACKOFF);
           break;
         case OP_RDM_DUB_RESPONSE:
@@ -1388,8 +2450,20 @@ void Transceiver_Tasks() {
       }
 
       if (ok) {
-        FreeActiveBuffer();
-        g_transceiver.state = STATE_C_TX_READY;
+        RecordLineTime(port);
+        if (port->settings.dmx_refresh_interval &&
+            port->active->op == OP_TX_ONLY &&
+            port->active->data[0] == NULL_START_CODE) {
+          RetainActiveBuffer(port);
+        }
+        FreeActiveBuffer(port);
+        port->state = STATE_C_TX_READY;
+        // If there is another frame queued, start it now rather than waiting
+        // for the next call to Transceiver_Tasks().
+        if (ControllerFrameReady(port) &&
+            port->desired_mode == T_MODE_CONTROLLER) {
+          StartControllerFrame(port);
+        }
       }
       break;
 
@@ -1397,68 +2471,83 @@ void Transceiver_Tasks() {
     case STATE_R_INITIALIZE:
       // This is done once when we switch to Responder mode
       // Reset the UART
-      PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      PLIB_USART_Enable(g_hw_settings.usart);
-      UART_FlushRX();
+      PLIB_USART_ReceiverDisable(HW_USART(port));
+      PLIB_USART_TransmitterDisable(HW_USART(port));
+      PLIB_USART_Enable(HW_USART(port));
+      UART_FlushRX(port);
 
       // Put us into RX mode
-      EnableRX();
+      EnableRX(port);
 
       // Setup the timer
-      PLIB_TMR_Counter16BitClear(g_hw_settings.timer_module_id);
+      PLIB_TMR_Counter16BitClear(HW_TIMER_MODULE_ID(port));
       // 6.5 ms until overflow.
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id, 65535);
-      PLIB_TMR_PrescaleSelect(g_hw_settings.timer_module_id,
+      PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port), 65535);
+      PLIB_TMR_PrescaleSelect(HW_TIMER_MODULE_ID(port),
                               TMR_PRESCALE_VALUE_8);
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
+      PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
 
       // Fall through
     case STATE_R_RX_PREPARE:
       // Setup RX buffer
-      if (!g_transceiver.active) {
-        if (g_transceiver.free_size == 0u) {
+      if (!port->active) {
+        if (port->free_size == 0u) {
+          SysLog_Message(SYSLOG_INFO, "Lost buffers!");
+          port->state = STATE_ERROR;
+          return;
+        }
+
+        port->free_size--;
+        port->active = port->free_list[port->free_size];
+      }
+      if (!port->rx_spare && !port->rx_complete) {
+        if (port->free_size == 0u) {
           SysLog_Message(SYSLOG_INFO, "Lost buffers!");
-          g_transceiver.state = STATE_ERROR;
+          port->state = STATE_ERROR;
           return;
         }
 
-        g_transceiver.free_size--;
-        g_transceiver.active = g_transceiver.free_list[g_transceiver.free_size];
+        port->free_size--;
+        port->rx_spare = port->free_list[port->free_size];
+        port->rx_spare->op = OP_RX;
+      }
+      if (port->dub_enabled && !port->dub_buffer && port->free_size) {
+        port->free_size--;
+        port->dub_buffer = port->free_list[port->free_size];
       }
 
       // Reset state variables.
-      g_timing.request.break_time = 0u;
-      g_timing.request.mark_time = 0u;
-      g_transceiver.data_index = 0u;
-      g_transceiver.event_index = 0u;
-      g_transceiver.active->op = OP_RX;
+      port->timing.request.break_time = 0u;
+      port->timing.request.mark_time = 0u;
+      port->data_index = 0u;
+      port->event_index = 0u;
+      port->active->op = OP_RX;
 
-      g_transceiver.state = STATE_R_RX_MBB;
+      port->state = STATE_R_RX_MBB;
 
       // Catch the next falling edge.
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-      PLIB_IC_Disable(g_hw_settings.input_capture_module);
-      PLIB_IC_FirstCaptureEdgeSelect(g_hw_settings.input_capture_module,
+      SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+      SYS_INT_SourceStatusClear(HW_INPUT_CAPTURE_SOURCE(port));
+      PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+      PLIB_IC_FirstCaptureEdgeSelect(HW_INPUT_CAPTURE_MODULE(port),
                                      IC_EDGE_FALLING);
-      PLIB_IC_Enable(g_hw_settings.input_capture_module);
-      SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+      PLIB_IC_Enable(HW_INPUT_CAPTURE_MODULE(port));
+      SYS_INT_SourceEnable(HW_INPUT_CAPTURE_SOURCE(port));
 
       // Fall through
     case STATE_R_RX_MBB:
       // noop, waiting for IC event
 
-      SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-      if (g_transceiver.desired_mode != T_MODE_RESPONDER) {
-        g_transceiver.mode = g_transceiver.desired_mode;
-        PLIB_IC_Disable(g_hw_settings.input_capture_module);
-        PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-        FreeActiveBuffer();
-        SwitchMode();
+      SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+      if (port->desired_mode != T_MODE_RESPONDER) {
+        port->mode = port->desired_mode;
+        PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
+        PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+        FreeActiveBuffer(port);
+        SwitchMode(port);
         break;
       }
-      SYS_INT_SourceEnable(g_hw_settings.input_capture_source);
+      SYS_INT_SourceEnable(HW_INPUT_CAPTURE_SOURCE(port));
       break;
 
     case STATE_R_RX_BREAK:
@@ -1469,37 +2558,54 @@ void Transceiver_Tasks() {
       break;
 
     case STATE_R_RX_DATA:
-      SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
+      SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+      if (port->rx_complete) {
+        // The next frame has started since the call to
+        // DeliverCompleteFrame(). Finish the previous frame first.
+        SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
+        break;
+      }
 
-      if (g_transceiver.data_index != 0u) {
+      if (port->data_index != 0u) {
         // Got at least one byte, so we have the start code.
         // Check the time since the last byte.
-        if ((g_transceiver.active->data[0] == RDM_START_CODE &&
-             CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
+        if ((port->active->data[0] == RDM_START_CODE &&
+             CoarseTimer_HasElapsed(port->last_byte_coarse,
                                     RESPONDER_RDM_INTERSLOT_TIMEOUT)) ||
-            CoarseTimer_HasElapsed(g_transceiver.last_byte_coarse,
+            CoarseTimer_HasElapsed(port->last_byte_coarse,
                                    RESPONDER_DMX_INTERSLOT_TIMEOUT)) {
           // RDM inter-slot timeout
-          RXEndFrameEvent();
-          PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-          g_transceiver.state = STATE_R_RX_PREPARE;
+          RXEndFrameEvent(port);
+          PLIB_USART_ReceiverDisable(HW_USART(port));
+          port->state = STATE_R_RX_PREPARE;
           break;
         }
       }
 
-      if (g_transceiver.event_index != g_transceiver.data_index) {
-        RXFrameEvent();
-        g_transceiver.event_index = g_transceiver.data_index;
+      if (port->event_index != port->data_index) {
+        // The ISR keeps receiving while the handler runs. If the frame ends
+        // in the meantime, the ISR publishes this buffer and switches to the
+        // spare.
+        TransceiverBuffer *buffer = port->active;
+        uint16_t length = port->data_index;
+        SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
+        RXFrameEvent(port, buffer, length, &port->timing);
+        port->event_index = length;
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        if (port->dub_rx_buffer) {
+          // The ISR answered a DUB while the handler was running.
+          break;
+        }
       }
 
-      if (g_transceiver.next) {
+      if (port->rdm_queue.size && !port->rx_complete) {
         // Update the seed with the value from the coarse timer. This is a
         // useful source of entropy.
         Random_SetSeed(CoarseTimer_GetTime());
-        PrepareRDMResponse();
+        PrepareRDMResponse(port);
       } else {
         // Continue receiving
-        SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
+        SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
       }
       break;
     case STATE_R_TX_WAITING:
@@ -1511,90 +2617,105 @@ void Transceiver_Tasks() {
       // noop
       break;
     case STATE_R_TX_DRAIN:
-      FreeActiveBuffer();
+      FreeActiveBuffer(port);
       break;
     case STATE_R_TX_COMPLETE:
-      PLIB_TMR_Stop(g_hw_settings.timer_module_id);
-      PLIB_TMR_Period16BitSet(g_hw_settings.timer_module_id, 65535u);
-      PLIB_TMR_Start(g_hw_settings.timer_module_id);
-      g_transceiver.data_index = 0u;
-      g_transceiver.state = STATE_R_RX_PREPARE;
+      PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
+      PLIB_TMR_Period16BitSet(HW_TIMER_MODULE_ID(port), 65535u);
+      PLIB_TMR_Start(HW_TIMER_MODULE_ID(port));
+      if (port->dub_rx_buffer) {
+        FreeActiveBuffer(port);
+        port->active = port->dub_rx_buffer;
+        port->dub_rx_buffer = NULL;
+      }
+      port->data_index = 0u;
+      port->state = STATE_R_RX_PREPARE;
       break;
 
     // Self Test States
     case STATE_T_INITIALIZE:
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-      UART_FlushRX();
-      SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-      SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-      SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-      SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-      PLIB_USART_TransmitterInterruptModeSelect(g_hw_settings.usart,
+      PLIB_USART_TransmitterDisable(HW_USART(port));
+      UART_FlushRX(port);
+      SYS_INT_SourceDisable(HW_USART_TX_SOURCE(port));
+      SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+      SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
+      SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
+      PLIB_USART_TransmitterInterruptModeSelect(HW_USART(port),
                                                 USART_TRANSMIT_FIFO_EMPTY);
-      PLIB_USART_Enable(g_hw_settings.usart);
+      PLIB_USART_Enable(HW_USART(port));
 
       // Setup loopback
       PLIB_PORTS_PinClear(PORTS_ID_0,
-                          g_hw_settings.port,
-                          g_hw_settings.rx_enable_bit);
+                          HW_PORT(port),
+                          HW_RX_ENABLE_BIT(port));
       PLIB_PORTS_PinSet(PORTS_ID_0,
-                        g_hw_settings.port,
-                        g_hw_settings.tx_enable_bit);
+                        HW_PORT(port),
+                        HW_TX_ENABLE_BIT(port));
 
-      g_transceiver.state = STATE_T_TX_READY;
+      port->state = STATE_T_TX_READY;
       // Fall through
     case STATE_T_TX_READY:
-      if (g_transceiver.desired_mode != T_MODE_SELF_TEST) {
-        SwitchMode();
+      if (port->desired_mode != T_MODE_SELF_TEST) {
+        SwitchMode(port);
         return;
       }
-      if (!g_transceiver.next) {
+      if (!port->rdm_queue.size) {
         return;
       }
-      TakeNextBuffer();
-      g_transceiver.data_index = 0;
-      g_transceiver.tx_frame_start = CoarseTimer_GetTime();
-      g_transceiver.state = STATE_T_RX_WAIT;
-
-      SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-      SYS_INT_SourceEnable(g_hw_settings.usart_rx_source);
-      PLIB_USART_ReceiverEnable(g_hw_settings.usart);
-      PLIB_USART_TransmitterEnable(g_hw_settings.usart);
-      PLIB_USART_TransmitterByteSend(g_hw_settings.usart, SELF_TEST_VALUE);
+      TakeNextBuffer(port, &port->rdm_queue);
+      port->data_index = 0;
+      port->tx_frame_start = CoarseTimer_GetTime();
+      port->state = STATE_T_RX_WAIT;
+
+      SYS_INT_SourceStatusClear(HW_USART_RX_SOURCE(port));
+      SYS_INT_SourceEnable(HW_USART_RX_SOURCE(port));
+      PLIB_USART_ReceiverEnable(HW_USART(port));
+      PLIB_USART_TransmitterEnable(HW_USART(port));
+      PLIB_USART_TransmitterByteSend(HW_USART(port), SELF_TEST_VALUE);
       // Fall through
     case STATE_T_RX_WAIT:
-      if (CoarseTimer_HasElapsed(g_transceiver.tx_frame_start,
+      if (CoarseTimer_HasElapsed(port->tx_frame_start,
                                  SELF_TEST_TIMEOUT)) {
-        SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-        g_transceiver.state = STATE_T_VERIFY;
+        SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+        port->state = STATE_T_VERIFY;
       }
       break;
     case STATE_T_VERIFY:
-      SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-      PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-      PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-
-      g_transceiver.result = T_RESULT_SELF_TEST_FAILED;
-      if (g_transceiver.data_index > 0 &&
-          g_transceiver.active->data[0] == SELF_TEST_VALUE) {
-        g_transceiver.result = T_RESULT_OK;
+      SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+      PLIB_USART_ReceiverDisable(HW_USART(port));
+      PLIB_USART_TransmitterDisable(HW_USART(port));
+
+      port->result = T_RESULT_SELF_TEST_FAILED;
+      if (port->data_index > 0 &&
+          port->active->data[0] == SELF_TEST_VALUE) {
+        port->result = T_RESULT_OK;
       }
-      g_transceiver.data_index = 0;
-      FrameComplete();
-      FreeActiveBuffer();
-      g_transceiver.state = STATE_T_TX_READY;
+      port->data_index = 0;
+      FrameComplete(port);
+      FreeActiveBuffer(port);
+      port->state = STATE_T_TX_READY;
       break;
 
     case STATE_RESET:
-      SwitchMode();
+      SwitchMode(port);
       break;
     case STATE_ERROR:
       break;
   }
 }
 
+void Transceiver_Tasks() {
+  unsigned int i = 0u;
+  for (; i < TRANSCEIVER_PORT_COUNT; i++) {
+    if (g_ports[i].initialized) {
+      PortTasks(&g_ports[i]);
+    }
+  }
+}
+
 /*
  * Queue an operation.
+ * @param port The port to queue the operation on.
  * @param token The token for this operation.
  * @param start_code The start code for the outgoing frame.
  * @param op The type of operation.
@@ -1602,241 +2723,386 @@ void Transceiver_Tasks() {
  * @param size The number of slots.
  * @returns true if the operation was queued, false if the buffer was full.
  */
-bool Transceiver_QueueFrame(int16_t token, uint8_t start_code,
-                            InternalOperation op, const uint8_t* data,
-                            unsigned int size) {
-  if (g_transceiver.free_size == 0u) {
-    return false;
-  }
-
+static bool QueueFrame(TransceiverPort *port, int16_t token,
+                       uint8_t start_code, InternalOperation op,
+                       const uint8_t* data, unsigned int size) {
   if (op == OP_SELF_TEST) {
-    if (g_transceiver.mode != T_MODE_SELF_TEST) {
+    if (port->mode != T_MODE_SELF_TEST) {
       return false;
     }
-  } else if (g_transceiver.mode != T_MODE_CONTROLLER) {
+  } else if (port->mode != T_MODE_CONTROLLER) {
     return false;
   }
 
-  g_transceiver.free_size--;
-  g_transceiver.next = g_transceiver.free_list[g_transceiver.free_size];
+  TransceiverBuffer *buffer = EnqueueBuffer(
+      port, op == OP_TX_ONLY ? &port->dmx_queue : &port->rdm_queue, data);
+  if (!buffer) {
+    return false;
+  }
 
   if (size > DMX_FRAME_SIZE) {
     size = DMX_FRAME_SIZE;
   }
-  g_transceiver.next->size = size + 1u;  // include start code.
-  g_transceiver.next->op = op;
-  g_transceiver.next->token = token;
-  g_transceiver.next->data[0] = start_code;
-  SysLog_Print(SYSLOG_INFO, "Start code %d", start_code);
-  if (size) {
-    memcpy(&g_transceiver.next->data[1], data, size);
+  buffer->size = size + 1u;  // include start code.
+  buffer->op = op;
+  buffer->token = token;
+  buffer->data[0] = start_code;
+  SysLog_Event(SYSLOG_INFO, "Start code %d", start_code);
+  // If this is the loaned buffer, the data is already in place.
+  if (size && data != &buffer->data[1]) {
+    memcpy(&buffer->data[1], data, size);
   }
   return true;
 }
 
-bool Transceiver_QueueDMX(int16_t token, const uint8_t* data,
-                          unsigned int size) {
-  return Transceiver_QueueFrame(
-      token, NULL_START_CODE, OP_TX_ONLY, data, size);
+bool Transceiver_QueueDMX(uint8_t port_index, int16_t token,
+                          const uint8_t* data, unsigned int size) {
+  return QueueFrame(&g_ports[port_index], token, NULL_START_CODE, OP_TX_ONLY,
+                    data, size);
 }
 
-bool Transceiver_QueueASC(int16_t token, uint8_t start_code,
-                          const uint8_t* data, unsigned int size) {
-  return Transceiver_QueueFrame(
-      token, start_code, OP_TX_ONLY, data, size);
+bool Transceiver_QueueASC(uint8_t port_index, int16_t token,
+                          uint8_t start_code, const uint8_t* data,
+                          unsigned int size) {
+  return QueueFrame(&g_ports[port_index], token, start_code, OP_TX_ONLY,
+                    data, size);
 }
 
-bool Transceiver_QueueRDMDUB(int16_t token, const uint8_t* data,
-                             unsigned int size) {
-  return Transceiver_QueueFrame(
-      token, RDM_START_CODE, OP_RDM_DUB,
-      data, size);
+bool Transceiver_QueueRDMDUB(uint8_t port_index, int16_t token,
+                             const uint8_t* data, unsigned int size) {
+  return QueueFrame(&g_ports[port_index], token, RDM_START_CODE, OP_RDM_DUB,
+                    data, size);
 }
 
-bool Transceiver_QueueRDMRequest(int16_t token, const uint8_t* data,
-                                 unsigned int size, bool is_broadcast) {
-  return Transceiver_QueueFrame(
-      token, RDM_START_CODE,
-      is_broadcast ? OP_RDM_BROADCAST : OP_RDM_WITH_RESPONSE,
-      data, size);
+bool Transceiver_QueueRDMRequest(uint8_t port_index, int16_t token,
+                                 const uint8_t* data, unsigned int size,
+                                 bool is_broadcast) {
+  return QueueFrame(&g_ports[port_index], token, RDM_START_CODE,
+                    is_broadcast ? OP_RDM_BROADCAST : OP_RDM_WITH_RESPONSE,
+                    data, size);
 }
 
-bool Transceiver_QueueRDMResponse(bool include_break,
+bool Transceiver_QueueRDMResponse(uint8_t port_index, bool include_break,
                                   const IOVec* data,
                                   unsigned int iov_count) {
-  if (g_transceiver.mode != T_MODE_RESPONDER || g_transceiver.free_size == 0u) {
+  TransceiverPort *port = &g_ports[port_index];
+  if (port->mode != T_MODE_RESPONDER) {
     return false;
   }
 
-  if (g_transceiver.state != STATE_R_RX_DATA) {
-    // Can only queue while we're receiving data
+  if (port->state != STATE_R_RX_DATA || port->rdm_queue.size ||
+      port->rx_complete) {
+    // Can only queue a single response, while we're receiving the request.
     return false;
   }
 
-  g_transceiver.free_size--;
-  g_transceiver.next = g_transceiver.free_list[g_transceiver.free_size];
+  TransceiverBuffer *buffer = EnqueueBuffer(port, &port->rdm_queue, NULL);
+  if (!buffer) {
+    return false;
+  }
 
   unsigned int i = 0u;
   uint16_t offset = 0u;
   for (; i != iov_count; i++) {
     if (offset + data[i].length > BUFFER_SIZE) {
-      memcpy(g_transceiver.next->data + offset, data[i].base,
+      memcpy(buffer->data + offset, data[i].base,
              BUFFER_SIZE - offset);
       offset = BUFFER_SIZE;
       SysLog_Message(SYSLOG_ERROR, "Truncated RDM response");
       break;
     } else {
-      memcpy(g_transceiver.next->data + offset, data[i].base, data[i].length);
+      memcpy(buffer->data + offset, data[i].base, data[i].length);
       offset += data[i].length;
     }
   }
-  g_transceiver.next->size = offset;
-  g_transceiver.next->op = include_break ? OP_RDM_WITH_RESPONSE :
+  buffer->size = offset;
+  buffer->op = include_break ? OP_RDM_WITH_RESPONSE :
                            OP_RDM_DUB_RESPONSE;
   return true;
 }
 
-bool Transceiver_QueueSelfTest(int16_t token) {
-  return Transceiver_QueueFrame(token, 0, OP_SELF_TEST, NULL, 0);
+void Transceiver_SetDUBResponse(uint8_t port_index, const uint8_t *uid,
+                                const uint8_t *response) {
+  TransceiverPort *port = &g_ports[port_index];
+  if (uid == NULL || response == NULL) {
+    port->dub_enabled = false;
+    if (port->dub_buffer) {
+      // If the response is being sent, it'll be freed once it completes.
+      if (port->dub_buffer != port->active) {
+        port->free_list[port->free_size] = port->dub_buffer;
+        port->free_size++;
+      }
+      port->dub_buffer = NULL;
+    }
+    return;
+  }
+
+  if (port->dub_enabled &&
+      memcmp(port->dub_uid, uid, UID_LENGTH) == 0 &&
+      memcmp(port->dub_response, response, DUB_RESPONSE_LENGTH) == 0) {
+    return;
+  }
+
+  // Disable the fast path while it's updated, so the ISR can't send a
+  // partially copied response.
+  port->dub_enabled = false;
+  memcpy(port->dub_uid, uid, UID_LENGTH);
+  memcpy(port->dub_response, response, DUB_RESPONSE_LENGTH);
+  port->dub_enabled = true;
+}
+
+bool Transceiver_QueueSelfTest(uint8_t port_index, int16_t token) {
+  return QueueFrame(&g_ports[port_index], token, 0, OP_SELF_TEST, NULL, 0);
+}
+
+uint8_t* Transceiver_LoanBuffer(unsigned int *size) {
+  // Buffers are only loaned from the first port. Frames for the other ports
+  // are copied out of the loaned buffer.
+  TransceiverPort *port = &g_ports[0];
+  if (!port->loan) {
+    if (port->free_size == 0u) {
+      return NULL;
+    }
+    port->free_size--;
+    port->loan = port->free_list[port->free_size];
+  }
+  *size = BUFFER_STORAGE_SIZE;
+  return port->loan->storage;
 }
 
 /*
  *  This is called by the MessageHandler, so we know we're not in _Tasks or an
  *  ISR.
  */
-void Transceiver_Reset() {
+void Transceiver_Reset(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
   // Disable & clear all interrupts.
-  SYS_INT_SourceDisable(g_hw_settings.usart_tx_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_tx_source);
-  SYS_INT_SourceDisable(g_hw_settings.usart_rx_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_rx_source);
-  SYS_INT_SourceDisable(g_hw_settings.usart_error_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.usart_error_source);
+  SYS_INT_SourceDisable(HW_USART_TX_SOURCE(port));
+  SYS_INT_SourceStatusClear(HW_USART_TX_SOURCE(port));
+  SYS_INT_SourceDisable(HW_USART_RX_SOURCE(port));
+  SYS_INT_SourceStatusClear(HW_USART_RX_SOURCE(port));
+  SYS_INT_SourceDisable(HW_USART_ERROR_SOURCE(port));
+  SYS_INT_SourceStatusClear(HW_USART_ERROR_SOURCE(port));
 
   // Reset Timer
-  SYS_INT_SourceDisable(g_hw_settings.timer_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.timer_source);
-  PLIB_TMR_Stop(g_hw_settings.timer_module_id);
+  SYS_INT_SourceDisable(HW_TIMER_SOURCE(port));
+  SYS_INT_SourceStatusClear(HW_TIMER_SOURCE(port));
+  PLIB_TMR_Stop(HW_TIMER_MODULE_ID(port));
 
   // Reset IC
-  SYS_INT_SourceDisable(g_hw_settings.input_capture_source);
-  SYS_INT_SourceStatusClear(g_hw_settings.input_capture_source);
-  PLIB_IC_Disable(g_hw_settings.input_capture_module);
+  SYS_INT_SourceDisable(HW_INPUT_CAPTURE_SOURCE(port));
+  SYS_INT_SourceStatusClear(HW_INPUT_CAPTURE_SOURCE(port));
+  PLIB_IC_Disable(HW_INPUT_CAPTURE_MODULE(port));
 
   // Reset UART
-  PLIB_USART_ReceiverDisable(g_hw_settings.usart);
-  PLIB_USART_TransmitterDisable(g_hw_settings.usart);
-  PLIB_USART_Disable(g_hw_settings.usart);
+  PLIB_USART_ReceiverDisable(HW_USART(port));
+  PLIB_USART_TransmitterDisable(HW_USART(port));
+  PLIB_USART_Disable(HW_USART(port));
+
+#ifdef TRANSCEIVER_DMA
+  // Reset DMA
+  SYS_INT_SourceDisable(HW_DMA_SOURCE(port));
+  SYS_INT_SourceStatusClear(HW_DMA_SOURCE(port));
+  PLIB_DMA_ChannelXDisable(DMA_ID_0, HW_DMA_CHANNEL(port));
+  PLIB_DMA_ChannelXINTSourceFlagClear(DMA_ID_0, HW_DMA_CHANNEL(port),
+                                      DMA_INT_BLOCK_TRANSFER_COMPLETE);
+  port->dma_rx = false;
+#endif
+
+  // Let the senders of any pending frames know they won't complete, otherwise
+  // they'll wait forever for the event.
+  CancelActive(port);
+  CancelQueue(port, &port->dmx_queue);
+  CancelQueue(port, &port->rdm_queue);
 
   // Reset buffers in case we got into a weird state.
-  InitializeBuffers();
+  InitializeBuffers(port);
 
   // Reset all timing configuration.
-  ResetTimingSettings();
+  ResetTimingSettings(port);
 
   // Set us back into the TX Mark state.
-  ResetToMark();
+  ResetToMark(port);
 
-  g_transceiver.state = STATE_RESET;
+  port->state = STATE_RESET;
 }
 
-bool Transceiver_SetBreakTime(uint16_t break_time_us) {
+bool Transceiver_SetBreakTime(uint8_t port_index, uint16_t break_time_us) {
+  TransceiverPort *port = &g_ports[port_index];
   if (break_time_us < MINIMUM_TX_BREAK_TIME ||
       break_time_us > MAXIMUM_TX_BREAK_TIME) {
     return false;
   }
-  g_timing_settings.break_time = break_time_us;
+  port->settings.break_time = break_time_us;
   uint16_t ticks = MicroSecondsToTicks(break_time_us);
-  g_timing_settings.break_ticks = ticks - BREAK_FUDGE_FACTOR;
+  port->settings.break_ticks = ticks - BREAK_FUDGE_FACTOR;
   SysLog_Print(SYSLOG_INFO, "Break ticks is %d", ticks);
   return true;
 }
 
-uint16_t Transceiver_GetBreakTime() {
-  return g_timing_settings.break_time;
+uint16_t Transceiver_GetBreakTime(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.break_time;
 }
 
-bool Transceiver_SetMarkTime(uint16_t mark_time_us) {
+bool Transceiver_SetMarkTime(uint8_t port_index, uint16_t mark_time_us) {
+  TransceiverPort *port = &g_ports[port_index];
   if (mark_time_us < MINIMUM_TX_MARK_TIME ||
       mark_time_us > MAXIMUM_TX_MARK_TIME) {
     return false;
   }
-  g_timing_settings.mark_time = mark_time_us;
+  port->settings.mark_time = mark_time_us;
   uint16_t ticks = MicroSecondsToTicks(mark_time_us);
-  g_timing_settings.mark_ticks = ticks - MARK_FUDGE_FACTOR;
+  port->settings.mark_ticks = ticks - MARK_FUDGE_FACTOR;
   SysLog_Print(SYSLOG_INFO, "MAB ticks is %d", ticks);
   return true;
 }
 
-uint16_t Transceiver_GetMarkTime() {
-  return g_timing_settings.mark_time;
+uint16_t Transceiver_GetMarkTime(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.mark_time;
 }
 
-bool Transceiver_SetRDMBroadcastTimeout(uint16_t delay) {
+bool Transceiver_SetRDMBroadcastTimeout(uint8_t port_index, uint16_t delay) {
+  TransceiverPort *port = &g_ports[port_index];
   if (delay > 50u) {
     return false;
   }
-  g_timing_settings.rdm_broadcast_timeout = delay;
+  port->settings.rdm_broadcast_timeout = delay;
   SysLog_Print(SYSLOG_INFO, "Bcast timeout: %d",
-               g_timing_settings.rdm_broadcast_timeout);
+               port->settings.rdm_broadcast_timeout);
   return true;
 }
 
-uint16_t Transceiver_GetRDMBroadcastTimeout() {
-  return g_timing_settings.rdm_broadcast_timeout;
+uint16_t Transceiver_GetRDMBroadcastTimeout(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.rdm_broadcast_timeout;
 }
 
-bool Transceiver_SetRDMResponseTimeout(uint16_t delay) {
+bool Transceiver_SetRDMResponseTimeout(uint8_t port_index, uint16_t delay) {
+  TransceiverPort *port = &g_ports[port_index];
   if (delay < 10u || delay > 50u) {
     return false;
   }
-  g_timing_settings.rdm_response_timeout = delay;
+  port->settings.rdm_response_timeout = delay;
   return true;
 }
 
-uint16_t Transceiver_GetRDMResponseTimeout() {
-  return g_timing_settings.rdm_response_timeout;
+uint16_t Transceiver_GetRDMResponseTimeout(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.rdm_response_timeout;
 }
 
-bool Transceiver_SetRDMDUBResponseLimit(uint16_t limit) {
+bool Transceiver_SetRDMDUBResponseLimit(uint8_t port_index, uint16_t limit) {
+  TransceiverPort *port = &g_ports[port_index];
   // If you change the max here be mindful of the comment in the RX UART ISR
   // about buffer sizes.
   if (limit < 10000u || limit > 35000u) {
     return false;
   }
-  g_timing_settings.rdm_dub_response_limit = limit;
+  port->settings.rdm_dub_response_limit = limit;
   return true;
 }
 
-uint16_t Transceiver_GetRDMDUBResponseLimit() {
-  return g_timing_settings.rdm_dub_response_limit;
+uint16_t Transceiver_GetRDMDUBResponseLimit(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.rdm_dub_response_limit;
 }
 
-bool Transceiver_SetRDMResponderDelay(uint16_t delay) {
+bool Transceiver_SetRDMResponderDelay(uint8_t port_index, uint16_t delay) {
+  TransceiverPort *port = &g_ports[port_index];
   if (delay < MINIMUM_RESPONDER_DELAY || delay > MAXIMUM_RESPONDER_DELAY) {
     return false;
   }
-  g_timing_settings.rdm_responder_delay = delay;
+  port->settings.rdm_responder_delay = delay;
   uint16_t max_jitter = MAXIMUM_RESPONDER_DELAY - delay;
-  g_timing_settings.rdm_responder_jitter = (
-    g_timing_settings.rdm_responder_jitter < max_jitter ?
-    g_timing_settings.rdm_responder_jitter : max_jitter);
+  port->settings.rdm_responder_jitter = (
+    port->settings.rdm_responder_jitter < max_jitter ?
+    port->settings.rdm_responder_jitter : max_jitter);
   return true;
 }
 
-uint16_t Transceiver_GetRDMResponderDelay() {
-  return g_timing_settings.rdm_responder_delay;
+uint16_t Transceiver_GetRDMResponderDelay(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.rdm_responder_delay;
 }
 
-bool Transceiver_SetRDMResponderJitter(uint16_t max_jitter) {
-  if ((uint32_t) max_jitter + g_timing_settings.rdm_responder_delay >
+bool Transceiver_SetRDMResponderJitter(uint8_t port_index,
+                                       uint16_t max_jitter) {
+  TransceiverPort *port = &g_ports[port_index];
+  if ((uint32_t) max_jitter + port->settings.rdm_responder_delay >
       MAXIMUM_RESPONDER_DELAY) {
     return false;
   }
-  g_timing_settings.rdm_responder_jitter = max_jitter;
+  port->settings.rdm_responder_jitter = max_jitter;
   return true;
 }
 
-uint16_t Transceiver_GetRDMResponderJitter() {
-  return g_timing_settings.rdm_responder_jitter;
+uint16_t Transceiver_GetRDMResponderJitter(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.rdm_responder_jitter;
+}
+
+bool Transceiver_SetDMXRefreshInterval(uint8_t port_index, uint16_t interval) {
+  TransceiverPort *port = &g_ports[port_index];
+  if (interval != 0u && (interval < MINIMUM_DMX_REFRESH_INTERVAL ||
+                         interval > MAXIMUM_DMX_REFRESH_INTERVAL)) {
+    return false;
+  }
+  port->settings.dmx_refresh_interval = interval;
+  if (interval == 0u && port->refresh) {
+    // Release the held frame. If it's being sent, it'll be freed once the
+    // frame completes.
+    if (port->refresh != port->active) {
+      port->free_list[port->free_size] = port->refresh;
+      port->free_size++;
+    }
+    port->refresh = NULL;
+  }
+  return true;
+}
+
+uint16_t Transceiver_GetDMXRefreshInterval(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->settings.dmx_refresh_interval;
+}
+
+uint16_t Transceiver_GetFrameRate(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->frame_rate;
+}
+
+void Transceiver_GetTurnaroundStats(uint8_t port_index,
+                                    TransceiverTurnaroundStats *stats) {
+  TransceiverPort *port = &g_ports[port_index];
+  // RecordTurnaround() runs in the UART ISR for fast path DUBs.
+  uint8_t enabled = DisablePortInterrupts(port);
+  *stats = port->turnaround;
+  uint64_t total = port->turnaround_total;
+  RestorePortInterrupts(port, enabled);
+
+  stats->mean = stats->count ? total / stats->count : 0u;
+}
+
+void Transceiver_ResetTurnaroundStats(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  uint8_t enabled = DisablePortInterrupts(port);
+  memset(&port->turnaround, 0, sizeof(port->turnaround));
+  port->turnaround_total = 0u;
+  RestorePortInterrupts(port, enabled);
+}
+
+void Transceiver_GetLineStats(uint8_t port_index, TransceiverLineStats *stats) {
+  TransceiverPort *port = &g_ports[port_index];
+  *stats = port->line_stats;
+}
+
+void Transceiver_ResetLineStats(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  memset(&port->line_stats, 0, sizeof(port->line_stats));
+}
+
+uint32_t Transceiver_GetRXOverrunCount(uint8_t port_index) {
+  TransceiverPort *port = &g_ports[port_index];
+  return port->rx_overruns;
 }
@@ -51,6 +51,12 @@
  *  - Transceiver_QueueRDMDUB();
  *  - Transceiver_QueueRDMRequest();
  *
+ * DMX and ASC frames are held in a separate queue from RDM frames. The two
+ * queues take turns on the line, except when the DMX refresh interval has
+ * passed, in which case a DMX frame is sent next. This keeps the DMX refresh
+ * rate up while RDM requests are being sent. See
+ * Transceiver_SetDMXRefreshInterval().
+ *
  * See @ref controller-overview "Controller State Machine".
  *
  * @par Responder Mode
@@ -59,6 +65,9 @@
  * received. The handler should call Transceiver_QueueRDMResponse() to send a
  * response frame. See @ref responder-overview "Responder State Machine".
  *
+ * DUB requests can also be answered directly from the RX ISR, without waiting
+ * for the handler, see Transceiver_SetDUBResponse().
+ *
  * @par Self Test Mode
  *
  * This puts the E1.11 driver circuit into loopback mode and allows the client
@@ -66,6 +75,24 @@
  * single byte which can be used to confirm the driver circuit is working
  * correctly.
  *
+ * @par Ports
+ *
+ * A device may have up to TRANSCEIVER_PORT_COUNT ports, each driving its own
+ * RS485 line. Each port has its own mode, queues, buffers, timing settings and
+ * statistics, and is serviced by its own set of ISRs. The port_index argument
+ * selects the port, and must be less than TRANSCEIVER_PORT_COUNT. Events
+ * include the index of the port they occurred on.
+ *
+ * @par DMA
+ *
+ * If TRANSCEIVER_DMA is defined in app_settings.h, the slot data is moved
+ * between the USART and the buffers by a DMA channel, rather than by the
+ * USART ISR. This is used for all transmitted frames, and for the responses
+ * received in controller mode. Each port uses the DMA channel from
+ * TRANSCEIVER_DMA_CHANNEL (or TRANSCEIVER_PORT1_DMA_CHANNEL). In responder
+ * mode, requests are still received by the USART ISR, since each slot is
+ * timestamped as it arrives.
+ *
  * @addtogroup transceiver
  * @{
  * @file transceiver.h
@@ -79,6 +106,7 @@
 #include <stdbool.h>
 
 #include "iovec.h"
+#include "setting_macros.h"
 #include "system_config.h"
 #include "peripheral/ic/plib_ic.h"
 #include "peripheral/ports/plib_ports.h"
@@ -181,6 +209,51 @@ typedef union {
   } request;
 } TransceiverTiming;
 
+/**
+ * @brief The number of buckets in the RDM responder turnaround histogram.
+ */
+#define TRANSCEIVER_TURNAROUND_BUCKETS 9u
+
+/**
+ * @brief The RDM responder turnaround statistics.
+ *
+ * The turnaround time is measured from the end of the incoming RDM request to
+ * when the response was ready to send. This shows how long the handler took
+ * and how close the response came to the 2ms limit. All times are in 10ths of
+ * a microsecond.
+ *
+ * The response isn't sent before the responder delay, so turnaround times
+ * shorter than the delay don't show on the line. Turnaround times of 6.5ms or
+ * more are recorded as 0xffff.
+ */
+typedef struct {
+  uint32_t count;  //!< The number of responses sent.
+  uint16_t min;  //!< The shortest turnaround time, or 0 if count is 0.
+  uint16_t max;  //!< The longest turnaround time, or 0 if count is 0.
+  uint16_t mean;  //!< The mean turnaround time, or 0 if count is 0.
+  /**
+   * @brief The turnaround time histogram.
+   *
+   * Each bucket is RESPONDER_TURNAROUND_BUCKET_WIDTH wide. The last bucket
+   * counts all responses at or beyond the 2ms deadline from E1.20.
+   */
+  uint32_t histogram[TRANSCEIVER_TURNAROUND_BUCKETS];
+} TransceiverTurnaroundStats;
+
+/**
+ * @brief The line time used by each class of frame in controller mode.
+ *
+ * A frame's line time runs from the start of the break until the next frame
+ * may start, so it includes any RDM response and the backoff period. All times
+ * are in 10ths of a millisecond.
+ */
+typedef struct {
+  uint32_t dmx_frames;  //!< The number of DMX and ASC frames sent.
+  uint32_t dmx_time;  //!< The line time used by DMX and ASC frames.
+  uint32_t rdm_frames;  //!< The number of RDM requests sent, including DUB.
+  uint32_t rdm_time;  //!< The line time used by RDM requests.
+} TransceiverLineStats;
+
 /**
  * @brief Information about a transceiver event.
  *
@@ -231,6 +304,11 @@ typedef struct {
    * This may be NULL, if no timing information was available.
    */
   TransceiverTiming *timing;
+
+  /**
+   * @brief The index of the port the event occurred on.
+   */
+  uint8_t port;
 } TransceiverEvent;
 
 /**
@@ -244,8 +322,9 @@ typedef bool (*TransceiverEventCallback)(const TransceiverEvent *event);
  * @brief The hardware settings to use for the Transceiver.
  *
  * Alas, this doesn't contain all of the settings. The vector numbers used in
- * the ISRs are required at compile time, so we can't control that. We'll need
- * to come up with a better way to make this modular.
+ * the ISRs are required at compile time, so they come from the
+ * TRANSCEIVER_UART, TRANSCEIVER_TIMER & TRANSCEIVER_IC values (or the
+ * TRANSCEIVER_PORT1_* values for the second port) in app_settings.h.
  */
 typedef struct {
   USART_MODULE_ID usart;  //!< The USART module to use
@@ -266,8 +345,41 @@ typedef struct {
   IC_TIMERS input_capture_timer;  //!< The timer to use for IC
 } TransceiverHardwareSettings;
 
+/**
+ * @brief Build the TransceiverHardwareSettings for a set of peripherals.
+ * @param uart The USART number.
+ * @param timer The timer number, this must be 2 or 3 since it's also used by
+ *   the input capture module.
+ * @param ic The input capture module number.
+ * @param port_channel The port to use for control signals.
+ * @param break_pin The port bit to use to generate breaks.
+ * @param tx_enable_pin The TX Enable bit.
+ * @param rx_enable_pin The RX Enable bit.
+ */
+#define TRANSCEIVER_HW_SETTINGS(uart, timer, ic, port_channel, break_pin, \
+                                tx_enable_pin, rx_enable_pin) \
+  { \
+    .usart = AS_USART_ID(uart), \
+    .usart_vector = AS_USART_INTERRUPT_VECTOR(uart), \
+    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(uart), \
+    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(uart), \
+    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(uart), \
+    .port = port_channel, \
+    .break_bit = break_pin, \
+    .tx_enable_bit = tx_enable_pin, \
+    .rx_enable_bit = rx_enable_pin, \
+    .input_capture_module = AS_IC_ID(ic), \
+    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(ic), \
+    .input_capture_source = AS_IC_INTERRUPT_SOURCE(ic), \
+    .timer_module_id = AS_TIMER_ID(timer), \
+    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(timer), \
+    .timer_source = AS_TIMER_INTERRUPT_SOURCE(timer), \
+    .input_capture_timer = AS_IC_TMR_ID(timer), \
+  }
+
 /**
  * @brief Initialize the transceiver.
+ * @param port_index The index of the port.
  * @param settings The settings to use for the transceiver.
  * @param tx_callback The callback to run when a transceiver TX event occurs.
  * @param rx_callback The callback to run when a transceiver RX event occurs.
@@ -276,13 +388,20 @@ typedef struct {
  * will override the value of tx_callback.
  * If PIPELINE_TRANSCEIVER_RX_EVENT is defined in app_pipeline.h, the macro
  * will override the value of rx_callback.
+ * If TRANSCEIVER_STATIC_HW_SETTINGS is defined in app_settings.h, settings is
+ * ignored and the TRANSCEIVER_* values (or TRANSCEIVER_PORT1_* for the second
+ * port) from app_settings.h are used instead.
+ *
+ * Each port must be initialized before it's used.
  */
-void Transceiver_Initialize(const TransceiverHardwareSettings *settings,
+void Transceiver_Initialize(uint8_t port_index,
+                            const TransceiverHardwareSettings *settings,
                             TransceiverEventCallback tx_callback,
                             TransceiverEventCallback rx_callback);
 
 /**
  * @brief Change the operating mode of the transceiver.
+ * @param port_index The index of the port.
  * @param mode the new operating mode.
  * @param token The token passed to the TransceiverEventCallback when the mode
  *   change completes.
@@ -293,34 +412,44 @@ void Transceiver_Initialize(const TransceiverHardwareSettings *settings,
  * After any in-progress operation completes, then next call to
  * Transceiver_Tasks() will result in the mode change.
  */
-bool Transceiver_SetMode(TransceiverMode mode, int16_t token);
+bool Transceiver_SetMode(uint8_t port_index,
+                         TransceiverMode mode, int16_t token);
 
 /**
  * @brief The operating mode of the transceiver.
+ * @param port_index The index of the port.
  * @returns the current operating mode.
  */
-TransceiverMode Transceiver_GetMode();
+TransceiverMode Transceiver_GetMode(uint8_t port_index);
 
 /**
  * @brief Perform the periodic transceiver tasks.
  *
- * This should be called in the main event loop.
+ * This should be called in the main event loop. It services every port that
+ * has been initialized.
  */
 void Transceiver_Tasks();
 
 /**
  * @brief Queue a DMX frame for transmission.
+ * @param port_index The index of the port.
  * @param token The token for this operation.
  * @param data The DMX data, excluding the start code.
  * @param size The size of the DMX data, excluding the start code.
  * @returns true if the frame was accepted and buffered, false if the transmit
  *   buffer is full.
+ *
+ * Up to TRANSCEIVER_TX_QUEUE_SIZE DMX and ASC frames may be queued at once.
+ * Queued frames are sent in the order they were queued, interleaved with any
+ * queued RDM frames.
  */
-bool Transceiver_QueueDMX(int16_t token, const uint8_t* data,
+bool Transceiver_QueueDMX(uint8_t port_index,
+                          int16_t token, const uint8_t* data,
                           unsigned int size);
 
 /**
  * @brief Queue an alternate start code (ASC) frame for transmission.
+ * @param port_index The index of the port.
  * @param token The token for this operation.
  * @param start_code the alternate start code.
  * @param data The ASC data, excluding the start code.
@@ -328,22 +457,25 @@ bool Transceiver_QueueDMX(int16_t token, const uint8_t* data,
  * @returns true if the frame was accepted and buffered, false if the transmit
  *   buffer is full.
  */
-bool Transceiver_QueueASC(int16_t token, uint8_t start_code,
+bool Transceiver_QueueASC(uint8_t port_index, int16_t token, uint8_t start_code,
                           const uint8_t* data, unsigned int size);
 
 /**
  * @brief Queue an RDM DUB operation.
+ * @param port_index The index of the port.
  * @param token The token for this operation.
  * @param data The RDM DUB data, excluding the start code.
  * @param size The size of the RDM DUB data, excluding the start code.
  * @returns true if the frame was accepted and buffered, false if the transmit
  *   buffer is full.
  */
-bool Transceiver_QueueRDMDUB(int16_t token, const uint8_t* data,
+bool Transceiver_QueueRDMDUB(uint8_t port_index,
+                             int16_t token, const uint8_t* data,
                              unsigned int size);
 
 /**
  * @brief Queue an RDM Get / Set operation.
+ * @param port_index The index of the port.
  * @param token The token for this operation.
  * @param data The RDM data, excluding the start code.
  * @param size The size of the RDM data, excluding the start code.
@@ -351,37 +483,82 @@ bool Transceiver_QueueRDMDUB(int16_t token, const uint8_t* data,
  * @returns true if the frame was accepted and buffered, false if the transmit
  *   buffer is full.
  */
-bool Transceiver_QueueRDMRequest(int16_t token, const uint8_t* data,
+bool Transceiver_QueueRDMRequest(uint8_t port_index,
+                                 int16_t token, const uint8_t* data,
                                  unsigned int size, bool is_broadcast);
 
 /**
  * @brief Queue an RDM Response.
+ * @param port_index The index of the port.
  * @param include_break true if this response requires a break
  * @param iov The data to send in the response
  * @param iov_count The number of IOVecs.
  * @returns true if the frame was accepted and buffered, false if the transmit
  *   buffer is full.
  */
-bool Transceiver_QueueRDMResponse(bool include_break,
+bool Transceiver_QueueRDMResponse(uint8_t port_index, bool include_break,
                                   const IOVec* iov,
                                   unsigned int iov_count);
 
+/**
+ * @brief Set the response sent for DUB requests that cover a UID.
+ * @param port_index The index of the port.
+ * @param uid The UID of the responder, or NULL to disable the fast path.
+ * @param response The DUB_RESPONSE_LENGTH byte encoded DUB response, or NULL.
+ *
+ * In responder mode, a valid DUB request whose destination and range cover
+ * the UID is answered from the RX ISR, as soon as the last byte arrives, so the
+ * response goes out on time no matter how busy the main loop is. The frame is
+ * still passed to the TransceiverEventCallback, but it can't queue a response
+ * for it.
+ *
+ * The caller is responsible for disabling the fast path when the responder
+ * shouldn't answer DUBs, e.g. when it's muted.
+ */
+void Transceiver_SetDUBResponse(uint8_t port_index, const uint8_t *uid,
+                                const uint8_t *response);
+
 
 /**
  * @brief Schedule a loopback self test.
+ * @param port_index The index of the port.
  */
-bool Transceiver_QueueSelfTest(int16_t token);
+bool Transceiver_QueueSelfTest(uint8_t port_index, int16_t token);
+
+/**
+ * @brief Loan a transmit buffer to the host transport.
+ * @param[out] size The size of the loaned buffer.
+ * @returns A pointer to the loaned buffer, or NULL if no buffer is free.
+ *
+ * This allows the host transport to read directly into a transmit buffer. If
+ * the buffer holds a message whose payload starts MESSAGE_HEADER_SIZE bytes
+ * into it, queueing that payload with Transceiver_QueueDMX() or one of the
+ * other Queue functions hands over the buffer without copying the data.
+ *
+ * Only one buffer is loaned at a time; until it's queued, subsequent calls
+ * return the same buffer. Since the buffer may have been queued, this should
+ * be called before each read.
+ *
+ * The buffer belongs to the first port. Frames queued on the other ports are
+ * copied out of the loaned buffer.
+ */
+uint8_t* Transceiver_LoanBuffer(unsigned int *size);
 
 /**
  * @brief Reset the transceiver state.
+ * @param port_index The index of the port.
  *
  * This can be used to recover from an error. The line will be placed back into
  * a MARK state.
+ *
+ * The frame in progress and any queued frames are cancelled, and their
+ * T_RESULT_CANCELLED events run before this returns.
  */
-void Transceiver_Reset();
+void Transceiver_Reset(uint8_t port_index);
 
 /**
  * @brief Set the break (space) time.
+ * @param port_index The index of the port.
  * @param break_time_us the break time in microseconds, values are 44 to 800
  *   inclusive.
  * @returns true if the break time was updated, false if the value was out of
@@ -392,17 +569,19 @@ void Transceiver_Reset();
  * purposes. Table 3-1 in E1.20 lists the minimum break as 176uS and the
  * maximum as 352uS.
  */
-bool Transceiver_SetBreakTime(uint16_t break_time_us);
+bool Transceiver_SetBreakTime(uint8_t port_index, uint16_t break_time_us);
 
 /**
  * @brief Return the current configured break time.
+ * @param port_index The index of the port.
  * @returns The break time in microseconds.
  * @sa Transceiver_SetBreakTime
  */
-uint16_t Transceiver_GetBreakTime();
+uint16_t Transceiver_GetBreakTime(uint8_t port_index);
 
 /**
  * @brief Set the mark-after-break (MAB) time.
+ * @param port_index The index of the port.
  * @param mark_time_us the mark time in microseconds, values are 4 to 800
  *   inclusive.
  * @returns true if the mark time was updated, false if the value was out of
@@ -411,17 +590,19 @@ uint16_t Transceiver_GetBreakTime();
  * The default is 12uS. Table 6 in E1.11 allows 12uS to 1s. Table 3-1 in E1.20
  * allows 12 to 88uS. We go down to 4 uS for testing purposes.
  */
-bool Transceiver_SetMarkTime(uint16_t mark_time_us);
+bool Transceiver_SetMarkTime(uint8_t port_index, uint16_t mark_time_us);
 
 /**
  * @brief Return the current configured mark-after-break (MAB) time.
+ * @param port_index The index of the port.
  * @returns The MAB time in microseconds.
  * @sa Transceiver_SetMarkTime.
  */
-uint16_t Transceiver_GetMarkTime();
+uint16_t Transceiver_GetMarkTime(uint8_t port_index);
 
 /**
  * @brief Set the controller timeout for broadcast RDM commands.
+ * @param port_index The index of the port.
  * @param delay the time to wait for a broadcast response, in 10ths of a
  *   millisecond. Valid values are 0 to 50 (0 to 5ms).
  * @returns true if the broadcast timeout was updated, false if the value
@@ -432,16 +613,18 @@ uint16_t Transceiver_GetMarkTime();
  * want to be able to listen for responders that incorrectly reply to non-DUB
  * broadcasts.
  */
-bool Transceiver_SetRDMBroadcastTimeout(uint16_t delay);
+bool Transceiver_SetRDMBroadcastTimeout(uint8_t port_index, uint16_t delay);
 
 /**
  * @brief Return the current controller timeout for broadcast RDM commands.
+ * @param port_index The index of the port.
  * @returns The RDM broadcast listen time, in 10ths of a millisecond.
  */
-uint16_t Transceiver_GetRDMBroadcastTimeout();
+uint16_t Transceiver_GetRDMBroadcastTimeout(uint8_t port_index);
 
 /**
  * @brief Set the controller's RDM response timeout.
+ * @param port_index The index of the port.
  * @param delay the time to wait in 10ths of a millisecond. Valid values
  *   are 10 - 50 (1 - 5ms). Values < 28 are outside the specification but may
  *   be used for testing.
@@ -458,17 +641,19 @@ uint16_t Transceiver_GetRDMBroadcastTimeout();
  * limits of the specification to fail. By setting the value more than 28, we
  * can accomodate responders that are out-of-spec.
  */
-bool Transceiver_SetRDMResponseTimeout(uint16_t delay);
+bool Transceiver_SetRDMResponseTimeout(uint8_t port_index, uint16_t delay);
 
 /**
  * @brief Return the controller's RDM response timeout.
+ * @param port_index The index of the port.
  * @returns The controller RDM response timeout, in 10ths of a millisecond.
  * @sa Transceiver_SetRDMResponseTimeout
  */
-uint16_t Transceiver_GetRDMResponseTimeout();
+uint16_t Transceiver_GetRDMResponseTimeout(uint8_t port_index);
 
 /**
  * @brief Set the maximum time allowed for a DUB response.
+ * @param port_index The index of the port.
  * @param limit the maximum time to wait from the start of the DUB response
  * until the end, in 10ths of a microseconds. Valid values are 10000 - 35000
  * (1 - 3.5ms). Values < 28000 are outside the specification but may be used
@@ -481,18 +666,20 @@ uint16_t Transceiver_GetRDMResponseTimeout();
  * limits of the specification to fail. By setting the value to more than 29000,
  * we can support responders that are out-of-spec.
  */
-bool Transceiver_SetRDMDUBResponseLimit(uint16_t limit);
+bool Transceiver_SetRDMDUBResponseLimit(uint8_t port_index, uint16_t limit);
 
 /**
  * @brief Return the Controller DUB response timeout.
+ * @param port_index The index of the port.
  * @returns The RDM DUB response limit, in 10ths of a microsecond.
  * @sa Transceiver_SetDUBResponseLimit.
  */
-uint16_t Transceiver_GetRDMDUBResponseLimit();
+uint16_t Transceiver_GetRDMDUBResponseLimit(uint8_t port_index);
 
 /**
  * @brief Configure the delay after the end of the controller's packet before
  * the responder will transmit the reply.
+ * @param port_index The index of the port.
  * @param delay the delay between the end-of-packet and transmitting the
  * responder, in 10ths of a microseconds. Valid values are 1760 - 20000
  * (0.176 - 2ms).
@@ -500,17 +687,19 @@ uint16_t Transceiver_GetRDMDUBResponseLimit();
  *
  * The default value is 1760 (176uS), see Table 3-4, E1.20.
  */
-bool Transceiver_SetRDMResponderDelay(uint16_t delay);
+bool Transceiver_SetRDMResponderDelay(uint8_t port_index, uint16_t delay);
 
 /**
  * @brief Return the RDM responder delay.
+ * @param port_index The index of the port.
  * @returns The RDM responder delay, in 10ths of a microsecond.
  * @sa Transceiver_SetRDMResponderDelay.
  */
-uint16_t Transceiver_GetRDMResponderDelay();
+uint16_t Transceiver_GetRDMResponderDelay(uint8_t port_index);
 
 /**
  * @brief Configure the jitter added to the responder delay.
+ * @param port_index The index of the port.
  * @param max_jitter the maximum jitter in 10ths of a microsecond. Set to 0 to
  *   disable jitter. Valid values are 0 to (20000 - Responder Delay).
  * @returns true if jitter time was updated, false if the value was out of
@@ -518,14 +707,98 @@ uint16_t Transceiver_GetRDMResponderDelay();
  *
  * The default value is 0.
  */
-bool Transceiver_SetRDMResponderJitter(uint16_t max_jitter);
+bool Transceiver_SetRDMResponderJitter(uint8_t port_index, uint16_t max_jitter);
 
 /**
  * @brief Return the RDM responder jitter.
+ * @param port_index The index of the port.
  * @returns The RDM responder jitter, in 10ths of a microsecond.
  * @sa Transceiver_SetRDMResponderJitter.
  */
-uint16_t Transceiver_GetRDMResponderJitter();
+uint16_t Transceiver_GetRDMResponderJitter(uint8_t port_index);
+
+/**
+ * @brief Configure the DMX refresh interval.
+ * @param port_index The index of the port.
+ * @param interval the refresh interval in 10ths of a millisecond. Set to 0 to
+ *   disable refresh. Valid values are 0 or 13 to 10000.
+ * @returns true if the refresh interval was updated, false if the value was
+ *   out of range.
+ *
+ * In controller mode, once a DMX frame has been sent it's held by the
+ * transceiver. If no other DMX frame is queued when the refresh interval
+ * expires, the held frame is sent again, without notifying the caller. Queuing
+ * a new DMX frame replaces the held frame once the new frame has been sent.
+ *
+ * The refresh interval also sets the minimum DMX refresh rate when RDM frames
+ * are queued. Once the interval has passed, the next frame sent is a DMX frame,
+ * rather than an RDM frame. Since a frame in progress isn't interrupted, a
+ * long RDM transaction can still delay the DMX frame.
+ *
+ * The interval is measured from the start of the previous DMX frame. The
+ * default value is 0.
+ */
+bool Transceiver_SetDMXRefreshInterval(uint8_t port_index, uint16_t interval);
+
+/**
+ * @brief Return the DMX refresh interval.
+ * @param port_index The index of the port.
+ * @returns The DMX refresh interval, in 10ths of a millisecond.
+ * @sa Transceiver_SetDMXRefreshInterval.
+ */
+uint16_t Transceiver_GetDMXRefreshInterval(uint8_t port_index);
+
+/**
+ * @brief Return the achieved transmit frame rate.
+ * @param port_index The index of the port.
+ * @returns The number of frames sent in the last second.
+ *
+ * This only counts frames sent in controller mode.
+ */
+uint16_t Transceiver_GetFrameRate(uint8_t port_index);
+
+/**
+ * @brief Return the RDM responder turnaround statistics.
+ * @param port_index The index of the port.
+ * @param stats The struct to populate.
+ *
+ * Only responses sent in responder mode are counted.
+ */
+void Transceiver_GetTurnaroundStats(uint8_t port_index,
+                                    TransceiverTurnaroundStats *stats);
+
+/**
+ * @brief Reset the RDM responder turnaround statistics.
+ * @param port_index The index of the port.
+ */
+void Transceiver_ResetTurnaroundStats(uint8_t port_index);
+
+/**
+ * @brief Return the line time used by DMX and RDM frames.
+ * @param port_index The index of the port.
+ * @param stats The struct to populate.
+ *
+ * Only frames sent in controller mode are counted.
+ */
+void Transceiver_GetLineStats(uint8_t port_index, TransceiverLineStats *stats);
+
+/**
+ * @brief Reset the line time statistics.
+ * @param port_index The index of the port.
+ */
+void Transceiver_ResetLineStats(uint8_t port_index);
+
+/**
+ * @brief Return the number of received frames dropped in responder mode.
+ * @param port_index The index of the port.
+ * @returns The number of frames that ended while the RX handler was still
+ *   busy with the previous one.
+ *
+ * Received frames are double buffered, so the RX handler can overlap with the
+ * next frame. A frame is only dropped if it ends before the handler has
+ * finished with the one before it.
+ */
+uint32_t Transceiver_GetRXOverrunCount(uint8_t port_index);
 
 #ifdef __cplusplus
 }
@@ -136,6 +136,22 @@
  */
 #define CONTROLLER_NON_RDM_BACKOFF 2u
 
+/**
+ * @brief The minimum DMX refresh interval the user can configure.
+ *
+ * Measured in 10ths of a millisecond. We can't send frames any faster than the
+ * minimum break-to-break time.
+ */
+#define MINIMUM_DMX_REFRESH_INTERVAL CONTROLLER_MIN_BREAK_TO_BREAK
+
+/**
+ * @brief The maximum DMX refresh interval the user can configure.
+ *
+ * Measured in 10ths of a millisecond. The value is from Table 6 in E1.11
+ * (2008), which limits the break-to-break time to 1s.
+ */
+#define MAXIMUM_DMX_REFRESH_INTERVAL 10000u
+
 // Responder params
 // ----------------------------------------------------------------------------
 
@@ -167,6 +183,15 @@
  */
 #define MAXIMUM_RESPONDER_DELAY 20000u
 
+/**
+ * @brief The width of each bucket in the responder turnaround histogram.
+ *
+ * Measured in 10ths of a microsecond. With TRANSCEIVER_TURNAROUND_BUCKETS
+ * buckets, the last bucket starts at the 2ms maximum responder packet spacing
+ * from Table 3-4 in E1.20.
+ */
+#define RESPONDER_TURNAROUND_BUCKET_WIDTH 2500u
+
 /**
  * @brief The minimum mark time for responders to receive
  *
@@ -27,6 +27,7 @@
 #include "system_definitions.h"
 #include "transceiver.h"
 #include "uid_store.h"
+#include "usb_transport.h"
 
 #define USB_CONSOLE_BUFFER_SIZE 1024
 // #define USB_CONSOLE_BUFFER_SIZE 70
@@ -398,8 +399,14 @@ void USBConsole_Tasks() {
         case 'c':
           SysLog_Print(SYSLOG_INFO, "DMX Frames %d",
                        ReceiverCounters_DMXFrames());
+          SysLog_Print(SYSLOG_INFO, "Changed DMX Frames %d",
+                       ReceiverCounters_DMXChangedFrames());
           SysLog_Print(SYSLOG_INFO, "RDM Frames %d",
                        ReceiverCounters_RDMFrames());
+          SysLog_Print(SYSLOG_INFO, "RX Overruns %d",
+                       Transceiver_GetRXOverrunCount(0u));
+          SysLog_Print(SYSLOG_INFO, "USB TX Queue Full %d",
+                       USBTransport_GetTXQueueFullCount());
           break;
         case 'd':
           SysLog_Message(SYSLOG_DEBUG, "debug");
@@ -428,11 +435,12 @@ void USBConsole_Tasks() {
           break;
         case 'm':
           SysLog_Print(SYSLOG_INFO, "%s Mode",
-                       Transceiver_GetMode() == T_MODE_CONTROLLER ?
+                       Transceiver_GetMode(0u) == T_MODE_CONTROLLER ?
                        "Controller" : "Responder");
           break;
         case 'M':
-          Transceiver_SetMode(Transceiver_GetMode() == T_MODE_CONTROLLER ?
+          Transceiver_SetMode(0u,
+                              Transceiver_GetMode(0u) == T_MODE_CONTROLLER ?
                               T_MODE_RESPONDER : T_MODE_CONTROLLER,
                               TRANSCEIVER_NO_NOTIFICATION);
           break;
@@ -440,16 +448,19 @@ void USBConsole_Tasks() {
           APP_Reset();
           break;
         case 't':
-          SysLog_Print(SYSLOG_INFO, "Break: %dus", Transceiver_GetBreakTime());
-          SysLog_Print(SYSLOG_INFO, "Mark: %dus", Transceiver_GetMarkTime());
+          SysLog_Print(SYSLOG_INFO, "Break: %dus",
+                       Transceiver_GetBreakTime(0u));
+          SysLog_Print(SYSLOG_INFO, "Mark: %dus", Transceiver_GetMarkTime(0u));
           SysLog_Print(SYSLOG_INFO, "RDM Bcast timeout: %d / 10 us",
-                       Transceiver_GetRDMBroadcastTimeout());
+                       Transceiver_GetRDMBroadcastTimeout(0u));
           SysLog_Print(SYSLOG_INFO, "RDM timeout: %d / 10 us",
-                       Transceiver_GetRDMResponseTimeout());
+                       Transceiver_GetRDMResponseTimeout(0u));
           SysLog_Print(SYSLOG_INFO, "RDM responder delay: %d / 10 us",
-                       Transceiver_GetRDMResponderDelay());
+                       Transceiver_GetRDMResponderDelay(0u));
           SysLog_Print(SYSLOG_INFO, "RDM responder jitter: %d / 10 us",
-                       Transceiver_GetRDMResponderJitter());
+                       Transceiver_GetRDMResponderJitter(0u));
+          SysLog_Print(SYSLOG_INFO, "TX frame rate: %d / s",
+                       Transceiver_GetFrameRate(0u));
           break;
         case 'w':
           SysLog_Message(SYSLOG_WARN, "warning");
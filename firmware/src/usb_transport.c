@@ -32,6 +32,7 @@
 #include "stream_decoder.h"
 #include "system_config.h"
 #include "system_definitions.h"
+#include "transceiver.h"
 #include "transport.h"
 #include "usb/usb_device.h"
 #include "utils.h"
@@ -52,17 +53,21 @@ typedef struct {
   USBTransportState state;
   bool is_configured;  //!< Keep track of whether the device is configured.
 
-  bool tx_in_progress;  //!< True if there is a TX in progress
+  // The TX buffers form a ring. The write complete event runs in the USB ISR
+  // and only advances tx_head, the main loop only advances tx_tail.
+  volatile uint8_t tx_head;  //!< The position of the oldest TX buffer.
+  volatile uint8_t tx_tail;  //!< The position of the next free TX buffer.
+  uint32_t tx_queue_full;  //!< The number of times the TX buffers were full.
   bool rx_in_progress;  //!< True if there is a RX in progress.
   bool dfu_detach;  //!< True if we've received a DFU detach.
 
-  USB_DEVICE_TRANSFER_HANDLE write_transfer;
   USB_DEVICE_TRANSFER_HANDLE read_transfer;
   USB_ENDPOINT_ADDRESS tx_endpoint;  //!< TX endpoint address
   USB_ENDPOINT_ADDRESS rx_endpoint;  //!< RX endpoint address
   uint8_t alt_setting;  //!< The alternate setting, always 0
 
   int rx_data_size;
+  uint8_t *rx_buffer;  //!< The buffer used for the current read.
 } USBTransportData;
 
 static USBTransportData g_usb_transport_data;
@@ -70,8 +75,25 @@ static USBTransportData g_usb_transport_data;
 // Receive data buffer
 static uint8_t receivedDataBuffer[USB_READ_BUFFER_SIZE];
 
-// Transmit data buffer
-static uint8_t transmitDataBuffer[USB_READ_BUFFER_SIZE];
+typedef struct {
+  USB_DEVICE_TRANSFER_HANDLE transfer;
+  uint8_t data[USB_READ_BUFFER_SIZE];
+} TXBuffer;
+
+// Transmit data buffers, these are written to the host in order.
+static TXBuffer g_tx_buffers[USB_TX_BUFFER_COUNT];
+
+// The ring positions wrap at twice the number of buffers, so that a full ring
+// can be told apart from an empty one.
+enum { TX_POSITION_LIMIT = 2u * USB_TX_BUFFER_COUNT };
+
+/*
+ * @brief Return the number of TX buffers being written.
+ */
+static inline uint8_t TXPending() {
+  return (g_usb_transport_data.tx_tail + TX_POSITION_LIMIT -
+          g_usb_transport_data.tx_head) % TX_POSITION_LIMIT;
+}
 
 // The buffer that holds the DFU Status response.
 static uint8_t g_status_response[GET_STATUS_RESPONSE_SIZE];
@@ -108,6 +130,33 @@ static inline void DFUGetStatus() {
                          GET_STATUS_RESPONSE_SIZE);
 }
 
+// Read functions
+// ----------------------------------------------------------------------------
+
+/*
+ * @brief Schedule the next read from the host.
+ *
+ * If the pipeline provides a buffer, the data is read directly into it, which
+ * saves copying it again later. Otherwise we use receivedDataBuffer.
+ */
+static void ScheduleRead() {
+  uint8_t *buffer = NULL;
+  unsigned int size = 0u;
+#ifdef PIPELINE_TRANSPORT_RX_BUFFER
+  buffer = PIPELINE_TRANSPORT_RX_BUFFER(&size);
+#endif
+  if (buffer == NULL || size < sizeof(receivedDataBuffer)) {
+    buffer = receivedDataBuffer;
+  }
+  g_usb_transport_data.rx_buffer = buffer;
+  g_usb_transport_data.rx_in_progress = true;
+  USB_DEVICE_EndpointRead(g_usb_transport_data.usb_device,
+                          &g_usb_transport_data.read_transfer,
+                          g_usb_transport_data.rx_endpoint,
+                          buffer,
+                          sizeof(receivedDataBuffer));
+}
+
 // USB Event Handler
 // ----------------------------------------------------------------------------
 
@@ -191,8 +240,12 @@ void USBTransport_EventHandler(USB_DEVICE_EVENT event, void* event_data,
       break;
 
     case USB_DEVICE_EVENT_ENDPOINT_WRITE_COMPLETE:
-      // Endpoint write is complete
-      g_usb_transport_data.tx_in_progress = false;
+      // Endpoint write is complete. Writes complete in the order they were
+      // queued.
+      if (g_usb_transport_data.tx_head != g_usb_transport_data.tx_tail) {
+        g_usb_transport_data.tx_head = (g_usb_transport_data.tx_head + 1u) %
+                                       TX_POSITION_LIMIT;
+      }
       break;
 
     case USB_DEVICE_EVENT_RESUMED:
@@ -211,10 +264,13 @@ void USBTransport_Initialize(TransportRxFunction rx_cb) {
   g_usb_transport_data.rx_endpoint = 0x01;
   g_usb_transport_data.tx_endpoint = 0x81;
   g_usb_transport_data.rx_in_progress = false;
-  g_usb_transport_data.tx_in_progress = false;
+  g_usb_transport_data.tx_head = 0u;
+  g_usb_transport_data.tx_tail = 0u;
+  g_usb_transport_data.tx_queue_full = 0u;
   g_usb_transport_data.dfu_detach = false;
   g_usb_transport_data.alt_setting = 0;
   g_usb_transport_data.rx_data_size = 0;
+  g_usb_transport_data.rx_buffer = receivedDataBuffer;
 }
 
 void USBTransport_Tasks() {
@@ -268,15 +324,8 @@ void USBTransport_Tasks() {
                                   USB_TRANSFER_TYPE_BULK, endpointSize);
       }
 
-      // Indicate that we are waiting for read
-      g_usb_transport_data.rx_in_progress = true;
-
       // Place a new read request.
-      USB_DEVICE_EndpointRead(g_usb_transport_data.usb_device,
-                              &g_usb_transport_data.read_transfer,
-                              g_usb_transport_data.rx_endpoint,
-                              &receivedDataBuffer[0],
-                              sizeof(receivedDataBuffer));
+      ScheduleRead();
 
       // Device is ready to run the main task
       g_usb_transport_data.state = USB_STATE_MAIN_TASK;
@@ -290,22 +339,17 @@ void USBTransport_Tasks() {
 
       if (g_usb_transport_data.rx_in_progress == false) {
         // We have received data.
-        if (g_usb_transport_data.tx_in_progress == false) {
+        if (TXPending() < USB_TX_BUFFER_COUNT) {
           // we only go ahead and process the data if we can respond.
 #ifdef PIPELINE_TRANSPORT_RX
-          PIPELINE_TRANSPORT_RX(receivedDataBuffer,
+          PIPELINE_TRANSPORT_RX(g_usb_transport_data.rx_buffer,
                                 g_usb_transport_data.rx_data_size);
 #else
-          g_usb_transport_data.rx_cb(receivedDataBuffer,
+          g_usb_transport_data.rx_cb(g_usb_transport_data.rx_buffer,
                                      g_usb_transport_data.rx_data_size);
 #endif
           // schedule the next read
-          g_usb_transport_data.rx_in_progress = true;
-          USB_DEVICE_EndpointRead(g_usb_transport_data.usb_device,
-                                  &g_usb_transport_data.read_transfer,
-                                  g_usb_transport_data.rx_endpoint,
-                                  &receivedDataBuffer[0],
-                                  sizeof (receivedDataBuffer));
+          ScheduleRead();
         }
       }
       break;
@@ -323,7 +367,9 @@ void USBTransport_Tasks() {
                                    g_usb_transport_data.rx_endpoint);
       }
       g_usb_transport_data.rx_in_progress = false;
-      g_usb_transport_data.tx_in_progress = false;
+      // Drop any pending writes. tx_head belongs to the ISR, so the tail is
+      // moved back to it.
+      g_usb_transport_data.tx_tail = g_usb_transport_data.tx_head;
 
       g_usb_transport_data.state = (
           g_usb_transport_data.state == USB_STATE_LOST_POWER ?
@@ -336,59 +382,74 @@ void USBTransport_Tasks() {
 
 bool USBTransport_SendResponse(uint8_t token, Command command, uint8_t rc,
                                const IOVec* data, unsigned int iov_count) {
-  if (g_usb_transport_data.tx_in_progress ||
-      g_usb_transport_data.state != USB_STATE_MAIN_TASK) {
+  if (g_usb_transport_data.state != USB_STATE_MAIN_TASK) {
     return false;
   }
 
-  transmitDataBuffer[0] = START_OF_MESSAGE_ID;
-  transmitDataBuffer[1] = token;
-  transmitDataBuffer[2] = ShortLSB(command);
-  transmitDataBuffer[3] = ShortMSB(command);
+  if (TXPending() == USB_TX_BUFFER_COUNT) {
+    g_usb_transport_data.tx_queue_full++;
+    Flags_SetTXDrop();
+    return false;
+  }
+
+  const uint8_t tail = g_usb_transport_data.tx_tail;
+  TXBuffer *tx_buffer = &g_tx_buffers[tail % USB_TX_BUFFER_COUNT];
+  uint8_t *tx_data = tx_buffer->data;
+
+  tx_data[0] = START_OF_MESSAGE_ID;
+  tx_data[1] = token;
+  tx_data[2] = ShortLSB(command);
+  tx_data[3] = ShortMSB(command);
   // 4 & 5 are the length.
-  transmitDataBuffer[6] = rc;
+  tx_data[6] = rc;
 
   // Set appropriate flags.
-  transmitDataBuffer[7] = 0;
+  tx_data[7] = 0;
   if (Flags_HasChanged()) {
-    transmitDataBuffer[7] |= TRANSPORT_FLAGS_CHANGED;
+    tx_data[7] |= TRANSPORT_FLAGS_CHANGED;
   }
 
   unsigned int i = 0;
   uint16_t offset = 0;
   for (; i != iov_count; i++) {
     if (offset + data[i].length > PAYLOAD_SIZE) {
-      memcpy(transmitDataBuffer + offset + 8, data[i].base,
+      memcpy(tx_data + offset + 8, data[i].base,
              PAYLOAD_SIZE - offset);
       offset = PAYLOAD_SIZE;
-      transmitDataBuffer[7] |= TRANSPORT_MSG_TRUNCATED;
+      tx_data[7] |= TRANSPORT_MSG_TRUNCATED;
       break;
     } else {
-      memcpy(transmitDataBuffer + offset + 8, data[i].base, data[i].length);
+      memcpy(tx_data + offset + 8, data[i].base, data[i].length);
       offset += data[i].length;
     }
   }
 
-  transmitDataBuffer[4] = ShortLSB(offset);
-  transmitDataBuffer[5] = ShortMSB(offset);
-  transmitDataBuffer[8 + offset] = END_OF_MESSAGE_ID;
+  tx_data[4] = ShortLSB(offset);
+  tx_data[5] = ShortMSB(offset);
+  tx_data[8 + offset] = END_OF_MESSAGE_ID;
 
-  g_usb_transport_data.tx_in_progress = true;
+  // The write may complete before USB_DEVICE_EndpointWrite() returns, so the
+  // buffer is added to the ring first.
+  g_usb_transport_data.tx_tail = (tail + 1u) % TX_POSITION_LIMIT;
 
   USB_DEVICE_RESULT result = USB_DEVICE_EndpointWrite(
       g_usb_transport_data.usb_device,
-      &g_usb_transport_data.write_transfer,
-      g_usb_transport_data.tx_endpoint, transmitDataBuffer,
+      &tx_buffer->transfer,
+      g_usb_transport_data.tx_endpoint, tx_data,
       offset + 9,
       USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE);
   if (result != USB_DEVICE_RESULT_OK) {
-    g_usb_transport_data.tx_in_progress = false;
+    g_usb_transport_data.tx_tail = tail;
   }
   return result == USB_DEVICE_RESULT_OK;
 }
 
 bool USBTransport_WritePending() {
-  return g_usb_transport_data.tx_in_progress;
+  return g_usb_transport_data.tx_head != g_usb_transport_data.tx_tail;
+}
+
+uint32_t USBTransport_GetTXQueueFullCount() {
+  return g_usb_transport_data.tx_queue_full;
 }
 
 USB_DEVICE_HANDLE USBTransport_GetHandle() {
@@ -400,10 +461,12 @@ bool USBTransport_IsConfigured() {
 }
 
 void USBTransport_SoftReset() {
-  if (g_usb_transport_data.tx_in_progress) {
+  uint8_t position = g_usb_transport_data.tx_head;
+  const uint8_t tail = g_usb_transport_data.tx_tail;
+  for (; position != tail; position = (position + 1u) % TX_POSITION_LIMIT) {
     USB_DEVICE_EndpointTransferCancel(
         g_usb_transport_data.usb_device,
         g_usb_transport_data.tx_endpoint,
-        g_usb_transport_data.write_transfer);
+        g_tx_buffers[position % USB_TX_BUFFER_COUNT].transfer);
   }
 }
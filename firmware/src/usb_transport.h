@@ -70,10 +70,11 @@ void USBTransport_Tasks();
  * @param data The iovecs with the payload data.
  * @param iov_count The number of IOVecs.
  * @returns true if the message was queued for sending. False if the device was
- * not yet configured, or is there was already a message queued.
+ * not yet configured, or all the transmit buffers are in use.
  *
- * Only one message can be sent at a time. Until the send completes, any
- * further messages will be dropped.
+ * Up to USB_TX_BUFFER_COUNT messages can be queued, they are sent to the host
+ * in order. Once all the buffers are in use, further messages are dropped and
+ * the TX Drop flag is set.
  */
 bool USBTransport_SendResponse(uint8_t token, Command command, uint8_t rc,
                                const IOVec* data, unsigned int iov_count);
@@ -83,6 +84,12 @@ bool USBTransport_SendResponse(uint8_t token, Command command, uint8_t rc,
  */
 bool USBTransport_WritePending();
 
+/**
+ * @brief Return the number of messages dropped because the transmit buffers
+ *   were full.
+ */
+uint32_t USBTransport_GetTXQueueFullCount();
+
 /**
  * @brief Return the USB Device handle.
  * @returns The device handle or USB_DEVICE_HANDLE_INVALID.
@@ -0,0 +1,158 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ChecksumBenchmark.cpp
+ * Measure the end-of-frame checksum cost for maximum length RDM frames.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "constants.h"
+#include "rdm.h"
+#include "rdm_util.h"
+#include "receiver_counters.h"
+#include "responder.h"
+#include "transceiver.h"
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+// The number of frames to time.
+const unsigned int ITERATIONS = 20000;
+
+// The largest RDM frame, including the checksum.
+const unsigned int FRAME_SIZE = 255u;
+
+const uint8_t TEST_UID[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x01};
+const uint8_t CONTROLLER_UID[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x00};
+
+/*
+ * Build a GET request with the largest possible param data.
+ */
+void BuildFrame(uint8_t *frame) {
+  const unsigned int message_length = FRAME_SIZE - RDM_CHECKSUM_LENGTH;
+  RDMHeader *header = reinterpret_cast<RDMHeader*>(frame);
+  memset(frame, 0, FRAME_SIZE);
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = message_length;
+  memcpy(header->dest_uid, TEST_UID, UID_LENGTH);
+  memcpy(header->src_uid, CONTROLLER_UID, UID_LENGTH);
+  header->command_class = GET_COMMAND;
+  header->param_data_length = message_length - sizeof(RDMHeader);
+  for (unsigned int i = sizeof(RDMHeader); i < message_length; i++) {
+    frame[i] = i;
+  }
+  RDMUtil_AppendChecksum(frame);
+}
+
+/*
+ * Return the average time in nanoseconds for the responder to handle the
+ * last byte of the frame.
+ *
+ * The frame arrives a byte at a time, like it does from the UART ISR. Only the
+ * event carrying the final checksum byte is timed, since that's the one in the
+ * window before the response is due.
+ */
+double TimeLastByte(const uint8_t *frame) {
+  TransceiverEvent event;
+  event.token = 0;
+  event.op = T_OP_RX;
+  event.data = frame;
+  event.timing = NULL;
+  event.port = 0u;
+
+  std::chrono::steady_clock::duration total(0);
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    for (unsigned int length = 1; length < FRAME_SIZE; length++) {
+      event.result = length == 1 ? T_RESULT_RX_START_FRAME :
+          T_RESULT_RX_CONTINUE_FRAME;
+      event.length = length;
+      Responder_Receive(&event);
+    }
+    event.result = T_RESULT_RX_CONTINUE_FRAME;
+    event.length = FRAME_SIZE;
+    auto start = std::chrono::steady_clock::now();
+    Responder_Receive(&event);
+    total += std::chrono::steady_clock::now() - start;
+  }
+  return std::chrono::duration<double, std::nano>(total).count() / ITERATIONS;
+}
+
+/*
+ * Return the average time in nanoseconds to verify the whole frame, which
+ * is what the responder did before the checksum was kept as bytes arrived.
+ */
+double TimeVerify(const uint8_t *frame) {
+  unsigned int valid = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    valid += RDMUtil_VerifyChecksum(frame, FRAME_SIZE);
+  }
+  auto end = std::chrono::steady_clock::now();
+  if (valid != ITERATIONS) {
+    cout << "Checksum mismatch" << endl;
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+      ITERATIONS;
+}
+
+/*
+ * Return the average time in nanoseconds to append the checksum to a
+ * maximum length response.
+ */
+double TimeAppend(uint8_t *frame) {
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    RDMUtil_AppendChecksum(frame);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+      ITERATIONS;
+}
+}  // namespace
+
+int main() {
+  uint8_t frame[FRAME_SIZE];
+  BuildFrame(frame);
+
+  Responder_Initialize();
+  ReceiverCounters_ResetCounters();
+
+  double last_byte = TimeLastByte(frame);
+  double verify = TimeVerify(frame);
+  double append = TimeAppend(frame);
+
+  bool ok = ReceiverCounters_RDMChecksumInvalidCounter() == 0u;
+
+  cout << std::left << std::setw(28) << "operation" << std::right
+       << std::setw(12) << "time (ns)" << endl;
+  cout << std::fixed << std::setprecision(1);
+  cout << std::left << std::setw(28) << "responder last byte"
+       << std::right << std::setw(12) << last_byte << endl;
+  cout << std::left << std::setw(28) << "full frame verify"
+       << std::right << std::setw(12) << verify << endl;
+  cout << std::left << std::setw(28) << "append checksum"
+       << std::right << std::setw(12) << append << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
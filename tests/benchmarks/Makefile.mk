@@ -0,0 +1,55 @@
+# Benchmarks
+##################################################
+
+noinst_PROGRAMS += tests/benchmarks/pid_dispatch_benchmark
+
+tests_benchmarks_pid_dispatch_benchmark_SOURCES = \
+    tests/benchmarks/PIDDispatchBenchmark.cpp
+tests_benchmarks_pid_dispatch_benchmark_CXXFLAGS = $(BUILD_FLAGS) \
+                                                   -I tests/include \
+                                                   $(GMOCK_INCLUDES) \
+                                                   $(GTEST_INCLUDES)
+tests_benchmarks_pid_dispatch_benchmark_LDADD = \
+    firmware/src/libdimmermodel.la \
+    firmware/src/libledmodel.la \
+    firmware/src/libmovinglightmodel.la \
+    firmware/src/libnetworkmodel.la \
+    firmware/src/libproxymodel.la \
+    firmware/src/librandom.la \
+    firmware/src/librdmbuffer.la \
+    firmware/src/librdmresponder.la \
+    firmware/src/librdmutil.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/libsensormodel.la \
+    firmware/src/libcoarsetimer.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libspirgbmock.la \
+    $(GMOCK_LIBS) $(GTEST_LIBS)
+
+noinst_PROGRAMS += tests/benchmarks/simulator_benchmark
+
+tests_benchmarks_simulator_benchmark_SOURCES = \
+    tests/benchmarks/SimulatorBenchmark.cpp
+tests_benchmarks_simulator_benchmark_CXXFLAGS = $(TESTING_CXXFLAGS) \
+                                                $(OLA_CFLAGS)
+tests_benchmarks_simulator_benchmark_LDADD = \
+    tests/sim/libsim.la \
+    firmware/src/libtransceiver.la \
+    firmware/src/libcoarsetimer.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libsyslogmock.la \
+    $(GMOCK_LIBS) $(GTEST_LIBS) $(OLA_LIBS)
+
+noinst_PROGRAMS += tests/benchmarks/checksum_benchmark
+
+tests_benchmarks_checksum_benchmark_SOURCES = \
+    tests/benchmarks/ChecksumBenchmark.cpp
+tests_benchmarks_checksum_benchmark_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_benchmarks_checksum_benchmark_LDADD = \
+    firmware/src/libresponder.la \
+    firmware/src/librdmutil.la \
+    firmware/src/libreceivercounters.la \
+    tests/mocks/librdmhandlermock.la \
+    tests/mocks/libsyslogmock.la \
+    tests/mocks/libtransceivermock.la \
+    $(GMOCK_LIBS) $(GTEST_LIBS)
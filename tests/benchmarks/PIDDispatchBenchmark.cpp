@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PIDDispatchBenchmark.cpp
+ * Measure the cost of RDMResponder_DispatchPID() for each model.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Array.h"
+#include "constants.h"
+#include "dimmer_model.h"
+#include "led_model.h"
+#include "moving_light.h"
+#include "network_model.h"
+#include "proxy_model.h"
+#include "sensor_model.h"
+#include "rdm.h"
+#include "rdm_frame.h"
+#include "rdm_responder.h"
+#include "utils.h"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace {
+
+const uint8_t TEST_UID[] = {0x7a, 0x70, 0xff, 0xff, 0xfe, 0x10};
+const uint8_t CONTROLLER_UID[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x00};
+
+// A PID that none of the models support.
+const uint16_t UNKNOWN_PID = 0x7fff;
+
+// The number of times to dispatch each PID.
+const unsigned int ITERATIONS = 20000;
+
+struct ModelProperties {
+  string name;
+  void (*init_fn)();
+  const ModelEntry *entry;
+};
+
+// This matches the list in user_manual/pid_gen.
+const ModelProperties MODELS[] = {
+  {
+    "led",
+    LEDModel_Initialize,
+    &LED_MODEL_ENTRY,
+  },
+  {
+    "proxy",
+    ProxyModel_Initialize,
+    &PROXY_MODEL_ENTRY,
+  },
+  {
+    "moving_light",
+    MovingLightModel_Initialize,
+    &MOVING_LIGHT_MODEL_ENTRY,
+  },
+  {
+    "sensor",
+    SensorModel_Initialize,
+    &SENSOR_MODEL_ENTRY,
+  },
+  {
+    "network",
+    NetworkModel_Initialize,
+    &NETWORK_MODEL_ENTRY,
+  },
+  {
+    "dimmer",
+    DimmerModel_Initialize,
+    &DIMMER_MODEL_ENTRY,
+  },
+};
+
+/*
+ * Build a GET request for the PID.
+ *
+ * The param data length never matches a handler's get_param_size, so every
+ * supported PID ends in the same NACK. This means we measure the cost of the
+ * lookup, rather than the cost of the PID handlers.
+ */
+void BuildRequest(uint16_t pid, RDMHeader *header) {
+  memset(header, 0, sizeof(RDMHeader));
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = sizeof(RDMHeader);
+  memcpy(header->dest_uid, TEST_UID, UID_LENGTH);
+  memcpy(header->src_uid, CONTROLLER_UID, UID_LENGTH);
+  header->command_class = GET_COMMAND;
+  header->param_id = ntohs(pid);
+  header->param_data_length = 0xff;
+}
+
+/*
+ * Return the average time in nanoseconds to dispatch a request.
+ */
+double TimeDispatch(const RDMHeader *header) {
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    RDMResponder_DispatchPID(header, nullptr);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+      ITERATIONS;
+}
+
+/*
+ * Benchmark a single model.
+ * @returns false if the model's descriptor table isn't sorted.
+ */
+bool RunModel(const ModelProperties &model) {
+  RDMResponderSettings settings;
+  memcpy(settings.uid, TEST_UID, UID_LENGTH);
+  RDMResponder_Initialize(&settings);
+
+  model.init_fn();
+  model.entry->activate_fn();
+
+  const ResponderDefinition *definition = g_responder->def;
+  bool sorted = RDMResponder_DescriptorsAreSorted(definition);
+
+  RDMHeader header;
+  double total = 0.0;
+  double worst = 0.0;
+  for (unsigned int i = 0; i < definition->descriptor_count; i++) {
+    BuildRequest(definition->descriptors[i].pid, &header);
+    double time = TimeDispatch(&header);
+    total += time;
+    if (time > worst) {
+      worst = time;
+    }
+  }
+
+  BuildRequest(UNKNOWN_PID, &header);
+  double unknown = TimeDispatch(&header);
+
+  model.entry->deactivate_fn();
+
+  cout << std::left << std::setw(14) << model.name << std::right
+       << std::setw(6) << definition->descriptor_count
+       << std::setw(8) << (sorted ? "yes" : "NO")
+       << std::fixed << std::setprecision(1)
+       << std::setw(12)
+       << (definition->descriptor_count ?
+           total / definition->descriptor_count : 0.0)
+       << std::setw(12) << worst
+       << std::setw(14) << unknown << endl;
+
+  if (!sorted) {
+    cerr << "The descriptors for " << model.name << " are not sorted" << endl;
+  }
+  return sorted;
+}
+}  // namespace
+
+int main() {
+  cout << std::left << std::setw(14) << "model" << std::right
+       << std::setw(6) << "pids"
+       << std::setw(8) << "sorted"
+       << std::setw(12) << "mean (ns)"
+       << std::setw(12) << "worst (ns)"
+       << std::setw(14) << "unknown (ns)" << endl;
+
+  bool ok = true;
+  for (unsigned int i = 0; i < arraysize(MODELS); i++) {
+    ok &= RunModel(MODELS[i]);
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
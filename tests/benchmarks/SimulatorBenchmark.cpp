@@ -0,0 +1,220 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatorBenchmark.cpp
+ * Compare the per-tick and event driven modes of the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+#include "app_settings.h"
+#include "coarse_timer.h"
+#include "dmx_spec.h"
+#include "setting_macros.h"
+#include "transceiver.h"
+
+#include "tests/sim/InterruptController.h"
+#include "tests/sim/PeripheralInputCapture.h"
+#include "tests/sim/PeripheralTimer.h"
+#include "tests/sim/PeripheralUART.h"
+#include "tests/sim/SignalGenerator.h"
+#include "tests/sim/Simulator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declare the ISR symbols.
+void InputCaptureEvent(void);
+void Transceiver_TimerEvent();
+void Transceiver_UARTEvent();
+
+#ifdef __cplusplus
+}
+#endif
+
+using ola::NewCallback;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+namespace {
+
+const uint32_t CLOCK_SPEED = 80000000;
+const uint32_t BAUD_RATE = 250000;
+
+// The number of full DMX frames to receive.
+const unsigned int FRAME_COUNT = 20;
+
+struct Result {
+  double wall_time;  // in ms
+  uint64_t cycles;
+  uint64_t steps;
+  unsigned int frames;
+  unsigned int events;
+};
+
+Result *g_result = nullptr;
+
+bool EventHandler(const TransceiverEvent *event) {
+  if (g_result && event->op == T_OP_RX) {
+    g_result->events++;
+    if (event->result == T_RESULT_RX_START_FRAME) {
+      g_result->frames++;
+    }
+  }
+  return true;
+}
+
+/*
+ * Receive FRAME_COUNT full DMX frames in responder mode.
+ */
+Result RunScenario(Simulator::Mode mode) {
+  Result result = {0.0, 0u, 0u, 0u, 0u};
+
+  std::unique_ptr<ola::Callback0<void>> tasks(
+      NewCallback(&Transceiver_Tasks));
+  Simulator simulator(CLOCK_SPEED, mode);
+  InterruptController interrupt_controller;
+  PeripheralTimer timer(&simulator, &interrupt_controller);
+  PeripheralInputCapture ic(&simulator, &interrupt_controller);
+  PeripheralUART uart(&simulator, &interrupt_controller, nullptr);
+  SignalGenerator generator(&simulator, &ic, &uart, AS_IC_ID(2),
+                            AS_USART_ID(1), CLOCK_SPEED, BAUD_RATE);
+
+  PLIB_TMR_SetMock(&timer);
+  PLIB_IC_SetMock(&ic);
+  PLIB_USART_SetMock(&uart);
+  SYS_INT_SetMock(&interrupt_controller);
+
+  interrupt_controller.RegisterISR(INT_SOURCE_TIMER_1,
+      NewCallback(&CoarseTimer_TimerEvent));
+  interrupt_controller.RegisterISR(INT_SOURCE_TIMER_3,
+      NewCallback(&Transceiver_TimerEvent));
+  interrupt_controller.RegisterISR(INT_SOURCE_INPUT_CAPTURE_2,
+      NewCallback(&InputCaptureEvent));
+  interrupt_controller.RegisterISR(INT_SOURCE_USART_1_ERROR,
+      NewCallback(&Transceiver_UARTEvent));
+  interrupt_controller.RegisterISR(INT_SOURCE_USART_1_TRANSMIT,
+      NewCallback(&Transceiver_UARTEvent));
+  interrupt_controller.RegisterISR(INT_SOURCE_USART_1_RECEIVE,
+      NewCallback(&Transceiver_UARTEvent));
+  simulator.AddTask(tasks.get());
+
+  TransceiverHardwareSettings settings = {
+    .usart = AS_USART_ID(1),
+    .usart_vector = AS_USART_INTERRUPT_VECTOR(1),
+    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(1),
+    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(1),
+    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(1),
+    .port = PORT_CHANNEL_F,
+    .break_bit = PORTS_BIT_POS_8,
+    .tx_enable_bit = PORTS_BIT_POS_1,
+    .rx_enable_bit = PORTS_BIT_POS_0,
+    .input_capture_module = AS_IC_ID(2),
+    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(2),
+    .input_capture_source = AS_IC_INTERRUPT_SOURCE(2),
+    .timer_module_id = AS_TIMER_ID(3),
+    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(3),
+    .timer_source = AS_TIMER_INTERRUPT_SOURCE(3),
+    .input_capture_timer = AS_IC_TMR_ID(3),
+  };
+  Transceiver_Initialize(0u, &settings, &EventHandler, &EventHandler);
+
+  CoarseTimer_Settings timer_settings = {
+    .timer_id = AS_TIMER_ID(1),
+    .interrupt_source = AS_TIMER_INTERRUPT_SOURCE(1)
+  };
+  CoarseTimer_Initialize(&timer_settings);
+
+  Transceiver_SetMode(0u, T_MODE_RESPONDER, 0);
+
+  uint8_t frame[DMX_FRAME_SIZE + 1];
+  for (unsigned int i = 0; i < sizeof(frame); i++) {
+    frame[i] = i & 0xff;
+  }
+  frame[0] = NULL_START_CODE;
+
+  generator.SetStopOnComplete(true);
+  generator.AddDelay(100);
+  for (unsigned int i = 0; i < FRAME_COUNT; i++) {
+    generator.AddBreak(176);
+    generator.AddMark(12);
+    generator.AddFrame(frame, sizeof(frame));
+    generator.AddDelay(100);
+  }
+
+  // Stop if something goes wrong.
+  simulator.SetClockLimit(FRAME_COUNT * 30000, false);
+
+  g_result = &result;
+  auto start = std::chrono::steady_clock::now();
+  simulator.Run();
+  auto end = std::chrono::steady_clock::now();
+  g_result = nullptr;
+
+  result.wall_time = std::chrono::duration<double, std::milli>(
+      end - start).count();
+  result.cycles = simulator.Cycles();
+  result.steps = simulator.Steps();
+
+  simulator.RemoveTask(tasks.get());
+  PLIB_TMR_SetMock(nullptr);
+  PLIB_IC_SetMock(nullptr);
+  PLIB_USART_SetMock(nullptr);
+  SYS_INT_SetMock(nullptr);
+  return result;
+}
+
+void PrintResult(const char *name, const Result &result) {
+  cout << std::left << std::setw(14) << name << std::right
+       << std::setw(8) << result.frames
+       << std::setw(8) << result.events
+       << std::setw(12) << result.cycles
+       << std::setw(12) << result.steps
+       << std::fixed << std::setprecision(1)
+       << std::setw(12) << result.wall_time << endl;
+}
+}  // namespace
+
+int main() {
+  cout << std::left << std::setw(14) << "mode" << std::right
+       << std::setw(8) << "frames"
+       << std::setw(8) << "events"
+       << std::setw(12) << "cycles"
+       << std::setw(12) << "steps"
+       << std::setw(12) << "wall (ms)" << endl;
+
+  Result per_tick = RunScenario(Simulator::MODE_PER_TICK);
+  PrintResult("per-tick", per_tick);
+  Result event_driven = RunScenario(Simulator::MODE_EVENT_DRIVEN);
+  PrintResult("event-driven", event_driven);
+
+  if (per_tick.frames != FRAME_COUNT ||
+      per_tick.frames != event_driven.frames ||
+      per_tick.events != event_driven.events) {
+    cerr << "The modes disagree, or frames were lost" << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "Speedup: " << std::setprecision(1)
+       << per_tick.wall_time / event_driven.wall_time << "x" << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/*
+ * This is the stub for plib_dma.h used for the tests. It contains the bare
+ * minimum required to implement the mock DMA symbols.
+ *
+ * The addresses are uintptr_t rather than uint32_t, so the simulator can use
+ * pointers into host memory.
+ */
+
+#ifndef TESTS_HARMONY_INCLUDE_PERIPHERAL_DMA_PLIB_DMA_H_
+#define TESTS_HARMONY_INCLUDE_PERIPHERAL_DMA_PLIB_DMA_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  DMA_ID_0 = 0,
+  DMA_NUMBER_OF_MODULES
+} DMA_MODULE_ID;
+
+typedef enum {
+  DMA_CHANNEL_0 = 0,
+  DMA_CHANNEL_1,
+  DMA_CHANNEL_2,
+  DMA_CHANNEL_3,
+  DMA_CHANNEL_4,
+  DMA_CHANNEL_5,
+  DMA_CHANNEL_6,
+  DMA_CHANNEL_7,
+  DMA_NUMBER_OF_CHANNELS
+} DMA_CHANNEL;
+
+typedef enum {
+  DMA_CHANNEL_TRIGGER_TRANSFER_START = 0,
+  DMA_CHANNEL_TRIGGER_TRANSFER_ABORT,
+  DMA_CHANNEL_TRIGGER_PATTERN_MATCH_ABORT
+} DMA_CHANNEL_TRIGGER_TYPE;
+
+typedef enum {
+  DMA_INT_ADDRESS_ERROR = 0x01,
+  DMA_INT_TRANSFER_ABORT = 0x02,
+  DMA_INT_CELL_TRANSFER_COMPLETE = 0x04,
+  DMA_INT_BLOCK_TRANSFER_COMPLETE = 0x08,
+  DMA_INT_DESTINATION_HALF_FULL = 0x10,
+  DMA_INT_DESTINATION_DONE = 0x20,
+  DMA_INT_SOURCE_HALF_EMPTY = 0x40,
+  DMA_INT_SOURCE_DONE = 0x80
+} DMA_INT_TYPE;
+
+// The trigger sources share their numbering with the interrupt sources.
+typedef enum {
+  DMA_TRIGGER_USART_1_ERROR = 26,
+  DMA_TRIGGER_USART_1_RECEIVE = 27,
+  DMA_TRIGGER_USART_1_TRANSMIT = 28,
+  DMA_TRIGGER_USART_2_ERROR = 40,
+  DMA_TRIGGER_USART_2_RECEIVE = 41,
+  DMA_TRIGGER_USART_2_TRANSMIT = 42
+} DMA_TRIGGER_SOURCE;
+
+void PLIB_DMA_Enable(DMA_MODULE_ID index);
+
+void PLIB_DMA_ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+
+void PLIB_DMA_ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+
+void PLIB_DMA_ChannelXTriggerEnable(DMA_MODULE_ID index,
+                                    DMA_CHANNEL channel,
+                                    DMA_CHANNEL_TRIGGER_TYPE trigger);
+
+void PLIB_DMA_ChannelXStartIRQSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  DMA_TRIGGER_SOURCE IRQnum);
+
+void PLIB_DMA_ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                            DMA_CHANNEL channel,
+                                            uintptr_t sourceStartAddress);
+
+void PLIB_DMA_ChannelXDestinationStartAddressSet(
+    DMA_MODULE_ID index,
+    DMA_CHANNEL channel,
+    uintptr_t destinationStartAddress);
+
+void PLIB_DMA_ChannelXSourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                    uint16_t sourceSize);
+
+void PLIB_DMA_ChannelXDestinationSizeSet(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel,
+                                         uint16_t destinationSize);
+
+void PLIB_DMA_ChannelXCellSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  uint16_t CellSize);
+
+uint16_t PLIB_DMA_ChannelXDestinationPointerGet(DMA_MODULE_ID index,
+                                                DMA_CHANNEL channel);
+
+void PLIB_DMA_ChannelXINTSourceEnable(DMA_MODULE_ID index,
+                                      DMA_CHANNEL channel,
+                                      DMA_INT_TYPE dmaINTSource);
+
+bool PLIB_DMA_ChannelXINTSourceFlagGet(DMA_MODULE_ID index,
+                                       DMA_CHANNEL channel,
+                                       DMA_INT_TYPE dmaINTSource);
+
+void PLIB_DMA_ChannelXINTSourceFlagClear(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel,
+                                         DMA_INT_TYPE dmaINTSource);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // TESTS_HARMONY_INCLUDE_PERIPHERAL_DMA_PLIB_DMA_H_
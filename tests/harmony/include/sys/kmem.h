@@ -0,0 +1,13 @@
+/*
+ * This is the stub for kmem.h used for the tests. There is no separate
+ * physical address space on the host, so the conversion is a no-op.
+ */
+
+#ifndef TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
+#define TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
+
+#include <stdint.h>
+
+#define KVA_TO_PA(v) ((uintptr_t) (v))
+
+#endif  // TESTS_HARMONY_INCLUDE_SYS_KMEM_H_
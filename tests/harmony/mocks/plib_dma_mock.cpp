@@ -0,0 +1,119 @@
+#include <gmock/gmock.h>
+#include "plib_dma_mock.h"
+
+namespace {
+  PeripheralDMAInterface *g_plib_dma_mock = NULL;
+}
+
+void PLIB_DMA_SetMock(PeripheralDMAInterface* mock) {
+  g_plib_dma_mock = mock;
+}
+
+void PLIB_DMA_Enable(DMA_MODULE_ID index) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->Enable(index);
+  }
+}
+
+void PLIB_DMA_ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXEnable(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXDisable(index, channel);
+  }
+}
+
+void PLIB_DMA_ChannelXTriggerEnable(DMA_MODULE_ID index,
+                                    DMA_CHANNEL channel,
+                                    DMA_CHANNEL_TRIGGER_TYPE trigger) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXTriggerEnable(index, channel, trigger);
+  }
+}
+
+void PLIB_DMA_ChannelXStartIRQSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  DMA_TRIGGER_SOURCE IRQnum) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXStartIRQSet(index, channel, IRQnum);
+  }
+}
+
+void PLIB_DMA_ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                            DMA_CHANNEL channel,
+                                            uintptr_t sourceStartAddress) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXSourceStartAddressSet(index, channel,
+                                                   sourceStartAddress);
+  }
+}
+
+void PLIB_DMA_ChannelXDestinationStartAddressSet(
+    DMA_MODULE_ID index,
+    DMA_CHANNEL channel,
+    uintptr_t destinationStartAddress) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXDestinationStartAddressSet(
+        index, channel, destinationStartAddress);
+  }
+}
+
+void PLIB_DMA_ChannelXSourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                    uint16_t sourceSize) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXSourceSizeSet(index, channel, sourceSize);
+  }
+}
+
+void PLIB_DMA_ChannelXDestinationSizeSet(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel,
+                                         uint16_t destinationSize) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXDestinationSizeSet(index, channel,
+                                                destinationSize);
+  }
+}
+
+void PLIB_DMA_ChannelXCellSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  uint16_t CellSize) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXCellSizeSet(index, channel, CellSize);
+  }
+}
+
+uint16_t PLIB_DMA_ChannelXDestinationPointerGet(DMA_MODULE_ID index,
+                                                DMA_CHANNEL channel) {
+  if (g_plib_dma_mock) {
+    return g_plib_dma_mock->ChannelXDestinationPointerGet(index, channel);
+  }
+  return 0;
+}
+
+void PLIB_DMA_ChannelXINTSourceEnable(DMA_MODULE_ID index,
+                                      DMA_CHANNEL channel,
+                                      DMA_INT_TYPE dmaINTSource) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXINTSourceEnable(index, channel, dmaINTSource);
+  }
+}
+
+bool PLIB_DMA_ChannelXINTSourceFlagGet(DMA_MODULE_ID index,
+                                       DMA_CHANNEL channel,
+                                       DMA_INT_TYPE dmaINTSource) {
+  if (g_plib_dma_mock) {
+    return g_plib_dma_mock->ChannelXINTSourceFlagGet(index, channel,
+                                                     dmaINTSource);
+  }
+  return false;
+}
+
+void PLIB_DMA_ChannelXINTSourceFlagClear(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel,
+                                         DMA_INT_TYPE dmaINTSource) {
+  if (g_plib_dma_mock) {
+    g_plib_dma_mock->ChannelXINTSourceFlagClear(index, channel, dmaINTSource);
+  }
+}
@@ -114,3 +114,17 @@ USART_ERROR PLIB_USART_ErrorsGet(USART_MODULE_ID index) {
   }
   return USART_ERROR_NONE;
 }
+
+void* PLIB_USART_TransmitterAddressGet(USART_MODULE_ID index) {
+  if (g_plib_usart_mock) {
+    return g_plib_usart_mock->TransmitterAddressGet(index);
+  }
+  return NULL;
+}
+
+void* PLIB_USART_ReceiverAddressGet(USART_MODULE_ID index) {
+  if (g_plib_usart_mock) {
+    return g_plib_usart_mock->ReceiverAddressGet(index);
+  }
+  return NULL;
+}
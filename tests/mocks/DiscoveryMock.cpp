@@ -0,0 +1,105 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DiscoveryMock.cpp
+ * A mock Discovery module.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "DiscoveryMock.h"
+
+namespace {
+static MockDiscovery *g_discovery_mock = NULL;
+}
+
+void Discovery_SetMock(MockDiscovery* mock) {
+  g_discovery_mock = mock;
+}
+
+void Discovery_Initialize(const DiscoverySettings *settings) {
+  if (g_discovery_mock) {
+    g_discovery_mock->Initialize(settings);
+  }
+}
+
+bool Discovery_Start(int16_t token, uint8_t port, DiscoveryMode mode) {
+  if (g_discovery_mock) {
+    return g_discovery_mock->Start(token, port, mode);
+  }
+  return false;
+}
+
+bool Discovery_IsRunning() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->IsRunning();
+  }
+  return false;
+}
+
+uint8_t Discovery_GetPort() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->GetPort();
+  }
+  return 0u;
+}
+
+bool Discovery_TransceiverEvent(const TransceiverEvent *event) {
+  if (g_discovery_mock) {
+    return g_discovery_mock->TransceiverEvent(event);
+  }
+  return false;
+}
+
+unsigned int Discovery_UIDCount() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->UIDCount();
+  }
+  return 0u;
+}
+
+const uint8_t *Discovery_GetUIDs() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->GetUIDs();
+  }
+  return NULL;
+}
+
+unsigned int Discovery_AddedCount() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->AddedCount();
+  }
+  return 0u;
+}
+
+const uint8_t *Discovery_GetAddedUIDs() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->GetAddedUIDs();
+  }
+  return NULL;
+}
+
+unsigned int Discovery_RemovedCount() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->RemovedCount();
+  }
+  return 0u;
+}
+
+const uint8_t *Discovery_GetRemovedUIDs() {
+  if (g_discovery_mock) {
+    return g_discovery_mock->GetRemovedUIDs();
+  }
+  return NULL;
+}
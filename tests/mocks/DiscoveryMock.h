@@ -0,0 +1,45 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DiscoveryMock.h
+ * A mock Discovery module.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_MOCKS_DISCOVERYMOCK_H_
+#define TESTS_MOCKS_DISCOVERYMOCK_H_
+
+#include <gmock/gmock.h>
+
+#include "discovery.h"
+
+class MockDiscovery {
+ public:
+  MOCK_METHOD1(Initialize, void(const DiscoverySettings *settings));
+  MOCK_METHOD3(Start, bool(int16_t token, uint8_t port, DiscoveryMode mode));
+  MOCK_METHOD0(IsRunning, bool());
+  MOCK_METHOD0(GetPort, uint8_t());
+  MOCK_METHOD1(TransceiverEvent, bool(const ::TransceiverEvent *event));
+  MOCK_METHOD0(UIDCount, unsigned int());
+  MOCK_METHOD0(GetUIDs, const uint8_t*());
+  MOCK_METHOD0(AddedCount, unsigned int());
+  MOCK_METHOD0(GetAddedUIDs, const uint8_t*());
+  MOCK_METHOD0(RemovedCount, unsigned int());
+  MOCK_METHOD0(GetRemovedUIDs, const uint8_t*());
+};
+
+void Discovery_SetMock(MockDiscovery* mock);
+
+#endif  // TESTS_MOCKS_DISCOVERYMOCK_H_
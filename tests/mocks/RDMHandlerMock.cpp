@@ -47,6 +47,27 @@ void RDMHandler_GetUID(uint8_t *uid) {
   }
 }
 
+bool RDMHandler_GetDMXWindow(DMXSlotWindow *window) {
+  if (g_rdmhandler_mock) {
+    return g_rdmhandler_mock->GetDMXWindow(window);
+  }
+  return false;
+}
+
+bool RDMHandler_GetDUBResponse(uint8_t *uid, uint8_t *response) {
+  if (g_rdmhandler_mock) {
+    return g_rdmhandler_mock->GetDUBResponse(uid, response);
+  }
+  return false;
+}
+
+void RDMHandler_HandleDMX(const uint8_t *slots, unsigned int length,
+                          bool changed) {
+  if (g_rdmhandler_mock) {
+    g_rdmhandler_mock->HandleDMX(slots, length, changed);
+  }
+}
+
 bool RDMHandler_SetActiveModel(uint16_t model_id) {
   if (g_rdmhandler_mock) {
     return g_rdmhandler_mock->SetActiveModel(model_id);
@@ -31,6 +31,10 @@ class MockRDMHandler {
   MOCK_METHOD1(AddModel, bool(const ModelEntry *entry));
   MOCK_METHOD1(SetActiveModel, bool(uint16_t model_id));
   MOCK_METHOD1(GetUID, void(uint8_t *uid));
+  MOCK_METHOD1(GetDMXWindow, bool(DMXSlotWindow *window));
+  MOCK_METHOD2(GetDUBResponse, bool(uint8_t *uid, uint8_t *response));
+  MOCK_METHOD3(HandleDMX, void(const uint8_t *slots, unsigned int length,
+                               bool changed));
   MOCK_METHOD2(HandleRequest, void(const RDMHeader *header,
                                    const uint8_t *param_data));
   MOCK_METHOD0(Tasks, void());
@@ -47,6 +47,14 @@ void SysLog_Print(SysLogLevel level, const char* format, ...) {
   (void) format;
 }
 
+void SysLog_QueueEvent(SysLogLevel level, const char* format, ...) {
+  // Noop
+  (void) level;
+  (void) format;
+}
+
+void SysLog_Tasks() {}
+
 SysLogLevel SysLog_GetLevel() {
   if (g_syslog_mock) {
     return g_syslog_mock->GetLevel();
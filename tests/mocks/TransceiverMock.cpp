@@ -29,24 +29,27 @@ void Transceiver_SetMock(MockTransceiver* mock) {
 }
 
 
-void Transceiver_Initialize(const TransceiverHardwareSettings* settings,
+void Transceiver_Initialize(uint8_t port_index,
+                            const TransceiverHardwareSettings* settings,
                             TransceiverEventCallback tx_callback,
                             TransceiverEventCallback rx_callback) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->Initialize(settings, tx_callback, rx_callback);
+    return g_transceiver_mock->Initialize(port_index, settings, tx_callback,
+                                          rx_callback);
   }
 }
 
-bool Transceiver_SetMode(TransceiverMode mode, int16_t token) {
+bool Transceiver_SetMode(uint8_t port_index, TransceiverMode mode,
+                         int16_t token) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetMode(mode, token);
+    return g_transceiver_mock->SetMode(port_index, mode, token);
   }
   return true;
 }
 
-TransceiverMode Transceiver_GetMode() {
+TransceiverMode Transceiver_GetMode(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetMode();
+    return g_transceiver_mock->GetMode(port_index);
   }
   return T_MODE_RESPONDER;
 }
@@ -57,139 +60,210 @@ void Transceiver_Tasks() {
   }
 }
 
-bool Transceiver_QueueDMX(int16_t token, const uint8_t* data,
-                          unsigned int size) {
+bool Transceiver_QueueDMX(uint8_t port_index, int16_t token,
+                          const uint8_t* data, unsigned int size) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->QueueDMX(token, data, size);
+    return g_transceiver_mock->QueueDMX(port_index, token, data, size);
   }
   return true;
 }
 
-bool Transceiver_QueueASC(int16_t token, uint8_t start_code,
+bool Transceiver_QueueASC(uint8_t port_index, int16_t token, uint8_t start_code,
                           const uint8_t* data, unsigned int size) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->QueueASC(token, start_code, data, size);
+    return g_transceiver_mock->QueueASC(port_index, token, start_code, data,
+                                        size);
   }
   return true;
 }
 
-bool Transceiver_QueueRDMDUB(int16_t token, const uint8_t* data,
-                             unsigned int size) {
+bool Transceiver_QueueRDMDUB(uint8_t port_index, int16_t token,
+                             const uint8_t* data, unsigned int size) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->QueueRDMDUB(token, data, size);
+    return g_transceiver_mock->QueueRDMDUB(port_index, token, data, size);
   }
   return true;
 }
 
-bool Transceiver_QueueRDMRequest(int16_t token, const uint8_t* data,
+bool Transceiver_QueueRDMRequest(uint8_t port_index, int16_t token,
+                                 const uint8_t* data,
                                  unsigned int size, bool is_broadcast) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->QueueRDMRequest(token, data, size, is_broadcast);
+    return g_transceiver_mock->QueueRDMRequest(port_index, token, data, size,
+                                               is_broadcast);
   }
   return true;
 }
 
-bool Transceiver_QueueSelfTest(int16_t token) {
+void Transceiver_SetDUBResponse(uint8_t port_index, const uint8_t *uid,
+                                const uint8_t *response) {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->SetDUBResponse(port_index, uid, response);
+  }
+}
+
+bool Transceiver_QueueSelfTest(uint8_t port_index, int16_t token) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->QueueSelfTest(token);
+    return g_transceiver_mock->QueueSelfTest(port_index, token);
   }
   return true;
 }
 
-bool Transceiver_SetBreakTime(uint16_t mark_time_us) {
+uint8_t* Transceiver_LoanBuffer(unsigned int *size) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->LoanBuffer(size);
+  }
+  return NULL;
+}
+
+bool Transceiver_SetBreakTime(uint8_t port_index, uint16_t mark_time_us) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetBreakTime(mark_time_us);
+    return g_transceiver_mock->SetBreakTime(port_index, mark_time_us);
   }
   return true;
 }
 
-uint16_t Transceiver_GetBreakTime() {
+uint16_t Transceiver_GetBreakTime(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetBreakTime();
+    return g_transceiver_mock->GetBreakTime(port_index);
   }
   return 176;
 }
 
-bool Transceiver_SetMarkTime(uint16_t mark_time_us) {
+bool Transceiver_SetMarkTime(uint8_t port_index, uint16_t mark_time_us) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetMarkTime(mark_time_us);
+    return g_transceiver_mock->SetMarkTime(port_index, mark_time_us);
   }
   return true;
 }
 
-uint16_t Transceiver_GetMarkTime() {
+uint16_t Transceiver_GetMarkTime(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetMarkTime();
+    return g_transceiver_mock->GetMarkTime(port_index);
   }
   return 12;
 }
 
-bool Transceiver_SetRDMBroadcastTimeout(uint16_t delay) {
+bool Transceiver_SetRDMBroadcastTimeout(uint8_t port_index, uint16_t delay) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetRDMBroadcastTimeout(delay);
+    return g_transceiver_mock->SetRDMBroadcastTimeout(port_index, delay);
   }
   return true;
 }
 
-uint16_t Transceiver_GetRDMBroadcastTimeout() {
+uint16_t Transceiver_GetRDMBroadcastTimeout(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetRDMBroadcastTimeout();
+    return g_transceiver_mock->GetRDMBroadcastTimeout(port_index);
   }
   return 0;
 }
 
-bool Transceiver_SetRDMResponseTimeout(uint16_t wait_time) {
+bool Transceiver_SetRDMResponseTimeout(uint8_t port_index, uint16_t wait_time) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetRDMResponseTimeout(wait_time);
+    return g_transceiver_mock->SetRDMResponseTimeout(port_index, wait_time);
   }
   return true;
 }
 
-uint16_t Transceiver_GetRDMResponseTimeout() {
+uint16_t Transceiver_GetRDMResponseTimeout(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetRDMResponseTimeout();
+    return g_transceiver_mock->GetRDMResponseTimeout(port_index);
   }
   return 28;
 }
 
-bool Transceiver_SetRDMDUBResponseLimit(uint16_t limit) {
+bool Transceiver_SetRDMDUBResponseLimit(uint8_t port_index, uint16_t limit) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetRDMDUBResponseLimit(limit);
+    return g_transceiver_mock->SetRDMDUBResponseLimit(port_index, limit);
   }
   return true;
 }
 
-uint16_t Transceiver_GetRDMDUBResponseLimit() {
+uint16_t Transceiver_GetRDMDUBResponseLimit(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetRDMDUBResponseLimit();
+    return g_transceiver_mock->GetRDMDUBResponseLimit(port_index);
   }
   return 28;
 }
 
-bool Transceiver_SetRDMResponderDelay(uint16_t delay) {
+bool Transceiver_SetRDMResponderDelay(uint8_t port_index, uint16_t delay) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetRDMResponderDelay(delay);
+    return g_transceiver_mock->SetRDMResponderDelay(port_index, delay);
   }
   return true;
 }
 
-uint16_t Transceiver_GetRDMResponderDelay() {
+uint16_t Transceiver_GetRDMResponderDelay(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetRDMResponderDelay();
+    return g_transceiver_mock->GetRDMResponderDelay(port_index);
   }
   return 1760;
 }
 
-bool Transceiver_SetRDMResponderJitter(uint16_t max_jitter) {
+bool Transceiver_SetRDMResponderJitter(uint8_t port_index,
+                                       uint16_t max_jitter) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->SetRDMResponderJitter(max_jitter);
+    return g_transceiver_mock->SetRDMResponderJitter(port_index, max_jitter);
   }
   return true;
 }
 
-uint16_t Transceiver_GetRDMResponderJitter() {
+uint16_t Transceiver_GetRDMResponderJitter(uint8_t port_index) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->GetRDMResponderJitter(port_index);
+  }
+  return 0;
+}
+
+bool Transceiver_SetDMXRefreshInterval(uint8_t port_index, uint16_t interval) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->SetDMXRefreshInterval(port_index, interval);
+  }
+  return true;
+}
+
+uint16_t Transceiver_GetDMXRefreshInterval(uint8_t port_index) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->GetDMXRefreshInterval(port_index);
+  }
+  return 0;
+}
+
+uint16_t Transceiver_GetFrameRate(uint8_t port_index) {
+  if (g_transceiver_mock) {
+    return g_transceiver_mock->GetFrameRate(port_index);
+  }
+  return 0;
+}
+
+void Transceiver_GetTurnaroundStats(uint8_t port_index,
+                                    TransceiverTurnaroundStats *stats) {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->GetTurnaroundStats(port_index, stats);
+  }
+}
+
+void Transceiver_ResetTurnaroundStats(uint8_t port_index) {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->ResetTurnaroundStats(port_index);
+  }
+}
+
+void Transceiver_GetLineStats(uint8_t port_index, TransceiverLineStats *stats) {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->GetLineStats(port_index, stats);
+  }
+}
+
+void Transceiver_ResetLineStats(uint8_t port_index) {
+  if (g_transceiver_mock) {
+    g_transceiver_mock->ResetLineStats(port_index);
+  }
+}
+
+uint32_t Transceiver_GetRXOverrunCount(uint8_t port_index) {
   if (g_transceiver_mock) {
-    return g_transceiver_mock->GetRDMResponderJitter();
+    return g_transceiver_mock->GetRXOverrunCount(port_index);
   }
   return 0;
 }
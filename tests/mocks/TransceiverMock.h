@@ -28,36 +28,58 @@
 
 class MockTransceiver {
  public:
-  MOCK_METHOD3(Initialize, void(const TransceiverHardwareSettings* settings,
+  MOCK_METHOD4(Initialize, void(uint8_t port_index,
+                                const TransceiverHardwareSettings* settings,
                                 TransceiverEventCallback tx_callback,
                                 TransceiverEventCallback rx_callback));
-  MOCK_METHOD2(SetMode, bool(TransceiverMode mode, int16_t token));
-  MOCK_METHOD0(GetMode, TransceiverMode());
+  MOCK_METHOD3(SetMode, bool(uint8_t port_index, TransceiverMode mode,
+                             int16_t token));
+  MOCK_METHOD1(GetMode, TransceiverMode(uint8_t port_index));
   MOCK_METHOD0(Tasks, void());
-  MOCK_METHOD3(QueueDMX, bool(int16_t token, const uint8_t* data,
-                              unsigned int size));
-  MOCK_METHOD4(QueueASC, bool(int16_t token, uint8_t start_code,
+  MOCK_METHOD4(QueueDMX, bool(uint8_t port_index, int16_t token,
                               const uint8_t* data, unsigned int size));
-  MOCK_METHOD3(QueueRDMDUB, bool(int16_t token, const uint8_t* data,
-                                 unsigned int size));
-  MOCK_METHOD4(QueueRDMRequest, bool(int16_t token, const uint8_t* data,
+  MOCK_METHOD5(QueueASC, bool(uint8_t port_index, int16_t token,
+                              uint8_t start_code,
+                              const uint8_t* data, unsigned int size));
+  MOCK_METHOD4(QueueRDMDUB, bool(uint8_t port_index, int16_t token,
+                                 const uint8_t* data, unsigned int size));
+  MOCK_METHOD5(QueueRDMRequest, bool(uint8_t port_index, int16_t token,
+                                     const uint8_t* data,
                                      unsigned int size, bool is_broadcast));
-  MOCK_METHOD1(QueueSelfTest, bool(int16_t token));
-  MOCK_METHOD0(Transceiver_Reset, void());
-  MOCK_METHOD1(SetBreakTime, bool(uint16_t break_time_us));
-  MOCK_METHOD0(GetBreakTime, uint16_t());
-  MOCK_METHOD1(SetMarkTime, bool(uint16_t break_time_us));
-  MOCK_METHOD0(GetMarkTime, uint16_t());
-  MOCK_METHOD1(SetRDMBroadcastTimeout, bool(uint16_t break_time_us));
-  MOCK_METHOD0(GetRDMBroadcastTimeout, uint16_t());
-  MOCK_METHOD1(SetRDMResponseTimeout, bool(uint16_t break_time_us));
-  MOCK_METHOD0(GetRDMResponseTimeout, uint16_t());
-  MOCK_METHOD1(SetRDMDUBResponseLimit, bool(uint16_t limit));
-  MOCK_METHOD0(GetRDMDUBResponseLimit, uint16_t());
-  MOCK_METHOD1(SetRDMResponderDelay, bool(uint16_t delay));
-  MOCK_METHOD0(GetRDMResponderDelay, uint16_t());
-  MOCK_METHOD1(SetRDMResponderJitter, bool(uint16_t max_jitter));
-  MOCK_METHOD0(GetRDMResponderJitter, uint16_t());
+  MOCK_METHOD3(SetDUBResponse, void(uint8_t port_index, const uint8_t *uid,
+                                    const uint8_t *response));
+  MOCK_METHOD2(QueueSelfTest, bool(uint8_t port_index, int16_t token));
+  MOCK_METHOD1(LoanBuffer, uint8_t*(unsigned int *size));
+  MOCK_METHOD1(Transceiver_Reset, void(uint8_t port_index));
+  MOCK_METHOD2(SetBreakTime, bool(uint8_t port_index, uint16_t break_time_us));
+  MOCK_METHOD1(GetBreakTime, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetMarkTime, bool(uint8_t port_index, uint16_t break_time_us));
+  MOCK_METHOD1(GetMarkTime, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetRDMBroadcastTimeout, bool(uint8_t port_index,
+                                            uint16_t break_time_us));
+  MOCK_METHOD1(GetRDMBroadcastTimeout, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetRDMResponseTimeout, bool(uint8_t port_index,
+                                           uint16_t break_time_us));
+  MOCK_METHOD1(GetRDMResponseTimeout, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetRDMDUBResponseLimit, bool(uint8_t port_index,
+                                            uint16_t limit));
+  MOCK_METHOD1(GetRDMDUBResponseLimit, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetRDMResponderDelay, bool(uint8_t port_index, uint16_t delay));
+  MOCK_METHOD1(GetRDMResponderDelay, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetRDMResponderJitter, bool(uint8_t port_index,
+                                           uint16_t max_jitter));
+  MOCK_METHOD1(GetRDMResponderJitter, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(SetDMXRefreshInterval, bool(uint8_t port_index,
+                                           uint16_t interval));
+  MOCK_METHOD1(GetDMXRefreshInterval, uint16_t(uint8_t port_index));
+  MOCK_METHOD1(GetFrameRate, uint16_t(uint8_t port_index));
+  MOCK_METHOD2(GetTurnaroundStats, void(uint8_t port_index,
+                                        TransceiverTurnaroundStats *stats));
+  MOCK_METHOD1(ResetTurnaroundStats, void(uint8_t port_index));
+  MOCK_METHOD2(GetLineStats, void(uint8_t port_index,
+                                  TransceiverLineStats *stats));
+  MOCK_METHOD1(ResetLineStats, void(uint8_t port_index));
+  MOCK_METHOD1(GetRXOverrunCount, uint32_t(uint8_t port_index));
 };
 
 void Transceiver_SetMock(MockTransceiver* mock);
@@ -38,6 +38,10 @@ InterruptController::Interrupt::~Interrupt() {
   }
 }
 
+InterruptController::InterruptController()
+    : m_trigger_callback(nullptr) {
+}
+
 InterruptController::~InterruptController() {
   ola::STLDeleteValues(&m_interrupts);
 }
@@ -54,6 +58,9 @@ void InterruptController::RegisterISR(INT_SOURCE source,
 void InterruptController::RaiseInterrupt(INT_SOURCE source) {
   Interrupt *interrupt = GetInterrupt(source);
   interrupt->active = true;
+  if (m_trigger_callback) {
+    m_trigger_callback->Run(source);
+  }
   if (!interrupt->enabled) {
     return;
   }
@@ -68,6 +75,10 @@ void InterruptController::RaiseInterrupt(INT_SOURCE source) {
   }
 }
 
+void InterruptController::SetTriggerCallback(TriggerCallback *callback) {
+  m_trigger_callback = callback;
+}
+
 bool InterruptController::SourceStatusGet(INT_SOURCE source) {
   Interrupt *interrupt = GetInterrupt(source);
   return interrupt->active;
@@ -85,8 +96,9 @@ void InterruptController::SourceEnable(INT_SOURCE source) {
 
 bool InterruptController::SourceDisable(INT_SOURCE source) {
   Interrupt *interrupt = GetInterrupt(source);
+  bool was_enabled = interrupt->enabled;
   interrupt->enabled = false;
-  return true;
+  return was_enabled;
 }
 
 void InterruptController::VectorPrioritySet(
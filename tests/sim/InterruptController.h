@@ -28,7 +28,9 @@
 class InterruptController : public SysIntInterface {
  public:
   typedef ola::Callback0<void> ISRCallback;
+  typedef ola::Callback1<void, INT_SOURCE> TriggerCallback;
 
+  InterruptController();
   ~InterruptController();
 
   // Ownership of the callback is transferred.
@@ -36,6 +38,11 @@ class InterruptController : public SysIntInterface {
 
   void RaiseInterrupt(INT_SOURCE source);
 
+  // The callback is run each time an interrupt is raised, even if the source
+  // is disabled. This is used to trigger the DMA controller.
+  // Ownership is not transferred.
+  void SetTriggerCallback(TriggerCallback *callback);
+
   bool SourceStatusGet(INT_SOURCE source);
   void SourceStatusClear(INT_SOURCE source);
   void SourceEnable(INT_SOURCE source);
@@ -57,6 +64,7 @@ class InterruptController : public SysIntInterface {
   };
 
   std::map<INT_SOURCE, Interrupt*> m_interrupts;
+  TriggerCallback *m_trigger_callback;
 
   Interrupt *GetInterrupt(INT_SOURCE source);
 };
@@ -5,6 +5,8 @@ noinst_LTLIBRARIES += tests/sim/libsim.la
 
 tests_sim_libsim_la_SOURCES = tests/sim/InterruptController.cpp \
                               tests/sim/InterruptController.h \
+                              tests/sim/PeripheralDMA.cpp \
+                              tests/sim/PeripheralDMA.h \
                               tests/sim/PeripheralInputCapture.cpp \
                               tests/sim/PeripheralInputCapture.h \
                               tests/sim/PeripheralSPI.cpp \
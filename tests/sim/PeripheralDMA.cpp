@@ -0,0 +1,274 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralDMA.cpp
+ * The DMA controller used with the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include "PeripheralDMA.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "macros.h"
+#include "ola/Callback.h"
+
+using std::vector;
+
+PeripheralDMA::Channel::Channel(INT_SOURCE source)
+    : interrupt_source(source),
+      enabled(false),
+      start_irq_enabled(false),
+      start_irq(-1),
+      source(0),
+      destination(0),
+      source_size(0),
+      destination_size(0),
+      cell_size(1),
+      source_pointer(0),
+      destination_pointer(0),
+      transferred(0),
+      int_enable(0),
+      int_flags(0) {
+}
+
+PeripheralDMA::PeripheralDMA(InterruptController *interrupt_controller,
+                             PeripheralUART *uart)
+    : m_interrupt_controller(interrupt_controller),
+      m_uart(uart),
+      m_trigger(ola::NewCallback(this, &PeripheralDMA::Trigger)),
+      m_enabled(false),
+      m_cell_count(0) {
+  m_interrupt_controller->SetTriggerCallback(m_trigger.get());
+
+  const vector<INT_SOURCE> sources = {
+    INT_SOURCE_DMA_0,
+    INT_SOURCE_DMA_1,
+    INT_SOURCE_DMA_2,
+    INT_SOURCE_DMA_3,
+    INT_SOURCE_DMA_4,
+    INT_SOURCE_DMA_5,
+    INT_SOURCE_DMA_6,
+    INT_SOURCE_DMA_7
+  };
+
+  for (const auto &int_source : sources) {
+    m_channels.push_back(Channel(int_source));
+  }
+}
+
+PeripheralDMA::~PeripheralDMA() {
+  m_interrupt_controller->SetTriggerCallback(nullptr);
+}
+
+void PeripheralDMA::Enable(DMA_MODULE_ID index) {
+  if (index != DMA_ID_0) {
+    FAIL() << "Invalid DMA module " << index;
+  }
+  m_enabled = true;
+}
+
+void PeripheralDMA::ChannelXEnable(DMA_MODULE_ID index,
+                                   DMA_CHANNEL channel) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->enabled = true;
+  }
+}
+
+void PeripheralDMA::ChannelXDisable(DMA_MODULE_ID index,
+                                    DMA_CHANNEL channel) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    // The pointers are retained, so the progress can still be read.
+    chan->enabled = false;
+  }
+}
+
+void PeripheralDMA::ChannelXTriggerEnable(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          DMA_CHANNEL_TRIGGER_TYPE trigger) {
+  Channel *chan = GetChannel(index, channel);
+  if (!chan) {
+    return;
+  }
+  if (trigger != DMA_CHANNEL_TRIGGER_TRANSFER_START) {
+    FAIL() << "Unimplemented trigger type: " << trigger;
+  }
+  chan->start_irq_enabled = true;
+}
+
+void PeripheralDMA::ChannelXStartIRQSet(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel,
+                                        DMA_TRIGGER_SOURCE IRQnum) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->start_irq = IRQnum;
+  }
+}
+
+// Changing the start address or sizes resets the pointers.
+void PeripheralDMA::ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                                  DMA_CHANNEL channel,
+                                                  uintptr_t address) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->source = address;
+    chan->source_pointer = 0;
+    chan->transferred = 0;
+  }
+}
+
+void PeripheralDMA::ChannelXDestinationStartAddressSet(DMA_MODULE_ID index,
+                                                       DMA_CHANNEL channel,
+                                                       uintptr_t address) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->destination = address;
+    chan->destination_pointer = 0;
+    chan->transferred = 0;
+  }
+}
+
+void PeripheralDMA::ChannelXSourceSizeSet(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          uint16_t size) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->source_size = size;
+    chan->source_pointer = 0;
+    chan->transferred = 0;
+  }
+}
+
+void PeripheralDMA::ChannelXDestinationSizeSet(DMA_MODULE_ID index,
+                                               DMA_CHANNEL channel,
+                                               uint16_t size) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->destination_size = size;
+    chan->destination_pointer = 0;
+    chan->transferred = 0;
+  }
+}
+
+void PeripheralDMA::ChannelXCellSizeSet(DMA_MODULE_ID index,
+                                        DMA_CHANNEL channel,
+                                        uint16_t size) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->cell_size = size;
+  }
+}
+
+uint16_t PeripheralDMA::ChannelXDestinationPointerGet(DMA_MODULE_ID index,
+                                                      DMA_CHANNEL channel) {
+  Channel *chan = GetChannel(index, channel);
+  return chan ? chan->destination_pointer : 0;
+}
+
+void PeripheralDMA::ChannelXINTSourceEnable(DMA_MODULE_ID index,
+                                            DMA_CHANNEL channel,
+                                            DMA_INT_TYPE source) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->int_enable |= source;
+  }
+}
+
+bool PeripheralDMA::ChannelXINTSourceFlagGet(DMA_MODULE_ID index,
+                                             DMA_CHANNEL channel,
+                                             DMA_INT_TYPE source) {
+  Channel *chan = GetChannel(index, channel);
+  return chan ? chan->int_flags & source : false;
+}
+
+void PeripheralDMA::ChannelXINTSourceFlagClear(DMA_MODULE_ID index,
+                                               DMA_CHANNEL channel,
+                                               DMA_INT_TYPE source) {
+  Channel *chan = GetChannel(index, channel);
+  if (chan) {
+    chan->int_flags &= ~source;
+  }
+}
+
+PeripheralDMA::Channel *PeripheralDMA::GetChannel(DMA_MODULE_ID index,
+                                                  DMA_CHANNEL channel) {
+  if (index != DMA_ID_0 || channel >= m_channels.size()) {
+    ADD_FAILURE() << "Invalid DMA channel " << index << ":" << channel;
+    return nullptr;
+  }
+  return &m_channels[channel];
+}
+
+void PeripheralDMA::Trigger(INT_SOURCE source) {
+  if (!m_enabled) {
+    return;
+  }
+  for (auto &channel : m_channels) {
+    if (channel.enabled && channel.start_irq_enabled &&
+        channel.start_irq == source) {
+      TransferCell(&channel);
+    }
+  }
+}
+
+void PeripheralDMA::TransferCell(Channel *channel) {
+  const unsigned int block_size = std::max(channel->source_size,
+                                           channel->destination_size);
+  for (unsigned int i = 0;
+       i < channel->cell_size && channel->transferred < block_size; i++) {
+    Write(channel->destination + channel->destination_pointer,
+          Read(channel->source + channel->source_pointer));
+    channel->transferred++;
+    channel->source_pointer++;
+    if (channel->source_pointer >= channel->source_size) {
+      channel->source_pointer = 0;
+    }
+    channel->destination_pointer++;
+    if (channel->destination_pointer >= channel->destination_size) {
+      channel->destination_pointer = 0;
+    }
+  }
+  m_cell_count++;
+
+  if (channel->transferred == block_size) {
+    // The channel is disabled at the end of the block, and the pointers reset.
+    channel->enabled = false;
+    channel->source_pointer = 0;
+    channel->destination_pointer = 0;
+    channel->transferred = 0;
+    channel->int_flags |= DMA_INT_BLOCK_TRANSFER_COMPLETE;
+    if (channel->int_enable & DMA_INT_BLOCK_TRANSFER_COMPLETE) {
+      m_interrupt_controller->RaiseInterrupt(channel->interrupt_source);
+    }
+  }
+}
+
+uint8_t PeripheralDMA::Read(uintptr_t address) {
+  uint8_t value = 0;
+  if (!m_uart->RegisterRead(address, &value)) {
+    value = *reinterpret_cast<const uint8_t*>(address);
+  }
+  return value;
+}
+
+void PeripheralDMA::Write(uintptr_t address, uint8_t value) {
+  if (!m_uart->RegisterWrite(address, value)) {
+    *reinterpret_cast<uint8_t*>(address) = value;
+  }
+}
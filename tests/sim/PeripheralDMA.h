@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PeripheralDMA.h
+ * The DMA controller used with the simulator.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#ifndef TESTS_SIM_PERIPHERALDMA_H_
+#define TESTS_SIM_PERIPHERALDMA_H_
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "plib_dma_mock.h"
+
+#include "InterruptController.h"
+#include "PeripheralUART.h"
+#include "ola/Callback.h"
+
+/*
+ * Only the start IRQ trigger is implemented. Each time the start IRQ is raised
+ * a single cell is transferred, and the block completes once the larger of the
+ * source & destination sizes has been transferred.
+ *
+ * Addresses that belong to the UART registers are passed to the UART, all
+ * other addresses are treated as pointers to host memory.
+ */
+class PeripheralDMA : public PeripheralDMAInterface {
+ public:
+  // Ownership is not transferred.
+  PeripheralDMA(InterruptController *interrupt_controller,
+                PeripheralUART *uart);
+  ~PeripheralDMA();
+
+  void Enable(DMA_MODULE_ID index);
+  void ChannelXEnable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXDisable(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void ChannelXTriggerEnable(DMA_MODULE_ID index,
+                             DMA_CHANNEL channel,
+                             DMA_CHANNEL_TRIGGER_TYPE trigger);
+  void ChannelXStartIRQSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                           DMA_TRIGGER_SOURCE IRQnum);
+  void ChannelXSourceStartAddressSet(DMA_MODULE_ID index,
+                                     DMA_CHANNEL channel,
+                                     uintptr_t address);
+  void ChannelXDestinationStartAddressSet(DMA_MODULE_ID index,
+                                          DMA_CHANNEL channel,
+                                          uintptr_t address);
+  void ChannelXSourceSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                             uint16_t size);
+  void ChannelXDestinationSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  uint16_t size);
+  void ChannelXCellSizeSet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                           uint16_t size);
+  uint16_t ChannelXDestinationPointerGet(DMA_MODULE_ID index,
+                                         DMA_CHANNEL channel);
+  void ChannelXINTSourceEnable(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                               DMA_INT_TYPE source);
+  bool ChannelXINTSourceFlagGet(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                DMA_INT_TYPE source);
+  void ChannelXINTSourceFlagClear(DMA_MODULE_ID index, DMA_CHANNEL channel,
+                                  DMA_INT_TYPE source);
+
+  // The number of cells transferred since the DMA controller was created.
+  unsigned int CellCount() const { return m_cell_count; }
+
+ private:
+  struct Channel {
+    explicit Channel(INT_SOURCE source);
+
+    const INT_SOURCE interrupt_source;
+    bool enabled;
+    bool start_irq_enabled;
+    int start_irq;
+    uintptr_t source;
+    uintptr_t destination;
+    uint16_t source_size;
+    uint16_t destination_size;
+    uint16_t cell_size;
+    uint16_t source_pointer;
+    uint16_t destination_pointer;
+    // The number of bytes transferred in the current block.
+    unsigned int transferred;
+    uint8_t int_enable;
+    uint8_t int_flags;
+  };
+
+  InterruptController *m_interrupt_controller;
+  PeripheralUART *m_uart;
+  std::unique_ptr<InterruptController::TriggerCallback> m_trigger;
+  std::vector<Channel> m_channels;
+  bool m_enabled;
+  unsigned int m_cell_count;
+
+  Channel *GetChannel(DMA_MODULE_ID index, DMA_CHANNEL channel);
+  void Trigger(INT_SOURCE source);
+  void TransferCell(Channel *channel);
+  uint8_t Read(uintptr_t address);
+  void Write(uintptr_t address, uint8_t value);
+};
+
+#endif  // TESTS_SIM_PERIPHERALDMA_H_
@@ -82,6 +82,7 @@ void PeripheralInputCapture::Tick() {
       m_interrupt_controller->RaiseInterrupt(ic.interrupt_source);
     }
   }
+  ScheduleNextEvent();
 }
 
 void PeripheralInputCapture::TriggerEvent(IC_MODULE_ID index,
@@ -159,6 +160,7 @@ void PeripheralInputCapture::TriggerEvent(IC_MODULE_ID index,
   if (trigger_interrupt) {
     m_interrupt_controller->RaiseInterrupt(ic.interrupt_source);
   }
+  ScheduleNextEvent();
 }
 
 void PeripheralInputCapture::Enable(IC_MODULE_ID index) {
@@ -166,6 +168,7 @@ void PeripheralInputCapture::Enable(IC_MODULE_ID index) {
     FAIL() << "Invalid IC " << index;
   }
   m_ic[index].enabled = true;
+  ScheduleNextEvent();
 }
 
 void PeripheralInputCapture::Disable(IC_MODULE_ID index) {
@@ -245,3 +248,17 @@ bool PeripheralInputCapture::BufferIsEmpty(IC_MODULE_ID index) {
   }
   return m_ic[index].buffer.empty();
 }
+
+void PeripheralInputCapture::ScheduleNextEvent() {
+  if (m_simulator->GetMode() != Simulator::MODE_EVENT_DRIVEN) {
+    return;
+  }
+
+  // The interrupt is raised on every cycle until the buffer is drained.
+  for (const auto &ic : m_ic) {
+    if (ic.enabled && ic.buffer.size() > ic.events_per_interrupt) {
+      m_simulator->ScheduleEvent(1);
+      return;
+    }
+  }
+}
@@ -85,6 +85,8 @@ class PeripheralInputCapture : public PeripheralInputCaptureInterface {
   };
 
   std::vector<InputCapture> m_ic;
+
+  void ScheduleNextEvent();
 };
 
 
@@ -174,6 +174,8 @@ void PeripheralSPI::Tick() {
       m_interrupt_controller->RaiseInterrupt(
           static_cast<INT_SOURCE>(spi.interrupt_source + 1));
     }
+    // The SPI module isn't event driven, it needs to run on every cycle.
+    m_simulator->ScheduleEvent(1);
   }
 }
 
@@ -183,6 +185,7 @@ void PeripheralSPI::Enable(SPI_MODULE_ID index) {
     ADD_FAILURE() << "Invalid SPI " << index;
   }
   m_spi[index].enabled = true;
+  m_simulator->ScheduleEvent(1);
 }
 
 void PeripheralSPI::Disable(SPI_MODULE_ID index) {
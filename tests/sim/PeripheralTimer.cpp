@@ -34,7 +34,8 @@ PeripheralTimer::Timer::Timer(INT_SOURCE source)
       counter(0),
       period(0),
       interrupt_source(source),
-      prescale(TMR_PRESCALE_VALUE_1) {
+      prescale(TMR_PRESCALE_VALUE_1),
+      next_cycle(0) {
 }
 
 PeripheralTimer::PeripheralTimer(Simulator *simulator,
@@ -69,22 +70,17 @@ PeripheralTimer::~PeripheralTimer() {
   m_simulator->RemoveTask(m_callback.get());
 }
 
+/*
+ * The counter is only brought up to date when it's accessed, or when the
+ * simulator runs the Tick() task. This means the simulator can skip over the
+ * cycles between period matches.
+ */
 void PeripheralTimer::Tick() {
-  uint64_t ticks = m_simulator->Clock();
+  uint64_t end = m_simulator->Cycles() + 1;
   for (auto &timer : m_timers) {
-    if (timer.enabled && (ticks % m_prescale_values[timer.prescale] == 0)) {
-      if (timer.counter == timer.period) {
-        timer.counter = 0;
-      } else {
-        timer.counter++;
-        if (timer.counter == timer.period) {
-          timer.in_isr = true;
-          m_interrupt_controller->RaiseInterrupt(timer.interrupt_source);
-          timer.in_isr = false;
-        }
-      }
-    }
+    Advance(&timer, end);
   }
+  ScheduleNextEvent();
 }
 
 void PeripheralTimer::Counter16BitSet(TMR_MODULE_ID index, uint16_t value) {
@@ -92,11 +88,14 @@ void PeripheralTimer::Counter16BitSet(TMR_MODULE_ID index, uint16_t value) {
     FAIL() << "Invalid timer " << index;
   }
 
+  Advance(&m_timers[index], m_simulator->Cycles());
   m_timers[index].counter = value;
+  ScheduleNextEvent();
 }
 
 uint16_t PeripheralTimer::Counter16BitGet(TMR_MODULE_ID index) {
   if (index < m_timers.size()) {
+    Advance(&m_timers[index], m_simulator->Cycles());
     return m_timers[index].counter;
   }
   return 0;
@@ -112,10 +111,12 @@ void PeripheralTimer::Period16BitSet(TMR_MODULE_ID index, uint16_t period) {
   }
 
   Timer *timer = &m_timers[index];
+  Advance(timer, m_simulator->Cycles());
   // Per the data sheet, writes to the period are only allowed when the timer
   // is disabled or we're within the ISR
   if (timer->enabled == false || timer->in_isr) {
     timer->period = period;
+    ScheduleNextEvent();
   } else {
     FAIL() << "Period modifed while timer " << static_cast<int>(index)
            << " was active";
@@ -125,6 +126,7 @@ void PeripheralTimer::Period16BitSet(TMR_MODULE_ID index, uint16_t period) {
 void PeripheralTimer::Stop(TMR_MODULE_ID index) {
   if (index < m_timers.size()) {
     // This does not reset the counter to 0
+    Advance(&m_timers[index], m_simulator->Cycles());
     m_timers[index].enabled = false;
   } else {
     FAIL() << "Invalid timer " << index;
@@ -133,7 +135,9 @@ void PeripheralTimer::Stop(TMR_MODULE_ID index) {
 
 void PeripheralTimer::Start(TMR_MODULE_ID index) {
   if (index < m_timers.size()) {
+    Advance(&m_timers[index], m_simulator->Cycles());
     m_timers[index].enabled = true;
+    ScheduleNextEvent();
   } else {
     FAIL() << "Invalid timer " << index;
   }
@@ -191,3 +195,81 @@ void PeripheralTimer::Mode16BitEnable(TMR_MODULE_ID index) {
   }
 }
 
+/*
+ * @brief Apply the cycles up to, but not including end, to the counter.
+ *
+ * The counter is incremented on each cycle that is a multiple of the
+ * prescaler. The ISR is run when the counter matches the period.
+ */
+void PeripheralTimer::Advance(Timer *timer, uint64_t end) {
+  while (timer->next_cycle < end) {
+    if (!timer->enabled) {
+      timer->next_cycle = end;
+      return;
+    }
+
+    const uint64_t prescale = m_prescale_values[timer->prescale];
+    const uint64_t first = ((timer->next_cycle + prescale - 1) / prescale) *
+                           prescale;
+    const uint32_t increments = IncrementsToMatch(*timer);
+    if (increments && first + (increments - 1) * prescale < end) {
+      timer->counter = timer->period;
+      timer->next_cycle = first + (increments - 1) * prescale + 1;
+      timer->in_isr = true;
+      m_interrupt_controller->RaiseInterrupt(timer->interrupt_source);
+      timer->in_isr = false;
+    } else {
+      uint64_t count = first < end ? (end - 1 - first) / prescale + 1 : 0;
+      timer->counter = CounterAfter(*timer, count);
+      timer->next_cycle = end;
+    }
+  }
+}
+
+void PeripheralTimer::ScheduleNextEvent() {
+  if (m_simulator->GetMode() != Simulator::MODE_EVENT_DRIVEN) {
+    return;
+  }
+
+  const uint64_t now = m_simulator->Cycles();
+  for (const auto &timer : m_timers) {
+    uint32_t increments = IncrementsToMatch(timer);
+    if (!timer.enabled || !increments) {
+      continue;
+    }
+    const uint64_t prescale = m_prescale_values[timer.prescale];
+    const uint64_t first = ((timer.next_cycle + prescale - 1) / prescale) *
+                           prescale;
+    const uint64_t match = first + (increments - 1) * prescale;
+    // If the match is in the past, Tick() hasn't run yet for this cycle and
+    // will handle it.
+    m_simulator->ScheduleEvent(match > now ? match - now : 0);
+  }
+}
+
+/*
+ * @brief The number of increments until the counter matches the period.
+ * @returns The number of increments, or 0 if the counter will never match.
+ */
+uint32_t PeripheralTimer::IncrementsToMatch(const Timer &timer) {
+  if (timer.counter == timer.period) {
+    // The next increment resets the counter to 0.
+    return timer.period ? timer.period + 1u : 0u;
+  }
+  return static_cast<uint16_t>(timer.period - timer.counter);
+}
+
+/*
+ * @brief The counter value after a number of increments, which must be less
+ *   than IncrementsToMatch().
+ */
+uint16_t PeripheralTimer::CounterAfter(const Timer &timer,
+                                       uint64_t increments) {
+  if (increments == 0) {
+    return timer.counter;
+  }
+  if (timer.counter == timer.period) {
+    return timer.period ? increments - 1 : 0;
+  }
+  return static_cast<uint16_t>(timer.counter + increments);
+}
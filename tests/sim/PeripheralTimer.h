@@ -66,10 +66,18 @@ class PeripheralTimer : public PeripheralTimerInterface {
      uint16_t period;
      INT_SOURCE interrupt_source;
      TMR_PRESCALE prescale;
+     // The first cycle that hasn't been applied to the counter.
+     uint64_t next_cycle;
   };
 
   std::vector<Timer> m_timers;
   std::map<TMR_PRESCALE, uint16_t> m_prescale_values;
+
+  void Advance(Timer *timer, uint64_t end);
+  void ScheduleNextEvent();
+
+  static uint32_t IncrementsToMatch(const Timer &timer);
+  static uint16_t CounterAfter(const Timer &timer, uint64_t increments);
 };
 
 #endif  // TESTS_SIM_PERIPHERALTIMER_H_
@@ -37,9 +37,12 @@ PeripheralUART::UART::UART(INT_SOURCE source)
       int_mode(USART_TRANSMIT_FIFO_NOT_FULL),
       tx_byte(0),
       errors(USART_ERROR_NONE),
+      tx_register(0),
+      rx_register(0),
       ticks_per_bit(16),
-      tx_counter(0),
-      tx_state(IDLE) {
+      tx_busy(false),
+      tx_done_at(0),
+      tx_remaining(0) {
 }
 
 PeripheralUART::PeripheralUART(Simulator *simulator,
@@ -69,6 +72,7 @@ PeripheralUART::~PeripheralUART() {
 }
 
 void PeripheralUART::Tick() {
+  const uint64_t now = m_simulator->Cycles();
   for (unsigned int i = 0; i < m_uarts.size(); i++) {
     UART &uart = m_uarts[i];
     if (!uart.enabled) {
@@ -76,24 +80,19 @@ void PeripheralUART::Tick() {
     }
 
     if (uart.tx_enable) {
-      if (uart.tx_state == IDLE && !uart.tx_buffer.empty()) {
-        uart.tx_state = START_BIT;
+      if (!uart.tx_busy && !uart.tx_buffer.empty()) {
+        uart.tx_busy = true;
         uart.tx_byte = uart.tx_buffer.front();
         uart.tx_buffer.pop();
+        // The cycle the byte is loaded on counts towards the start bit.
+        uart.tx_done_at = now + BITS_PER_BYTE * uart.ticks_per_bit - 1;
       }
-      if (uart.tx_state != IDLE) {
-        uart.tx_counter++;
-        if (uart.tx_counter == uart.ticks_per_bit) {
-          uart.tx_counter = 0;
-
-          if (uart.tx_state == STOP_BIT_2) {
-            if (m_tx_callback) {
-              m_tx_callback->Run(static_cast<USART_MODULE_ID>(i), uart.tx_byte);
-            }
-            uart.tx_state = IDLE;
-          } else {
-            uart.tx_state = static_cast<UARTState>(uart.tx_state + 1);
+      if (uart.tx_busy) {
+        if (now >= uart.tx_done_at) {
+          if (m_tx_callback) {
+            m_tx_callback->Run(static_cast<USART_MODULE_ID>(i), uart.tx_byte);
           }
+          uart.tx_busy = false;
         }
 
         bool trigger_tx_isr = false;
@@ -102,7 +101,7 @@ void PeripheralUART::Tick() {
             trigger_tx_isr = uart.tx_buffer.size() < TX_FIFO_SIZE;
             break;
           case USART_TRANSMIT_FIFO_IDLE:
-            trigger_tx_isr = (uart.tx_state == IDLE && uart.tx_buffer.empty());
+            trigger_tx_isr = (!uart.tx_busy && uart.tx_buffer.empty());
             break;
           case USART_TRANSMIT_FIFO_EMPTY:
             trigger_tx_isr = uart.tx_buffer.empty();
@@ -122,6 +121,7 @@ void PeripheralUART::Tick() {
           static_cast<INT_SOURCE>(uart.interrupt_source + 1));
     }
   }
+  ScheduleNextEvent();
 }
 
 void PeripheralUART::ReceiveByte(USART_MODULE_ID index, uint8_t byte) {
@@ -131,6 +131,7 @@ void PeripheralUART::ReceiveByte(USART_MODULE_ID index, uint8_t byte) {
   UART &uart = m_uarts[index];
   if (uart.rx_enable) {
     uart.rx_buffer.push(byte);
+    ScheduleNextEvent();
   }
 }
 
@@ -151,6 +152,7 @@ void PeripheralUART::SignalFramingError(USART_MODULE_ID index, uint8_t byte) {
     } else {
       uart.rx_buffer.push(UART::FRAMING_ERROR_FLAG | byte);
     }
+    ScheduleNextEvent();
   }
 }
 
@@ -159,6 +161,7 @@ void PeripheralUART::Enable(USART_MODULE_ID index) {
     FAIL() << "Invalid UART " << index;
   }
   m_uarts[index].enabled = true;
+  ScheduleNextEvent();
 }
 
 void PeripheralUART::Disable(USART_MODULE_ID index) {
@@ -175,8 +178,8 @@ void PeripheralUART::Disable(USART_MODULE_ID index) {
   while (!uart.rx_buffer.empty()) {
     uart.rx_buffer.pop();
   }
-  uart.tx_counter = 0;
-  uart.tx_state = IDLE;
+  uart.tx_busy = false;
+  uart.tx_remaining = 0;
   // TODO(simon): reset flags here
   uart.errors = USART_ERROR_NONE;
 }
@@ -185,14 +188,25 @@ void PeripheralUART::TransmitterEnable(USART_MODULE_ID index) {
   if (index >= m_uarts.size()) {
     FAIL() << "Invalid UART " << index;
   }
-  m_uarts[index].tx_enable = true;
+  UART &uart = m_uarts[index];
+  if (!uart.tx_enable && uart.tx_busy) {
+    uart.tx_done_at = m_simulator->Cycles() + uart.tx_remaining;
+  }
+  uart.tx_enable = true;
+  ScheduleNextEvent();
 }
 
 void PeripheralUART::TransmitterDisable(USART_MODULE_ID index) {
   if (index >= m_uarts.size()) {
     FAIL() << "Invalid UART " << index;
   }
-  m_uarts[index].tx_enable = false;
+  UART &uart = m_uarts[index];
+  if (uart.tx_enable && uart.tx_busy) {
+    // The transmitter stops mid-byte.
+    const uint64_t now = m_simulator->Cycles();
+    uart.tx_remaining = uart.tx_done_at > now ? uart.tx_done_at - now : 0;
+  }
+  uart.tx_enable = false;
 }
 
 void PeripheralUART::BaudRateSet(USART_MODULE_ID index,
@@ -211,6 +225,7 @@ void PeripheralUART::TransmitterByteSend(USART_MODULE_ID index, int8_t data) {
   UART &uart = m_uarts[index];
   if (uart.tx_buffer.size() < TX_FIFO_SIZE) {
     uart.tx_buffer.push(data);
+    ScheduleNextEvent();
   }
 }
 
@@ -257,6 +272,7 @@ void PeripheralUART::ReceiverEnable(USART_MODULE_ID index) {
     FAIL() << "Invalid UART " << index;
   }
   m_uarts[index].rx_enable = true;
+  ScheduleNextEvent();
 }
 
 void PeripheralUART::ReceiverDisable(USART_MODULE_ID index) {
@@ -316,3 +332,72 @@ USART_ERROR PeripheralUART::ErrorsGet(USART_MODULE_ID index) {
   // Yuck
   return static_cast<USART_ERROR>(m_uarts[index].errors);
 }
+
+void* PeripheralUART::TransmitterAddressGet(USART_MODULE_ID index) {
+  if (index >= m_uarts.size()) {
+    ADD_FAILURE() << "Invalid UART " << index;
+    return nullptr;
+  }
+  return &m_uarts[index].tx_register;
+}
+
+void* PeripheralUART::ReceiverAddressGet(USART_MODULE_ID index) {
+  if (index >= m_uarts.size()) {
+    ADD_FAILURE() << "Invalid UART " << index;
+    return nullptr;
+  }
+  return &m_uarts[index].rx_register;
+}
+
+bool PeripheralUART::RegisterRead(uintptr_t address, uint8_t *value) {
+  for (unsigned int i = 0; i < m_uarts.size(); i++) {
+    if (address == reinterpret_cast<uintptr_t>(&m_uarts[i].rx_register)) {
+      *value = ReceiverByteReceive(static_cast<USART_MODULE_ID>(i));
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PeripheralUART::RegisterWrite(uintptr_t address, uint8_t value) {
+  for (unsigned int i = 0; i < m_uarts.size(); i++) {
+    if (address == reinterpret_cast<uintptr_t>(&m_uarts[i].tx_register)) {
+      TransmitterByteSend(static_cast<USART_MODULE_ID>(i), value);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PeripheralUART::ReceiverIsEnabled(USART_MODULE_ID index) const {
+  if (index >= m_uarts.size()) {
+    ADD_FAILURE() << "Invalid UART " << index;
+    return false;
+  }
+  return m_uarts[index].rx_enable;
+}
+
+void PeripheralUART::ScheduleNextEvent() {
+  if (m_simulator->GetMode() != Simulator::MODE_EVENT_DRIVEN) {
+    return;
+  }
+
+  const uint64_t now = m_simulator->Cycles();
+  for (const auto &uart : m_uarts) {
+    if (!uart.enabled) {
+      continue;
+    }
+    if (uart.tx_enable) {
+      if (uart.tx_busy) {
+        m_simulator->ScheduleEvent(
+            uart.tx_done_at > now ? uart.tx_done_at - now : 0);
+      } else if (!uart.tx_buffer.empty()) {
+        m_simulator->ScheduleEvent(1);
+      }
+    }
+    // The RX interrupt is raised on every cycle until the FIFO is drained.
+    if (uart.rx_enable && !uart.rx_buffer.empty()) {
+      m_simulator->ScheduleEvent(1);
+    }
+  }
+}
@@ -21,6 +21,7 @@
 #ifndef TESTS_SIM_PERIPHERALUART_H_
 #define TESTS_SIM_PERIPHERALUART_H_
 
+#include <stdint.h>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -71,6 +72,18 @@ class PeripheralUART : public PeripheralUSARTInterface {
   void LineControlModeSelect(USART_MODULE_ID index,
                              USART_LINECONTROL_MODE dataFlowConfig);
   USART_ERROR ErrorsGet(USART_MODULE_ID index);
+  void* TransmitterAddressGet(USART_MODULE_ID index);
+  void* ReceiverAddressGet(USART_MODULE_ID index);
+
+  // Used by the DMA controller to access the TX & RX registers. These return
+  // false if the address doesn't belong to a UART register.
+  bool RegisterRead(uintptr_t address, uint8_t *value);
+  bool RegisterWrite(uintptr_t address, uint8_t value);
+
+  // Returns true if the receiver is enabled. This isn't part of the PLIB API,
+  // it's used by the soak harness to tell when the transceiver has abandoned
+  // a frame.
+  bool ReceiverIsEnabled(USART_MODULE_ID index) const;
 
  private:
   Simulator *m_simulator;
@@ -78,21 +91,6 @@ class PeripheralUART : public PeripheralUSARTInterface {
   TXCallback *m_tx_callback;
   std::unique_ptr<ola::Callback0<void>> m_callback;
 
-  enum UARTState {
-    IDLE,
-    START_BIT,
-    BIT_0,
-    BIT_1,
-    BIT_2,
-    BIT_3,
-    BIT_4,
-    BIT_5,
-    BIT_6,
-    BIT_7,
-    STOP_BIT_1,
-    STOP_BIT_2,
-  };
-
   struct UART {
    public:
     explicit UART(INT_SOURCE source);
@@ -108,10 +106,18 @@ class PeripheralUART : public PeripheralUSARTInterface {
     std::queue<uint16_t> rx_buffer;
     uint8_t tx_byte;
     uint8_t errors;
+    // Only the addresses of the registers are used, see RegisterRead() and
+    // RegisterWrite().
+    uint8_t tx_register;
+    uint8_t rx_register;
 
     uint32_t ticks_per_bit;
-    uint32_t tx_counter;
-    UARTState tx_state;
+    // True if a byte is being shifted out.
+    bool tx_busy;
+    // The cycle the current byte completes on.
+    uint64_t tx_done_at;
+    // The cycles left on the current byte while the transmitter is disabled.
+    uint64_t tx_remaining;
 
     static const uint16_t FRAMING_ERROR_FLAG = 0x8000;
   };
@@ -119,6 +125,10 @@ class PeripheralUART : public PeripheralUSARTInterface {
   std::vector<UART> m_uarts;
   static const uint8_t TX_FIFO_SIZE = 8;
   static const uint8_t RX_FIFO_SIZE = 8;
+  // Start bit, 8 data bits & 2 stop bits.
+  static const uint8_t BITS_PER_BYTE = 11;
+
+  void ScheduleNextEvent();
 };
 
 
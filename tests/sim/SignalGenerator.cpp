@@ -65,6 +65,7 @@ void SignalGenerator::Tick() {
   }
 
   if (clock < m_next_event_at) {
+    ScheduleNextEvent();
     return;
   }
 
@@ -75,7 +76,7 @@ void SignalGenerator::Tick() {
     case WAITING:
       // The event is complete, move onto the next one.
       ProcessNextEvent();
-      return;
+      break;
     case START_BIT:
     case BIT_0:
     case BIT_1:
@@ -94,11 +95,12 @@ void SignalGenerator::Tick() {
       m_uart->ReceiveByte(m_uart_index, m_tx_byte);
       m_state = IDLE;
       ProcessNextEvent();
-      return;
+      break;
     case HALTING:
       m_simulator->Stop();
       break;
   }
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::Reset() {
@@ -115,28 +117,34 @@ void SignalGenerator::SetStopOnComplete(bool stop_on_complete) {
 
 void SignalGenerator::AddDelay(uint32_t duration) {
   m_events.push(Event(EVENT_DELAY, duration));
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::AddBreak(uint32_t duration) {
   m_events.push(Event(EVENT_BREAK, duration));
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::AddMark(uint32_t duration) {
   m_events.push(Event(EVENT_MARK, duration));
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::AddByte(uint8_t byte) {
   m_events.push(Event(EVENT_BYTE, byte));
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::AddFrame(const uint8_t *data, unsigned int size) {
   for (unsigned int i = 0; i < size; i++) {
     m_events.push(Event(EVENT_BYTE, data[i]));
   }
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::AddFramingError(uint8_t byte) {
   m_events.push(Event(EVENT_FRAMING_ERROR, byte));
+  ScheduleNextEvent();
 }
 
 void SignalGenerator::ProcessNextEvent() {
@@ -183,6 +191,18 @@ void SignalGenerator::ProcessNextEvent() {
   m_events.pop();
 }
 
+void SignalGenerator::ScheduleNextEvent() {
+  uint64_t clock = m_simulator->Clock();
+  if (m_framing_error_at > clock) {
+    m_simulator->ScheduleEvent(m_framing_error_at - clock);
+  }
+  if (m_next_event_at > clock) {
+    m_simulator->ScheduleEvent(m_next_event_at - clock);
+  } else if (m_state != IDLE || !m_events.empty()) {
+    m_simulator->ScheduleEvent(1);
+  }
+}
+
 void SignalGenerator::AddDurationToClock(uint32_t duration) {
   m_next_event_at = m_simulator->Clock() + duration * m_cycles_per_usecond;
 }
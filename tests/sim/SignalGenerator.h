@@ -170,6 +170,7 @@ class SignalGenerator {
   std::queue<Event> m_events;
 
   void ProcessNextEvent();
+  void ScheduleNextEvent();
   void AddDurationToClock(uint32_t duration);
   void SetLineState(LineState new_state);
   bool GetNextBit() const;
@@ -22,12 +22,15 @@
 
 #include <gtest/gtest.h>
 
-Simulator::Simulator(uint32_t clock_speed)
+Simulator::Simulator(uint32_t clock_speed, Mode mode)
     : m_clock_speed(clock_speed),
+      m_mode(mode),
       m_run(true),
       m_clock_limit(0),
       m_clock_limit_fatal(false),
-      m_clock(0) {
+      m_clock(0),
+      m_cycles(0),
+      m_steps(0) {
 }
 
 void Simulator::SetClockLimit(uint64_t duration, bool fatal) {
@@ -43,18 +46,39 @@ void Simulator::RemoveTask(TaskFn *fn) {
   m_tasks.erase(fn);
 }
 
+void Simulator::ScheduleEvent(uint64_t delay) {
+  if (m_mode == MODE_EVENT_DRIVEN) {
+    m_events.insert(m_clock + (delay ? delay : 1));
+  }
+}
+
 uint64_t Simulator::Clock() const {
   return m_clock;
 }
 
+uint64_t Simulator::Cycles() const {
+  return m_cycles;
+}
+
+uint64_t Simulator::Steps() const {
+  return m_steps;
+}
+
 void Simulator::Run() {
   m_run = true;
   m_clock = 0;
+  // Events are relative to the old clock. Every peripheral re-schedules when
+  // it's run at clock 0.
+  m_events.clear();
   while (m_run) {
     for (const auto &task : m_tasks) {
       task->Run();
     }
-    m_clock++;
+    m_steps++;
+
+    uint64_t next = NextClock();
+    m_cycles += next - m_clock;
+    m_clock = next;
     if (m_clock_limit && m_clock >= m_clock_limit) {
       if (m_clock_limit_fatal) {
         FAIL() << "Clock limit exceeded: " << m_clock_limit;
@@ -67,3 +91,28 @@ void Simulator::Run() {
 void Simulator::Stop() {
   m_run = false;
 }
+
+uint64_t Simulator::NextClock() {
+  if (m_mode == MODE_PER_TICK) {
+    return m_clock + 1;
+  }
+
+  while (!m_events.empty() && *m_events.begin() <= m_clock) {
+    m_events.erase(m_events.begin());
+  }
+
+  if (m_events.empty()) {
+    if (m_clock_limit > m_clock) {
+      return m_clock_limit;
+    }
+    // Nothing else will ever happen, so stop.
+    m_run = false;
+    return m_clock + 1;
+  }
+
+  uint64_t next = *m_events.begin();
+  if (m_clock_limit > m_clock && m_clock_limit < next) {
+    return m_clock_limit;
+  }
+  return next;
+}
@@ -26,11 +26,29 @@
 
 #include "ola/Callback.h"
 
+/*
+ * @brief Drives the simulated peripherals and the firmware tasks.
+ *
+ * The simulator can run in one of two modes:
+ *  - MODE_PER_TICK: every task is run once for each cycle of the virtual
+ *    clock.
+ *  - MODE_EVENT_DRIVEN: the peripherals call ScheduleEvent() with the time of
+ *    their next state change and the clock jumps straight to the earliest
+ *    one. Every task is still run at each of these points.
+ *
+ * In event driven mode, a task that doesn't schedule its next event will only
+ * run when some other peripheral causes the clock to stop.
+ */
 class Simulator {
  public:
   typedef ola::Callback0<void> TaskFn;
 
-  explicit Simulator(uint32_t clock_speed);
+  enum Mode {
+    MODE_PER_TICK,
+    MODE_EVENT_DRIVEN,
+  };
+
+  explicit Simulator(uint32_t clock_speed, Mode mode = MODE_PER_TICK);
 
   // Stop the simulator after a certain duration.
   // This can be made fatal to guard against tests that never complete.
@@ -39,9 +57,21 @@ class Simulator {
   void AddTask(TaskFn *fn);
   void RemoveTask(TaskFn *fn);
 
-  // Monotomic clock
+  // Request that the tasks are run again in delay cycles. A delay of 0 is
+  // treated as 1. This is a no-op in MODE_PER_TICK.
+  void ScheduleEvent(uint64_t delay);
+
+  Mode GetMode() const { return m_mode; }
+
+  // The clock for the current call to Run().
   uint64_t Clock() const;
 
+  // Monotomic cycle count, this isn't reset by Run().
+  uint64_t Cycles() const;
+
+  // The number of times the tasks have been run.
+  uint64_t Steps() const;
+
   void Run();
   void Stop();
 
@@ -49,12 +79,18 @@ class Simulator {
   typedef std::set<TaskFn*> Tasks;
 
   const uint32_t m_clock_speed;
+  const Mode m_mode;
 
   bool m_run;
   uint64_t m_clock_limit;
   bool m_clock_limit_fatal;
   uint64_t m_clock;
+  uint64_t m_cycles;
+  uint64_t m_steps;
   Tasks m_tasks;
+  std::set<uint64_t> m_events;
+
+  uint64_t NextClock();
 };
 
 #endif  // TESTS_SIM_SIMULATOR_H_
@@ -0,0 +1,23 @@
+# Soak tests
+##################################################
+
+noinst_PROGRAMS += tests/soak/soak_harness
+
+tests_soak_soak_harness_SOURCES = tests/soak/SoakHarness.cpp
+tests_soak_soak_harness_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
+tests_soak_soak_harness_LDADD = \
+    tests/sim/libsim.la \
+    firmware/src/libresponder.la \
+    firmware/src/librdmhandler.la \
+    firmware/src/libledmodel.la \
+    firmware/src/librdmresponder.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/libtransceiver.la \
+    firmware/src/libcoarsetimer.la \
+    firmware/src/librdmbuffer.la \
+    firmware/src/librandom.la \
+    firmware/src/librdmutil.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libspirgbmock.la \
+    tests/mocks/libsyslogmock.la \
+    $(GMOCK_LIBS) $(GTEST_LIBS) $(OLA_LIBS)
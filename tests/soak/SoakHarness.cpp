@@ -0,0 +1,638 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SoakHarness.cpp
+ * Run the responder side of the transceiver against randomized traffic for a
+ * long period of simulated time.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <string.h>
+
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include "Array.h"
+#include "app_settings.h"
+#include "coarse_timer.h"
+#include "constants.h"
+#include "dmx_spec.h"
+#include "led_model.h"
+#include "rdm.h"
+#include "rdm_frame.h"
+#include "rdm_handler.h"
+#include "rdm_model.h"
+#include "rdm_responder.h"
+#include "rdm_util.h"
+#include "receiver_counters.h"
+#include "responder.h"
+#include "setting_macros.h"
+#include "transceiver.h"
+#include "utils.h"
+
+#include "tests/sim/InterruptController.h"
+#include "tests/sim/PeripheralInputCapture.h"
+#include "tests/sim/PeripheralTimer.h"
+#include "tests/sim/PeripheralUART.h"
+#include "tests/sim/SignalGenerator.h"
+#include "tests/sim/Simulator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declare the ISR symbols.
+void InputCaptureEvent(void);
+void Transceiver_TimerEvent();
+void Transceiver_UARTEvent();
+
+#ifdef __cplusplus
+}
+#endif
+
+using ola::NewCallback;
+using std::cout;
+using std::endl;
+using std::setw;
+
+DEFINE_uint32(duration, 60, "The simulated time to run for, in seconds");
+DEFINE_uint32(seed, 1, "The seed for the traffic generator");
+DEFINE_uint32(framing_error_rate, 1,
+              "The percentage of frames that contain a framing error");
+
+namespace {
+
+const uint32_t CLOCK_SPEED = 80000000;
+const uint32_t BAUD_RATE = 250000;
+const uint32_t USECONDS_PER_SLOT = 44;
+
+// The amount of traffic to queue before running the simulator.
+const uint32_t BATCH_DURATION = 1000000;  // 1s
+
+// How long to leave the line idle after an RDM request. This is longer than
+// the maximum responder turnaround + the length of the response.
+const uint32_t RDM_RESPONSE_WINDOW = 5000;
+
+const uint8_t OUR_UID[UID_LENGTH] = {0x7a, 0x70, 0x12, 0x34, 0x56, 0x78};
+const uint8_t OTHER_UID[UID_LENGTH] = {0x7a, 0x70, 0x12, 0x34, 0x56, 0x79};
+const uint8_t CONTROLLER_UID[UID_LENGTH] = {0x7a, 0x70, 0, 0, 0, 1};
+const uint8_t ALTERNATE_START_CODES[] = {0x17, 0x55, 0x91};
+const uint16_t GET_PIDS[] = {
+  PID_DEVICE_INFO,
+  PID_SOFTWARE_VERSION_LABEL,
+  PID_DMX_START_ADDRESS,
+  PID_IDENTIFY_DEVICE,
+};
+
+enum FrameType {
+  FRAME_DMX,
+  FRAME_ASC,
+  FRAME_RDM_FOR_US,
+  FRAME_RDM_BAD_CHECKSUM,
+  FRAME_RDM_FOR_OTHER,
+  FRAME_DUB,
+  FRAME_TYPE_COUNT,
+};
+
+const char *FRAME_TYPE_NAMES[] = {
+  "DMX",
+  "ASC",
+  "RDM (for us)",
+  "RDM (bad checksum)",
+  "RDM (for other)",
+  "DUB",
+};
+
+class SoakHarness {
+ public:
+  SoakHarness();
+  ~SoakHarness();
+
+  void Init();
+  void Run(uint64_t duration);
+  bool Report();
+
+ private:
+  std::unique_ptr<ola::Callback0<void>> m_tasks;
+  std::unique_ptr<PeripheralUART::TXCallback> m_tx_callback;
+  Simulator m_simulator;
+  InterruptController m_interrupt_controller;
+  PeripheralTimer m_timer;
+  PeripheralInputCapture m_ic;
+  PeripheralUART m_uart;
+  SignalGenerator m_generator;
+  std::mt19937 m_random;
+
+  // Traffic counters.
+  uint64_t m_sent[FRAME_TYPE_COUNT];
+  uint64_t m_slots_sent;
+  uint64_t m_framing_errors;
+  uint64_t m_expected_responses;
+  uint64_t m_rx_frames;
+  uint64_t m_tx_bytes;
+  double m_wall_time;  // in seconds
+
+  // ISR to task latency
+  uint64_t m_pending_isr_cycle;
+  uint64_t m_max_latency;
+
+  ReceiverCounters m_initial_counters;
+  uint8_t m_transaction_number;
+
+  uint32_t QueueBatch();
+  uint32_t QueueFrame();
+  uint32_t QueueSlots(const uint8_t *data, unsigned int size);
+  uint32_t QueueRDM(const uint8_t *dest_uid, uint8_t command_class,
+                    uint16_t pid, const uint8_t *param_data,
+                    unsigned int param_data_length, bool corrupt_checksum);
+
+  uint32_t RandomInRange(uint32_t min, uint32_t max);
+
+  void UARTRXEvent();
+  void GotByte(USART_MODULE_ID uart_id, uint8_t byte);
+  bool RXEvent(const TransceiverEvent *event);
+
+  static SoakHarness *s_instance;
+  static bool TXEventHandler(const TransceiverEvent *event);
+  static bool RXEventHandler(const TransceiverEvent *event);
+  static void SendResponse(bool include_break, const IOVec *data,
+                           unsigned int iov_count);
+};
+
+SoakHarness *SoakHarness::s_instance = nullptr;
+
+SoakHarness::SoakHarness()
+    : m_tasks(NewCallback(&Transceiver_Tasks)),
+      m_tx_callback(NewCallback(this, &SoakHarness::GotByte)),
+      m_simulator(CLOCK_SPEED, Simulator::MODE_EVENT_DRIVEN),
+      m_timer(&m_simulator, &m_interrupt_controller),
+      m_ic(&m_simulator, &m_interrupt_controller),
+      m_uart(&m_simulator, &m_interrupt_controller, m_tx_callback.get()),
+      m_generator(&m_simulator, &m_ic, &m_uart, AS_IC_ID(2),
+                  AS_USART_ID(1), CLOCK_SPEED, BAUD_RATE),
+      m_random(FLAGS_seed),
+      m_slots_sent(0),
+      m_framing_errors(0),
+      m_expected_responses(0),
+      m_rx_frames(0),
+      m_tx_bytes(0),
+      m_wall_time(0.0),
+      m_pending_isr_cycle(0),
+      m_max_latency(0),
+      m_transaction_number(0) {
+  memset(m_sent, 0, sizeof(m_sent));
+  s_instance = this;
+}
+
+SoakHarness::~SoakHarness() {
+  m_simulator.RemoveTask(m_tasks.get());
+  PLIB_TMR_SetMock(nullptr);
+  PLIB_IC_SetMock(nullptr);
+  PLIB_USART_SetMock(nullptr);
+  SYS_INT_SetMock(nullptr);
+  s_instance = nullptr;
+}
+
+void SoakHarness::Init() {
+  PLIB_TMR_SetMock(&m_timer);
+  PLIB_IC_SetMock(&m_ic);
+  PLIB_USART_SetMock(&m_uart);
+  SYS_INT_SetMock(&m_interrupt_controller);
+
+  m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_1,
+      NewCallback(&CoarseTimer_TimerEvent));
+  m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_3,
+      NewCallback(&Transceiver_TimerEvent));
+  m_interrupt_controller.RegisterISR(INT_SOURCE_INPUT_CAPTURE_2,
+      NewCallback(&InputCaptureEvent));
+  m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_ERROR,
+      NewCallback(&Transceiver_UARTEvent));
+  m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_TRANSMIT,
+      NewCallback(&Transceiver_UARTEvent));
+  m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_RECEIVE,
+      NewCallback(this, &SoakHarness::UARTRXEvent));
+  m_simulator.AddTask(m_tasks.get());
+
+  TransceiverHardwareSettings settings = {
+    .usart = AS_USART_ID(1),
+    .usart_vector = AS_USART_INTERRUPT_VECTOR(1),
+    .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(1),
+    .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(1),
+    .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(1),
+    .port = PORT_CHANNEL_F,
+    .break_bit = PORTS_BIT_POS_8,
+    .tx_enable_bit = PORTS_BIT_POS_1,
+    .rx_enable_bit = PORTS_BIT_POS_0,
+    .input_capture_module = AS_IC_ID(2),
+    .input_capture_vector = AS_IC_INTERRUPT_VECTOR(2),
+    .input_capture_source = AS_IC_INTERRUPT_SOURCE(2),
+    .timer_module_id = AS_TIMER_ID(3),
+    .timer_vector = AS_TIMER_INTERRUPT_VECTOR(3),
+    .timer_source = AS_TIMER_INTERRUPT_SOURCE(3),
+    .input_capture_timer = AS_IC_TMR_ID(3),
+  };
+  Transceiver_Initialize(0u, &settings, &TXEventHandler, &RXEventHandler);
+
+  CoarseTimer_Settings timer_settings = {
+    .timer_id = AS_TIMER_ID(1),
+    .interrupt_source = AS_TIMER_INTERRUPT_SOURCE(1)
+  };
+  CoarseTimer_Initialize(&timer_settings);
+
+  // The responder stack, this matches what APP_Initialize() does.
+  RDMResponderSettings responder_settings;
+  memset(&responder_settings, 0, sizeof(responder_settings));
+  memcpy(responder_settings.uid, OUR_UID, UID_LENGTH);
+  RDMResponder_Initialize(&responder_settings);
+  ReceiverCounters_ResetCounters();
+
+  RDMHandlerSettings rdm_handler_settings = {
+    .default_model = LED_MODEL_ID,
+    .send_callback = &SendResponse
+  };
+  RDMHandler_Initialize(&rdm_handler_settings);
+  LEDModel_Initialize();
+  RDMHandler_AddModel(&LED_MODEL_ENTRY);
+  Responder_Initialize();
+
+  Transceiver_SetMode(0u, T_MODE_RESPONDER, 0);
+  m_initial_counters = g_responder_counters;
+}
+
+void SoakHarness::Run(uint64_t duration) {
+  auto start = std::chrono::steady_clock::now();
+  // Give the transceiver time to switch to responder mode.
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(RDM_RESPONSE_WINDOW);
+  m_simulator.Run();
+
+  uint64_t queued = 0;
+  while (queued < duration) {
+    m_generator.Reset();
+    m_generator.SetStopOnComplete(true);
+    const uint64_t previous_minutes = queued / 60000000;
+    queued += QueueBatch();
+    m_simulator.Run();
+
+    if (queued / 60000000 != previous_minutes) {
+      cout << "Simulated " << queued / 60000000 << " min" << endl;
+    }
+  }
+  // Let any final frames time out.
+  m_generator.Reset();
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(RDM_RESPONSE_WINDOW);
+  m_simulator.Run();
+
+  m_wall_time = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+bool SoakHarness::Report() {
+  const double sim_time = static_cast<double>(m_simulator.Cycles()) /
+                          CLOCK_SPEED;
+  uint64_t total_frames = 0;
+  for (unsigned int i = 0; i < FRAME_TYPE_COUNT; i++) {
+    total_frames += m_sent[i];
+  }
+
+  cout << std::fixed << std::setprecision(1);
+  cout << "Simulated " << sim_time << "s in " << m_wall_time << "s" << endl;
+  cout << endl << "Frames sent:" << endl;
+  for (unsigned int i = 0; i < FRAME_TYPE_COUNT; i++) {
+    cout << "  " << std::left << setw(20) << FRAME_TYPE_NAMES[i] << std::right
+         << setw(12) << m_sent[i] << endl;
+  }
+  cout << "  " << std::left << setw(20) << "Framing errors" << std::right
+       << setw(12) << m_framing_errors << endl;
+
+  cout << endl << "Throughput:" << endl;
+  cout << "  " << std::left << setw(20) << "frames / s" << std::right
+       << setw(12) << total_frames / sim_time << endl;
+  cout << "  " << std::left << setw(20) << "slots / s" << std::right
+       << setw(12) << m_slots_sent / sim_time << endl;
+  cout << "  " << std::left << setw(20) << "TX bytes / s" << std::right
+       << setw(12) << m_tx_bytes / sim_time << endl;
+
+  const ReceiverCounters &counters = g_responder_counters;
+  const ReceiverCounters &initial = m_initial_counters;
+  const uint64_t rdm_sent = m_sent[FRAME_RDM_FOR_US] +
+                            m_sent[FRAME_RDM_BAD_CHECKSUM] +
+                            m_sent[FRAME_RDM_FOR_OTHER] + m_sent[FRAME_DUB];
+  const int64_t dropped_dmx = m_sent[FRAME_DMX] -
+      (counters.dmx_frames - initial.dmx_frames);
+  const int64_t dropped_asc = m_sent[FRAME_ASC] -
+      (counters.asc_frames - initial.asc_frames);
+  const int64_t dropped_rdm = rdm_sent -
+      (counters.rdm_frames - initial.rdm_frames);
+
+  cout << endl << "ReceiverCounters deltas:" << endl;
+  const struct {
+    const char *name;
+    uint32_t delta;
+  } deltas[] = {
+    {"dmx_frames", counters.dmx_frames - initial.dmx_frames},
+    {"asc_frames", counters.asc_frames - initial.asc_frames},
+    {"rdm_frames", counters.rdm_frames - initial.rdm_frames},
+    {"rdm_short_frame", counters.rdm_short_frame - initial.rdm_short_frame},
+    {"rdm_length_mismatch",
+     counters.rdm_length_mismatch - initial.rdm_length_mismatch},
+    {"rdm_sub_start_code",
+     counters.rdm_sub_start_code_invalid -
+     initial.rdm_sub_start_code_invalid},
+    {"rdm_msg_len_invalid",
+     counters.rdm_msg_len_invalid - initial.rdm_msg_len_invalid},
+    {"rdm_pdl_invalid",
+     counters.rdm_param_data_len_invalid -
+     initial.rdm_param_data_len_invalid},
+    {"rdm_checksum_invalid",
+     counters.rdm_checksum_invalid - initial.rdm_checksum_invalid},
+  };
+  for (unsigned int i = 0; i < arraysize(deltas); i++) {
+    cout << "  " << std::left << setw(20) << deltas[i].name << std::right
+         << setw(12) << deltas[i].delta << endl;
+  }
+
+  TransceiverTurnaroundStats turnaround;
+  Transceiver_GetTurnaroundStats(0u, &turnaround);
+
+  cout << endl << "Dropped:" << endl;
+  cout << "  " << std::left << setw(20) << "DMX frames" << std::right
+       << setw(12) << dropped_dmx << endl;
+  cout << "  " << std::left << setw(20) << "ASC frames" << std::right
+       << setw(12) << dropped_asc << endl;
+  cout << "  " << std::left << setw(20) << "RDM frames" << std::right
+       << setw(12) << dropped_rdm << endl;
+  cout << "  " << std::left << setw(20) << "RDM responses" << std::right
+       << setw(12)
+       << static_cast<int64_t>(m_expected_responses - turnaround.count)
+       << endl;
+  cout << "  " << std::left << setw(20) << "RX frame events" << std::right
+       << setw(12) << static_cast<int64_t>(total_frames - m_rx_frames)
+       << endl;
+  cout << "  " << std::left << setw(20) << "RX overruns" << std::right
+       << setw(12) << Transceiver_GetRXOverrunCount(0u) << endl;
+
+  cout << endl << "Latency:" << endl;
+  cout << "  " << std::left << setw(20) << "max ISR to task (cy)"
+       << std::right << setw(12) << m_max_latency << endl;
+  cout << "  " << std::left << setw(20) << "max turnaround (us)"
+       << std::right << setw(12);
+  if (turnaround.max == UINT16_MAX) {
+    cout << ">6500" << endl;
+  } else {
+    cout << turnaround.max / 10.0 << endl;
+  }
+
+  return dropped_dmx == 0 && dropped_asc == 0 && dropped_rdm == 0 &&
+         m_expected_responses == turnaround.count &&
+         counters.rdm_checksum_invalid - initial.rdm_checksum_invalid ==
+           m_sent[FRAME_RDM_BAD_CHECKSUM];
+}
+
+/*
+ * @brief Queue up BATCH_DURATION worth of traffic.
+ * @returns The duration of the traffic in microseconds.
+ */
+uint32_t SoakHarness::QueueBatch() {
+  uint32_t duration = 0;
+  while (duration < BATCH_DURATION) {
+    duration += QueueFrame();
+  }
+  return duration;
+}
+
+/*
+ * @brief Queue a single frame, with a randomized break & mark.
+ * @returns The duration of the frame in microseconds.
+ */
+uint32_t SoakHarness::QueueFrame() {
+  // The mix of traffic is weighted towards DMX.
+  static const FrameType TRAFFIC_MIX[] = {
+    FRAME_DMX, FRAME_DMX, FRAME_DMX, FRAME_DMX, FRAME_DMX, FRAME_DMX,
+    FRAME_ASC, FRAME_RDM_FOR_US, FRAME_RDM_FOR_US, FRAME_RDM_BAD_CHECKSUM,
+    FRAME_RDM_FOR_OTHER, FRAME_DUB,
+  };
+  const FrameType type = TRAFFIC_MIX[RandomInRange(
+      0, arraysize(TRAFFIC_MIX) - 1)];
+  m_sent[type]++;
+
+  const uint32_t break_time = RandomInRange(92, 250);
+  const uint32_t mark_time = RandomInRange(12, 88);
+  m_generator.AddBreak(break_time);
+  m_generator.AddMark(mark_time);
+  uint32_t duration = break_time + mark_time;
+
+  switch (type) {
+    case FRAME_DMX:
+    case FRAME_ASC:
+      {
+        uint8_t frame[DMX_FRAME_SIZE + 1];
+        const unsigned int size = RandomInRange(24, DMX_FRAME_SIZE) + 1;
+        for (unsigned int i = 1; i < size; i++) {
+          frame[i] = m_random() & 0xff;
+        }
+        frame[0] = type == FRAME_DMX ? NULL_START_CODE :
+            ALTERNATE_START_CODES[RandomInRange(
+                0, arraysize(ALTERNATE_START_CODES) - 1)];
+        duration += QueueSlots(frame, size);
+
+        const uint32_t idle = RandomInRange(0, 1000);
+        if (idle) {
+          m_generator.AddDelay(idle);
+          duration += idle;
+        }
+      }
+      break;
+    case FRAME_RDM_FOR_US:
+    case FRAME_RDM_BAD_CHECKSUM:
+      m_expected_responses += (type == FRAME_RDM_FOR_US);
+      duration += QueueRDM(
+          OUR_UID, GET_COMMAND,
+          GET_PIDS[RandomInRange(0, arraysize(GET_PIDS) - 1)],
+          nullptr, 0, type == FRAME_RDM_BAD_CHECKSUM);
+      break;
+    case FRAME_RDM_FOR_OTHER:
+      duration += QueueRDM(OTHER_UID, GET_COMMAND, PID_DEVICE_INFO, nullptr, 0,
+                           false);
+      break;
+    case FRAME_DUB:
+      {
+        // Half of the DUBs cover our UID.
+        const bool covers_us = RandomInRange(0, 1);
+        uint8_t param_data[2 * UID_LENGTH];
+        memcpy(param_data, covers_us ? OUR_UID : OTHER_UID, UID_LENGTH);
+        memcpy(param_data + UID_LENGTH, OTHER_UID, UID_LENGTH);
+        m_expected_responses += covers_us;
+        const uint8_t broadcast[UID_LENGTH] = {
+          0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+        };
+        duration += QueueRDM(broadcast, DISCOVERY_COMMAND,
+                             PID_DISC_UNIQUE_BRANCH, param_data,
+                             sizeof(param_data), false);
+      }
+      break;
+    default:
+      {}
+  }
+  return duration;
+}
+
+/*
+ * @brief Queue the slots for a frame.
+ *
+ * Some frames get a framing error in place of one of the slots, and some have
+ * a gap between two of the slots.
+ * @returns The duration of the slots in microseconds.
+ */
+uint32_t SoakHarness::QueueSlots(const uint8_t *data, unsigned int size) {
+  const unsigned int error_slot =
+      RandomInRange(0, 99) < FLAGS_framing_error_rate ?
+      RandomInRange(1, size - 1) : 0;
+  const unsigned int gap_slot =
+      RandomInRange(0, 99) < 5 ? RandomInRange(1, size - 1) : 0;
+  uint32_t duration = size * USECONDS_PER_SLOT;
+
+  for (unsigned int i = 0; i < size; i++) {
+    if (i && i == gap_slot) {
+      const uint32_t gap = RandomInRange(1, 50);
+      m_generator.AddDelay(gap);
+      duration += gap;
+    }
+    if (i && i == error_slot) {
+      m_generator.AddFramingError(data[i]);
+      m_framing_errors++;
+    } else {
+      m_generator.AddByte(data[i]);
+    }
+  }
+  m_slots_sent += size;
+  return duration;
+}
+
+/*
+ * @brief Queue an RDM request and leave the line idle for the response.
+ * @returns The duration of the request and response window in microseconds.
+ */
+uint32_t SoakHarness::QueueRDM(const uint8_t *dest_uid,
+                               uint8_t command_class,
+                               uint16_t pid,
+                               const uint8_t *param_data,
+                               unsigned int param_data_length,
+                               bool corrupt_checksum) {
+  uint8_t frame[RDM_MAX_FRAME_SIZE];
+  RDMHeader *header = reinterpret_cast<RDMHeader*>(frame);
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = sizeof(RDMHeader) + param_data_length;
+  memcpy(header->dest_uid, dest_uid, UID_LENGTH);
+  memcpy(header->src_uid, CONTROLLER_UID, UID_LENGTH);
+  header->transaction_number = m_transaction_number++;
+  header->port_id = 1;
+  header->message_count = 0;
+  header->sub_device = 0;
+  header->command_class = command_class;
+  header->param_id = ntohs(pid);
+  header->param_data_length = param_data_length;
+  if (param_data_length) {
+    memcpy(frame + sizeof(RDMHeader), param_data, param_data_length);
+  }
+  const unsigned int size = RDMUtil_AppendChecksum(frame);
+  if (corrupt_checksum) {
+    frame[size - 1]++;
+  }
+
+  // RDM frames don't get framing errors or gaps since that would change the
+  // expected number of responses.
+  for (unsigned int i = 0; i < size; i++) {
+    m_generator.AddByte(frame[i]);
+  }
+  m_generator.AddDelay(RDM_RESPONSE_WINDOW);
+  m_slots_sent += size;
+  return size * USECONDS_PER_SLOT + RDM_RESPONSE_WINDOW;
+}
+
+uint32_t SoakHarness::RandomInRange(uint32_t min, uint32_t max) {
+  return std::uniform_int_distribution<uint32_t>(min, max)(m_random);
+}
+
+void SoakHarness::UARTRXEvent() {
+  if (!m_pending_isr_cycle &&
+      m_uart.ReceiverDataIsAvailable(AS_USART_ID(1))) {
+    m_pending_isr_cycle = m_simulator.Cycles();
+  }
+  Transceiver_UARTEvent();
+  if (!m_uart.ReceiverIsEnabled(AS_USART_ID(1))) {
+    // The transceiver abandoned the frame, either because of a framing error
+    // or because the buffer is full. The data will never reach the task.
+    m_pending_isr_cycle = 0;
+  }
+}
+
+void SoakHarness::GotByte(USART_MODULE_ID uart_id, uint8_t byte) {
+  (void) byte;
+  if (uart_id == AS_USART_ID(1)) {
+    m_tx_bytes++;
+  }
+}
+
+bool SoakHarness::RXEvent(const TransceiverEvent *event) {
+  if (event->result == T_RESULT_RX_START_FRAME) {
+    m_rx_frames++;
+  }
+  if (m_pending_isr_cycle) {
+    m_max_latency = std::max(m_max_latency,
+                             m_simulator.Cycles() - m_pending_isr_cycle);
+    m_pending_isr_cycle = 0;
+  }
+  Responder_Receive(event);
+  return true;
+}
+
+bool SoakHarness::TXEventHandler(const TransceiverEvent *event) {
+  (void) event;
+  return true;
+}
+
+bool SoakHarness::RXEventHandler(const TransceiverEvent *event) {
+  return s_instance ? s_instance->RXEvent(event) : true;
+}
+
+/*
+ * On the device, PIPELINE_RDMRESPONDER_SEND routes responses straight to the
+ * transceiver.
+ */
+void SoakHarness::SendResponse(bool include_break, const IOVec *data,
+                               unsigned int iov_count) {
+  Transceiver_QueueRDMResponse(0u, include_break, data, iov_count);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Soak test the transceiver with randomized traffic.");
+
+  SoakHarness harness;
+  harness.Init();
+  harness.Run(static_cast<uint64_t>(FLAGS_duration) * 1000000);
+  return harness.Report() ? ola::EXIT_OK : ola::EXIT_SOFTWARE;
+}
@@ -38,7 +38,7 @@
 /**
  * @brief The timer to use for the coarse timer.
  */
-#define COARSE_TIMER_ID 2
+#define COARSE_TIMER_ID 4
 
 /**
  * @}
@@ -84,6 +84,84 @@
  */
 #define TRANSCEIVER_RX_ENABLE_PORT_BIT PORTS_BIT_POS_1
 
+/**
+ * @brief The number of transceiver ports.
+ */
+#define TRANSCEIVER_PORT_COUNT 2
+
+/**
+ * @brief The USART to use for the second transceiver port.
+ */
+#define TRANSCEIVER_PORT1_UART 2
+
+/**
+ * @brief The Timer module id to use for the second transceiver port.
+ */
+#define TRANSCEIVER_PORT1_TIMER 2
+
+/**
+ * @brief The input capture module id to use for the second transceiver port.
+ */
+#define TRANSCEIVER_PORT1_IC 3
+
+/**
+ * @brief The port to use for the second port's direction & break pins.
+ */
+#define TRANSCEIVER_PORT1_PORT PORT_CHANNEL_F
+
+/**
+ * @brief The bit position of the second port's break pin.
+ */
+#define TRANSCEIVER_PORT1_PORT_BIT PORTS_BIT_POS_9
+
+/**
+ * @brief The bit position of the second port's TX enable pin.
+ */
+#define TRANSCEIVER_PORT1_TX_ENABLE_PORT_BIT PORTS_BIT_POS_2
+
+/**
+ * @brief The bit position of the second port's RX enable pin.
+ */
+#define TRANSCEIVER_PORT1_RX_ENABLE_PORT_BIT PORTS_BIT_POS_3
+
+/**
+ * @brief The DMA channel to use for the first transceiver port.
+ *
+ * This is only used if the transceiver is built with TRANSCEIVER_DMA.
+ */
+#define TRANSCEIVER_DMA_CHANNEL 0
+
+/**
+ * @brief The DMA channel to use for the second transceiver port.
+ */
+#define TRANSCEIVER_PORT1_DMA_CHANNEL 1
+
+/**
+ * @brief The number of frames that can be queued for transmission.
+ *
+ * DMX and RDM frames are queued separately, each queue holds this many frames.
+ * Each port has 2 * TRANSCEIVER_TX_QUEUE_SIZE + 2 buffers of 576 bytes, the
+ * two queues plus the active buffer and one on loan to the host transport. The
+ * buffers use (2 * TRANSCEIVER_TX_QUEUE_SIZE + 2) * 576 *
+ * TRANSCEIVER_PORT_COUNT bytes of RAM in total.
+ */
+#define TRANSCEIVER_TX_QUEUE_SIZE 4
+
+/**
+ * @}
+ *
+ * @name Discovery
+ * Settings for the @ref discovery.h "RDM Discovery" engine.
+ * @{
+ */
+
+/**
+ * @brief The maximum number of UIDs that discovery can find.
+ *
+ * Each UID uses 6 bytes of RAM.
+ */
+#define DISCOVERY_MAX_UIDS 8
+
 /**
  * @}
  *
@@ -39,8 +39,9 @@ extern "C" {
 /* EP0 size in bytes */
 #define USB_DEVICE_EP0_BUFFER_SIZE      64
 
-/* Endpoint Transfer Queue Size combined for Read and write */
-#define USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED    2
+/* Endpoint Transfer Queue Size combined for Read and write. This is one read
+   plus USB_TX_BUFFER_COUNT writes. */
+#define USB_DEVICE_ENDPOINT_QUEUE_DEPTH_COMBINED    4
 
 #define LOG_BUFFER_SIZE 256
 
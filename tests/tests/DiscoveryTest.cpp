@@ -0,0 +1,693 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DiscoveryTest.cpp
+ * Tests for the RDM Discovery code.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "Array.h"
+#include "TransceiverMock.h"
+#include "constants.h"
+#include "discovery.h"
+#include "rdm_frame.h"
+#include "rdm_util.h"
+#include "utils.h"
+
+#include "app_settings.h"
+
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::_;
+using std::map;
+using std::vector;
+
+class MockDiscoveryComplete {
+ public:
+  MOCK_METHOD2(Complete, void(int16_t token, DiscoveryResult result));
+};
+
+namespace {
+
+MockDiscoveryComplete *g_complete_mock = nullptr;
+
+void DiscoveryComplete(int16_t token, DiscoveryResult result) {
+  if (g_complete_mock) {
+    g_complete_mock->Complete(token, result);
+  }
+}
+
+uint64_t UIDToInt(const uint8_t *uid) {
+  uint64_t value = 0;
+  for (unsigned int i = 0; i < UID_LENGTH; i++) {
+    value = (value << 8) + uid[i];
+  }
+  return value;
+}
+
+void IntToUID(uint64_t value, uint8_t *uid) {
+  for (int i = UID_LENGTH - 1; i >= 0; i--) {
+    uid[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+}  // namespace
+
+/*
+ * The simulated responders are stored in m_responders, along with their mute
+ * state. Transceiver operations are held in m_pending until RunBus() delivers
+ * the response.
+ */
+class DiscoveryTest : public testing::Test {
+ public:
+  void SetUp() {
+    Transceiver_SetMock(&m_transceiver_mock);
+    g_complete_mock = &m_complete_mock;
+
+    ON_CALL(m_transceiver_mock, QueueRDMDUB(_, _, _, _))
+        .WillByDefault(Invoke(this, &DiscoveryTest::QueueDUB));
+    ON_CALL(m_transceiver_mock, QueueRDMRequest(_, _, _, _, _))
+        .WillByDefault(Invoke(this, &DiscoveryTest::QueueRequest));
+
+    DiscoverySettings settings = {
+      .uid = {0x7a, 0x70, 0xff, 0xff, 0xfe, 0},
+      .complete_callback = DiscoveryComplete
+    };
+    Discovery_Initialize(&settings);
+
+    m_has_pending = false;
+    m_dub_count = 0;
+    m_single_dub_count = 0;
+    m_mute_count = 0;
+    m_unmute_count = 0;
+    m_ack_mutes = true;
+  }
+
+  void TearDown() {
+    g_complete_mock = nullptr;
+    Transceiver_SetMock(nullptr);
+  }
+
+  void AddResponder(uint64_t uid) {
+    m_responders[uid] = false;
+  }
+
+  bool QueueDUB(uint8_t port, int16_t token, const uint8_t *data,
+                unsigned int size) {
+    return Queue(port, token, T_OP_RDM_DUB, data, size);
+  }
+
+  bool QueueRequest(uint8_t port, int16_t token, const uint8_t *data,
+                    unsigned int size, bool is_broadcast) {
+    return Queue(port, token,
+                 is_broadcast ? T_OP_RDM_BROADCAST : T_OP_RDM_WITH_RESPONSE,
+                 data, size);
+  }
+
+  /*
+   * Deliver the responses until discovery stops queueing operations.
+   */
+  void RunBus();
+
+  /*
+   * Deliver the response to the pending operation.
+   */
+  void RunBusOnce();
+
+  /*
+   * Cancel the pending operation, like Transceiver_Reset() does.
+   */
+  void CancelPending();
+
+  /*
+   * Check the discovered UIDs match the responders, ignoring the order.
+   */
+  void ExpectAllUIDsFound();
+
+  /*
+   * Check the added & removed UIDs from the last run, ignoring the order.
+   */
+  void ExpectChanges(const vector<uint64_t> &added,
+                     const vector<uint64_t> &removed);
+
+ protected:
+  NiceMock<MockTransceiver> m_transceiver_mock;
+  MockDiscoveryComplete m_complete_mock;
+
+  map<uint64_t, bool> m_responders;
+  bool m_ack_mutes;
+  unsigned int m_dub_count;
+  unsigned int m_single_dub_count;  // DUBs with a range of one UID.
+  unsigned int m_mute_count;
+  unsigned int m_unmute_count;
+
+  static const int16_t kToken = 3;
+  static const uint8_t kPort = 0;
+  static const uint8_t kOtherPort = 1;
+
+ private:
+  bool m_has_pending;
+  uint8_t m_pending_port;
+  int16_t m_pending_token;
+  TransceiverOperation m_pending_op;
+  vector<uint8_t> m_pending_frame;
+
+  bool Queue(uint8_t port, int16_t token, TransceiverOperation op,
+             const uint8_t *data, unsigned int size);
+  void Respond(TransceiverOperation op, const vector<uint8_t> &frame);
+  void SendEvent(TransceiverOperation op, TransceiverOperationResult result,
+                 const uint8_t *data, unsigned int length);
+  void BuildDUBResponse(uint64_t uid, uint8_t *response);
+};
+
+const uint8_t DiscoveryTest::kPort;
+const uint8_t DiscoveryTest::kOtherPort;
+
+bool DiscoveryTest::Queue(uint8_t port, int16_t token, TransceiverOperation op,
+                          const uint8_t *data, unsigned int size) {
+  EXPECT_FALSE(m_has_pending);
+  m_has_pending = true;
+  m_pending_port = port;
+  m_pending_token = token;
+  m_pending_op = op;
+  m_pending_frame.assign(1, RDM_START_CODE);
+  m_pending_frame.insert(m_pending_frame.end(), data, data + size);
+  return true;
+}
+
+void DiscoveryTest::RunBus() {
+  // Guard against an endless loop.
+  unsigned int operations = 0;
+  while (m_has_pending && operations++ < 100000) {
+    m_has_pending = false;
+    EXPECT_EQ(DISCOVERY_TOKEN, m_pending_token);
+    Respond(m_pending_op, m_pending_frame);
+  }
+  EXPECT_FALSE(m_has_pending);
+}
+
+void DiscoveryTest::RunBusOnce() {
+  ASSERT_TRUE(m_has_pending);
+  m_has_pending = false;
+  Respond(m_pending_op, m_pending_frame);
+}
+
+void DiscoveryTest::CancelPending() {
+  ASSERT_TRUE(m_has_pending);
+  m_has_pending = false;
+  SendEvent(m_pending_op, T_RESULT_CANCELLED, nullptr, 0u);
+}
+
+void DiscoveryTest::ExpectAllUIDsFound() {
+  vector<uint64_t> expected;
+  for (const auto &iter : m_responders) {
+    expected.push_back(iter.first);
+  }
+
+  vector<uint64_t> actual;
+  for (unsigned int i = 0; i < Discovery_UIDCount(); i++) {
+    actual.push_back(UIDToInt(Discovery_GetUIDs() + i * UID_LENGTH));
+  }
+  std::sort(actual.begin(), actual.end());
+  EXPECT_EQ(expected, actual);
+}
+
+static vector<uint64_t> UIDList(const uint8_t *uids, unsigned int count) {
+  vector<uint64_t> output;
+  for (unsigned int i = 0; i < count; i++) {
+    output.push_back(UIDToInt(uids + i * UID_LENGTH));
+  }
+  std::sort(output.begin(), output.end());
+  return output;
+}
+
+void DiscoveryTest::ExpectChanges(const vector<uint64_t> &added,
+                                  const vector<uint64_t> &removed) {
+  EXPECT_EQ(added, UIDList(Discovery_GetAddedUIDs(), Discovery_AddedCount()));
+  EXPECT_EQ(removed,
+            UIDList(Discovery_GetRemovedUIDs(), Discovery_RemovedCount()));
+}
+
+void DiscoveryTest::Respond(TransceiverOperation op,
+                            const vector<uint8_t> &frame) {
+  ASSERT_TRUE(RDMUtil_VerifyChecksum(frame.data(), frame.size()));
+  const RDMHeader *header = reinterpret_cast<const RDMHeader*>(frame.data());
+  EXPECT_EQ(DISCOVERY_COMMAND, header->command_class);
+  const uint8_t *param_data = frame.data() + sizeof(RDMHeader);
+  uint16_t pid = ntohs(header->param_id);
+
+  if (op == T_OP_RDM_BROADCAST) {
+    EXPECT_EQ(PID_DISC_UN_MUTE, pid);
+    m_unmute_count++;
+    for (auto &iter : m_responders) {
+      iter.second = false;
+    }
+    SendEvent(op, T_RESULT_RX_TIMEOUT, nullptr, 0);
+  } else if (op == T_OP_RDM_DUB) {
+    EXPECT_EQ(PID_DISC_UNIQUE_BRANCH, pid);
+    ASSERT_EQ(2 * UID_LENGTH, header->param_data_length);
+    m_dub_count++;
+    uint64_t lower = UIDToInt(param_data);
+    uint64_t upper = UIDToInt(param_data + UID_LENGTH);
+    EXPECT_LE(lower, upper);
+    if (lower == upper) {
+      m_single_dub_count++;
+    }
+
+    // Responses from more than one responder are OR'ed together.
+    uint8_t response[DUB_RESPONSE_LENGTH];
+    memset(response, 0, sizeof(response));
+    unsigned int responders = 0;
+    for (const auto &iter : m_responders) {
+      if (!iter.second && iter.first >= lower && iter.first <= upper) {
+        uint8_t single_response[DUB_RESPONSE_LENGTH];
+        BuildDUBResponse(iter.first, single_response);
+        for (unsigned int i = 0; i < DUB_RESPONSE_LENGTH; i++) {
+          response[i] |= single_response[i];
+        }
+        responders++;
+      }
+    }
+    if (responders) {
+      SendEvent(op, T_RESULT_RX_DATA, response, arraysize(response));
+    } else {
+      SendEvent(op, T_RESULT_RX_TIMEOUT, nullptr, 0);
+    }
+  } else {
+    EXPECT_EQ(PID_DISC_MUTE, pid);
+    m_mute_count++;
+    uint64_t uid = UIDToInt(header->dest_uid);
+    auto iter = m_responders.find(uid);
+    if (iter == m_responders.end() || !m_ack_mutes) {
+      SendEvent(op, T_RESULT_RX_TIMEOUT, nullptr, 0);
+      return;
+    }
+    iter->second = true;
+
+    uint8_t response[sizeof(RDMHeader) + 2 + RDM_CHECKSUM_LENGTH];
+    memcpy(response, frame.data(), sizeof(RDMHeader));
+    RDMHeader *response_header = reinterpret_cast<RDMHeader*>(response);
+    response_header->message_length = sizeof(RDMHeader) + 2;
+    memcpy(response_header->dest_uid, header->src_uid, UID_LENGTH);
+    memcpy(response_header->src_uid, header->dest_uid, UID_LENGTH);
+    response_header->port_id = ACK;
+    response_header->command_class = DISCOVERY_COMMAND_RESPONSE;
+    response_header->param_data_length = 2;
+    response[sizeof(RDMHeader)] = 0;
+    response[sizeof(RDMHeader) + 1] = 0;
+    unsigned int size = RDMUtil_AppendChecksum(response);
+    SendEvent(op, T_RESULT_RX_DATA, response, size);
+  }
+}
+
+void DiscoveryTest::SendEvent(TransceiverOperation op,
+                              TransceiverOperationResult result,
+                              const uint8_t *data, unsigned int length) {
+  TransceiverTiming timing;
+  memset(reinterpret_cast<uint8_t*>(&timing), 0, sizeof(timing));
+  TransceiverEvent event = {
+    .token = DISCOVERY_TOKEN,
+    .op = op,
+    .result = result,
+    .data = data,
+    .length = length,
+    .timing = &timing,
+    .port = m_pending_port
+  };
+  EXPECT_TRUE(Discovery_TransceiverEvent(&event));
+}
+
+void DiscoveryTest::BuildDUBResponse(uint64_t uid, uint8_t *response) {
+  uint8_t uid_data[UID_LENGTH];
+  IntToUID(uid, uid_data);
+
+  memset(response, 0xfe, 7);
+  response[7] = 0xaa;
+  uint16_t checksum = 0;
+  for (unsigned int i = 0; i < UID_LENGTH; i++) {
+    response[8 + 2 * i] = uid_data[i] | 0xaa;
+    response[9 + 2 * i] = uid_data[i] | 0x55;
+    checksum += response[8 + 2 * i] + response[9 + 2 * i];
+  }
+  response[20] = ShortMSB(checksum) | 0xaa;
+  response[21] = ShortMSB(checksum) | 0x55;
+  response[22] = ShortLSB(checksum) | 0xaa;
+  response[23] = ShortLSB(checksum) | 0x55;
+}
+
+TEST_F(DiscoveryTest, noResponders) {
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  EXPECT_TRUE(Discovery_IsRunning());
+  RunBus();
+
+  EXPECT_FALSE(Discovery_IsRunning());
+  EXPECT_EQ(0u, Discovery_UIDCount());
+  EXPECT_EQ(1u, m_unmute_count);
+  EXPECT_EQ(1u, m_dub_count);
+  EXPECT_EQ(0u, m_mute_count);
+}
+
+TEST_F(DiscoveryTest, singleResponder) {
+  AddResponder(0x7a7012345678);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  ExpectAllUIDsFound();
+  // The first DUB finds the responder, the second confirms there are no more.
+  EXPECT_EQ(2u, m_dub_count);
+  EXPECT_EQ(1u, m_mute_count);
+}
+
+TEST_F(DiscoveryTest, multipleResponders) {
+  AddResponder(0);
+  AddResponder(1);
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  AddResponder(0x7a7080000000);
+  AddResponder(0x7a70ffffffff);
+  AddResponder(0xfffffffffffe);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  // Some collisions decode to a phantom UID, so there may be extra mutes.
+  ExpectAllUIDsFound();
+  EXPECT_LE(m_responders.size(), m_mute_count);
+}
+
+TEST_F(DiscoveryTest, rediscovery) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectAllUIDsFound();
+
+  // The responders are unmuted, and a responder that went away is removed.
+  m_responders.erase(0x7a7000000001);
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectAllUIDsFound();
+  EXPECT_EQ(2u, m_unmute_count);
+}
+
+TEST_F(DiscoveryTest, fullChanges) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectChanges({0x7a7000000001, 0x7a7000000002}, {});
+
+  m_responders.erase(0x7a7000000001);
+  AddResponder(0x7a7000000003);
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectAllUIDsFound();
+  ExpectChanges({0x7a7000000003}, {0x7a7000000001});
+  EXPECT_EQ(0u, m_single_dub_count);
+}
+
+TEST_F(DiscoveryTest, incrementalNoChanges) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  AddResponder(0x7a7080000000);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectAllUIDsFound();
+
+  // Each known UID is verified, and a single DUB finds no new responders.
+  m_dub_count = 0;
+  m_mute_count = 0;
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_INCREMENTAL));
+  RunBus();
+  ExpectAllUIDsFound();
+  ExpectChanges({}, {});
+  EXPECT_EQ(m_responders.size(), m_single_dub_count);
+  EXPECT_EQ(m_responders.size() + 1, m_dub_count);
+  EXPECT_EQ(m_responders.size(), m_mute_count);
+}
+
+TEST_F(DiscoveryTest, incrementalChanges) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  AddResponder(0x7a7080000000);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  m_responders.erase(0x7a7000000002);
+  AddResponder(0x7a7000000003);
+  AddResponder(0x000000000001);
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_INCREMENTAL));
+  RunBus();
+  ExpectAllUIDsFound();
+  ExpectChanges({0x000000000001, 0x7a7000000003}, {0x7a7000000002});
+  EXPECT_LE(3u, m_single_dub_count);
+}
+
+TEST_F(DiscoveryTest, incrementalMuteFails) {
+  AddResponder(0x7a7000000001);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  // A known responder that responds to the DUB but not the mute is removed.
+  m_ack_mutes = false;
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_INCREMENTAL));
+  RunBus();
+  EXPECT_EQ(0u, Discovery_UIDCount());
+  ExpectChanges({}, {0x7a7000000001});
+}
+
+TEST_F(DiscoveryTest, incrementalCancelled) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_CANCELLED));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  // If the run doesn't complete, the unverified UIDs are kept.
+  m_responders.clear();
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_INCREMENTAL));
+  TransceiverEvent event = {
+    DISCOVERY_TOKEN, T_OP_RDM_BROADCAST, T_RESULT_CANCELLED, nullptr, 0,
+    nullptr, kPort
+  };
+  EXPECT_TRUE(Discovery_TransceiverEvent(&event));
+  EXPECT_EQ(2u, Discovery_UIDCount());
+  ExpectChanges({}, {});
+}
+
+TEST_F(DiscoveryTest, tableFull) {
+  for (unsigned int i = 0; i < DISCOVERY_MAX_UIDS + 1; i++) {
+    AddResponder(0x7a7000000000 + i * 0x1000);
+  }
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_TABLE_FULL));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  EXPECT_EQ(static_cast<unsigned int>(DISCOVERY_MAX_UIDS),
+            Discovery_UIDCount());
+}
+
+TEST_F(DiscoveryTest, muteFails) {
+  AddResponder(0x7a7000000001);
+  m_ack_mutes = false;
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  // Each time the responder is isolated, the mute is retried before the
+  // branch is split. Eventually the single-UID branch is dropped.
+  EXPECT_EQ(0u, Discovery_UIDCount());
+  EXPECT_EQ(0u, m_mute_count % DISCOVERY_MUTE_ATTEMPTS);
+  EXPECT_LT(0u, m_mute_count);
+}
+
+TEST_F(DiscoveryTest, alreadyRunning) {
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  EXPECT_FALSE(Discovery_Start(kToken + 1, kPort, DISCOVERY_FULL));
+
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  RunBus();
+}
+
+TEST_F(DiscoveryTest, queueFull) {
+  EXPECT_CALL(m_transceiver_mock,
+              QueueRDMRequest(kPort, DISCOVERY_TOKEN, _, _, true))
+      .WillOnce(Return(false));
+  EXPECT_CALL(m_complete_mock, Complete(_, _)).Times(0);
+
+  EXPECT_FALSE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  EXPECT_FALSE(Discovery_IsRunning());
+}
+
+TEST_F(DiscoveryTest, txError) {
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_TX_ERROR));
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+
+  TransceiverEvent event = {
+    DISCOVERY_TOKEN, T_OP_RDM_BROADCAST, T_RESULT_TX_ERROR, nullptr, 0, nullptr,
+    kPort
+  };
+  EXPECT_TRUE(Discovery_TransceiverEvent(&event));
+  EXPECT_FALSE(Discovery_IsRunning());
+}
+
+TEST_F(DiscoveryTest, cancelled) {
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_CANCELLED));
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+
+  TransceiverEvent event = {
+    DISCOVERY_TOKEN, T_OP_RDM_BROADCAST, T_RESULT_CANCELLED, nullptr, 0,
+    nullptr, kPort
+  };
+  EXPECT_TRUE(Discovery_TransceiverEvent(&event));
+  EXPECT_FALSE(Discovery_IsRunning());
+}
+
+/*
+ * Resetting the transceiver cancels the pending operation. Check discovery
+ * can be started again afterwards.
+ */
+TEST_F(DiscoveryTest, cancelledMidRun) {
+  AddResponder(0x7a7012345678);
+  AddResponder(0x7a7012345679);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_CANCELLED));
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+
+  // Deliver the unmute response, then cancel the first DUB.
+  RunBusOnce();
+  EXPECT_EQ(1u, m_unmute_count);
+  CancelPending();
+  EXPECT_FALSE(Discovery_IsRunning());
+
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectAllUIDsFound();
+}
+
+TEST_F(DiscoveryTest, otherEvents) {
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+
+  TransceiverEvent event = {
+    kToken, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, nullptr, 0, nullptr, kPort
+  };
+  EXPECT_FALSE(Discovery_TransceiverEvent(&event));
+  EXPECT_TRUE(Discovery_IsRunning());
+}
+
+TEST_F(DiscoveryTest, otherPort) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+  // All operations are queued on the other port.
+  EXPECT_CALL(m_transceiver_mock, QueueRDMDUB(kOtherPort, _, _, _))
+      .Times(AnyNumber());
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kOtherPort, _, _, _, _))
+      .Times(AnyNumber());
+
+  EXPECT_TRUE(Discovery_Start(kToken, kOtherPort, DISCOVERY_FULL));
+  EXPECT_EQ(kOtherPort, Discovery_GetPort());
+
+  // Events from the other ports are ignored.
+  TransceiverEvent event = {
+    DISCOVERY_TOKEN, T_OP_RDM_BROADCAST, T_RESULT_CANCELLED, nullptr, 0,
+    nullptr, kPort
+  };
+  EXPECT_TRUE(Discovery_TransceiverEvent(&event));
+  EXPECT_TRUE(Discovery_IsRunning());
+
+  RunBus();
+  ExpectAllUIDsFound();
+
+  // An incremental run on the same port keeps the known UIDs.
+  m_dub_count = 0;
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kOtherPort, DISCOVERY_INCREMENTAL));
+  RunBus();
+  ExpectAllUIDsFound();
+  ExpectChanges({}, {});
+  EXPECT_EQ(m_responders.size(), m_single_dub_count);
+}
+
+TEST_F(DiscoveryTest, changePort) {
+  AddResponder(0x7a7000000001);
+  AddResponder(0x7a7000000002);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+  EXPECT_CALL(m_complete_mock, Complete(kToken + 1, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+  ExpectAllUIDsFound();
+
+  // The UIDs found on the first port aren't known on the other port, so they
+  // aren't verified, or reported as removed.
+  m_responders.clear();
+  AddResponder(0x7a7000000003);
+  EXPECT_TRUE(Discovery_Start(kToken + 1, kOtherPort, DISCOVERY_INCREMENTAL));
+  RunBus();
+  ExpectAllUIDsFound();
+  ExpectChanges({0x7a7000000003}, {});
+  EXPECT_EQ(0u, m_single_dub_count);
+}
+
+TEST_F(DiscoveryTest, changePortQueueFull) {
+  AddResponder(0x7a7000000001);
+  EXPECT_CALL(m_complete_mock, Complete(kToken, DISCOVERY_OK));
+
+  EXPECT_TRUE(Discovery_Start(kToken, kPort, DISCOVERY_FULL));
+  RunBus();
+
+  // If the run can't start, the port & known UIDs are unchanged.
+  EXPECT_CALL(m_transceiver_mock,
+              QueueRDMRequest(kOtherPort, DISCOVERY_TOKEN, _, _, true))
+      .WillOnce(Return(false));
+  EXPECT_FALSE(Discovery_Start(kToken + 1, kOtherPort, DISCOVERY_FULL));
+  EXPECT_EQ(kPort, Discovery_GetPort());
+  EXPECT_EQ(1u, Discovery_UIDCount());
+}
@@ -35,6 +35,7 @@
 #include "Array.h"
 #include "Matchers.h"
 #include "ModelTest.h"
+#include "SPIRGBMock.h"
 #include "TestHelpers.h"
 
 using ola::network::HostToNetwork;
@@ -45,6 +46,8 @@ using ola::rdm::RDMRequest;
 using ola::rdm::RDMResponse;
 using ola::rdm::RDMSetRequest;
 using std::unique_ptr;
+using ::testing::InSequence;
+using ::testing::StrictMock;
 
 class LEDModelTest : public ModelTest {
  public:
@@ -58,3 +61,44 @@ class LEDModelTest : public ModelTest {
     LED_MODEL_ENTRY.activate_fn();
   }
 };
+
+TEST_F(LEDModelTest, dmxWindow) {
+  DMXSlotWindow window;
+  uint8_t *data = reinterpret_cast<uint8_t*>(&window);
+  EXPECT_EQ(0, m_model->ioctl_fn(IOCTL_GET_DMX_WINDOW, data, 0));
+  EXPECT_EQ(1, m_model->ioctl_fn(IOCTL_GET_DMX_WINDOW, data, sizeof(window)));
+  EXPECT_EQ(1, window.start_address);
+  EXPECT_EQ(6, window.footprint);
+
+  uint16_t pixel_count = HostToNetwork(static_cast<uint16_t>(10));
+  unique_ptr<RDMRequest> request = BuildSetRequest(
+      PID_PIXEL_COUNT, reinterpret_cast<uint8_t*>(&pixel_count),
+      sizeof(pixel_count));
+  EXPECT_NE(0, InvokeRDMHandler(request.get()));
+
+  EXPECT_EQ(1, m_model->ioctl_fn(IOCTL_GET_DMX_WINDOW, data, sizeof(window)));
+  EXPECT_EQ(1, window.start_address);
+  EXPECT_EQ(30, window.footprint);
+}
+
+TEST_F(LEDModelTest, dmxOutput) {
+  StrictMock<MockSPIRGB> spi_mock;
+  SPIRGB_SetMock(&spi_mock);
+
+  {
+    InSequence seq;
+    EXPECT_CALL(spi_mock, BeginUpdate());
+    EXPECT_CALL(spi_mock, SetPixel(0, RED, 1));
+    EXPECT_CALL(spi_mock, SetPixel(0, GREEN, 2));
+    EXPECT_CALL(spi_mock, SetPixel(0, BLUE, 3));
+    EXPECT_CALL(spi_mock, SetPixel(1, RED, 4));
+    EXPECT_CALL(spi_mock, CompleteUpdate());
+  }
+
+  const uint8_t slots[] = {1, 2, 3, 4};
+  m_model->dmx_fn(slots, arraysize(slots), true);
+
+  // Unchanged frames don't update the pixels.
+  m_model->dmx_fn(slots, arraysize(slots), false);
+  SPIRGB_SetMock(nullptr);
+}
@@ -31,6 +31,7 @@ TESTS += tests/tests/bootloader_test \
          tests/tests/bootloader_transfer_test \
          tests/tests/coarse_timer_test \
          tests/tests/dimmer_model_test \
+         tests/tests/discovery_test \
          tests/tests/flags_test \
          tests/tests/led_model_test \
          tests/tests/message_handler_test \
@@ -39,12 +40,16 @@ TESTS += tests/tests/bootloader_test \
          tests/tests/rdm_handler_test \
          tests/tests/rdm_responder_test \
          tests/tests/rdm_util_test \
+         tests/tests/responder_definition_test \
          tests/tests/responder_test \
          tests/tests/spirgb_test \
          tests/tests/stream_decoder_test \
          tests/tests/simulated_transceiver_test \
+         tests/tests/simulated_transceiver_dma_test \
          tests/tests/spi_test \
+         tests/tests/syslog_test \
          tests/tests/transceiver_test \
+         tests/tests/transceiver_static_test \
          tests/tests/usb_transport_test \
          tests/tests/utils_test
 
@@ -93,6 +98,14 @@ tests_tests_dimmer_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                       tests/tests/libmodeltest.la \
                                       tests/mocks/libmatchers.la
 
+tests_tests_discovery_test_SOURCES = tests/tests/DiscoveryTest.cpp
+tests_tests_discovery_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_discovery_test_LDADD = $(TESTING_LIBS) \
+                                   firmware/src/libdiscovery.la \
+                                   firmware/src/librdmutil.la \
+                                   tests/mocks/libsyslogmock.la \
+                                   tests/mocks/libtransceivermock.la
+
 tests_tests_flags_test_SOURCES = tests/tests/FlagsTest.cpp
 tests_tests_flags_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_flags_test_LDADD = $(TESTING_LIBS) \
@@ -112,13 +125,17 @@ tests_tests_led_model_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                    firmware/src/librdmutil.la \
                                    tests/tests/libmodeltest.la \
                                    tests/harmony/mocks/libharmonymock.la \
-                                   tests/mocks/libmatchers.la
+                                   tests/mocks/libmatchers.la \
+                                   tests/mocks/libspirgbmock.la
 
 tests_tests_message_handler_test_SOURCES = tests/tests/MessageHandlerTest.cpp
 tests_tests_message_handler_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_message_handler_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                          firmware/src/libmessagehandler.la \
+                                         firmware/src/librdmutil.la \
                                          tests/mocks/libappmock.la \
+                                         tests/mocks/libcoarsetimermock.la \
+                                         tests/mocks/libdiscoverymock.la \
                                          tests/mocks/libflagsmock.la \
                                          tests/mocks/libmatchers.la \
                                          tests/mocks/librdmhandlermock.la \
@@ -159,6 +176,7 @@ tests_tests_rdm_handler_test_SOURCES = tests/tests/RDMHandlerTest.cpp
 tests_tests_rdm_handler_test_CXXFLAGS = $(TESTING_CXXFLAGS) $(OLA_CFLAGS)
 tests_tests_rdm_handler_test_LDADD = $(TESTING_LIBS) $(OLA_LIBS) \
                                      tests/mocks/libmatchers.la \
+                                     tests/mocks/libtransceivermock.la \
                                      firmware/src/librdmhandler.la \
                                      firmware/src/librdmresponder.la \
                                      firmware/src/libreceivercounters.la \
@@ -185,6 +203,26 @@ tests_tests_rdm_util_test_LDADD = $(TESTING_LIBS) \
                                   firmware/src/librdmutil.la \
                                   tests/mocks/libmatchers.la
 
+tests_tests_responder_definition_test_SOURCES = \
+    tests/tests/ResponderDefinitionTest.cpp
+tests_tests_responder_definition_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_responder_definition_test_LDADD = \
+    $(TESTING_LIBS) \
+    firmware/src/libdimmermodel.la \
+    firmware/src/libledmodel.la \
+    firmware/src/libmovinglightmodel.la \
+    firmware/src/libnetworkmodel.la \
+    firmware/src/libproxymodel.la \
+    firmware/src/librandom.la \
+    firmware/src/librdmbuffer.la \
+    firmware/src/librdmresponder.la \
+    firmware/src/librdmutil.la \
+    firmware/src/libreceivercounters.la \
+    firmware/src/libsensormodel.la \
+    firmware/src/libcoarsetimer.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libspirgbmock.la
+
 tests_tests_responder_test_SOURCES = tests/tests/ResponderTest.cpp
 tests_tests_responder_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_responder_test_LDADD = $(TESTING_LIBS) \
@@ -194,8 +232,8 @@ tests_tests_responder_test_LDADD = $(TESTING_LIBS) \
                                    firmware/src/librdmutil.la \
                                    tests/mocks/libmatchers.la \
                                    tests/mocks/librdmhandlermock.la \
-                                   tests/mocks/libspirgbmock.la \
-                                   tests/mocks/libsyslogmock.la
+                                   tests/mocks/libsyslogmock.la \
+                                   tests/mocks/libtransceivermock.la
 
 tests_tests_spirgb_test_SOURCES = tests/tests/SPIRGBTest.cpp
 tests_tests_spirgb_test_CXXFLAGS = $(TESTING_CXXFLAGS)
@@ -230,6 +268,11 @@ tests_tests_spi_test_LDADD = \
     tests/mocks/libmatchers.la \
     tests/harmony/mocks/libharmonymock.la
 
+tests_tests_syslog_test_SOURCES = tests/tests/SysLogTest.cpp
+tests_tests_syslog_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_syslog_test_LDADD = $(TESTING_LIBS) \
+                                firmware/src/libsyslog.la
+
 tests_tests_transceiver_test_SOURCES = tests/tests/TransceiverTest.cpp
 tests_tests_transceiver_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_transceiver_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
@@ -238,6 +281,15 @@ tests_tests_transceiver_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
                                      tests/mocks/libcoarsetimermock.la \
                                      tests/mocks/libsyslogmock.la
 
+tests_tests_transceiver_static_test_SOURCES = tests/tests/TransceiverTest.cpp
+tests_tests_transceiver_static_test_CXXFLAGS = $(TESTING_CXXFLAGS)
+tests_tests_transceiver_static_test_LDADD = \
+    $(GMOCK_LIBS) $(GTEST_LIBS) \
+    firmware/src/libtransceiverstatic.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libcoarsetimermock.la \
+    tests/mocks/libsyslogmock.la
+
 tests_tests_simulated_transceiver_test_SOURCES = \
     tests/tests/SimulatedTransceiverTest.cpp
 tests_tests_simulated_transceiver_test_CXXFLAGS = \
@@ -250,6 +302,18 @@ tests_tests_simulated_transceiver_test_LDADD = \
     tests/harmony/mocks/libharmonymock.la \
     tests/mocks/libsyslogmock.la
 
+tests_tests_simulated_transceiver_dma_test_SOURCES = \
+    tests/tests/SimulatedTransceiverTest.cpp
+tests_tests_simulated_transceiver_dma_test_CXXFLAGS = \
+    $(TESTING_CXXFLAGS) $(OLA_CFLAGS) -DTRANSCEIVER_DMA
+tests_tests_simulated_transceiver_dma_test_LDADD = \
+    $(GMOCK_LIBS) $(GTEST_LIBS) $(OLA_LIBS) \
+    tests/sim/libsim.la \
+    firmware/src/libtransceiverdma.la \
+    firmware/src/libcoarsetimer.la \
+    tests/harmony/mocks/libharmonymock.la \
+    tests/mocks/libsyslogmock.la
+
 tests_tests_utils_test_SOURCES = tests/tests/UtilsTest.cpp
 tests_tests_utils_test_CXXFLAGS = $(TESTING_CXXFLAGS)
 tests_tests_utils_test_LDADD = $(GMOCK_LIBS) $(GTEST_LIBS) \
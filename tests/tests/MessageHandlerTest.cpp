@@ -19,9 +19,15 @@
  */
 
 #include <gtest/gtest.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
 
 #include "AppMock.h"
 #include "Array.h"
+#include "CoarseTimerMock.h"
+#include "DiscoveryMock.h"
 #include "FlagsMock.h"
 #include "Matchers.h"
 #include "RDMHandlerMock.h"
@@ -29,12 +35,32 @@
 #include "TransportMock.h"
 #include "constants.h"
 #include "message_handler.h"
+#include "rdm.h"
+#include "rdm_frame.h"
+#include "rdm_util.h"
+#include "utils.h"
+
+#include "app_settings.h"
 
 using ::testing::Args;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::InvokeWithoutArgs;
+using ::testing::NiceMock;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::_;
+using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
+using std::vector;
 
+namespace {
+
+// Add the port index to a command.
+Command PortCommand(uint8_t port, Command command) {
+  return static_cast<Command>((port << 8) | command);
+}
+}  // namespace
 
 // Tests for configuration messages.
 // ----------------------------------------------------------------------------
@@ -69,6 +95,7 @@ class ConfigurationTest
   MockTransport m_transport_mock;
   MockTransceiver m_transceiver_mock;
   static const uint8_t kToken = 0;
+  static const uint8_t kPort = 0;
 };
 
 TEST_P(ConfigurationTest, CheckOversizedGetRequest) {
@@ -126,45 +153,51 @@ TEST_P(ConfigurationTest, CheckSetGet) {
 
   switch (args.get_command) {
     case COMMAND_GET_BREAK_TIME:
-      EXPECT_CALL(m_transceiver_mock, SetBreakTime(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetBreakTime(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetBreakTime())
+      EXPECT_CALL(m_transceiver_mock, GetBreakTime(kPort))
           .WillOnce(Return(args.value));
       break;
     case COMMAND_GET_MARK_TIME:
-      EXPECT_CALL(m_transceiver_mock, SetMarkTime(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetMarkTime(kPort, args.value))
+          .WillOnce(Return(true));
+      EXPECT_CALL(m_transceiver_mock, GetMarkTime(kPort))
+          .WillOnce(Return(args.value));
+      break;
+    case COMMAND_GET_DMX_REFRESH_INTERVAL:
+      EXPECT_CALL(m_transceiver_mock, SetDMXRefreshInterval(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetMarkTime())
+      EXPECT_CALL(m_transceiver_mock, GetDMXRefreshInterval(kPort))
           .WillOnce(Return(args.value));
       break;
     case COMMAND_GET_RDM_BROADCAST_TIMEOUT:
-      EXPECT_CALL(m_transceiver_mock, SetRDMBroadcastTimeout(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetRDMBroadcastTimeout(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetRDMBroadcastTimeout())
+      EXPECT_CALL(m_transceiver_mock, GetRDMBroadcastTimeout(kPort))
           .WillOnce(Return(args.value));
       break;
     case COMMAND_GET_RDM_RESPONSE_TIMEOUT:
-      EXPECT_CALL(m_transceiver_mock, SetRDMResponseTimeout(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetRDMResponseTimeout(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetRDMResponseTimeout())
+      EXPECT_CALL(m_transceiver_mock, GetRDMResponseTimeout(kPort))
           .WillOnce(Return(args.value));
       break;
     case COMMAND_GET_RDM_DUB_RESPONSE_LIMIT:
-      EXPECT_CALL(m_transceiver_mock, SetRDMDUBResponseLimit(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetRDMDUBResponseLimit(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetRDMDUBResponseLimit())
+      EXPECT_CALL(m_transceiver_mock, GetRDMDUBResponseLimit(kPort))
           .WillOnce(Return(args.value));
       break;
     case COMMAND_GET_RDM_RESPONDER_DELAY:
-      EXPECT_CALL(m_transceiver_mock, SetRDMResponderDelay(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetRDMResponderDelay(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetRDMResponderDelay())
+      EXPECT_CALL(m_transceiver_mock, GetRDMResponderDelay(kPort))
           .WillOnce(Return(args.value));
       break;
     case COMMAND_GET_RDM_RESPONDER_JITTER:
-      EXPECT_CALL(m_transceiver_mock, SetRDMResponderJitter(args.value))
+      EXPECT_CALL(m_transceiver_mock, SetRDMResponderJitter(kPort, args.value))
           .WillOnce(Return(true));
-      EXPECT_CALL(m_transceiver_mock, GetRDMResponderJitter())
+      EXPECT_CALL(m_transceiver_mock, GetRDMResponderJitter(kPort))
           .WillOnce(Return(args.value));
       break;
     default:
@@ -187,6 +220,8 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Values(
       ConfigurationTestArgs(COMMAND_GET_BREAK_TIME, COMMAND_SET_BREAK_TIME, 88),
       ConfigurationTestArgs(COMMAND_GET_MARK_TIME, COMMAND_SET_MARK_TIME, 16),
+      ConfigurationTestArgs(COMMAND_GET_DMX_REFRESH_INTERVAL,
+                            COMMAND_SET_DMX_REFRESH_INTERVAL, 250),
       ConfigurationTestArgs(COMMAND_GET_RDM_BROADCAST_TIMEOUT,
                             COMMAND_SET_RDM_BROADCAST_TIMEOUT, 20),
       ConfigurationTestArgs(COMMAND_GET_RDM_RESPONSE_TIMEOUT,
@@ -208,6 +243,8 @@ class MessageHandlerTest : public testing::Test {
     Transceiver_SetMock(&m_transceiver_mock);
     MessageHandler_Initialize(Transport_Send);
     RDMHandler_SetMock(&m_rdm_handler_mock);
+    Discovery_SetMock(&m_discovery_mock);
+    CoarseTimer_SetMock(&m_timer_mock);
   }
 
   void TearDown() {
@@ -215,11 +252,13 @@ class MessageHandlerTest : public testing::Test {
     Flags_SetMock(nullptr);
     Transport_SetMock(nullptr);
     RDMHandler_SetMock(nullptr);
+    Discovery_SetMock(nullptr);
+    CoarseTimer_SetMock(nullptr);
   }
 
-  void SendEvent(uint8_t token, TransceiverOperation op,
+  void SendEvent(int16_t token, TransceiverOperation op,
                  TransceiverOperationResult result, const uint8_t *data,
-                 unsigned int length) {
+                 unsigned int length, uint8_t port = kPort) {
     TransceiverTiming timing;
     memset(reinterpret_cast<uint8_t*>(&timing), 0, sizeof(timing));
     TransceiverEvent event {
@@ -228,7 +267,8 @@ class MessageHandlerTest : public testing::Test {
       .result = result,
       .data = data,
       .length = length,
-      .timing = &timing
+      .timing = &timing,
+      .port = port
     };
     MessageHandler_TransceiverEvent(&event);
   }
@@ -237,8 +277,12 @@ class MessageHandlerTest : public testing::Test {
   MockTransport m_transport_mock;
   MockTransceiver m_transceiver_mock;
   MockRDMHandler m_rdm_handler_mock;
+  NiceMock<MockDiscovery> m_discovery_mock;
+  NiceMock<MockCoarseTimer> m_timer_mock;
 
   static const uint8_t kToken = 0;
+  static const uint8_t kPort = 0;
+  static const uint8_t kOtherPort = 1;
   static const uint8_t kEmptyDUBResponse[];
   static const uint8_t kEmptyRDMResponse[];
 };
@@ -264,11 +308,11 @@ TEST_F(MessageHandlerTest, testSetMode) {
               RC_INVALID_MODE, _, 0))
       .Times(1)
       .WillRepeatedly(Return(true));
-  EXPECT_CALL(m_transceiver_mock, SetMode(T_MODE_CONTROLLER, kToken))
+  EXPECT_CALL(m_transceiver_mock, SetMode(kPort, T_MODE_CONTROLLER, kToken))
       .WillOnce(Return(true));
-  EXPECT_CALL(m_transceiver_mock, SetMode(T_MODE_RESPONDER, kToken))
+  EXPECT_CALL(m_transceiver_mock, SetMode(kPort, T_MODE_RESPONDER, kToken))
       .WillOnce(Return(true));
-  EXPECT_CALL(m_transceiver_mock, SetMode(T_MODE_SELF_TEST, kToken))
+  EXPECT_CALL(m_transceiver_mock, SetMode(kPort, T_MODE_SELF_TEST, kToken))
       .WillOnce(Return(false));
 
   uint8_t request_payload = 0;
@@ -283,11 +327,32 @@ TEST_F(MessageHandlerTest, testSetMode) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testSetModeOtherPort) {
+  const Command command = PortCommand(kOtherPort, COMMAND_SET_MODE);
+  EXPECT_CALL(m_transport_mock, Send(kToken, command, RC_BAD_PARAM, NULL, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transceiver_mock,
+              SetMode(kOtherPort, T_MODE_CONTROLLER, kToken))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transceiver_mock, SetMode(kOtherPort, T_MODE_RESPONDER, _))
+      .Times(0);
+
+  // The responder only runs on the first port.
+  uint8_t request_payload = T_MODE_RESPONDER;
+  Message message = { kToken, static_cast<uint16_t>(command),
+                      sizeof(request_payload), &request_payload };
+  MessageHandler_HandleMessage(&message);
+
+  request_payload = T_MODE_CONTROLLER;
+  MessageHandler_HandleMessage(&message);
+}
+
 TEST_F(MessageHandlerTest, testGetInfo) {
   uint8_t response[] = {
     0x03, 0x00,
     0x7a, 0x70, 0x01, 0x02, 0x03, 0x04,
-    0, 0, 0, 0, 0, 0
+    0, 0, 0, 0, 0, 0,
+    TRANSCEIVER_PORT_COUNT
   };
 
   EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_GET_HARDWARE_INFO, RC_OK,
@@ -303,13 +368,96 @@ TEST_F(MessageHandlerTest, testGetInfo) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testGetTurnaroundStats) {
+  TransceiverTurnaroundStats stats;
+  memset(&stats, 0, sizeof(stats));
+  stats.count = 2;
+  stats.min = 1800;
+  stats.max = 2600;
+  stats.mean = 2200;
+  stats.histogram[0] = 1;
+  stats.histogram[1] = 1;
+
+  const uint8_t response[] = {
+    0x02, 0x00, 0x00, 0x00,  // count
+    0x08, 0x07,  // min
+    0x28, 0x0a,  // max
+    0x98, 0x08,  // mean
+    0x01, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00
+  };
+
+  EXPECT_CALL(m_transceiver_mock, GetTurnaroundStats(kPort, _))
+      .WillOnce(SetArgPointee<1>(stats));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_GET_RDM_TURNAROUND_STATS, RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_GET_RDM_TURNAROUND_STATS, 0, NULL };
+  MessageHandler_HandleMessage(&message);
+
+  // A payload is rejected.
+  const uint8_t payload = 0;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_GET_RDM_TURNAROUND_STATS, RC_BAD_PARAM,
+                   NULL, 0))
+      .WillOnce(Return(true));
+  Message bad_message = {
+    kToken, COMMAND_GET_RDM_TURNAROUND_STATS, sizeof(payload), &payload
+  };
+  MessageHandler_HandleMessage(&bad_message);
+}
+
+TEST_F(MessageHandlerTest, testGetLineStats) {
+  TransceiverLineStats stats;
+  stats.dmx_frames = 40;
+  stats.dmx_time = 9200;
+  stats.rdm_frames = 3;
+  stats.rdm_time = 258;
+
+  const uint8_t response[] = {
+    0x28, 0x00, 0x00, 0x00,  // DMX frames
+    0xf0, 0x23, 0x00, 0x00,  // DMX time
+    0x03, 0x00, 0x00, 0x00,  // RDM frames
+    0x02, 0x01, 0x00, 0x00,  // RDM time
+  };
+
+  EXPECT_CALL(m_transceiver_mock, GetLineStats(kPort, _))
+      .WillOnce(SetArgPointee<1>(stats));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_GET_LINE_STATS, RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_GET_LINE_STATS, 0, NULL };
+  MessageHandler_HandleMessage(&message);
+
+  // A payload is rejected.
+  const uint8_t payload = 0;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_GET_LINE_STATS, RC_BAD_PARAM, NULL, 0))
+      .WillOnce(Return(true));
+  Message bad_message = {
+    kToken, COMMAND_GET_LINE_STATS, sizeof(payload), &payload
+  };
+  MessageHandler_HandleMessage(&bad_message);
+}
+
 TEST_F(MessageHandlerTest, testDMX) {
   const uint8_t dmx_data[] = {1, 3, 4, 4};
 
   testing::InSequence seq;
-  EXPECT_CALL(m_transceiver_mock, QueueDMX(_, _, arraysize(dmx_data)))
+  EXPECT_CALL(m_transceiver_mock, QueueDMX(kPort, _, _, arraysize(dmx_data)))
       .WillOnce(Return(true));
-  EXPECT_CALL(m_transceiver_mock, QueueDMX(_, _, arraysize(dmx_data)))
+  EXPECT_CALL(m_transceiver_mock, QueueDMX(kPort, _, _, arraysize(dmx_data)))
       .WillOnce(Return(false));
   EXPECT_CALL(m_transport_mock, Send(kToken, TX_DMX, RC_BUFFER_FULL, NULL, 0))
       .WillOnce(Return(true));
@@ -351,6 +499,729 @@ TEST_F(MessageHandlerTest, testUnknownMessage) {
   MessageHandler_HandleMessage(&message);
 }
 
+TEST_F(MessageHandlerTest, testBatch) {
+  const uint8_t request[] = {
+    0xf0, 0x00, 0x02, 0x00, 0x01, 0x02,  // echo
+    0x11, 0x00, 0x00, 0x00,  // get break time
+    0x30, 0x00, 0x01, 0x00, 0x00,  // TX DMX, not batchable
+    0x12, 0x00, 0x02, 0x00, 0x0a, 0x00,  // set mark time
+  };
+  const uint8_t response[] = {
+    0xf0, 0x00, RC_OK, 0x02, 0x00, 0x01, 0x02,
+    0x11, 0x00, RC_OK, 0x02, 0x00, 0xb0, 0x00,
+    0x30, 0x00, RC_BAD_PARAM, 0x00, 0x00,
+    0x12, 0x00, RC_OK, 0x00, 0x00,
+  };
+
+  EXPECT_CALL(m_transceiver_mock, GetBreakTime(kPort)).WillOnce(Return(176));
+  EXPECT_CALL(m_transceiver_mock, QueueDMX(kPort, _, _, _)).Times(0);
+  EXPECT_CALL(m_transceiver_mock, SetMarkTime(kPort, 10))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_BATCH, RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_BATCH, arraysize(request), request };
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testMalformedBatch) {
+  EXPECT_CALL(m_transceiver_mock, GetBreakTime(kPort)).Times(0);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_BATCH, RC_BAD_PARAM, NULL, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  // The second sub-command is missing its length.
+  const uint8_t short_header[] = {0x11, 0x00, 0x00, 0x00, 0x13, 0x00};
+  Message message = {
+    kToken, COMMAND_BATCH, arraysize(short_header), short_header
+  };
+  MessageHandler_HandleMessage(&message);
+
+  // The second sub-command is missing its payload.
+  const uint8_t short_payload[] = {
+    0x11, 0x00, 0x00, 0x00,
+    0x12, 0x00, 0x02, 0x00, 0x0a
+  };
+  message.length = arraysize(short_payload);
+  message.payload = short_payload;
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testBatchOverflow) {
+  const unsigned int kEchoSize = 490;
+  uint8_t request[4 + kEchoSize + 4 * 4];
+  memset(request, 0, sizeof(request));
+  uint8_t *ptr = request;
+  *ptr++ = 0xf0;
+  *ptr++ = 0x00;
+  *ptr++ = kEchoSize & 0xff;
+  *ptr++ = kEchoSize >> 8;
+  ptr += kEchoSize;
+  for (unsigned int i = 0; i < 3; i++) {
+    *ptr++ = 0x11;  // get break time
+    ptr += 3;
+  }
+  *ptr++ = 0x13;  // get mark time
+
+  // The third break time response doesn't fit, so the mark time is never
+  // requested.
+  EXPECT_CALL(m_transceiver_mock, GetBreakTime(kPort))
+      .Times(3)
+      .WillRepeatedly(Return(176));
+  EXPECT_CALL(m_transceiver_mock, GetMarkTime(kPort)).Times(0);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_BATCH, RC_BUFFER_FULL, _, 1))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_BATCH, sizeof(request), request };
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testRDMBatch) {
+  const uint8_t request[] = {
+    0x41, 0x00, 3, 0, 1, 2, 3,  // RDM request
+    0xf0, 0x00, 0, 0,  // echo isn't allowed
+    0x42, 0x00, 2, 0, 4, 5  // RDM broadcast request
+  };
+  const uint8_t rdm_reply[] = {0xcc, 1, 2, 3, 4};
+  const uint8_t response[] = {
+    0x41, 0x00, RC_OK, 11, 0,
+    0, 0, 0, 0, 0, 0, 0xcc, 1, 2, 3, 4,
+    0xf0, 0x00, RC_BAD_PARAM, 0, 0,
+    0x42, 0x00, RC_OK, 0, 0
+  };
+
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+
+  int16_t batch_token = 0;
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, _, _, 3, false))
+      .WillOnce(DoAll(SaveArg<1>(&batch_token), Return(true)));
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, _, _, 2, true))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_RDM_BATCH, sizeof(request), request };
+  MessageHandler_HandleMessage(&message);
+
+  // The batch token is outside the range of host tokens.
+  EXPECT_LT(UINT8_MAX, batch_token);
+  SendEvent(batch_token, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA, rdm_reply,
+            arraysize(rdm_reply));
+
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_RDM_BATCH, RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+  SendEvent(batch_token, T_OP_RDM_BROADCAST, T_RESULT_RX_TIMEOUT, NULL, 0);
+}
+
+TEST_F(MessageHandlerTest, testRDMBatchErrors) {
+  const uint8_t request[] = {
+    0x41, 0x00, 1, 0, 1,
+    0x41, 0x00, 1, 0, 2
+  };
+  const uint8_t bad_request[] = {0x41, 0x00, 2, 0, 1};
+
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillOnce(Return(T_MODE_RESPONDER))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_BATCH, RC_BAD_PARAM, _, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_BATCH, RC_INVALID_MODE, _, 0))
+      .WillOnce(Return(true));
+
+  Message bad_message = {
+    kToken, COMMAND_RDM_BATCH, sizeof(bad_request), bad_request
+  };
+  MessageHandler_HandleMessage(&bad_message);
+
+  Message message = { kToken, COMMAND_RDM_BATCH, sizeof(request), request };
+  MessageHandler_HandleMessage(&message);  // Responder mode
+
+  // The transceiver queue is full when the second request is queued.
+  const uint8_t queue_full_response[] = {
+    0x41, 0x00, RC_RDM_TIMEOUT, 6, 0, 0, 0, 0, 0, 0, 0,
+    0x41, 0x00, RC_BUFFER_FULL, 0, 0
+  };
+  int16_t batch_token = 0;
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, _, _, 1, false))
+      .WillOnce(DoAll(SaveArg<1>(&batch_token), Return(true)))
+      .WillOnce(Return(false));
+  MessageHandler_HandleMessage(&message);
+
+  // Only one batch can run at once.
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, COMMAND_RDM_BATCH, RC_BUFFER_FULL, _, 0))
+      .WillOnce(Return(true));
+  Message second_message = {
+    kToken + 1, COMMAND_RDM_BATCH, sizeof(request), request
+  };
+  MessageHandler_HandleMessage(&second_message);
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_BATCH, RC_BUFFER_FULL, _, 1))
+      .With(Args<3, 4>(PayloadIs(queue_full_response,
+                                 arraysize(queue_full_response))))
+      .WillOnce(Return(true));
+  SendEvent(batch_token, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_TIMEOUT, NULL, 0);
+
+  // A mode change cancels the batch.
+  const uint8_t cancelled_response[] = {
+    0x41, 0x00, RC_CANCELLED, 6, 0, 0, 0, 0, 0, 0, 0
+  };
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, _, _, 1, false))
+      .WillOnce(Return(true));
+  MessageHandler_HandleMessage(&message);
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_BATCH, RC_CANCELLED, _, 1))
+      .With(Args<3, 4>(PayloadIs(cancelled_response,
+                                 arraysize(cancelled_response))))
+      .WillOnce(Return(true));
+  SendEvent(batch_token, T_OP_RDM_WITH_RESPONSE, T_RESULT_CANCELLED, NULL, 0);
+}
+
+/*
+ * Resetting the device cancels the batch's pending request, which must free
+ * the batch for the next command.
+ */
+TEST_F(MessageHandlerTest, testRDMBatchReset) {
+  const uint8_t request[] = {
+    0x41, 0x00, 1, 0, 1,
+    0x41, 0x00, 1, 0, 2
+  };
+  const uint8_t cancelled_response[] = {
+    0x41, 0x00, RC_CANCELLED, 6, 0, 0, 0, 0, 0, 0, 0
+  };
+  MockApp app_mock;
+  APP_SetMock(&app_mock);
+
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+
+  int16_t batch_token = 0;
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, _, _, 1, false))
+      .WillOnce(DoAll(SaveArg<1>(&batch_token), Return(true)))
+      .WillOnce(Return(true));
+  Message message = { kToken, COMMAND_RDM_BATCH, sizeof(request), request };
+  MessageHandler_HandleMessage(&message);
+
+  // The transceiver runs the cancelled event during the reset.
+  EXPECT_CALL(app_mock, Reset())
+      .WillOnce(InvokeWithoutArgs([&]() {
+        SendEvent(batch_token, T_OP_RDM_WITH_RESPONSE, T_RESULT_CANCELLED,
+                  NULL, 0);
+      }));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_BATCH, RC_CANCELLED, _, 1))
+      .With(Args<3, 4>(PayloadIs(cancelled_response,
+                                 arraysize(cancelled_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, COMMAND_RESET_DEVICE, RC_OK, NULL, 0))
+      .WillOnce(Return(true));
+  Message reset_message = { kToken + 1, COMMAND_RESET_DEVICE, 0, NULL };
+  MessageHandler_HandleMessage(&reset_message);
+
+  // The next batch is accepted.
+  message.token = kToken + 2;
+  MessageHandler_HandleMessage(&message);
+  APP_SetMock(nullptr);
+}
+
+/*
+ * Build a RDM response, including the start code.
+ */
+static vector<uint8_t> BuildRDMResponse(uint8_t response_type,
+                                        uint8_t transaction_number,
+                                        const vector<uint8_t> &param_data) {
+  const uint8_t controller_uid[] = {0x7a, 0x70, 0, 0, 0, 1};
+  const uint8_t responder_uid[] = {0x7a, 0x70, 0x12, 0x34, 0x56, 0x78};
+
+  vector<uint8_t> frame(
+      sizeof(RDMHeader) + param_data.size() + RDM_CHECKSUM_LENGTH);
+  RDMHeader *header = reinterpret_cast<RDMHeader*>(frame.data());
+  header->start_code = RDM_START_CODE;
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = sizeof(RDMHeader) + param_data.size();
+  memcpy(header->dest_uid, controller_uid, UID_LENGTH);
+  memcpy(header->src_uid, responder_uid, UID_LENGTH);
+  header->transaction_number = transaction_number;
+  header->port_id = response_type;
+  header->command_class = GET_COMMAND_RESPONSE;
+  header->param_id = htons(PID_DEVICE_INFO);
+  header->param_data_length = param_data.size();
+  std::copy(param_data.begin(), param_data.end(),
+            frame.begin() + sizeof(RDMHeader));
+  RDMUtil_AppendChecksum(frame.data());
+  return frame;
+}
+
+TEST_F(MessageHandlerTest, testSetAckTimerFollowUp) {
+  const uint8_t enabled = 1;
+  const uint8_t bad_value = 2;
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_BAD_PARAM, _, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_OK, _, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_GET_ACK_TIMER_FOLLOW_UP, RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(&enabled, sizeof(enabled))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_GET_ACK_TIMER_FOLLOW_UP, RC_BAD_PARAM, _, 0))
+      .WillOnce(Return(true));
+
+  Message bad_set = {
+    kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, sizeof(bad_value), &bad_value
+  };
+  MessageHandler_HandleMessage(&bad_set);
+  Message empty_set = { kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, 0, NULL };
+  MessageHandler_HandleMessage(&empty_set);
+
+  Message set = {
+    kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, sizeof(enabled), &enabled
+  };
+  MessageHandler_HandleMessage(&set);
+
+  Message get = { kToken, COMMAND_GET_ACK_TIMER_FOLLOW_UP, 0, NULL };
+  MessageHandler_HandleMessage(&get);
+  Message bad_get = {
+    kToken, COMMAND_GET_ACK_TIMER_FOLLOW_UP, sizeof(enabled), &enabled
+  };
+  MessageHandler_HandleMessage(&bad_get);
+}
+
+TEST_F(MessageHandlerTest, testAckTimerFollowUp) {
+  const uint8_t enabled = 1;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_OK, _, 0))
+      .WillOnce(Return(true));
+  Message set = {
+    kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, sizeof(enabled), &enabled
+  };
+  MessageHandler_HandleMessage(&set);
+
+  // 200ms ACK_TIMER
+  vector<uint8_t> ack_timer = BuildRDMResponse(ACK_TIMER, 5, {0, 2});
+  vector<uint8_t> ack = BuildRDMResponse(ACK, 6, {1, 2, 3});
+
+  EXPECT_CALL(m_transport_mock, Send(_, _, _, _, _)).Times(0);
+  SendEvent(kToken, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+
+  // Nothing is sent until the delay has passed.
+  EXPECT_CALL(m_timer_mock, HasElapsed(_, 2000))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+
+  vector<uint8_t> request;
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, kToken, _, _, false))
+      .WillOnce(Invoke([&](uint8_t, int16_t, const uint8_t *data,
+                           unsigned int size, bool) {
+        request.push_back(RDM_START_CODE);
+        request.insert(request.end(), data, data + size);
+        return true;
+      }));
+
+  MessageHandler_Tasks();
+  MessageHandler_Tasks();
+  MessageHandler_Tasks();
+
+  ASSERT_TRUE(RDMUtil_VerifyChecksum(request.data(), request.size()));
+  const RDMHeader *header = reinterpret_cast<const RDMHeader*>(
+      request.data());
+  const RDMHeader *ack_timer_header = reinterpret_cast<const RDMHeader*>(
+      ack_timer.data());
+  EXPECT_EQ(0, RDMUtil_UIDCompare(ack_timer_header->src_uid,
+                                  header->dest_uid));
+  EXPECT_EQ(0, RDMUtil_UIDCompare(ack_timer_header->dest_uid,
+                                  header->src_uid));
+  EXPECT_EQ(6, header->transaction_number);
+  EXPECT_EQ(GET_COMMAND, header->command_class);
+  EXPECT_EQ(PID_QUEUED_MESSAGE, ntohs(header->param_id));
+  EXPECT_EQ(1, header->param_data_length);
+  EXPECT_EQ(STATUS_ERROR, request[sizeof(RDMHeader)]);
+
+  // Only the final response is returned to the host.
+  vector<uint8_t> expected_response(6, 0);
+  expected_response.insert(expected_response.end(), ack.begin(), ack.end());
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_REQUEST, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(expected_response.data(),
+                                 expected_response.size())))
+      .WillOnce(Return(true));
+  SendEvent(kToken, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA, ack.data(),
+            ack.size());
+}
+
+TEST_F(MessageHandlerTest, testAckTimerFollowUpLimits) {
+  vector<uint8_t> ack_timer = BuildRDMResponse(ACK_TIMER, 5, {0, 1});
+
+  // The follow up is disabled by default.
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_REQUEST, RC_OK, _, 2))
+      .WillOnce(Return(true));
+  SendEvent(kToken, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+
+  const uint8_t enabled = 1;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_OK, _, 0))
+      .WillOnce(Return(true));
+  Message set = {
+    kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, sizeof(enabled), &enabled
+  };
+  MessageHandler_HandleMessage(&set);
+
+  ON_CALL(m_timer_mock, HasElapsed(_, _)).WillByDefault(Return(true));
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+
+  // A responder that keeps returning ACK_TIMER is followed up a limited
+  // number of times.
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(kPort, kToken, _, _, false))
+      .Times(5)
+      .WillRepeatedly(Return(true));
+  SendEvent(kToken, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+  for (unsigned int i = 0; i < 5; i++) {
+    MessageHandler_Tasks();
+    if (i == 4) {
+      EXPECT_CALL(m_transport_mock,
+                  Send(kToken, COMMAND_RDM_REQUEST, RC_OK, _, 2))
+          .WillOnce(Return(true));
+    }
+    SendEvent(kToken, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+              ack_timer.data(), ack_timer.size());
+  }
+  MessageHandler_Tasks();
+
+  // If the transceiver queue is full, the host is told.
+  EXPECT_CALL(m_transceiver_mock,
+              QueueRDMRequest(kPort, kToken + 1, _, _, false))
+      .WillOnce(Return(false));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, COMMAND_RDM_REQUEST, RC_BUFFER_FULL, _, 0))
+      .WillOnce(Return(true));
+  SendEvent(kToken + 1, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+  MessageHandler_Tasks();
+}
+
+TEST_F(MessageHandlerTest, testAckTimerFollowUpReset) {
+  vector<uint8_t> ack_timer = BuildRDMResponse(ACK_TIMER, 5, {0, 1});
+  MockApp app_mock;
+  APP_SetMock(&app_mock);
+
+  const uint8_t enabled = 1;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, RC_OK, _, 0))
+      .WillOnce(Return(true));
+  Message set = {
+    kToken, COMMAND_SET_ACK_TIMER_FOLLOW_UP, sizeof(enabled), &enabled
+  };
+  MessageHandler_HandleMessage(&set);
+
+  ON_CALL(m_timer_mock, HasElapsed(_, _)).WillByDefault(Return(true));
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+  EXPECT_CALL(app_mock, Reset()).Times(2);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, COMMAND_RESET_DEVICE, RC_OK, NULL, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  Message reset = { kToken + 1, COMMAND_RESET_DEVICE, 0, NULL };
+
+  // A reset while waiting for the ACK_TIMER delay cancels the follow up.
+  SendEvent(kToken, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_REQUEST, RC_CANCELLED, _, 0))
+      .WillOnce(Return(true));
+  MessageHandler_HandleMessage(&reset);
+  EXPECT_CALL(m_transceiver_mock, QueueRDMRequest(_, _, _, _, _)).Times(0);
+  MessageHandler_Tasks();
+
+  // A reset after the GET QUEUED_MESSAGE was sent cancels the frame, and the
+  // next ACK_TIMER is followed up again.
+  EXPECT_CALL(m_transceiver_mock,
+              QueueRDMRequest(kPort, kToken + 2, _, _, false))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  SendEvent(kToken + 2, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+  MessageHandler_Tasks();
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 2, COMMAND_RDM_REQUEST, RC_CANCELLED, _, 1))
+      .WillOnce(Return(true));
+  SendEvent(kToken + 2, T_OP_RDM_WITH_RESPONSE, T_RESULT_CANCELLED, NULL, 0);
+  MessageHandler_HandleMessage(&reset);
+
+  SendEvent(kToken + 2, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+            ack_timer.data(), ack_timer.size());
+  MessageHandler_Tasks();
+  APP_SetMock(nullptr);
+}
+
+TEST_F(MessageHandlerTest, testRDMDiscovery) {
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DISCOVERY, RC_BAD_PARAM, _, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DISCOVERY, RC_INVALID_MODE, _, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DISCOVERY, RC_BUFFER_FULL, _, 0))
+      .WillOnce(Return(true));
+
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillOnce(Return(T_MODE_RESPONDER))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+  EXPECT_CALL(m_discovery_mock, Start(kToken, kPort, DISCOVERY_FULL))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_discovery_mock, Start(kToken, kPort, DISCOVERY_INCREMENTAL))
+      .WillOnce(Return(true));
+
+  const uint8_t bad_mode = 2;
+  Message bad_message = { kToken, COMMAND_RDM_DISCOVERY, 1, &bad_mode };
+  MessageHandler_HandleMessage(&bad_message);
+
+  const uint8_t long_payload[] = {0, 0};
+  Message long_message = {
+    kToken, COMMAND_RDM_DISCOVERY, arraysize(long_payload), long_payload
+  };
+  MessageHandler_HandleMessage(&long_message);
+
+  Message message = { kToken, COMMAND_RDM_DISCOVERY, 0, NULL };
+  MessageHandler_HandleMessage(&message);  // Responder mode
+  MessageHandler_HandleMessage(&message);  // Already running
+  MessageHandler_HandleMessage(&message);  // Started, no response yet.
+
+  const uint8_t full_mode = DISCOVERY_FULL;
+  Message full_message = { kToken, COMMAND_RDM_DISCOVERY, 1, &full_mode };
+  MessageHandler_HandleMessage(&full_message);
+
+  const uint8_t incremental_mode = DISCOVERY_INCREMENTAL;
+  Message incremental_message = {
+    kToken, COMMAND_RDM_DISCOVERY, 1, &incremental_mode
+  };
+  MessageHandler_HandleMessage(&incremental_message);
+}
+
+TEST_F(MessageHandlerTest, testRDMDiscoveryComplete) {
+  // One unchanged, one added & one removed UID.
+  const uint8_t uids[] = {
+    0x7a, 0x70, 0, 0, 0, 1,
+    0x7a, 0x70, 0, 0, 0, 2,
+    0x7a, 0x70, 0, 0, 0, 3
+  };
+  const uint8_t response[] = {
+    2, 0,
+    1, 0,
+    1, 0,
+    0x7a, 0x70, 0, 0, 0, 2,
+    0x7a, 0x70, 0, 0, 0, 3
+  };
+
+  ON_CALL(m_discovery_mock, UIDCount()).WillByDefault(Return(2));
+  ON_CALL(m_discovery_mock, GetUIDs()).WillByDefault(Return(uids));
+  ON_CALL(m_discovery_mock, AddedCount()).WillByDefault(Return(1));
+  ON_CALL(m_discovery_mock, GetAddedUIDs())
+      .WillByDefault(Return(uids + UID_LENGTH));
+  ON_CALL(m_discovery_mock, RemovedCount()).WillByDefault(Return(1));
+  ON_CALL(m_discovery_mock, GetRemovedUIDs())
+      .WillByDefault(Return(uids + 2 * UID_LENGTH));
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DISCOVERY, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, COMMAND_RDM_DISCOVERY, RC_BUFFER_FULL, _, 2))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 2, COMMAND_RDM_DISCOVERY, RC_TX_ERROR, _, 2))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 3, COMMAND_RDM_DISCOVERY, RC_CANCELLED, _, 2))
+      .WillOnce(Return(true));
+
+  MessageHandler_DiscoveryComplete(kToken, DISCOVERY_OK);
+  MessageHandler_DiscoveryComplete(kToken + 1, DISCOVERY_TABLE_FULL);
+  MessageHandler_DiscoveryComplete(kToken + 2, DISCOVERY_TX_ERROR);
+  MessageHandler_DiscoveryComplete(kToken + 3, DISCOVERY_CANCELLED);
+}
+
+TEST_F(MessageHandlerTest, testGetDiscoveredUIDs) {
+  // More UIDs than fit in a single response.
+  const unsigned int uid_count = 100;
+  uint8_t uids[uid_count * UID_LENGTH];
+  for (unsigned int i = 0; i < arraysize(uids); i++) {
+    uids[i] = i & 0xff;
+  }
+
+  ON_CALL(m_discovery_mock, UIDCount()).WillByDefault(Return(uid_count));
+  ON_CALL(m_discovery_mock, GetUIDs()).WillByDefault(Return(uids));
+
+  const unsigned int first_count = 85;
+  uint8_t first_response[2 + first_count * UID_LENGTH];
+  first_response[0] = uid_count;
+  first_response[1] = 0;
+  memcpy(first_response + 2, uids, first_count * UID_LENGTH);
+
+  uint8_t second_response[2 + (uid_count - first_count) * UID_LENGTH];
+  second_response[0] = uid_count;
+  second_response[1] = 0;
+  memcpy(second_response + 2, uids + first_count * UID_LENGTH,
+         (uid_count - first_count) * UID_LENGTH);
+
+  const uint8_t empty_response[] = {uid_count, 0};
+
+  testing::InSequence seq;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(first_response, arraysize(first_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(second_response,
+                                 arraysize(second_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(empty_response, arraysize(empty_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERED_UIDS, RC_BAD_PARAM, _,
+                   0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  uint8_t offset[] = {0, 0};
+  Message message = {
+    kToken, COMMAND_RDM_GET_DISCOVERED_UIDS, arraysize(offset), offset
+  };
+  MessageHandler_HandleMessage(&message);
+
+  offset[0] = first_count;
+  MessageHandler_HandleMessage(&message);
+
+  offset[0] = uid_count;
+  MessageHandler_HandleMessage(&message);
+
+  // Past the end of the UIDs.
+  offset[0] = uid_count + 1;
+  MessageHandler_HandleMessage(&message);
+
+  // Missing offset.
+  Message bad_message = { kToken, COMMAND_RDM_GET_DISCOVERED_UIDS, 0, NULL };
+  MessageHandler_HandleMessage(&bad_message);
+}
+
+TEST_F(MessageHandlerTest, testGetDiscoveryChanges) {
+  // More changes than fit in a single response. The added UIDs are the last
+  // of the discovered UIDs, and are immediately followed by the removed UIDs.
+  const unsigned int uid_count = 70;
+  const unsigned int added_count = 60;
+  const unsigned int removed_count = 40;
+  const unsigned int change_count = added_count + removed_count;
+  uint8_t uids[(uid_count + removed_count) * UID_LENGTH];
+  for (unsigned int i = 0; i < arraysize(uids); i++) {
+    uids[i] = i & 0xff;
+  }
+  const uint8_t *changes = uids + (uid_count - added_count) * UID_LENGTH;
+
+  ON_CALL(m_discovery_mock, UIDCount()).WillByDefault(Return(uid_count));
+  ON_CALL(m_discovery_mock, GetUIDs()).WillByDefault(Return(uids));
+  ON_CALL(m_discovery_mock, AddedCount()).WillByDefault(Return(added_count));
+  ON_CALL(m_discovery_mock, GetAddedUIDs()).WillByDefault(Return(changes));
+  ON_CALL(m_discovery_mock, RemovedCount())
+      .WillByDefault(Return(removed_count));
+  ON_CALL(m_discovery_mock, GetRemovedUIDs())
+      .WillByDefault(Return(uids + uid_count * UID_LENGTH));
+
+  const uint8_t counts[] = {uid_count, 0, added_count, 0, removed_count, 0};
+
+  const unsigned int first_count = 84;
+  uint8_t first_response[arraysize(counts) + first_count * UID_LENGTH];
+  memcpy(first_response, counts, arraysize(counts));
+  memcpy(first_response + arraysize(counts), changes,
+         first_count * UID_LENGTH);
+
+  uint8_t second_response[
+      arraysize(counts) + (change_count - first_count) * UID_LENGTH];
+  memcpy(second_response, counts, arraysize(counts));
+  memcpy(second_response + arraysize(counts),
+         changes + first_count * UID_LENGTH,
+         (change_count - first_count) * UID_LENGTH);
+
+  testing::InSequence seq;
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DISCOVERY, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(first_response, arraysize(first_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERY_CHANGES, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(second_response,
+                                 arraysize(second_response))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERY_CHANGES, RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(counts, arraysize(counts))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_GET_DISCOVERY_CHANGES, RC_BAD_PARAM,
+                   _, 0))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  MessageHandler_DiscoveryComplete(kToken, DISCOVERY_OK);
+
+  uint8_t offset[] = {first_count, 0};
+  Message message = {
+    kToken, COMMAND_RDM_GET_DISCOVERY_CHANGES, arraysize(offset), offset
+  };
+  MessageHandler_HandleMessage(&message);
+
+  offset[0] = change_count;
+  MessageHandler_HandleMessage(&message);
+
+  // Past the end of the changes.
+  offset[0] = change_count + 1;
+  MessageHandler_HandleMessage(&message);
+
+  // Missing offset.
+  Message bad_message = {
+    kToken, COMMAND_RDM_GET_DISCOVERY_CHANGES, 0, NULL
+  };
+  MessageHandler_HandleMessage(&bad_message);
+}
+
+TEST_F(MessageHandlerTest, transceiverDiscoveryEvent) {
+  // Events for discovery operations aren't returned to the host.
+  EXPECT_CALL(m_discovery_mock, TransceiverEvent(_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock, Send(_, _, _, _, _)).Times(0);
+
+  SendEvent(kToken, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, NULL, 0);
+}
+
 TEST_F(MessageHandlerTest, transceiverDMXEvent) {
   EXPECT_CALL(m_transport_mock, Send(kToken, TX_DMX, RC_OK, _, _))
       .With(Args<3, 4>(EmptyPayload()))
@@ -395,6 +1266,94 @@ TEST_F(MessageHandlerTest, transceiverRDMDiscoveryRequest) {
   SendEvent(kToken + 2, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, NULL, 0);
 }
 
+TEST_F(MessageHandlerTest, transceiverRDMDecodedDUBRequest) {
+  const uint8_t dub[] = {1, 2, 3};
+  const uint8_t dub_response[] = {
+    0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xaa, 0xfa, 0x7f, 0xfa, 0x75,
+    0xba, 0x57, 0xbe, 0x75, 0xfe, 0x57, 0xfa, 0x7d, 0xaf, 0x57, 0xfa, 0xfd
+  };
+  const uint8_t collision[] = {0xfe, 0xfe, 0xaa, 0xff, 0xff, 0xff};
+
+  const uint8_t valid_reply[] = {
+    DUB_VALID_UID, 0x7a, 0x70, 0x12, 0x34, 0x56, 0x78
+  };
+  const uint8_t collision_reply[] = {DUB_COLLISION};
+  const uint8_t no_response_reply[] = {DUB_NO_RESPONSE};
+
+  EXPECT_CALL(m_transceiver_mock, GetMode(kPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+  EXPECT_CALL(m_transceiver_mock, QueueRDMDUB(kPort, _, dub, arraysize(dub)))
+      .Times(7)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_transceiver_mock,
+              QueueRDMDUB(kPort, kToken + 7, dub, arraysize(dub)))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DECODED_DUB_REQUEST, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(valid_reply, arraysize(valid_reply))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, COMMAND_RDM_DECODED_DUB_REQUEST, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(collision_reply,
+                                 arraysize(collision_reply))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 2, COMMAND_RDM_DECODED_DUB_REQUEST, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(collision_reply,
+                                 arraysize(collision_reply))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 3, COMMAND_RDM_DECODED_DUB_REQUEST, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(no_response_reply,
+                                 arraysize(no_response_reply))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 4, COMMAND_RDM_DECODED_DUB_REQUEST, RC_TX_ERROR,
+                   _, _))
+      .With(Args<3, 4>(EmptyPayload()))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 5, COMMAND_RDM_DECODED_DUB_REQUEST, RC_CANCELLED,
+                   _, _))
+      .With(Args<3, 4>(EmptyPayload()))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 6, COMMAND_RDM_DECODED_DUB_REQUEST, RC_OK, _, _))
+      .With(Args<3, 4>(PayloadIs(collision_reply,
+                                 arraysize(collision_reply))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 7, COMMAND_RDM_DECODED_DUB_REQUEST,
+                   RC_BUFFER_FULL, _, 0))
+      .WillOnce(Return(true));
+
+  for (uint8_t token = kToken; token <= kToken + 7; token++) {
+    Message message = {
+      token, COMMAND_RDM_DECODED_DUB_REQUEST, arraysize(dub), dub
+    };
+    MessageHandler_HandleMessage(&message);
+  }
+
+  SendEvent(kToken, T_OP_RDM_DUB, T_RESULT_RX_DATA, dub_response,
+            arraysize(dub_response));
+  SendEvent(kToken + 1, T_OP_RDM_DUB, T_RESULT_RX_DATA, collision,
+            arraysize(collision));
+  SendEvent(kToken + 2, T_OP_RDM_DUB, T_RESULT_RX_INVALID, NULL, 0);
+  SendEvent(kToken + 3, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, NULL, 0);
+  SendEvent(kToken + 4, T_OP_RDM_DUB, T_RESULT_TX_ERROR, NULL, 0);
+  SendEvent(kToken + 5, T_OP_RDM_DUB, T_RESULT_CANCELLED, NULL, 0);
+  // The line went low, but no bytes were received.
+  SendEvent(kToken + 6, T_OP_RDM_DUB, T_RESULT_OK, NULL, 0);
+
+  // Once the decoded response has been sent, the token returns raw DUB
+  // responses again.
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DUB_REQUEST, RC_RDM_TIMEOUT, _, _))
+      .WillOnce(Return(true));
+  SendEvent(kToken, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, NULL, 0);
+}
+
 TEST_F(MessageHandlerTest, transceiverRDMBroadcastRequest) {
   // Any data, doesn't have to be valid RDM
   const uint8_t rdm_reply[] = {1, 3, 4, 4, 5};
@@ -468,3 +1427,149 @@ TEST_F(MessageHandlerTest, transceiverRDMRequestWithResponse) {
   SendEvent(kToken + 2, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_TIMEOUT, NULL, 0);
   SendEvent(kToken + 3, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_INVALID, NULL, 0);
 }
+
+TEST_F(MessageHandlerTest, testPorts) {
+  const uint8_t break_time[] = {200, 0};
+  EXPECT_CALL(m_transceiver_mock, GetBreakTime(kOtherPort))
+      .WillOnce(Return(200));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, PortCommand(kOtherPort, COMMAND_GET_BREAK_TIME),
+                   RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(break_time, arraysize(break_time))))
+      .WillOnce(Return(true));
+
+  Message message = {
+    kToken,
+    static_cast<uint16_t>(PortCommand(kOtherPort, COMMAND_GET_BREAK_TIME)),
+    0, NULL
+  };
+  MessageHandler_HandleMessage(&message);
+
+  // Ports that don't exist are rejected.
+  const Command bad_command = PortCommand(TRANSCEIVER_PORT_COUNT,
+                                          COMMAND_GET_BREAK_TIME);
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, bad_command, RC_BAD_PARAM, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message bad_message = {
+    kToken, static_cast<uint16_t>(bad_command), 0, NULL
+  };
+  MessageHandler_HandleMessage(&bad_message);
+}
+
+TEST_F(MessageHandlerTest, testPortEvents) {
+  EXPECT_CALL(m_transport_mock, Send(kToken, TX_DMX, RC_OK, _, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, PortCommand(kOtherPort, TX_DMX), RC_OK, _, 0))
+      .WillOnce(Return(true));
+
+  SendEvent(kToken, T_OP_TX_ONLY, T_RESULT_OK, NULL, 0, kPort);
+  SendEvent(kToken + 1, T_OP_TX_ONLY, T_RESULT_OK, NULL, 0, kOtherPort);
+}
+
+TEST_F(MessageHandlerTest, testBatchPorts) {
+  const uint8_t request[] = {
+    0x11, 0x01, 0x00, 0x00,  // get break time, port 1
+    0x11, 0x02, 0x00, 0x00,  // get break time, port 2
+    0x13, 0x00, 0x00, 0x00,  // get mark time
+  };
+  const uint8_t response[] = {
+    0x11, 0x01, RC_OK, 0x02, 0x00, 0xc8, 0x00,
+    0x11, 0x02, RC_BAD_PARAM, 0x00, 0x00,
+    0x13, 0x00, RC_OK, 0x02, 0x00, 0x0c, 0x00,
+  };
+
+  EXPECT_CALL(m_transceiver_mock, GetBreakTime(kOtherPort))
+      .WillOnce(Return(200));
+  EXPECT_CALL(m_transceiver_mock, GetMarkTime(kPort)).WillOnce(Return(12));
+  EXPECT_CALL(m_transport_mock, Send(kToken, COMMAND_BATCH, RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(response, arraysize(response))))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_BATCH, arraysize(request), request };
+  MessageHandler_HandleMessage(&message);
+}
+
+TEST_F(MessageHandlerTest, testResetPorts) {
+  MockApp app_mock;
+  APP_SetMock(&app_mock);
+
+  // The reset cancels a frame on the other port.
+  EXPECT_CALL(app_mock, Reset())
+      .WillOnce(InvokeWithoutArgs([&]() {
+        SendEvent(kToken + 1, T_OP_TX_ONLY, T_RESULT_CANCELLED, NULL, 0,
+                  kOtherPort);
+      }));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken + 1, PortCommand(kOtherPort, TX_DMX), RC_CANCELLED,
+                   _, 0))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RESET_DEVICE, RC_OK, NULL, 0))
+      .WillOnce(Return(true));
+
+  Message message = { kToken, COMMAND_RESET_DEVICE, 0, NULL };
+  MessageHandler_HandleMessage(&message);
+  APP_SetMock(nullptr);
+}
+
+TEST_F(MessageHandlerTest, testDecodedDUBPorts) {
+  const uint8_t dub[] = {1, 2, 3};
+  const uint8_t no_response_reply[] = {DUB_NO_RESPONSE};
+
+  EXPECT_CALL(m_transceiver_mock, GetMode(kOtherPort))
+      .WillRepeatedly(Return(T_MODE_CONTROLLER));
+  EXPECT_CALL(m_transceiver_mock,
+              QueueRDMDUB(kOtherPort, kToken, dub, arraysize(dub)))
+      .WillOnce(Return(true));
+
+  // The same token on another port is a plain DUB.
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken, COMMAND_RDM_DUB_REQUEST, RC_RDM_TIMEOUT, _, 1))
+      .WillOnce(Return(true));
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken,
+                   PortCommand(kOtherPort, COMMAND_RDM_DECODED_DUB_REQUEST),
+                   RC_OK, _, 1))
+      .With(Args<3, 4>(PayloadIs(no_response_reply,
+                                 arraysize(no_response_reply))))
+      .WillOnce(Return(true));
+
+  Message message = {
+    kToken,
+    static_cast<uint16_t>(PortCommand(kOtherPort,
+                                      COMMAND_RDM_DECODED_DUB_REQUEST)),
+    arraysize(dub), dub
+  };
+  MessageHandler_HandleMessage(&message);
+
+  SendEvent(kToken, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, NULL, 0, kPort);
+  SendEvent(kToken, T_OP_RDM_DUB, T_RESULT_RX_TIMEOUT, NULL, 0, kOtherPort);
+}
+
+TEST_F(MessageHandlerTest, testDiscoveredUIDsOtherPort) {
+  // Discovery last ran on the first port, so the other port has no UIDs.
+  const uint8_t uids[] = {0x7a, 0x70, 0, 0, 0, 1};
+  const uint8_t empty_response[] = {0, 0};
+  ON_CALL(m_discovery_mock, GetPort()).WillByDefault(Return(kPort));
+  ON_CALL(m_discovery_mock, UIDCount()).WillByDefault(Return(1));
+  ON_CALL(m_discovery_mock, GetUIDs()).WillByDefault(Return(uids));
+
+  EXPECT_CALL(m_transport_mock,
+              Send(kToken,
+                   PortCommand(kOtherPort, COMMAND_RDM_GET_DISCOVERED_UIDS),
+                   RC_OK, _, 2))
+      .With(Args<3, 4>(PayloadIs(empty_response, arraysize(empty_response))))
+      .WillOnce(Return(true));
+
+  const uint8_t offset[] = {0, 0};
+  Message message = {
+    kToken,
+    static_cast<uint16_t>(PortCommand(kOtherPort,
+                                      COMMAND_RDM_GET_DISCOVERED_UIDS)),
+    arraysize(offset), offset
+  };
+  MessageHandler_HandleMessage(&message);
+}
@@ -32,8 +32,10 @@
 #include "Array.h"
 #include "Matchers.h"
 #include "TestHelpers.h"
+#include "TransceiverMock.h"
 
 using ::testing::Return;
+using ::testing::SetArgPointee;
 using ::testing::StrictMock;
 using ::testing::WithArgs;
 using ::testing::_;
@@ -71,6 +73,8 @@ class MockModel {
   MOCK_METHOD2(Request,
                int(const RDMHeader *header, const uint8_t *param_data));
   MOCK_METHOD0(Tasks, void());
+  MOCK_METHOD3(DMX, void(const uint8_t *slots, unsigned int length,
+                         bool changed));
 };
 
 MockModel *g_first_mock = nullptr;
@@ -108,6 +112,12 @@ void TasksFirst() {
   }
 }
 
+void DMXFirst(const uint8_t *slots, unsigned int length, bool changed) {
+  if (g_first_mock) {
+    g_first_mock->DMX(slots, length, changed);
+  }
+}
+
 void ActivateSecond() {
   if (g_second_mock) {
     g_second_mock->Activate();
@@ -170,12 +180,14 @@ class RDMHandlerTest : public testing::Test {
     g_first_mock = &m_first_model;
     g_second_mock = &m_second_model;
     g_sender = &m_sender_mock;
+    Transceiver_SetMock(&m_transceiver_mock);
   }
 
   void TearDown() {
     g_first_mock = nullptr;
     g_second_mock = nullptr;
     g_sender = nullptr;
+    Transceiver_SetMock(nullptr);
   }
 
   void SetUID(uint8_t uid[UID_LENGTH]) {
@@ -191,6 +203,7 @@ class RDMHandlerTest : public testing::Test {
   StrictMock<MockModel> m_first_model;
   StrictMock<MockModel> m_second_model;
   StrictMock<MockSender> m_sender_mock;
+  StrictMock<MockTransceiver> m_transceiver_mock;
 
   static const uint8_t OUR_UID[];
   static const uint8_t VENDORCAST_UID[];
@@ -229,7 +242,8 @@ const ModelEntry RDMHandlerTest::FIRST_MODEL {
   DeactivateFirst,
   IoctlFirst,
   RequestFirst,
-  TasksFirst
+  TasksFirst,
+  DMXFirst
 };
 
 const ModelEntry RDMHandlerTest::SECOND_MODEL {
@@ -238,7 +252,8 @@ const ModelEntry RDMHandlerTest::SECOND_MODEL {
   DeactivateSecond,
   IoctlSecond,
   RequestSecond,
-  TasksSecond
+  TasksSecond,
+  nullptr
 };
 
 TEST_F(RDMHandlerTest, testDispatching) {
@@ -441,3 +456,149 @@ TEST_F(RDMHandlerTest, testGetModelList) {
 
   CallRDMHandler(get_request.get());
 }
+
+TEST_F(RDMHandlerTest, testGetSetTurnaroundStats) {
+  RDMHandlerSettings settings = {
+    .default_model = MODEL_ONE,
+    .send_callback = SendResponse
+  };
+  RDMHandler_Initialize(&settings);
+
+  EXPECT_CALL(m_first_model, Activate()).Times(1);
+  EXPECT_CALL(m_first_model, Ioctl(IOCTL_GET_UID, _, UID_LENGTH))
+    .WillRepeatedly(WithArgs<1>(CopyUID(TEST_UID)));
+
+  EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
+
+  TransceiverTurnaroundStats stats;
+  memset(&stats, 0, sizeof(stats));
+  stats.count = 3;
+  stats.min = 1800;
+  stats.max = 21000;
+  stats.mean = 8200;
+  stats.histogram[0] = 1;
+  stats.histogram[1] = 1;
+  stats.histogram[8] = 1;
+
+  unique_ptr<RDMRequest> get_request(new RDMGetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 0, PID_RESPONDER_TURNAROUND,
+      nullptr, 0));
+
+  const uint8_t expected_data[] = {
+    0x00, 0x00, 0x00, 0x03,  // count
+    0x07, 0x08,  // min
+    0x52, 0x08,  // max
+    0x20, 0x08,  // mean
+    0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01
+  };
+  unique_ptr<RDMResponse> get_response(GetResponseFromData(
+        get_request.get(), expected_data, arraysize(expected_data)));
+
+  EXPECT_CALL(m_transceiver_mock, GetTurnaroundStats(0u, _))
+      .WillOnce(SetArgPointee<1>(stats));
+  EXPECT_CALL(m_sender_mock, SendResponse(true, _, 1))
+      .With(testing::Args<1, 2>(IOVecResponseIs(get_response.get())));
+
+  CallRDMHandler(get_request.get());
+
+  // A SET resets the counters.
+  unique_ptr<RDMRequest> set_request(new RDMSetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 0, PID_RESPONDER_TURNAROUND,
+      nullptr, 0));
+  unique_ptr<RDMResponse> set_response(GetResponseFromData(set_request.get()));
+
+  EXPECT_CALL(m_transceiver_mock, ResetTurnaroundStats(0u)).Times(1);
+  EXPECT_CALL(m_sender_mock, SendResponse(true, _, 1))
+      .With(testing::Args<1, 2>(IOVecResponseIs(set_response.get())));
+
+  CallRDMHandler(set_request.get());
+
+  // Param data is a format error.
+  const uint8_t param_data = 1;
+  unique_ptr<RDMRequest> bad_request(new RDMGetRequest(
+      m_controller_uid, m_our_uid, 0, 0, 0, PID_RESPONDER_TURNAROUND,
+      &param_data, sizeof(param_data)));
+  unique_ptr<RDMResponse> nack_response(
+      ola::rdm::NackWithReason(bad_request.get(), ola::rdm::NR_FORMAT_ERROR));
+
+  EXPECT_CALL(m_sender_mock, SendResponse(true, _, 1))
+      .With(testing::Args<1, 2>(IOVecResponseIs(nack_response.get())));
+
+  CallRDMHandler(bad_request.get());
+}
+
+TEST_F(RDMHandlerTest, testDMX) {
+  RDMHandlerSettings settings = {
+    .default_model = NULL_MODEL_ID,
+    .send_callback = nullptr
+  };
+  RDMHandler_Initialize(&settings);
+  EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
+  EXPECT_TRUE(RDMHandler_AddModel(&SECOND_MODEL));
+
+  const uint8_t slots[] = {1, 2, 3};
+  DMXSlotWindow window;
+
+  // No active model
+  EXPECT_FALSE(RDMHandler_GetDMXWindow(&window));
+  RDMHandler_HandleDMX(slots, arraysize(slots), true);
+
+  EXPECT_CALL(m_first_model, Activate()).Times(1);
+  EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_ONE));
+
+  EXPECT_CALL(m_first_model,
+              Ioctl(IOCTL_GET_DMX_WINDOW, _, sizeof(DMXSlotWindow)))
+    .WillOnce(Return(1))
+    .WillOnce(Return(0));
+  EXPECT_TRUE(RDMHandler_GetDMXWindow(&window));
+  EXPECT_FALSE(RDMHandler_GetDMXWindow(&window));
+
+  // The first frame after the model changes is always marked as changed.
+  EXPECT_CALL(m_first_model, DMX(slots, arraysize(slots), true)).Times(1);
+  EXPECT_CALL(m_first_model, DMX(slots, arraysize(slots), false)).Times(1);
+  RDMHandler_HandleDMX(slots, arraysize(slots), false);
+  RDMHandler_HandleDMX(slots, arraysize(slots), false);
+
+  // The second model doesn't have a dmx_fn.
+  EXPECT_CALL(m_first_model, Deactivate()).Times(1);
+  EXPECT_CALL(m_second_model, Activate()).Times(1);
+  EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_TWO));
+
+  EXPECT_FALSE(RDMHandler_GetDMXWindow(&window));
+  RDMHandler_HandleDMX(slots, arraysize(slots), true);
+}
+
+TEST_F(RDMHandlerTest, testDUBResponse) {
+  RDMHandlerSettings settings = {
+    .default_model = NULL_MODEL_ID,
+    .send_callback = nullptr
+  };
+  RDMHandler_Initialize(&settings);
+  EXPECT_TRUE(RDMHandler_AddModel(&FIRST_MODEL));
+
+  uint8_t uid[UID_LENGTH];
+  uint8_t response[DUB_RESPONSE_LENGTH];
+
+  // No active model
+  EXPECT_FALSE(RDMHandler_GetDUBResponse(uid, response));
+
+  EXPECT_CALL(m_first_model, Activate()).Times(1);
+  EXPECT_TRUE(RDMHandler_SetActiveModel(MODEL_ONE));
+
+  EXPECT_CALL(m_first_model, Ioctl(IOCTL_GET_UID, _, UID_LENGTH))
+    .WillRepeatedly(Return(1));
+  EXPECT_CALL(m_first_model,
+              Ioctl(IOCTL_GET_DUB_RESPONSE, _, DUB_RESPONSE_LENGTH))
+    .WillOnce(Return(1))
+    .WillOnce(Return(0));
+  EXPECT_TRUE(RDMHandler_GetDUBResponse(uid, response));
+  EXPECT_FALSE(RDMHandler_GetDUBResponse(uid, response));
+}
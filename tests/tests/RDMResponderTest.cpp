@@ -322,6 +322,37 @@ TEST_F(RDMResponderTest, DiscoveryUniqueBranch) {
             RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
 }
 
+TEST_F(RDMResponderTest, DiscoveryUniqueBranchUIDChange) {
+  InitResponder();
+
+  uint8_t param_data[UID_LENGTH * 2];
+  CreateDUBParamData(UID(0, 0), UID::AllDevices(), param_data);
+  EXPECT_EQ(-DUB_RESPONSE_LENGTH,
+            RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
+
+  // Change the UID, the cached response should be rebuilt.
+  const uint8_t new_uid[] = {0x7a, 0x70, 0x00, 0x00, 0x00, 0x01};
+  memcpy(g_responder->uid, new_uid, UID_LENGTH);
+  RDMResponder_InitResponder();
+
+  const uint8_t expected_data[] = {
+    0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xaa,
+    0xfa, 0x7f, 0xfa, 0x75, 0xaa, 0x55, 0xaa, 0x55,
+    0xaa, 0x55, 0xab, 0x55, 0xae, 0x57, 0xef, 0xf5
+  };
+  ArrayTuple tuple(g_rdm_buffer, DUB_RESPONSE_LENGTH);
+
+  CreateDUBParamData(UID(0, 0), UID::AllDevices(), param_data);
+  EXPECT_EQ(-DUB_RESPONSE_LENGTH,
+            RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
+  EXPECT_THAT(tuple, DataIs(expected_data, arraysize(expected_data)));
+
+  // The old UID is no longer within the range.
+  CreateDUBParamData(m_our_uid, m_our_uid, param_data);
+  EXPECT_EQ(0,
+            RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
+}
+
 TEST_F(RDMResponderTest, discoveryCommands) {
   unique_ptr<RDMDiscoveryRequest> unmute(NewUnMuteRequest(
       m_controller_uid, m_our_uid, 0));
@@ -398,10 +429,46 @@ TEST_F(RDMResponderTest, testBuildNack) {
   EXPECT_THAT(ArrayTuple(g_rdm_buffer, size), ResponseIs(response.get()));
 }
 
+TEST_F(RDMResponderTest, testDescriptorsAreSorted) {
+  ResponderDefinition responder_def;
+  InitDefinition(&responder_def);
+
+  // An empty table is sorted.
+  responder_def.descriptors = nullptr;
+  responder_def.descriptor_count = 0;
+  EXPECT_TRUE(RDMResponder_DescriptorsAreSorted(&responder_def));
+
+  const PIDDescriptor sorted_descriptors[] = {
+    {PID_DEVICE_INFO, nullptr, 0, nullptr},
+    {PID_RECORD_SENSORS, nullptr, 0, nullptr},
+    {PID_IDENTIFY_DEVICE, nullptr, 0, nullptr},
+  };
+  responder_def.descriptors = sorted_descriptors;
+  responder_def.descriptor_count = arraysize(sorted_descriptors);
+  EXPECT_TRUE(RDMResponder_DescriptorsAreSorted(&responder_def));
+
+  const PIDDescriptor unsorted_descriptors[] = {
+    {PID_DEVICE_INFO, nullptr, 0, nullptr},
+    {PID_IDENTIFY_DEVICE, nullptr, 0, nullptr},
+    {PID_RECORD_SENSORS, nullptr, 0, nullptr},
+  };
+  responder_def.descriptors = unsorted_descriptors;
+  responder_def.descriptor_count = arraysize(unsorted_descriptors);
+  EXPECT_FALSE(RDMResponder_DescriptorsAreSorted(&responder_def));
+
+  const PIDDescriptor duplicate_descriptors[] = {
+    {PID_DEVICE_INFO, nullptr, 0, nullptr},
+    {PID_DEVICE_INFO, nullptr, 0, nullptr},
+  };
+  responder_def.descriptors = duplicate_descriptors;
+  responder_def.descriptor_count = arraysize(duplicate_descriptors);
+  EXPECT_FALSE(RDMResponder_DescriptorsAreSorted(&responder_def));
+}
+
 TEST_F(RDMResponderTest, testDispatch) {
   const PIDDescriptor pid_descriptors[] = {
-    {PID_IDENTIFY_DEVICE, GetIdentifyDevice, 0, (PIDCommandHandler) nullptr},
     {PID_RECORD_SENSORS, (PIDCommandHandler) nullptr, 0, ClearSensors},
+    {PID_IDENTIFY_DEVICE, GetIdentifyDevice, 0, (PIDCommandHandler) nullptr},
   };
   ResponderDefinition responder_def;
   InitDefinition(&responder_def);
@@ -1045,6 +1112,47 @@ TEST_F(RDMResponderTest, ioctl) {
   EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_GET_UID, uid, arraysize(uid)));
 
   EXPECT_EQ(0, memcmp(TEST_UID, uid, UID_LENGTH));
+
+  ResponderDefinition responder_def;
+  InitDefinition(&responder_def);
+
+  DMXSlotWindow window;
+  uint8_t *data = reinterpret_cast<uint8_t*>(&window);
+  g_responder->dmx_start_address = 10;
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_GET_DMX_WINDOW, data, 0));
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_GET_DMX_WINDOW, data,
+                                  sizeof(window)));
+  EXPECT_EQ(10, window.start_address);
+  EXPECT_EQ(2, window.footprint);
+
+  // The footprint is truncated at slot 512.
+  g_responder->dmx_start_address = 512;
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_GET_DMX_WINDOW, data,
+                                  sizeof(window)));
+  EXPECT_EQ(512, window.start_address);
+  EXPECT_EQ(1, window.footprint);
+
+  g_responder->dmx_start_address = INVALID_DMX_START_ADDRESS;
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_GET_DMX_WINDOW, data,
+                                  sizeof(window)));
+
+  // The DUB response matches the one from RDMResponder_HandleDUBRequest().
+  InitResponder();
+  uint8_t dub_response[DUB_RESPONSE_LENGTH];
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_GET_DUB_RESPONSE, dub_response, 0));
+  EXPECT_EQ(1, RDMResponder_Ioctl(IOCTL_GET_DUB_RESPONSE, dub_response,
+                                  arraysize(dub_response)));
+
+  uint8_t param_data[UID_LENGTH * 2];
+  CreateDUBParamData(UID(0, 0), UID::AllDevices(), param_data);
+  EXPECT_EQ(-DUB_RESPONSE_LENGTH,
+            RDMResponder_HandleDUBRequest(param_data, arraysize(param_data)));
+  EXPECT_EQ(0, memcmp(g_rdm_buffer, dub_response, DUB_RESPONSE_LENGTH));
+
+  // No response if muted
+  g_responder->is_muted = true;
+  EXPECT_EQ(0, RDMResponder_Ioctl(IOCTL_GET_DUB_RESPONSE, dub_response,
+                                  arraysize(dub_response)));
 }
 
 TEST_F(RDMResponderTest, paramDescription) {
@@ -181,6 +181,42 @@ TEST_F(RDMUtilTest, testUpdateSensor) {
   EXPECT_EQ(434, sensor.highest_value);
 }
 
+TEST_F(RDMUtilTest, testDecodeDUBResponse) {
+  const uint8_t response[] = {
+    0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xaa, 0xfa, 0x7f, 0xfa, 0x75,
+    0xba, 0x57, 0xbe, 0x75, 0xfe, 0x57, 0xfa, 0x7d, 0xaf, 0x57, 0xfa, 0xfd
+  };
+  const uint8_t expected_uid[] = {0x7a, 0x70, 0x12, 0x34, 0x56, 0x78};
+
+  uint8_t uid[UID_LENGTH];
+  EXPECT_TRUE(RDMUtil_DecodeDUBResponse(response, arraysize(response), uid));
+  EXPECT_THAT(ArrayTuple(uid, UID_LENGTH),
+              DataIs(expected_uid, arraysize(expected_uid)));
+
+  // Without the preamble
+  memset(uid, 0, UID_LENGTH);
+  EXPECT_TRUE(RDMUtil_DecodeDUBResponse(response + 7, arraysize(response) - 7,
+                                        uid));
+  EXPECT_THAT(ArrayTuple(uid, UID_LENGTH),
+              DataIs(expected_uid, arraysize(expected_uid)));
+
+  // Truncated
+  EXPECT_FALSE(RDMUtil_DecodeDUBResponse(response, 0, uid));
+  EXPECT_FALSE(RDMUtil_DecodeDUBResponse(response, 7, uid));
+  EXPECT_FALSE(RDMUtil_DecodeDUBResponse(response, arraysize(response) - 1,
+                                         uid));
+
+  // Missing separator
+  EXPECT_FALSE(RDMUtil_DecodeDUBResponse(response + 8, arraysize(response) - 8,
+                                         uid));
+
+  // Bad checksum, i.e. a collision.
+  uint8_t collision[arraysize(response)];
+  memcpy(collision, response, arraysize(response));
+  collision[10] = 0xab;
+  EXPECT_FALSE(RDMUtil_DecodeDUBResponse(collision, arraysize(collision), uid));
+}
+
 // Tests for RDMUtil_VerifyChecksum
 //-----------------------------------------------------------------------------
 class ChecksumTest : public ::testing::TestWithParam<uint32_t> {};
@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderDefinitionTest.cpp
+ * Check the ResponderDefinitions used by each of the models.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "Array.h"
+#include "dimmer_model.h"
+#include "led_model.h"
+#include "moving_light.h"
+#include "network_model.h"
+#include "proxy_model.h"
+#include "rdm_responder.h"
+#include "sensor_model.h"
+
+namespace {
+
+const uint8_t TEST_UID[] = {0x7a, 0x70, 0xff, 0xff, 0xfe, 0x10};
+
+struct ModelProperties {
+  const char *name;
+  void (*init_fn)();
+  const ModelEntry *entry;
+};
+
+const ModelProperties MODELS[] = {
+  {"led", LEDModel_Initialize, &LED_MODEL_ENTRY},
+  {"proxy", ProxyModel_Initialize, &PROXY_MODEL_ENTRY},
+  {"moving_light", MovingLightModel_Initialize, &MOVING_LIGHT_MODEL_ENTRY},
+  {"sensor", SensorModel_Initialize, &SENSOR_MODEL_ENTRY},
+  {"network", NetworkModel_Initialize, &NETWORK_MODEL_ENTRY},
+  {"dimmer", DimmerModel_Initialize, &DIMMER_MODEL_ENTRY},
+};
+}  // namespace
+
+class ResponderDefinitionTest : public testing::Test {
+ public:
+  void SetUp() {
+    RDMResponderSettings settings;
+    memcpy(settings.uid, TEST_UID, UID_LENGTH);
+    RDMResponder_Initialize(&settings);
+  }
+};
+
+/*
+ * RDMResponder_DispatchPID() uses a binary search, so every descriptor table
+ * must be sorted by PID.
+ */
+TEST_F(ResponderDefinitionTest, rootDescriptorsAreSorted) {
+  for (unsigned int i = 0; i < arraysize(MODELS); i++) {
+    MODELS[i].init_fn();
+    MODELS[i].entry->activate_fn();
+    EXPECT_TRUE(RDMResponder_DescriptorsAreSorted(g_responder->def))
+        << "The root descriptors for " << MODELS[i].name << " are not sorted";
+    MODELS[i].entry->deactivate_fn();
+  }
+}
+
+TEST_F(ResponderDefinitionTest, subDeviceDescriptorsAreSorted) {
+  EXPECT_TRUE(RDMResponder_DescriptorsAreSorted(
+      DimmerModel_GetSubDeviceDefinition()));
+}
+
+TEST_F(ResponderDefinitionTest, childDescriptorsAreSorted) {
+  EXPECT_TRUE(RDMResponder_DescriptorsAreSorted(
+      ProxyModel_GetChildDefinition()));
+}
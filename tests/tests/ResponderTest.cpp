@@ -19,6 +19,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string.h>
 
 #include <algorithm>
 #include <memory>
@@ -28,10 +29,14 @@
 #include "Array.h"
 #include "Matchers.h"
 #include "RDMHandlerMock.h"
-#include "SPIRGBMock.h"
+#include "TransceiverMock.h"
 
+using ::testing::DoAll;
 using ::testing::IgnoreResult;
+using ::testing::IsNull;
+using ::testing::NotNull;
 using ::testing::Return;
+using ::testing::SetArgPointee;
 using ::testing::StrictMock;
 using ::testing::WithArgs;
 using ::testing::_;
@@ -40,23 +45,26 @@ class ResponderTest : public testing::Test {
  public:
   void SetUp() {
     RDMHandler_SetMock(&handler_mock);
-    SPIRGB_SetMock(&spi_mock);
+    EXPECT_CALL(handler_mock, GetDMXWindow(_))
+      .WillRepeatedly(Return(false));
+    EXPECT_CALL(handler_mock, GetDUBResponse(_, _))
+      .WillRepeatedly(Return(false));
     Responder_Initialize();
     ReceiverCounters_ResetCounters();
   }
 
   void TearDown() {
     RDMHandler_SetMock(nullptr);
-    SPIRGB_SetMock(nullptr);
   }
 
   void SendFrame(const uint8_t *frame, unsigned int size,
-                 unsigned int chunk_size = 1) {
+                 unsigned int chunk_size = 1, uint8_t port = 0) {
     TransceiverEvent event;
     event.token = 0;
     event.op = T_OP_RX;
     event.data = frame;
     event.timing = NULL;
+    event.port = port;
 
     unsigned int i = 0;
     while (i < size) {
@@ -67,9 +75,20 @@ class ResponderTest : public testing::Test {
     }
   }
 
+  void SendTimeout(const uint8_t *frame, unsigned int size) {
+    TransceiverEvent event;
+    event.token = 0;
+    event.op = T_OP_RX;
+    event.result = T_RESULT_RX_FRAME_TIMEOUT;
+    event.data = frame;
+    event.length = size;
+    event.timing = NULL;
+    event.port = 0;
+    Responder_Receive(&event);
+  }
+
  protected:
   StrictMock<MockRDMHandler> handler_mock;
-  MockSPIRGB spi_mock;
 
   static const uint8_t TEST_UID[];
   static const uint8_t ASC_FRAME[];
@@ -189,6 +208,48 @@ TEST_F(ResponderTest, rdmChecksumMismatch) {
   EXPECT_EQ(1, ReceiverCounters_RDMChecksumInvalidCounter());
 }
 
+TEST_F(ResponderTest, maxLengthRDMFrame) {
+  // A 255 byte frame, with a 229 byte param data.
+  uint8_t frame[255];
+  memcpy(frame, RDM_FRAME, sizeof(RDMHeader));
+  frame[MESSAGE_LENGTH_OFFSET] = 253;
+  frame[RDM_PARAM_DATA_LENGTH_OFFSET] = 253 - sizeof(RDMHeader);
+  for (unsigned int i = sizeof(RDMHeader); i < 253; i++) {
+    frame[i] = i;
+  }
+  uint16_t checksum = 0;
+  for (unsigned int i = 0; i < 253; i++) {
+    checksum += frame[i];
+  }
+  frame[253] = checksum >> 8;
+  frame[254] = checksum & 0xff;
+
+  EXPECT_CALL(handler_mock, HandleRequest(
+        reinterpret_cast<const RDMHeader*>(frame),
+        frame + RDM_PARAM_DATA_OFFSET))
+    .Times(3);
+
+  SendFrame(frame, arraysize(frame));
+  SendFrame(frame, arraysize(frame), 7);
+  SendFrame(frame, arraysize(frame), arraysize(frame));
+
+  EXPECT_EQ(3, ReceiverCounters_RDMFrames());
+  EXPECT_EQ(0, ReceiverCounters_RDMChecksumInvalidCounter());
+}
+
+TEST_F(ResponderTest, rdmTrailingData) {
+  EXPECT_CALL(handler_mock, GetUID(_))
+    .WillRepeatedly(WithArgs<0>(IgnoreResult(CopyUID(TEST_UID))));
+
+  // The extra byte arrives with the checksum, so the frame isn't dispatched.
+  uint8_t frame[arraysize(RDM_FRAME) + 1];
+  memcpy(frame, RDM_FRAME, arraysize(RDM_FRAME));
+  frame[arraysize(RDM_FRAME)] = 0;
+  SendFrame(frame, arraysize(frame), arraysize(frame));
+
+  EXPECT_EQ(1, ReceiverCounters_RDMFrames());
+}
+
 TEST_F(ResponderTest, badSubStartCode) {
   const uint8_t frame[] = {
     0xcc, 0x02, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x70, 0x12,
@@ -239,9 +300,20 @@ TEST_F(ResponderTest, nonRxOp) {
   event.length = 0;
   event.timing = NULL;
   event.result = T_RESULT_RX_CONTINUE_FRAME;
+  event.port = 0;
   Responder_Receive(&event);
 }
 
+TEST_F(ResponderTest, otherPort) {
+  // Frames received on the other ports are ignored.
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME), 1, 1);
+  EXPECT_EQ(0, ReceiverCounters_DMXFrames());
+  EXPECT_EQ(0xff, ReceiverCounters_DMXLastChecksum());
+
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+  EXPECT_EQ(1, ReceiverCounters_DMXFrames());
+}
+
 TEST_F(ResponderTest, dmxCounters) {
   EXPECT_EQ(0xff, ReceiverCounters_DMXLastChecksum());
   EXPECT_EQ(0xffff, ReceiverCounters_DMXLastSlotCount());
@@ -282,23 +354,132 @@ TEST_F(ResponderTest, dmxCounters) {
   EXPECT_EQ(45, ReceiverCounters_DMXMaximumSlotCount());
 }
 
-TEST_F(ResponderTest, SPIOutput) {
-  SPIRGBConfiguration spi_config;
-  spi_config.module_id = SPI_ID_1;
-  spi_config.baud_rate = 2000000;
-  spi_config.use_enhanced_buffering = false;
-  SPIRGB_Init(&spi_config);
+TEST_F(ResponderTest, dmxWindow) {
+  DMXSlotWindow window = {3, 4};
+  EXPECT_CALL(handler_mock, GetDMXWindow(_))
+    .WillRepeatedly(DoAll(SetArgPointee<0>(window), Return(true)));
+  EXPECT_CALL(handler_mock, HandleDMX(DMX_FRAME + 3, 4, true))
+    .Times(1);
+  EXPECT_CALL(handler_mock, HandleDMX(DMX_FRAME + 3, 4, false))
+    .Times(2);
+
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME), 2);
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME), arraysize(DMX_FRAME));
+  EXPECT_EQ(55, ReceiverCounters_DMXLastChecksum());
+  EXPECT_EQ(1, ReceiverCounters_DMXChangedFrames());
+}
+
+TEST_F(ResponderTest, dmxChangeDetection) {
+  DMXSlotWindow window = {3, 4};
+  EXPECT_CALL(handler_mock, GetDMXWindow(_))
+    .WillRepeatedly(DoAll(SetArgPointee<0>(window), Return(true)));
+
+  uint8_t frame[arraysize(DMX_FRAME)];
+  memcpy(frame, DMX_FRAME, arraysize(DMX_FRAME));
+
+  testing::InSequence seq;
+  EXPECT_CALL(handler_mock, HandleDMX(frame + 3, 4, true));
+  EXPECT_CALL(handler_mock, HandleDMX(frame + 3, 4, false));
+  EXPECT_CALL(handler_mock, HandleDMX(frame + 3, 4, true));
+  EXPECT_CALL(handler_mock, HandleDMX(frame + 3, 4, false));
+  EXPECT_CALL(handler_mock, HandleDMX(frame + 3, 4, true));
+
+  SendFrame(frame, arraysize(frame));
+
+  // A change outside the window.
+  frame[2] = 99;
+  SendFrame(frame, arraysize(frame));
+  EXPECT_EQ(1, ReceiverCounters_DMXChangedFrames());
+
+  // A change to the last slot in the window.
+  frame[6] = 99;
+  SendFrame(frame, arraysize(frame));
+  SendFrame(frame, arraysize(frame));
+  EXPECT_EQ(2, ReceiverCounters_DMXChangedFrames());
+
+  // A frame that ends part way through the window doesn't deliver anything,
+  // so the next complete frame is reported as changed, even though it matches
+  // the short frame.
+  frame[4] = 99;
+  SendFrame(frame, 5);
+  SendFrame(frame, arraysize(frame));
+  EXPECT_EQ(3, ReceiverCounters_DMXChangedFrames());
+  EXPECT_EQ(6, ReceiverCounters_DMXFrames());
+}
+
+TEST_F(ResponderTest, dmxWindowShortFrame) {
+  DMXSlotWindow window = {8, 6};
+  EXPECT_CALL(handler_mock, GetDMXWindow(_))
+    .WillRepeatedly(DoAll(SetArgPointee<0>(window), Return(true)));
+
+  // Slots 8 - 10 are passed once the frame times out.
+  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+  testing::Mock::VerifyAndClearExpectations(&handler_mock);
+
+  EXPECT_CALL(handler_mock, HandleDMX(DMX_FRAME + 8, 3, true))
+    .Times(1);
+  SendTimeout(DMX_FRAME, arraysize(DMX_FRAME));
+  testing::Mock::VerifyAndClearExpectations(&handler_mock);
+
+  // A second timeout doesn't deliver the window again.
+  SendTimeout(DMX_FRAME, arraysize(DMX_FRAME));
+
+  // Nothing is delivered if the frame ends before the window starts.
+  EXPECT_CALL(handler_mock, GetDMXWindow(_))
+    .WillRepeatedly(DoAll(SetArgPointee<0>(window), Return(true)));
+  SendFrame(SHORT_DMX_FRAME, arraysize(SHORT_DMX_FRAME));
+  SendTimeout(SHORT_DMX_FRAME, arraysize(SHORT_DMX_FRAME));
+}
+
+TEST_F(ResponderTest, dmxWithoutWindow) {
+  // The handler mock is strict, so this checks HandleDMX() isn't called.
+  SendFrame(LONG_DMX_FRAME, arraysize(LONG_DMX_FRAME));
+  SendTimeout(LONG_DMX_FRAME, arraysize(LONG_DMX_FRAME));
+  EXPECT_EQ(1, ReceiverCounters_DMXFrames());
+}
+
+TEST_F(ResponderTest, dubFastPathAtInitialize) {
+  StrictMock<MockTransceiver> transceiver_mock;
+  Transceiver_SetMock(&transceiver_mock);
 
-  EXPECT_CALL(spi_mock, BeginUpdate())
+  // The fast path is enabled for the default model, without a prior SET.
+  EXPECT_CALL(handler_mock, GetDUBResponse(_, _))
+    .WillOnce(Return(true));
+  EXPECT_CALL(transceiver_mock, SetDUBResponse(0, NotNull(), NotNull()))
     .Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, RED, 1)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, GREEN, 2)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(0, BLUE, 3)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, RED, 4)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, GREEN, 5)).Times(1);
-  EXPECT_CALL(spi_mock, SetPixel(1, BLUE, 6)).Times(1);
-  EXPECT_CALL(spi_mock, CompleteUpdate())
+  Responder_Initialize();
+
+  Transceiver_SetMock(nullptr);
+}
+
+TEST_F(ResponderTest, dubFastPath) {
+  StrictMock<MockTransceiver> transceiver_mock;
+  Transceiver_SetMock(&transceiver_mock);
+
+  // The same request, as a GET.
+  uint8_t get_frame[arraysize(RDM_FRAME)];
+  memcpy(get_frame, RDM_FRAME, arraysize(RDM_FRAME));
+  get_frame[20] = 0x20;
+  get_frame[25] = 0xef;
+
+  EXPECT_CALL(handler_mock, HandleRequest(_, _)).Times(3);
+  EXPECT_CALL(handler_mock, GetDUBResponse(_, _))
+    .WillOnce(Return(true))
+    .WillOnce(Return(false));
+
+  // The fast path is updated after each discovery request.
+  EXPECT_CALL(transceiver_mock, SetDUBResponse(0, NotNull(), NotNull()))
     .Times(1);
+  SendFrame(RDM_FRAME, arraysize(RDM_FRAME));
 
-  SendFrame(DMX_FRAME, arraysize(DMX_FRAME));
+  EXPECT_CALL(transceiver_mock, SetDUBResponse(0, IsNull(), IsNull()))
+    .Times(1);
+  SendFrame(RDM_FRAME, arraysize(RDM_FRAME));
+
+  // GET requests don't change the fast path.
+  SendFrame(get_frame, arraysize(get_frame));
+  EXPECT_EQ(3, ReceiverCounters_RDMFrames());
+
+  Transceiver_SetMock(nullptr);
 }
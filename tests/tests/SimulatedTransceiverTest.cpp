@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "Array.h"
+#include "app_settings.h"
 #include "coarse_timer.h"
 #include "constants.h"
 #include "dmx_spec.h"
@@ -35,6 +36,7 @@
 #include "transceiver.h"
 
 #include "tests/sim/InterruptController.h"
+#include "tests/sim/PeripheralDMA.h"
 #include "tests/sim/PeripheralInputCapture.h"
 #include "tests/sim/PeripheralTimer.h"
 #include "tests/sim/PeripheralUART.h"
@@ -75,7 +77,11 @@ extern "C" {
 void InputCaptureEvent(void);
 void Transceiver_TimerEvent();
 void Transceiver_UARTEvent();
-uint8_t Transceiver_FreeBufferCount();
+#ifdef TRANSCEIVER_DMA
+void Transceiver_DMAEvent();
+void Transceiver_RestartDMARX(uint8_t port_index);
+#endif
+uint8_t Transceiver_FreeBufferCount(uint8_t port_index);
 
 
 #ifdef __cplusplus
@@ -131,6 +137,29 @@ MATCHER_P3(MatchesFrameWithSC, start_code, expected_data, expected_length, "") {
   return true;
 }
 
+// Check that a vector contains at least min_count copies of the specified
+// E1.11 frame. The last copy may be incomplete.
+MATCHER_P4(RepeatsFrameWithSC, start_code, expected_data, expected_length,
+           min_count, "") {
+  const unsigned int frame_size = expected_length + 1;
+  if (arg.size() < frame_size * min_count) {
+    *result_listener << "Only " << arg.size() << " bytes, expected at least "
+                     << frame_size * min_count;
+    return false;
+  }
+  for (unsigned int i = 0; i < arg.size(); i++) {
+    unsigned int offset = i % frame_size;
+    uint8_t expected = offset ? expected_data[offset - 1] : start_code;
+    if (arg[i] != expected) {
+      *result_listener << "Index " << i << " mismatch, was "
+                       << static_cast<int>(arg[i]) << ", expected "
+                       << static_cast<int>(expected);
+      return false;
+    }
+  }
+  return true;
+}
+
 MATCHER_P2(MatchesFrame, expected_data, expected_length, "") {
   if (arg.empty()) {
     *result_listener << "Frame is empty";
@@ -178,14 +207,18 @@ class TransceiverTest : public testing::Test {
  public:
   TransceiverTest()
       : m_tx_callback(NewCallback(this, &TransceiverTest::GotByte)),
-        m_callback(ola::NewCallback(&Transceiver_Tasks)),
-        m_simulator(kClockSpeed),  // limit to 1s of CPU runtime.
+        m_callback(NewCallback(this, &TransceiverTest::RunTasks)),
+        m_simulator(kClockSpeed, Simulator::MODE_EVENT_DRIVEN),
         m_timer(&m_simulator, &m_interrupt_controller),
         m_ic(&m_simulator, &m_interrupt_controller),
         m_uart(&m_simulator, &m_interrupt_controller, m_tx_callback.get()),
         m_generator(&m_simulator, &m_ic, &m_uart, AS_IC_ID(2),
                     AS_USART_ID(1), kClockSpeed, kBaudRate),
+#ifdef TRANSCEIVER_DMA
+        m_dma(&m_interrupt_controller, &m_uart),
+#endif
         m_stop_after(-1),
+        m_tasks_resume(0),
         m_controller_uid(0x7a70, 0),
         m_device_uid(0x7a70, 1) {
   }
@@ -206,6 +239,9 @@ class TransceiverTest : public testing::Test {
     PLIB_TMR_SetMock(&m_timer);
     PLIB_IC_SetMock(&m_ic);
     PLIB_USART_SetMock(&m_uart);
+#ifdef TRANSCEIVER_DMA
+    PLIB_DMA_SetMock(&m_dma);
+#endif
     SYS_INT_SetMock(&m_interrupt_controller);
 
     m_interrupt_controller.RegisterISR(INT_SOURCE_TIMER_1,
@@ -220,11 +256,16 @@ class TransceiverTest : public testing::Test {
         NewCallback(&Transceiver_UARTEvent));
     m_interrupt_controller.RegisterISR(INT_SOURCE_USART_1_RECEIVE,
         NewCallback(&Transceiver_UARTEvent));
+#ifdef TRANSCEIVER_DMA
+    m_interrupt_controller.RegisterISR(
+        AS_DMA_INTERRUPT_SOURCE(TRANSCEIVER_DMA_CHANNEL),
+        NewCallback(&Transceiver_DMAEvent));
+#endif
 
     m_simulator.AddTask(m_callback.get());
 
     TransceiverHardwareSettings settings = DefaultSettings();
-    Transceiver_Initialize(&settings, &EventHandler, &EventHandler);
+    Transceiver_Initialize(kPort, &settings, &EventHandler, &EventHandler);
 
     CoarseTimer_Settings timer_settings = {
       .timer_id = AS_TIMER_ID(1),
@@ -238,12 +279,14 @@ class TransceiverTest : public testing::Test {
       // Run for another 6ms to allow any final states to timeout
       m_simulator.SetClockLimit(6000, false);
       m_simulator.Run();
-      // if we're in responder mode, then one buffer is used for the incoming
-      // frame.
-      if (Transceiver_GetMode() == T_MODE_RESPONDER) {
-        EXPECT_EQ(1, Transceiver_FreeBufferCount());
+      // if we're in responder mode, then two buffers are used for the
+      // incoming frames.
+      if (Transceiver_GetMode(kPort) == T_MODE_RESPONDER) {
+        EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE,
+                  Transceiver_FreeBufferCount(kPort));
       } else {
-        EXPECT_EQ(2, Transceiver_FreeBufferCount());
+        EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 2,
+                  Transceiver_FreeBufferCount(kPort));
       }
     }
 
@@ -251,6 +294,9 @@ class TransceiverTest : public testing::Test {
     PLIB_TMR_SetMock(nullptr);
     PLIB_IC_SetMock(nullptr);
     PLIB_USART_SetMock(nullptr);
+#ifdef TRANSCEIVER_DMA
+    PLIB_DMA_SetMock(nullptr);
+#endif
     SYS_INT_SetMock(nullptr);
 
     m_simulator.RemoveTask(m_callback.get());
@@ -282,6 +328,20 @@ class TransceiverTest : public testing::Test {
     m_stop_after = byte_count;
   }
 
+  void RunTasks() {
+    if (m_simulator.Clock() >= m_tasks_resume) {
+      Transceiver_Tasks();
+    }
+  }
+
+  // Stop running the transceiver tasks for a while, as if the RX handler was
+  // slow. The ISRs still run.
+  void PauseTasks(unsigned int duration_us) {
+    const uint64_t cycles = duration_us * (kClockSpeed / 1000000);
+    m_tasks_resume = m_simulator.Clock() + cycles;
+    m_simulator.ScheduleEvent(cycles);
+  }
+
  protected:
   std::unique_ptr<PeripheralUART::TXCallback> m_tx_callback;
   std::unique_ptr<ola::Callback0<void>> m_callback;
@@ -292,7 +352,11 @@ class TransceiverTest : public testing::Test {
   PeripheralInputCapture m_ic;
   PeripheralUART m_uart;
   SignalGenerator m_generator;
+#ifdef TRANSCEIVER_DMA
+  PeripheralDMA m_dma;
+#endif
   int m_stop_after;
+  uint64_t m_tasks_resume;
 
   UID m_controller_uid;
   UID m_device_uid;
@@ -306,12 +370,16 @@ class TransceiverTest : public testing::Test {
 
   static const uint32_t kClockSpeed = 80000000;
   static const uint32_t kBaudRate = 250000;
+  static const uint8_t kPort = 0;
 
   static const uint8_t kDMX1[];
   static const uint8_t kDMX2[];
   static const uint8_t kDMX3[];
   static const uint8_t kDUBRequest[];
   static const uint8_t kDUBResponse[];
+  static const uint8_t kDeviceUID[];
+  static const uint8_t kFastDUBRequest[];
+  static const uint8_t kFastDUBResponse[];
   static const uint8_t kRDMRequest[];
   static const uint8_t kRDMResponse[];
 };
@@ -328,6 +396,21 @@ const uint8_t TransceiverTest::kDUBResponse[] = {
   0xfe, 0xfe, 0xfe, 0xaa, 0xfa, 0x7f, 0xfa, 0x75, 0xaa, 0x55, 0xaa, 0x55,
   0xaa, 0x55, 0xab, 0x55, 0xae, 0x57, 0xef, 0xf5
 };
+const uint8_t TransceiverTest::kDeviceUID[] = {
+  0x7a, 0x70, 0x00, 0x00, 0x00, 0x01
+};
+// A broadcast DUB for the entire UID range, including the start code.
+const uint8_t TransceiverTest::kFastDUBRequest[] = {
+  0xcc, 0x01, 0x24, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7a, 0x70, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x10, 0x00, 0x01, 0x0c,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0x0d, 0xed
+};
+// The DUB response for kDeviceUID.
+const uint8_t TransceiverTest::kFastDUBResponse[] = {
+  0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xaa, 0xfa, 0x7f, 0xfa, 0x75,
+  0xaa, 0x55, 0xaa, 0x55, 0xaa, 0x55, 0xab, 0x55, 0xae, 0x57, 0xef, 0xf5
+};
 const uint8_t TransceiverTest::kRDMRequest[] = {
   0x01, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x00, 0x7a, 0x70, 0x00, 0x00,
   0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0xf0, 0x00, 0x03, 0xca
@@ -346,7 +429,7 @@ void TransceiverTest::SwitchToControllerMode() {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  EXPECT_TRUE(Transceiver_SetMode(T_MODE_CONTROLLER, token));
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_CONTROLLER, token));
 
   m_simulator.Run();
 }
@@ -358,7 +441,7 @@ void TransceiverTest::SwitchToSelfTestMode() {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  EXPECT_TRUE(Transceiver_SetMode(T_MODE_SELF_TEST, token));
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_SELF_TEST, token));
   m_simulator.Run();
 }
 
@@ -371,10 +454,14 @@ TEST_F(TransceiverTest, controllerTxDMX) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueDMX(1, kDMX1, arraysize(kDMX1));
+  Transceiver_QueueDMX(kPort, 1, kDMX1, arraysize(kDMX1));
   m_simulator.Run();
   EXPECT_THAT(m_tx_bytes,
               MatchesFrameWithSC(NULL_START_CODE, kDMX1, arraysize(kDMX1)));
+#ifdef TRANSCEIVER_DMA
+  // The start code is sent by the timer ISR, the slots by DMA.
+  EXPECT_EQ(arraysize(kDMX1), m_dma.CellCount());
+#endif
 }
 
 TEST_F(TransceiverTest, controllerTxEmptyDMX) {
@@ -386,7 +473,7 @@ TEST_F(TransceiverTest, controllerTxEmptyDMX) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueDMX(1, nullptr, 0);
+  Transceiver_QueueDMX(kPort, 1, nullptr, 0);
   m_simulator.Run();
 
   const uint8_t dmx[] = {};
@@ -404,13 +491,137 @@ TEST_F(TransceiverTest, controllerTxJumboDMX) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueDMX(1, dmx, arraysize(dmx));
+  Transceiver_QueueDMX(kPort, 1, dmx, arraysize(dmx));
   m_simulator.Run();
 
   // Limited to 512 slots
   EXPECT_THAT(m_tx_bytes, MatchesFrameWithSC(NULL_START_CODE, dmx, 512ul));
 }
 
+TEST_F(TransceiverTest, controllerTxQueuedDMX) {
+  SwitchToControllerMode();
+
+  {
+    InSequence seq;
+    EXPECT_CALL(m_event_handler,
+                Run(EventIs(1, T_OP_TX_ONLY, T_RESULT_OK, 0)))
+      .WillOnce(Return(true));
+    EXPECT_CALL(m_event_handler,
+                Run(EventIs(2, T_OP_TX_ONLY, T_RESULT_OK, 0)))
+      .WillOnce(Return(true));
+    EXPECT_CALL(m_event_handler,
+                Run(EventIs(3, T_OP_TX_ONLY, T_RESULT_OK, 0)))
+      .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
+                      Return(true)));
+  }
+
+  // The frames are sent back-to-back, without waiting for each completion.
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 1, kDMX1, arraysize(kDMX1)));
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 2, kDMX2, arraysize(kDMX2)));
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 3, kDMX3, arraysize(kDMX3)));
+  m_simulator.Run();
+
+  vector<uint8_t> expected;
+  expected.push_back(NULL_START_CODE);
+  expected.insert(expected.end(), kDMX1, kDMX1 + arraysize(kDMX1));
+  expected.push_back(NULL_START_CODE);
+  expected.insert(expected.end(), kDMX2, kDMX2 + arraysize(kDMX2));
+  expected.push_back(NULL_START_CODE);
+  expected.insert(expected.end(), kDMX3, kDMX3 + arraysize(kDMX3));
+  EXPECT_THAT(m_tx_bytes, ElementsAreArray(expected));
+}
+
+TEST_F(TransceiverTest, controllerTxDMXRefresh) {
+  SwitchToControllerMode();
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 30));  // 3ms
+
+  // Only the original frames generate events.
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(1, T_OP_TX_ONLY, T_RESULT_OK, 0)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(2, T_OP_TX_ONLY, T_RESULT_OK, 0)))
+    .WillOnce(Return(true));
+
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 1, kDMX1, arraysize(kDMX1)));
+  m_simulator.SetClockLimit(10000, false);  // 10ms
+  m_simulator.Run();
+  EXPECT_THAT(m_tx_bytes,
+              RepeatsFrameWithSC(NULL_START_CODE, kDMX1, arraysize(kDMX1), 3));
+
+  // A new frame replaces the held one. The simulator may have stopped part
+  // way through a frame, so allow for the rest of that frame.
+  unsigned int remaining = (arraysize(kDMX1) + 1 -
+                            m_tx_bytes.size() % (arraysize(kDMX1) + 1)) %
+                           (arraysize(kDMX1) + 1);
+  m_tx_bytes.clear();
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 2, kDMX2, arraysize(kDMX2)));
+  m_simulator.SetClockLimit(10000, false);
+  m_simulator.Run();
+  ASSERT_GE(m_tx_bytes.size(), remaining);
+  m_tx_bytes.erase(m_tx_bytes.begin(), m_tx_bytes.begin() + remaining);
+  EXPECT_THAT(m_tx_bytes,
+              RepeatsFrameWithSC(NULL_START_CODE, kDMX2, arraysize(kDMX2), 3));
+
+  // Disable refresh, this releases the held frame.
+  remaining = (arraysize(kDMX2) + 1 -
+               m_tx_bytes.size() % (arraysize(kDMX2) + 1)) %
+              (arraysize(kDMX2) + 1);
+  m_tx_bytes.clear();
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 0));
+  m_simulator.SetClockLimit(10000, false);
+  m_simulator.Run();
+  EXPECT_EQ(remaining, m_tx_bytes.size());
+}
+
+TEST_F(TransceiverTest, controllerInterleaveDMXAndRDM) {
+  SwitchToControllerMode();
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 30));  // 3ms
+
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(1, T_OP_TX_ONLY, T_RESULT_OK, 0)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(2, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_TIMEOUT, 0)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(3, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_TIMEOUT, 0)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(4, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_TIMEOUT, 0)))
+    .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
+                    Return(true)));
+
+  // Each RDM request takes longer than the refresh interval, so the held DMX
+  // frame is sent between each of them.
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 1, kDMX1, arraysize(kDMX1)));
+  for (int16_t token = 2; token < 5; token++) {
+    EXPECT_TRUE(Transceiver_QueueRDMRequest(kPort, token, kRDMRequest,
+                                            arraysize(kRDMRequest), false));
+  }
+  m_simulator.SetClockLimit(100000, false);  // 100ms
+  m_simulator.Run();
+
+  vector<uint8_t> expected;
+  for (unsigned int i = 0; i < 3; i++) {
+    expected.push_back(NULL_START_CODE);
+    expected.insert(expected.end(), kDMX1, kDMX1 + arraysize(kDMX1));
+    expected.push_back(RDM_START_CODE);
+    expected.insert(expected.end(), kRDMRequest,
+                    kRDMRequest + arraysize(kRDMRequest));
+  }
+  EXPECT_THAT(m_tx_bytes, ElementsAreArray(expected));
+
+  TransceiverLineStats stats;
+  Transceiver_GetLineStats(kPort, &stats);
+  EXPECT_EQ(3u, stats.dmx_frames);
+  EXPECT_EQ(3u, stats.rdm_frames);
+  EXPECT_LT(0u, stats.dmx_time);
+  EXPECT_LT(stats.dmx_time, stats.rdm_time);
+
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 0));
+}
+
 TEST_F(TransceiverTest, controllerTxASCFrame) {
   const uint8_t ASC = 0xdd;
   SwitchToControllerMode();
@@ -422,7 +633,7 @@ TEST_F(TransceiverTest, controllerTxASCFrame) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueASC(token, ASC, asc_frame, arraysize(asc_frame));
+  Transceiver_QueueASC(kPort, token, ASC, asc_frame, arraysize(asc_frame));
   m_simulator.Run();
 
   EXPECT_THAT(m_tx_bytes,
@@ -438,7 +649,8 @@ TEST_F(TransceiverTest, controllerTxRDMBroadcast) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest), true);
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
+                              true);
   m_simulator.Run();
 
   EXPECT_THAT(
@@ -447,7 +659,7 @@ TEST_F(TransceiverTest, controllerTxRDMBroadcast) {
 }
 
 TEST_F(TransceiverTest, controllerTxRDMBroadcastNoListen) {
-  Transceiver_SetRDMBroadcastTimeout(0);
+  Transceiver_SetRDMBroadcastTimeout(kPort, 0);
   SwitchToControllerMode();
 
   uint8_t token = 1;
@@ -456,7 +668,8 @@ TEST_F(TransceiverTest, controllerTxRDMBroadcastNoListen) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest), true);
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
+                              true);
   m_simulator.Run();
 
   EXPECT_THAT(
@@ -473,7 +686,7 @@ TEST_F(TransceiverTest, controllerRDMDUBNoResponse) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueRDMDUB(token, kDUBRequest, arraysize(kDUBRequest));
+  Transceiver_QueueRDMDUB(kPort, token, kDUBRequest, arraysize(kDUBRequest));
   m_simulator.Run();
 
   EXPECT_THAT(
@@ -487,7 +700,7 @@ TEST_F(TransceiverTest, controllerRDMDUBWithResponse) {
   uint8_t token = 1;
   StopAfter(1 + arraysize(kDUBRequest));
 
-  Transceiver_QueueRDMDUB(token, kDUBRequest, arraysize(kDUBRequest));
+  Transceiver_QueueRDMDUB(kPort, token, kDUBRequest, arraysize(kDUBRequest));
   m_simulator.Run();
 
   EXPECT_THAT(
@@ -513,7 +726,7 @@ TEST_F(TransceiverTest, controllerRDMDUBWithLargeResponse) {
   uint8_t token = 1;
   StopAfter(1 + arraysize(kDUBRequest));
 
-  Transceiver_QueueRDMDUB(token, kDUBRequest, arraysize(kDUBRequest));
+  Transceiver_QueueRDMDUB(kPort, token, kDUBRequest, arraysize(kDUBRequest));
   m_simulator.Run();
 
   EXPECT_THAT(
@@ -549,7 +762,7 @@ TEST_F(TransceiverTest, controllerRDMGetTimeout) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -563,7 +776,7 @@ TEST_F(TransceiverTest, controllerRDMGetWithResponse) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -584,8 +797,51 @@ TEST_F(TransceiverTest, controllerRDMGetWithResponse) {
                     Return(true)));
 
   m_simulator.Run();
+#ifdef TRANSCEIVER_DMA
+  // Everything other than the request start code is moved by DMA.
+  EXPECT_EQ(arraysize(kRDMRequest) + arraysize(kRDMResponse),
+            m_dma.CellCount());
+#endif
 }
 
+#ifdef TRANSCEIVER_DMA
+// Start the DMA RX transfer again part way through the response.
+TEST_F(TransceiverTest, controllerRDMGetDMARestart) {
+  SwitchToControllerMode();
+
+  uint8_t token = 1;
+  StopAfter(1 + arraysize(kRDMRequest));
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
+                              false);
+  m_simulator.Run();
+
+  const unsigned int kFirstSlots = 5;
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(176);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kRDMResponse, kFirstSlots);
+  m_simulator.Run();
+
+  Transceiver_RestartDMARX(kPort);
+
+  vector<uint8_t> rx_data;
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RDM_WITH_RESPONSE, T_RESULT_RX_DATA,
+                          arraysize(kRDMResponse))))
+    .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
+                    AppendTo(&rx_data)));
+
+  m_generator.Reset();
+  m_generator.SetStopOnComplete(false);
+  m_generator.AddFrame(kRDMResponse + kFirstSlots,
+                       arraysize(kRDMResponse) - kFirstSlots);
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data, ElementsAreArray(kRDMResponse, arraysize(kRDMResponse)));
+}
+#endif
+
 TEST_F(TransceiverTest, controllerRDMGetWithJumboResponse) {
   SwitchToControllerMode();
 
@@ -596,7 +852,7 @@ TEST_F(TransceiverTest, controllerRDMGetWithJumboResponse) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -627,7 +883,7 @@ TEST_F(TransceiverTest, controllerRDMGetInterslotTimeout) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -669,7 +925,7 @@ TEST_F(TransceiverTest, controllerRDMGetWithShortBreak) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -697,7 +953,7 @@ TEST_F(TransceiverTest, controllerRDMGetWithLongBreak) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -725,7 +981,7 @@ TEST_F(TransceiverTest, controllerRDMGetWithNoMark) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -751,7 +1007,7 @@ TEST_F(TransceiverTest, controllerRDMGetWithNoData) {
 
   uint8_t token = 1;
   StopAfter(1 + arraysize(kRDMRequest));
-  Transceiver_QueueRDMRequest(token, kRDMRequest, arraysize(kRDMRequest),
+  Transceiver_QueueRDMRequest(kPort, token, kRDMRequest, arraysize(kRDMRequest),
                               false);
   m_simulator.Run();
 
@@ -782,7 +1038,7 @@ TEST_F(TransceiverTest, controllerModeChange) {
               Run(EventIs(token, T_OP_TX_ONLY, T_RESULT_CANCELLED, 0)))
     .WillOnce(Return(true));
 
-  EXPECT_TRUE(Transceiver_QueueDMX(token, kDMX1, arraysize(kDMX1)));
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, token, kDMX1, arraysize(kDMX1)));
 
   token++;
 
@@ -790,7 +1046,7 @@ TEST_F(TransceiverTest, controllerModeChange) {
               Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK, 0)))
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
-  EXPECT_TRUE(Transceiver_SetMode(T_MODE_RESPONDER, token));
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_RESPONDER, token));
 
   m_simulator.Run();
 
@@ -1027,6 +1283,103 @@ TEST_F(TransceiverTest, responderRxDoubleFrame) {
   EXPECT_THAT(rx_data2, ElementsAreArray(kDMX2, arraysize(kDMX2)));
 }
 
+// Test a slow RX handler doesn't lose the end of the frame when the next break
+// arrives.
+TEST_F(TransceiverTest, responderRxSlowHandler) {
+  vector<uint8_t> rx_data1, rx_data2;
+
+  uint8_t token = 0;
+  EXPECT_CALL(m_event_handler, Run(EventIs(token, T_OP_RX, _, _)))
+    .WillRepeatedly(Return(true));
+  // The handler is busy from the first slot until part way through the second
+  // frame.
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, T_RESULT_RX_START_FRAME, _)))
+    .WillOnce(DoAll(InvokeWithoutArgs([this]() { PauseTasks(700); }),
+                    Return(true)))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(
+      m_event_handler,
+      Run(AllOf(
+          EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME, arraysize(kDMX1)),
+          RequestTimingIs(1760, 120))))
+    .WillOnce(AppendTo(&rx_data1));
+  EXPECT_CALL(
+      m_event_handler,
+      Run(AllOf(
+          EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME, arraysize(kDMX2)),
+          RequestTimingIs(1800, 140))))
+    .WillOnce(AppendTo(&rx_data2));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX1, arraysize(kDMX1));
+  m_generator.AddBreak(180);
+  m_generator.AddMark(14);
+  m_generator.AddFrame(kDMX2, arraysize(kDMX2));
+  m_generator.AddDelay(100);
+
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data1, ElementsAreArray(kDMX1, arraysize(kDMX1)));
+  EXPECT_THAT(rx_data2, ElementsAreArray(kDMX2, arraysize(kDMX2)));
+  EXPECT_EQ(0u, Transceiver_GetRXOverrunCount(kPort));
+}
+
+// Test a frame is dropped if it ends while the RX handler is still busy with
+// the frame before it.
+TEST_F(TransceiverTest, responderRxOverrun) {
+  vector<uint8_t> rx_data1, rx_data3;
+
+  uint8_t token = 0;
+  EXPECT_CALL(m_event_handler, Run(EventIs(token, T_OP_RX, _, _)))
+    .WillRepeatedly(Return(true));
+  // The handler is busy from the first slot until part way through the third
+  // frame.
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, T_RESULT_RX_START_FRAME, _)))
+    .WillOnce(DoAll(InvokeWithoutArgs([this]() { PauseTasks(1000); }),
+                    Return(true)))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(
+      m_event_handler,
+      Run(AllOf(
+          EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME, arraysize(kDMX1)),
+          RequestTimingIs(1760, 120))))
+    .WillOnce(AppendTo(&rx_data1));
+  EXPECT_CALL(m_event_handler,
+              Run(AllOf(EventIs(token, T_OP_RX, _, _),
+                        RequestTimingIs(1800, 140))))
+    .Times(0);
+  EXPECT_CALL(
+      m_event_handler,
+      Run(AllOf(
+          EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME, arraysize(kDMX2)),
+          RequestTimingIs(1900, 160))))
+    .WillOnce(AppendTo(&rx_data3));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX1, arraysize(kDMX1));
+  m_generator.AddBreak(180);
+  m_generator.AddMark(14);
+  m_generator.AddFrame(kDMX3, arraysize(kDMX3));
+  m_generator.AddBreak(190);
+  m_generator.AddMark(16);
+  m_generator.AddFrame(kDMX2, arraysize(kDMX2));
+  m_generator.AddDelay(100);
+
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data1, ElementsAreArray(kDMX1, arraysize(kDMX1)));
+  EXPECT_THAT(rx_data3, ElementsAreArray(kDMX2, arraysize(kDMX2)));
+  EXPECT_EQ(1u, Transceiver_GetRXOverrunCount(kPort));
+}
+
 // Test we don't crash if we receive a frame larger than 512 slots.
 TEST_F(TransceiverTest, responderRxJumboFrameWithResponse) {
   uint8_t jumbo_frame[600];
@@ -1060,7 +1413,7 @@ TEST_F(TransceiverTest, responderRxJumboFrameWithResponse) {
     .base = kRDMResponse,
     .length = arraysize(kRDMResponse)
   };
-  EXPECT_FALSE(Transceiver_QueueRDMResponse(true, &iovec, 1));
+  EXPECT_FALSE(Transceiver_QueueRDMResponse(kPort, true, &iovec, 1));
 }
 
 // Test we handle framing errors correctly.
@@ -1091,6 +1444,105 @@ TEST_F(TransceiverTest, responderRxFramingError) {
   EXPECT_THAT(rx_data, ElementsAreArray(kDMX2, arraysize(kDMX2)));
 }
 
+// A framing error that isn't a break leaves the line high, so the next edge is
+// a falling one. Check the following frame is still received.
+TEST_F(TransceiverTest, responderRxFramingErrorLineHigh) {
+  vector<uint8_t> rx_data;
+
+  uint8_t token = 0;
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, _, Lt(arraysize(kDMX2)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          arraysize(kDMX2))))
+    .WillOnce(AppendTo(&rx_data));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX1, 3);
+  m_generator.AddFramingError(kDMX1[3]);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX2, arraysize(kDMX2));
+  m_generator.AddDelay(100);
+
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data, ElementsAreArray(kDMX2, arraysize(kDMX2)));
+}
+
+// A framing error in the middle of a frame, followed by the rest of the slots.
+// The edges of those slots must not be taken as a break.
+TEST_F(TransceiverTest, responderRxFramingErrorMidFrame) {
+  vector<uint8_t> rx_data;
+
+  uint8_t token = 0;
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, _, Lt(arraysize(kDMX2)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          arraysize(kDMX2))))
+    .WillOnce(AppendTo(&rx_data));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX1, 3);
+  m_generator.AddFramingError(kDMX1[3]);
+  m_generator.AddFrame(kDMX1 + 4, arraysize(kDMX1) - 4);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX2, arraysize(kDMX2));
+  m_generator.AddDelay(100);
+
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data, ElementsAreArray(kDMX2, arraysize(kDMX2)));
+}
+
+// After a framing error the break is measured from the last edge of the bad
+// slot, so a long idle time makes the next break out of range and that frame
+// is lost. Check the frame after it is received.
+TEST_F(TransceiverTest, responderRxFramingErrorLongIdle) {
+  vector<uint8_t> rx_data;
+
+  uint8_t token = 0;
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, _, Lt(arraysize(kDMX2)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          arraysize(kDMX2))))
+    .WillOnce(AppendTo(&rx_data));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX1, 3);
+  m_generator.AddFramingError(kDMX1[3]);
+  m_generator.AddDelay(1000);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX1, arraysize(kDMX1));
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kDMX2, arraysize(kDMX2));
+  m_generator.AddDelay(100);
+
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data, ElementsAreArray(kDMX2, arraysize(kDMX2)));
+}
+
 TEST_F(TransceiverTest, responderRDMRequest) {
   vector<uint8_t> rx_data;
 
@@ -1119,7 +1571,7 @@ TEST_F(TransceiverTest, responderRDMRequest) {
     .base = kRDMResponse,
     .length = arraysize(kRDMResponse)
   };
-  Transceiver_QueueRDMResponse(true, &iovec, 1);
+  Transceiver_QueueRDMResponse(kPort, true, &iovec, 1);
 
   m_generator.Reset();
   m_generator.SetStopOnComplete(false);
@@ -1127,6 +1579,166 @@ TEST_F(TransceiverTest, responderRDMRequest) {
   m_simulator.Run();
 
   EXPECT_THAT(m_tx_bytes, MatchesFrame(kRDMResponse, arraysize(kRDMResponse)));
+
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(kPort, &stats);
+  // The response was queued as soon as the simulator stopped, 10us after the
+  // request.
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_NEAR(100, stats.min, 20);
+  EXPECT_EQ(stats.min, stats.max);
+  EXPECT_EQ(stats.min, stats.mean);
+  EXPECT_EQ(1u, stats.histogram[0]);
+}
+
+TEST_F(TransceiverTest, responderTurnaroundStatsMidFrame) {
+  vector<uint8_t> rx_data;
+
+  // Read and reset the stats from the main loop while the request is being
+  // received. This masks the port's interrupts, which must be restored.
+  auto read_and_reset_stats = []() {
+    TransceiverTurnaroundStats stats;
+    Transceiver_GetTurnaroundStats(kPort, &stats);
+    Transceiver_ResetTurnaroundStats(kPort);
+  };
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, _, Lt(arraysize(kRDMRequest)))))
+    .WillRepeatedly(DoAll(InvokeWithoutArgs(read_and_reset_stats),
+                          Return(true)));
+  EXPECT_CALL(
+      m_event_handler,
+      Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                  arraysize(kRDMRequest))))
+    .WillOnce(AppendTo(&rx_data));
+
+  // Also read them while waiting for the break.
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(1000);
+  m_simulator.Run();
+  read_and_reset_stats();
+
+  m_generator.Reset();
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kRDMRequest, arraysize(kRDMRequest));
+
+  m_simulator.Run();
+  EXPECT_THAT(rx_data, ElementsAreArray(kRDMRequest, arraysize(kRDMRequest)));
+
+  IOVec iovec = {
+    .base = kRDMResponse,
+    .length = arraysize(kRDMResponse)
+  };
+  Transceiver_QueueRDMResponse(kPort, true, &iovec, 1);
+
+  m_generator.Reset();
+  m_generator.SetStopOnComplete(false);
+  StopAfter(arraysize(kRDMResponse));
+  m_simulator.Run();
+
+  EXPECT_THAT(m_tx_bytes, MatchesFrame(kRDMResponse, arraysize(kRDMResponse)));
+
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(kPort, &stats);
+  EXPECT_EQ(1u, stats.count);
+}
+
+TEST_F(TransceiverTest, responderRDMLateResponse) {
+  vector<uint8_t> rx_data;
+
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, _, Lt(arraysize(kRDMRequest)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(
+      m_event_handler,
+      Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                  arraysize(kRDMRequest))))
+    .WillOnce(AppendTo(&rx_data));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kRDMRequest, arraysize(kRDMRequest));
+
+  m_simulator.Run();
+  EXPECT_THAT(rx_data, ElementsAreArray(kRDMRequest, arraysize(kRDMRequest)));
+
+  // Idle for 500us, longer than the responder delay but within the
+  // inter-slot timeout.
+  m_generator.Reset();
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(500);
+  m_simulator.Run();
+
+  IOVec iovec = {
+    .base = kRDMResponse,
+    .length = arraysize(kRDMResponse)
+  };
+  EXPECT_TRUE(Transceiver_QueueRDMResponse(kPort, true, &iovec, 1));
+
+  m_generator.Reset();
+  m_generator.SetStopOnComplete(false);
+  StopAfter(arraysize(kRDMResponse));
+  m_simulator.Run();
+
+  EXPECT_THAT(m_tx_bytes, MatchesFrame(kRDMResponse, arraysize(kRDMResponse)));
+
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(kPort, &stats);
+  // The response was ready 500us + 10us after the request.
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_NEAR(5100, stats.min, 150);
+  EXPECT_EQ(stats.min, stats.max);
+  EXPECT_EQ(stats.min, stats.mean);
+  EXPECT_EQ(1u, stats.histogram[2]);
+}
+
+// Check the turnaround time follows how long the response took to prepare.
+TEST_F(TransceiverTest, responderRDMTurnaroundTime) {
+  EXPECT_CALL(m_event_handler, Run(EventIs(_, T_OP_RX, _, _)))
+    .WillRepeatedly(Return(true));
+
+  IOVec iovec = {
+    .base = kRDMResponse,
+    .length = arraysize(kRDMResponse)
+  };
+
+  // The time to prepare each response in us, 1.2ms, 300us & 1.9ms.
+  const unsigned int kHandlerTimes[] = {1200, 300, 1900};
+  for (unsigned int i = 0; i < arraysize(kHandlerTimes); i++) {
+    m_generator.Reset();
+    m_generator.SetStopOnComplete(true);
+    m_generator.AddDelay(100);
+    m_generator.AddBreak(176);
+    m_generator.AddMark(12);
+    m_generator.AddFrame(kRDMRequest, arraysize(kRDMRequest));
+    m_generator.AddDelay(kHandlerTimes[i]);
+    m_simulator.Run();
+
+    EXPECT_TRUE(Transceiver_QueueRDMResponse(kPort, true, &iovec, 1));
+
+    m_tx_bytes.clear();
+    m_generator.Reset();
+    m_generator.SetStopOnComplete(false);
+    StopAfter(arraysize(kRDMResponse));
+    m_simulator.Run();
+    EXPECT_THAT(m_tx_bytes,
+                MatchesFrame(kRDMResponse, arraysize(kRDMResponse)));
+  }
+
+  // Each value includes the 10us before the simulator stops.
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(kPort, &stats);
+  EXPECT_EQ(3u, stats.count);
+  EXPECT_NEAR(3100, stats.min, 150);
+  EXPECT_NEAR(19100, stats.max, 150);
+  EXPECT_NEAR(11433, stats.mean, 150);
+  EXPECT_EQ(0u, stats.histogram[0]);
+  EXPECT_EQ(1u, stats.histogram[1]);
+  EXPECT_EQ(1u, stats.histogram[4]);
+  EXPECT_EQ(1u, stats.histogram[7]);
+  EXPECT_EQ(0u, stats.histogram[TRANSCEIVER_TURNAROUND_BUCKETS - 1]);
 }
 
 TEST_F(TransceiverTest, responderRDMDUB) {
@@ -1157,7 +1769,7 @@ TEST_F(TransceiverTest, responderRDMDUB) {
     .base = kDUBResponse,
     .length = arraysize(kDUBResponse)
   };
-  Transceiver_QueueRDMResponse(false, &iovec, 1);
+  Transceiver_QueueRDMResponse(kPort, false, &iovec, 1);
 
   m_generator.Reset();
   m_generator.SetStopOnComplete(false);
@@ -1201,7 +1813,7 @@ TEST_F(TransceiverTest, responderRDMOversizedDUB) {
     .base = dub_response,
     .length = arraysize(dub_response)
   };
-  Transceiver_QueueRDMResponse(false, &iovec, 1);
+  Transceiver_QueueRDMResponse(kPort, false, &iovec, 1);
 
   m_generator.Reset();
   m_generator.SetStopOnComplete(false);
@@ -1212,7 +1824,8 @@ TEST_F(TransceiverTest, responderRDMOversizedDUB) {
 }
 
 TEST_F(TransceiverTest, responderRDMDUBWithJitter) {
-  EXPECT_TRUE(Transceiver_SetRDMResponderJitter(1000));  // 100uS of jitter
+  // 100uS of jitter
+  EXPECT_TRUE(Transceiver_SetRDMResponderJitter(kPort, 1000));
 
   vector<uint8_t> rx_data;
 
@@ -1241,7 +1854,7 @@ TEST_F(TransceiverTest, responderRDMDUBWithJitter) {
     .base = kDUBResponse,
     .length = arraysize(kDUBResponse)
   };
-  Transceiver_QueueRDMResponse(false, &iovec, 1);
+  Transceiver_QueueRDMResponse(kPort, false, &iovec, 1);
 
   m_generator.Reset();
   m_generator.SetStopOnComplete(false);
@@ -1251,6 +1864,133 @@ TEST_F(TransceiverTest, responderRDMDUBWithJitter) {
   EXPECT_THAT(m_tx_bytes, MatchesFrame(kDUBResponse, arraysize(kDUBResponse)));
 }
 
+// Test a DUB is answered on time from the ISR while the main loop is busy.
+TEST_F(TransceiverTest, responderDUBFastPath) {
+  Transceiver_SetDUBResponse(kPort, kDeviceUID, kFastDUBResponse);
+
+  IOVec iovec = {
+    .base = kFastDUBResponse,
+    .length = arraysize(kFastDUBResponse)
+  };
+
+  // The main loop is stalled from the first slot until well after the
+  // response. The rest of the request is passed to the handler once it
+  // resumes, so it's counted, but it can't queue a second response.
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_START_FRAME, _)))
+    .WillOnce(DoAll(InvokeWithoutArgs([this]() { PauseTasks(2000); }),
+                    Return(true)));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          arraysize(kFastDUBRequest))))
+    .WillOnce(DoAll(InvokeWithoutArgs([&iovec]() {
+                      EXPECT_FALSE(Transceiver_QueueRDMResponse(
+                          kPort, false, &iovec, 1));
+                    }),
+                    Return(true)));
+
+  m_generator.SetStopOnComplete(false);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kFastDUBRequest, arraysize(kFastDUBRequest));
+  StopAfter(arraysize(kFastDUBResponse));
+  m_simulator.Run();
+
+  EXPECT_THAT(m_tx_bytes,
+              MatchesFrame(kFastDUBResponse, arraysize(kFastDUBResponse)));
+
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(kPort, &stats);
+  // The response was ready as soon as the last slot arrived.
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_LT(stats.min, 20);
+
+  // Release the response buffer.
+  Transceiver_SetDUBResponse(kPort, nullptr, nullptr);
+}
+
+// The same load as above, but without the fast path the response waits for
+// the handler, and misses the responder delay.
+TEST_F(TransceiverTest, responderDUBWithoutFastPath) {
+  IOVec iovec = {
+    .base = kFastDUBResponse,
+    .length = arraysize(kFastDUBResponse)
+  };
+
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_START_FRAME, _)))
+    .WillOnce(DoAll(InvokeWithoutArgs([this]() { PauseTasks(2000); }),
+                    Return(true)));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          Lt(arraysize(kFastDUBRequest)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          arraysize(kFastDUBRequest))))
+    .WillOnce(DoAll(InvokeWithoutArgs([&iovec]() {
+                      EXPECT_TRUE(Transceiver_QueueRDMResponse(
+                          kPort, false, &iovec, 1));
+                    }),
+                    Return(true)));
+
+  m_generator.SetStopOnComplete(false);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(kFastDUBRequest, arraysize(kFastDUBRequest));
+  StopAfter(arraysize(kFastDUBResponse));
+  m_simulator.Run();
+
+  EXPECT_THAT(m_tx_bytes,
+              MatchesFrame(kFastDUBResponse, arraysize(kFastDUBResponse)));
+
+  TransceiverTurnaroundStats stats;
+  Transceiver_GetTurnaroundStats(kPort, &stats);
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_GT(stats.min, DEFAULT_RDM_RESPONDER_DELAY);
+}
+
+// Test a DUB that doesn't cover the UID is passed to the handler.
+TEST_F(TransceiverTest, responderDUBFastPathOutOfRange) {
+  Transceiver_SetDUBResponse(kPort, kDeviceUID, kFastDUBResponse);
+
+  // Change the lower bound to 7a70:00000002, and fix the checksum.
+  uint8_t request[arraysize(kFastDUBRequest)];
+  memcpy(request, kFastDUBRequest, arraysize(kFastDUBRequest));
+  request[24] = 0x7a;
+  request[25] = 0x70;
+  request[29] = 0x02;
+  request[36] = 0x0e;
+  request[37] = 0xd9;
+
+  vector<uint8_t> rx_data;
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, _, Lt(arraysize(request)))))
+    .WillRepeatedly(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_CONTINUE_FRAME,
+                          arraysize(request))))
+    .WillOnce(AppendTo(&rx_data));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(0, T_OP_RX, T_RESULT_RX_FRAME_TIMEOUT, _)))
+    .WillOnce(Return(true));
+
+  m_generator.SetStopOnComplete(true);
+  m_generator.AddDelay(100);
+  m_generator.AddBreak(176);
+  m_generator.AddMark(12);
+  m_generator.AddFrame(request, arraysize(request));
+  m_generator.AddDelay(500);
+  m_simulator.Run();
+
+  EXPECT_THAT(rx_data, ElementsAreArray(request, arraysize(request)));
+  EXPECT_THAT(m_tx_bytes, IsEmpty());
+
+  Transceiver_SetDUBResponse(kPort, nullptr, nullptr);
+}
+
 TEST_F(TransceiverTest, selfTestPass) {
   SwitchToSelfTestMode();
   uint8_t token = 2;
@@ -1259,7 +1999,7 @@ TEST_F(TransceiverTest, selfTestPass) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  EXPECT_TRUE(Transceiver_QueueSelfTest(token));
+  EXPECT_TRUE(Transceiver_QueueSelfTest(kPort, token));
   StopAfter(1);
   m_simulator.Run();
 
@@ -1280,7 +2020,7 @@ TEST_F(TransceiverTest, selfTestFailCorrupt) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  EXPECT_TRUE(Transceiver_QueueSelfTest(token));
+  EXPECT_TRUE(Transceiver_QueueSelfTest(kPort, token));
   StopAfter(1);
   m_simulator.Run();
 
@@ -1301,7 +2041,7 @@ TEST_F(TransceiverTest, selfTestFailTimeout) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  EXPECT_TRUE(Transceiver_QueueSelfTest(token));
+  EXPECT_TRUE(Transceiver_QueueSelfTest(kPort, token));
   m_simulator.Run();
 
   EXPECT_THAT(m_tx_bytes, SizeIs(1));
@@ -1310,15 +2050,15 @@ TEST_F(TransceiverTest, selfTestFailTimeout) {
 
 TEST_F(TransceiverTest, switchModes) {
   SwitchToSelfTestMode();
-  EXPECT_EQ(T_MODE_SELF_TEST, Transceiver_GetMode());
+  EXPECT_EQ(T_MODE_SELF_TEST, Transceiver_GetMode(kPort));
   SwitchToControllerMode();
-  EXPECT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode());
+  EXPECT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode(kPort));
 }
 
 TEST_F(TransceiverTest, reset) {
   SwitchToControllerMode();
 
-  Transceiver_Reset();
+  Transceiver_Reset(kPort);
   Transceiver_Tasks();
 
   uint8_t token = 1;
@@ -1327,8 +2067,28 @@ TEST_F(TransceiverTest, reset) {
     .WillOnce(DoAll(InvokeWithoutArgs(&m_simulator, &Simulator::Stop),
                     Return(true)));
 
-  EXPECT_TRUE(Transceiver_QueueDMX(1, kDMX1, arraysize(kDMX1)));
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, 1, kDMX1, arraysize(kDMX1)));
   m_simulator.Run();
   EXPECT_THAT(m_tx_bytes,
               MatchesFrameWithSC(NULL_START_CODE, kDMX1, arraysize(kDMX1)));
 }
+
+TEST_F(TransceiverTest, resetCancelsPendingFrames) {
+  SwitchToControllerMode();
+
+  // Stop while waiting for the DUB response, with a request queued behind it.
+  StopAfter(1 + arraysize(kDUBRequest));
+  EXPECT_TRUE(Transceiver_QueueRDMDUB(kPort, 1, kDUBRequest,
+                                      arraysize(kDUBRequest)));
+  EXPECT_TRUE(Transceiver_QueueRDMRequest(kPort, 2, kRDMRequest,
+                                          arraysize(kRDMRequest), false));
+  m_simulator.Run();
+
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(1, T_OP_RDM_DUB, T_RESULT_CANCELLED, 0)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(2, T_OP_RDM_WITH_RESPONSE, T_RESULT_CANCELLED, 0)))
+    .WillOnce(Return(true));
+  Transceiver_Reset(kPort);
+}
@@ -0,0 +1,141 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SysLogTest.cpp
+ * Tests for the SysLog event queue.
+ * Copyright (C) 2015 Simon Newton
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "syslog.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// This matches SYSLOG_EVENT_QUEUE_SIZE in syslog.c
+const unsigned int kQueueSize = 16;
+
+vector<string> g_messages;
+
+void WriteMessage(const char *msg) {
+  g_messages.push_back(msg);
+}
+
+string EventMessage(int i) {
+  return "Event " + std::to_string(i);
+}
+}  // namespace
+
+class SysLogTest : public testing::Test {
+ public:
+  void SetUp() {
+    g_messages.clear();
+    SysLog_Initialize(WriteMessage);
+  }
+
+  void QueueEvents(int start, int count) {
+    for (int i = start; i < start + count; i++) {
+      SysLog_Event(SYSLOG_INFO, "Event %d", i);
+    }
+  }
+
+  /*
+   * Run SysLog_Tasks() until it stops writing messages.
+   */
+  void Drain() {
+    size_t size;
+    do {
+      size = g_messages.size();
+      SysLog_Tasks();
+    } while (g_messages.size() != size);
+  }
+};
+
+TEST_F(SysLogTest, eventsAreDeferred) {
+  SysLog_Event(SYSLOG_INFO, "%d, %d, %d, %d, %d, %d", 1, 2, 3, 4, 5, -6);
+  SysLog_Event(SYSLOG_WARN, "No args");
+  EXPECT_TRUE(g_messages.empty());
+
+  // One event is formatted per call.
+  SysLog_Tasks();
+  ASSERT_EQ(1u, g_messages.size());
+  EXPECT_EQ("1, 2, 3, 4, 5, -6", g_messages[0]);
+
+  SysLog_Tasks();
+  ASSERT_EQ(2u, g_messages.size());
+  EXPECT_EQ("No args", g_messages[1]);
+
+  SysLog_Tasks();
+  EXPECT_EQ(2u, g_messages.size());
+}
+
+TEST_F(SysLogTest, eventsBelowLevelAreDiscarded) {
+  SysLog_Event(SYSLOG_DEBUG, "Debug");
+
+  // Discarded events don't count as dropped.
+  Drain();
+  EXPECT_TRUE(g_messages.empty());
+}
+
+TEST_F(SysLogTest, queueWrapsAround) {
+  // Move the head part way through the buffer, so the next batch of events
+  // wraps around the end.
+  const int first_count = 10;
+  QueueEvents(0, first_count);
+  Drain();
+  ASSERT_EQ(static_cast<size_t>(first_count), g_messages.size());
+
+  g_messages.clear();
+  QueueEvents(first_count, kQueueSize);
+  Drain();
+
+  ASSERT_EQ(kQueueSize, g_messages.size());
+  for (unsigned int i = 0; i < kQueueSize; i++) {
+    EXPECT_EQ(EventMessage(first_count + i), g_messages[i]);
+  }
+}
+
+TEST_F(SysLogTest, dropWhenFull) {
+  QueueEvents(0, kQueueSize + 3);
+
+  // The queued events are written first, then the count of dropped events.
+  Drain();
+  ASSERT_EQ(kQueueSize + 1, g_messages.size());
+  for (unsigned int i = 0; i < kQueueSize; i++) {
+    EXPECT_EQ(EventMessage(i), g_messages[i]);
+  }
+  EXPECT_EQ("Dropped 3 log events", g_messages[kQueueSize]);
+
+  // The dropped count is reset once it's reported.
+  g_messages.clear();
+  QueueEvents(0, 1);
+  Drain();
+  ASSERT_EQ(1u, g_messages.size());
+  EXPECT_EQ(EventMessage(0), g_messages[0]);
+}
+
+TEST_F(SysLogTest, droppedCountSaturates) {
+  QueueEvents(0, kQueueSize + UINT16_MAX + 10);
+
+  Drain();
+  ASSERT_EQ(kQueueSize + 1, g_messages.size());
+  EXPECT_EQ("Dropped 65535 log events", g_messages[kQueueSize]);
+}
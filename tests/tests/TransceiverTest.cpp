@@ -21,11 +21,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <string.h>
+
 #include "Array.h"
+#include "app_settings.h"
+#include "constants.h"
 #include "transceiver.h"
 #include "setting_macros.h"
 
 using ::testing::Args;
+using ::testing::NotNull;
 using ::testing::StrictMock;
 using ::testing::Return;
 using ::testing::Field;
@@ -35,6 +40,22 @@ MATCHER_P3(EventIs, token, op, result, "") {
   return arg->token == token && arg->op == op && arg->result == result;
 }
 
+MATCHER_P4(PortEventIs, port, token, op, result, "") {
+  return arg->port == port && arg->token == token && arg->op == op &&
+         arg->result == result;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Exposed for testing.
+uint8_t Transceiver_FreeBufferCount(uint8_t port_index);
+
+#ifdef __cplusplus
+}
+#endif
+
 class MockEventHandler {
  public:
   MOCK_METHOD1(Run, bool(const TransceiverEvent *event));
@@ -59,6 +80,9 @@ class TransceiverTest : public testing::Test {
     g_event_handler = nullptr;
   }
 
+  static const uint8_t kPort = 0;
+  static const uint8_t kOtherPort = 1;
+
   TransceiverHardwareSettings DefaultSettings() const {
     TransceiverHardwareSettings settings = {
       .usart = AS_USART_ID(1),
@@ -81,185 +105,421 @@ class TransceiverTest : public testing::Test {
     return settings;
   }
 
+  TransceiverHardwareSettings OtherPortSettings() const {
+    TransceiverHardwareSettings settings = {
+      .usart = AS_USART_ID(2),
+      .usart_vector = AS_USART_INTERRUPT_VECTOR(2),
+      .usart_tx_source = AS_USART_INTERRUPT_TX_SOURCE(2),
+      .usart_rx_source = AS_USART_INTERRUPT_RX_SOURCE(2),
+      .usart_error_source = AS_USART_INTERRUPT_ERROR_SOURCE(2),
+      .port = PORT_CHANNEL_F,
+      .break_bit = PORTS_BIT_POS_9,
+      .tx_enable_bit = PORTS_BIT_POS_2,
+      .rx_enable_bit = PORTS_BIT_POS_3,
+      .input_capture_module = AS_IC_ID(3),
+      .input_capture_vector = AS_IC_INTERRUPT_VECTOR(3),
+      .input_capture_source = AS_IC_INTERRUPT_SOURCE(3),
+      .timer_module_id = AS_TIMER_ID(2),
+      .timer_vector = AS_TIMER_INTERRUPT_VECTOR(2),
+      .timer_source = AS_TIMER_INTERRUPT_SOURCE(2),
+      .input_capture_timer = AS_IC_TMR_ID(2),
+    };
+    return settings;
+  }
+
  protected:
   StrictMock<MockEventHandler> m_event_handler;
 };
 
 TEST_F(TransceiverTest, testUnsetTransceiver) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
 }
 
 TEST_F(TransceiverTest, testModeChanges) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, &EventHandler, &EventHandler);
+  Transceiver_Initialize(kPort, &settings, &EventHandler, &EventHandler);
 
   uint8_t token = 1;
 
-  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode());
+  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode(kPort));
   // In responder mode, the following are not permitted
-  EXPECT_FALSE(Transceiver_QueueDMX(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueASC(token, 0xdd, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueRDMDUB(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueRDMRequest(token, NULL, 0, false));
-  EXPECT_FALSE(Transceiver_QueueSelfTest(token));
+  EXPECT_FALSE(Transceiver_QueueDMX(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueASC(kPort, token, 0xdd, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueRDMDUB(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueRDMRequest(kPort, token, NULL, 0, false));
+  EXPECT_FALSE(Transceiver_QueueSelfTest(kPort, token));
 
   // Switch to controller mode, note the switch doesn't actually take place
   // until _Tasks() is called.
-  EXPECT_TRUE(Transceiver_SetMode(T_MODE_CONTROLLER, token));
-  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode());
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_CONTROLLER, token));
+  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode(kPort));
 
   // We still can't queue frames since the mode change hasn't completed yet
-  EXPECT_FALSE(Transceiver_QueueDMX(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueASC(token, 0xdd, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueRDMDUB(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueRDMRequest(token, NULL, 0, false));
-  EXPECT_FALSE(Transceiver_QueueSelfTest(token));
+  EXPECT_FALSE(Transceiver_QueueDMX(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueASC(kPort, token, 0xdd, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueRDMDUB(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueRDMRequest(kPort, token, NULL, 0, false));
+  EXPECT_FALSE(Transceiver_QueueSelfTest(kPort, token));
 
   // Allow the mode change to complete
   EXPECT_CALL(m_event_handler,
               Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
     .WillOnce(Return(true));
   Transceiver_Tasks();
-  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode());
+  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode(kPort));
 
   token++;
 
   // In controller mode the follow are not permitted
-  EXPECT_FALSE(Transceiver_QueueRDMResponse(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueSelfTest(token));
+  EXPECT_FALSE(Transceiver_QueueRDMResponse(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueSelfTest(kPort, token));
 
   // Switch to self test mode.
-  EXPECT_TRUE(Transceiver_SetMode(T_MODE_SELF_TEST, token));
-  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode());
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_SELF_TEST, token));
+  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode(kPort));
   EXPECT_CALL(m_event_handler,
               Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
     .WillOnce(Return(true));
   Transceiver_Tasks();
-  ASSERT_EQ(T_MODE_SELF_TEST, Transceiver_GetMode());
+  ASSERT_EQ(T_MODE_SELF_TEST, Transceiver_GetMode(kPort));
 
   // In self-test mode the follow are not permitted
-  EXPECT_FALSE(Transceiver_QueueDMX(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueASC(token, 0xdd, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueRDMDUB(token, NULL, 0));
-  EXPECT_FALSE(Transceiver_QueueRDMRequest(token, NULL, 0, false));
-  EXPECT_FALSE(Transceiver_QueueRDMResponse(token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueDMX(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueASC(kPort, token, 0xdd, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueRDMDUB(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueRDMRequest(kPort, token, NULL, 0, false));
+  EXPECT_FALSE(Transceiver_QueueRDMResponse(kPort, token, NULL, 0));
 
   // Switch back to controller mode
   token++;
-  EXPECT_TRUE(Transceiver_SetMode(T_MODE_CONTROLLER, token));
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_CONTROLLER, token));
   // There is already a mode change pending, so this will fail
-  EXPECT_FALSE(Transceiver_SetMode(T_MODE_CONTROLLER, ++token));
+  EXPECT_FALSE(Transceiver_SetMode(kPort, T_MODE_CONTROLLER, ++token));
+}
+
+TEST_F(TransceiverTest, testTXQueue) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(kPort, &settings, &EventHandler, &EventHandler);
+  const uint8_t dmx[] = {1, 2, 3, 4};
+
+  int16_t token = 1;
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_CONTROLLER, token));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode(kPort));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 2,
+            Transceiver_FreeBufferCount(kPort));
+
+  // Fill the DMX queue
+  for (unsigned int i = 0; i < TRANSCEIVER_TX_QUEUE_SIZE; i++) {
+    EXPECT_TRUE(Transceiver_QueueDMX(kPort, ++token, dmx, arraysize(dmx)));
+  }
+  EXPECT_EQ(TRANSCEIVER_TX_QUEUE_SIZE + 2, Transceiver_FreeBufferCount(kPort));
+  EXPECT_FALSE(Transceiver_QueueDMX(kPort, ++token, dmx, arraysize(dmx)));
+  EXPECT_FALSE(Transceiver_QueueASC(kPort, token, 0xdd, dmx, arraysize(dmx)));
+
+  // RDM frames have their own queue.
+  for (unsigned int i = 0; i < TRANSCEIVER_TX_QUEUE_SIZE; i++) {
+    EXPECT_TRUE(Transceiver_QueueRDMDUB(kPort, token++, NULL, 0));
+  }
+  EXPECT_EQ(2, Transceiver_FreeBufferCount(kPort));
+  EXPECT_FALSE(Transceiver_QueueRDMDUB(kPort, token, NULL, 0));
+  EXPECT_FALSE(Transceiver_QueueDMX(kPort, token, dmx, arraysize(dmx)));
+
+  // Switching modes cancels everything that is still queued, DMX frames first.
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_SELF_TEST, token));
+  {
+    testing::InSequence seq;
+    for (int16_t i = 2; i < TRANSCEIVER_TX_QUEUE_SIZE + 2; i++) {
+      EXPECT_CALL(m_event_handler,
+                  Run(EventIs(i, T_OP_TX_ONLY, T_RESULT_CANCELLED)))
+        .WillOnce(Return(true));
+    }
+    for (int16_t i = TRANSCEIVER_TX_QUEUE_SIZE + 2;
+         i < 2 * TRANSCEIVER_TX_QUEUE_SIZE + 2; i++) {
+      EXPECT_CALL(m_event_handler,
+                  Run(EventIs(i, T_OP_RDM_DUB, T_RESULT_CANCELLED)))
+        .WillOnce(Return(true));
+    }
+    EXPECT_CALL(m_event_handler,
+                Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
+      .WillOnce(Return(true));
+  }
+  Transceiver_Tasks();
+  ASSERT_EQ(T_MODE_SELF_TEST, Transceiver_GetMode(kPort));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 2,
+            Transceiver_FreeBufferCount(kPort));
+  EXPECT_EQ(0, Transceiver_GetFrameRate(kPort));
+}
+
+TEST_F(TransceiverTest, testLoanBuffer) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(kPort, &settings, &EventHandler, &EventHandler);
+  const uint8_t dmx[] = {1, 2, 3, 4};
+
+  int16_t token = 1;
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_CONTROLLER, token));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode(kPort));
+
+  unsigned int size = 0;
+  uint8_t *loan = Transceiver_LoanBuffer(&size);
+  ASSERT_THAT(loan, NotNull());
+  EXPECT_EQ(USB_READ_BUFFER_SIZE, size);
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 1,
+            Transceiver_FreeBufferCount(kPort));
+
+  // Until it's queued, the same buffer is returned.
+  EXPECT_EQ(loan, Transceiver_LoanBuffer(&size));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 1,
+            Transceiver_FreeBufferCount(kPort));
+
+  // Queueing data from elsewhere doesn't use the loaned buffer.
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, ++token, dmx, arraysize(dmx)));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE, Transceiver_FreeBufferCount(kPort));
+  EXPECT_EQ(loan, Transceiver_LoanBuffer(&size));
+
+  // Queueing the payload of the loaned buffer hands it over.
+  uint8_t *payload = loan + MESSAGE_HEADER_SIZE;
+  memcpy(payload, dmx, arraysize(dmx));
+  EXPECT_TRUE(Transceiver_QueueDMX(kPort, ++token, payload, arraysize(dmx)));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE, Transceiver_FreeBufferCount(kPort));
+
+  uint8_t *next_loan = Transceiver_LoanBuffer(&size);
+  ASSERT_THAT(next_loan, NotNull());
+  EXPECT_NE(loan, next_loan);
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE - 1,
+            Transceiver_FreeBufferCount(kPort));
+
+  // Switching modes returns the queued buffers, but not the loaned one.
+  EXPECT_TRUE(Transceiver_SetMode(kPort, T_MODE_SELF_TEST, ++token));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token - 2, T_OP_TX_ONLY, T_RESULT_CANCELLED)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token - 1, T_OP_TX_ONLY, T_RESULT_CANCELLED)))
+    .WillOnce(Return(true));
+  EXPECT_CALL(m_event_handler,
+              Run(EventIs(token, T_OP_MODE_CHANGE, T_RESULT_OK)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+  ASSERT_EQ(T_MODE_SELF_TEST, Transceiver_GetMode(kPort));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 1,
+            Transceiver_FreeBufferCount(kPort));
+  EXPECT_EQ(next_loan, Transceiver_LoanBuffer(&size));
 }
 
 TEST_F(TransceiverTest, testSetBreakTime) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
-
-  EXPECT_EQ(176, Transceiver_GetBreakTime());
-  EXPECT_FALSE(Transceiver_SetBreakTime(43));
-  EXPECT_EQ(176, Transceiver_GetBreakTime());
-  EXPECT_TRUE(Transceiver_SetBreakTime(44));
-  EXPECT_EQ(44, Transceiver_GetBreakTime());
-  EXPECT_TRUE(Transceiver_SetBreakTime(800));
-  EXPECT_EQ(800, Transceiver_GetBreakTime());
-  EXPECT_FALSE(Transceiver_SetBreakTime(801));
-  EXPECT_EQ(800, Transceiver_GetBreakTime());
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(176, Transceiver_GetBreakTime(kPort));
+  EXPECT_FALSE(Transceiver_SetBreakTime(kPort, 43));
+  EXPECT_EQ(176, Transceiver_GetBreakTime(kPort));
+  EXPECT_TRUE(Transceiver_SetBreakTime(kPort, 44));
+  EXPECT_EQ(44, Transceiver_GetBreakTime(kPort));
+  EXPECT_TRUE(Transceiver_SetBreakTime(kPort, 800));
+  EXPECT_EQ(800, Transceiver_GetBreakTime(kPort));
+  EXPECT_FALSE(Transceiver_SetBreakTime(kPort, 801));
+  EXPECT_EQ(800, Transceiver_GetBreakTime(kPort));
 }
 
 TEST_F(TransceiverTest, testSetMarkTime) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
-
-  EXPECT_EQ(12, Transceiver_GetMarkTime());
-  EXPECT_FALSE(Transceiver_SetMarkTime(3));
-  EXPECT_EQ(12, Transceiver_GetMarkTime());
-  EXPECT_TRUE(Transceiver_SetMarkTime(4));
-  EXPECT_EQ(4, Transceiver_GetMarkTime());
-  EXPECT_TRUE(Transceiver_SetMarkTime(800));
-  EXPECT_EQ(800, Transceiver_GetMarkTime());
-  EXPECT_FALSE(Transceiver_SetMarkTime(801));
-  EXPECT_EQ(800, Transceiver_GetMarkTime());
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(12, Transceiver_GetMarkTime(kPort));
+  EXPECT_FALSE(Transceiver_SetMarkTime(kPort, 3));
+  EXPECT_EQ(12, Transceiver_GetMarkTime(kPort));
+  EXPECT_TRUE(Transceiver_SetMarkTime(kPort, 4));
+  EXPECT_EQ(4, Transceiver_GetMarkTime(kPort));
+  EXPECT_TRUE(Transceiver_SetMarkTime(kPort, 800));
+  EXPECT_EQ(800, Transceiver_GetMarkTime(kPort));
+  EXPECT_FALSE(Transceiver_SetMarkTime(kPort, 801));
+  EXPECT_EQ(800, Transceiver_GetMarkTime(kPort));
 }
 
 TEST_F(TransceiverTest, testSetRDMBroadcastListen) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
-
-  EXPECT_EQ(28, Transceiver_GetRDMBroadcastTimeout());
-  EXPECT_TRUE(Transceiver_SetRDMBroadcastTimeout(1));
-  EXPECT_EQ(1, Transceiver_GetRDMBroadcastTimeout());
-  EXPECT_TRUE(Transceiver_SetRDMBroadcastTimeout(50));
-  EXPECT_EQ(50, Transceiver_GetRDMBroadcastTimeout());
-  EXPECT_FALSE(Transceiver_SetRDMBroadcastTimeout(51));
-  EXPECT_EQ(50, Transceiver_GetRDMBroadcastTimeout());
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(28, Transceiver_GetRDMBroadcastTimeout(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMBroadcastTimeout(kPort, 1));
+  EXPECT_EQ(1, Transceiver_GetRDMBroadcastTimeout(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMBroadcastTimeout(kPort, 50));
+  EXPECT_EQ(50, Transceiver_GetRDMBroadcastTimeout(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMBroadcastTimeout(kPort, 51));
+  EXPECT_EQ(50, Transceiver_GetRDMBroadcastTimeout(kPort));
 }
 
 TEST_F(TransceiverTest, testSetRDMWaitTime) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
-
-  EXPECT_EQ(28, Transceiver_GetRDMResponseTimeout());
-  EXPECT_FALSE(Transceiver_SetRDMResponseTimeout(9));
-  EXPECT_EQ(28, Transceiver_GetRDMResponseTimeout());
-  EXPECT_TRUE(Transceiver_SetRDMResponseTimeout(10));
-  EXPECT_EQ(10, Transceiver_GetRDMResponseTimeout());
-  EXPECT_TRUE(Transceiver_SetRDMResponseTimeout(50));
-  EXPECT_EQ(50, Transceiver_GetRDMResponseTimeout());
-  EXPECT_FALSE(Transceiver_SetRDMResponseTimeout(51));
-  EXPECT_EQ(50, Transceiver_GetRDMResponseTimeout());
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(28, Transceiver_GetRDMResponseTimeout(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMResponseTimeout(kPort, 9));
+  EXPECT_EQ(28, Transceiver_GetRDMResponseTimeout(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMResponseTimeout(kPort, 10));
+  EXPECT_EQ(10, Transceiver_GetRDMResponseTimeout(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMResponseTimeout(kPort, 50));
+  EXPECT_EQ(50, Transceiver_GetRDMResponseTimeout(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMResponseTimeout(kPort, 51));
+  EXPECT_EQ(50, Transceiver_GetRDMResponseTimeout(kPort));
 }
 
 TEST_F(TransceiverTest, testSetDUBResponseTime) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
-
-  EXPECT_EQ(29000, Transceiver_GetRDMDUBResponseLimit());
-  EXPECT_FALSE(Transceiver_SetRDMDUBResponseLimit(9999));
-  EXPECT_EQ(29000, Transceiver_GetRDMDUBResponseLimit());
-  EXPECT_TRUE(Transceiver_SetRDMDUBResponseLimit(10000));
-  EXPECT_EQ(10000, Transceiver_GetRDMDUBResponseLimit());
-  EXPECT_TRUE(Transceiver_SetRDMDUBResponseLimit(35000));
-  EXPECT_EQ(35000, Transceiver_GetRDMDUBResponseLimit());
-  EXPECT_FALSE(Transceiver_SetRDMDUBResponseLimit(35001));
-  EXPECT_EQ(35000, Transceiver_GetRDMDUBResponseLimit());
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(29000, Transceiver_GetRDMDUBResponseLimit(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMDUBResponseLimit(kPort, 9999));
+  EXPECT_EQ(29000, Transceiver_GetRDMDUBResponseLimit(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMDUBResponseLimit(kPort, 10000));
+  EXPECT_EQ(10000, Transceiver_GetRDMDUBResponseLimit(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMDUBResponseLimit(kPort, 35000));
+  EXPECT_EQ(35000, Transceiver_GetRDMDUBResponseLimit(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMDUBResponseLimit(kPort, 35001));
+  EXPECT_EQ(35000, Transceiver_GetRDMDUBResponseLimit(kPort));
 }
 
 TEST_F(TransceiverTest, testSetResponderDelay) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
-
-  EXPECT_EQ(1760, Transceiver_GetRDMResponderDelay());
-  EXPECT_FALSE(Transceiver_SetRDMResponderDelay(1759));
-  EXPECT_EQ(1760, Transceiver_GetRDMResponderDelay());
-  EXPECT_TRUE(Transceiver_SetRDMResponderDelay(1761));
-  EXPECT_EQ(1761, Transceiver_GetRDMResponderDelay());
-  EXPECT_TRUE(Transceiver_SetRDMResponderDelay(20000));
-  EXPECT_EQ(20000, Transceiver_GetRDMResponderDelay());
-  EXPECT_FALSE(Transceiver_SetRDMResponderDelay(20001));
-  EXPECT_EQ(20000, Transceiver_GetRDMResponderDelay());
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(1760, Transceiver_GetRDMResponderDelay(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMResponderDelay(kPort, 1759));
+  EXPECT_EQ(1760, Transceiver_GetRDMResponderDelay(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMResponderDelay(kPort, 1761));
+  EXPECT_EQ(1761, Transceiver_GetRDMResponderDelay(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMResponderDelay(kPort, 20000));
+  EXPECT_EQ(20000, Transceiver_GetRDMResponderDelay(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMResponderDelay(kPort, 20001));
+  EXPECT_EQ(20000, Transceiver_GetRDMResponderDelay(kPort));
 }
 
 TEST_F(TransceiverTest, testSetResponderJitter) {
   TransceiverHardwareSettings settings = DefaultSettings();
-  Transceiver_Initialize(&settings, NULL, NULL);
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
 
-  EXPECT_EQ(0, Transceiver_GetRDMResponderJitter());
-  EXPECT_FALSE(Transceiver_SetRDMResponderJitter(20000));
-  EXPECT_EQ(0, Transceiver_GetRDMResponderJitter());
+  EXPECT_EQ(0, Transceiver_GetRDMResponderJitter(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMResponderJitter(kPort, 20000));
+  EXPECT_EQ(0, Transceiver_GetRDMResponderJitter(kPort));
   // 176uS + up to 1ms
-  EXPECT_TRUE(Transceiver_SetRDMResponderJitter(1000));
-  EXPECT_EQ(1000, Transceiver_GetRDMResponderJitter());
-  EXPECT_TRUE(Transceiver_SetRDMResponderJitter(18240));
-  EXPECT_EQ(18240, Transceiver_GetRDMResponderJitter());
-  EXPECT_FALSE(Transceiver_SetRDMResponderJitter(18241));
-  EXPECT_EQ(18240, Transceiver_GetRDMResponderJitter());
+  EXPECT_TRUE(Transceiver_SetRDMResponderJitter(kPort, 1000));
+  EXPECT_EQ(1000, Transceiver_GetRDMResponderJitter(kPort));
+  EXPECT_TRUE(Transceiver_SetRDMResponderJitter(kPort, 18240));
+  EXPECT_EQ(18240, Transceiver_GetRDMResponderJitter(kPort));
+  EXPECT_FALSE(Transceiver_SetRDMResponderJitter(kPort, 18241));
+  EXPECT_EQ(18240, Transceiver_GetRDMResponderJitter(kPort));
 
   // Test we can't wrap to a negative value
-  EXPECT_FALSE(Transceiver_SetRDMResponderJitter(65535));
+  EXPECT_FALSE(Transceiver_SetRDMResponderJitter(kPort, 65535));
 
   // Now increase the delay, jitter should adjust
-  EXPECT_TRUE(Transceiver_SetRDMResponderDelay(11000));
-  EXPECT_EQ(11000, Transceiver_GetRDMResponderDelay());
-  EXPECT_EQ(9000, Transceiver_GetRDMResponderJitter());
+  EXPECT_TRUE(Transceiver_SetRDMResponderDelay(kPort, 11000));
+  EXPECT_EQ(11000, Transceiver_GetRDMResponderDelay(kPort));
+  EXPECT_EQ(9000, Transceiver_GetRDMResponderJitter(kPort));
+}
+
+TEST_F(TransceiverTest, testSetDMXRefreshInterval) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  Transceiver_Initialize(kPort, &settings, NULL, NULL);
+
+  EXPECT_EQ(0, Transceiver_GetDMXRefreshInterval(kPort));
+  EXPECT_FALSE(Transceiver_SetDMXRefreshInterval(kPort, 12));
+  EXPECT_EQ(0, Transceiver_GetDMXRefreshInterval(kPort));
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 13));
+  EXPECT_EQ(13, Transceiver_GetDMXRefreshInterval(kPort));
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 10000));
+  EXPECT_EQ(10000, Transceiver_GetDMXRefreshInterval(kPort));
+  EXPECT_FALSE(Transceiver_SetDMXRefreshInterval(kPort, 10001));
+  EXPECT_EQ(10000, Transceiver_GetDMXRefreshInterval(kPort));
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 0));
+  EXPECT_EQ(0, Transceiver_GetDMXRefreshInterval(kPort));
+
+  // Reset restores the default
+  EXPECT_TRUE(Transceiver_SetDMXRefreshInterval(kPort, 250));
+  Transceiver_Reset(kPort);
+  EXPECT_EQ(0, Transceiver_GetDMXRefreshInterval(kPort));
+}
+
+TEST_F(TransceiverTest, testPorts) {
+  TransceiverHardwareSettings settings = DefaultSettings();
+  TransceiverHardwareSettings other_settings = OtherPortSettings();
+  Transceiver_Initialize(kPort, &settings, &EventHandler, &EventHandler);
+  Transceiver_Initialize(kOtherPort, &other_settings, &EventHandler,
+                         &EventHandler);
+  const uint8_t dmx[] = {1, 2, 3, 4};
+
+  // Each port has its own mode.
+  int16_t token = 1;
+  EXPECT_TRUE(Transceiver_SetMode(kOtherPort, T_MODE_CONTROLLER, token));
+  EXPECT_CALL(m_event_handler,
+              Run(PortEventIs(kOtherPort, token, T_OP_MODE_CHANGE,
+                              T_RESULT_OK)))
+    .WillOnce(Return(true));
+  Transceiver_Tasks();
+  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode(kPort));
+  ASSERT_EQ(T_MODE_CONTROLLER, Transceiver_GetMode(kOtherPort));
+  EXPECT_FALSE(Transceiver_QueueDMX(kPort, ++token, dmx, arraysize(dmx)));
+
+  // Each port has its own timing settings.
+  EXPECT_TRUE(Transceiver_SetBreakTime(kOtherPort, 200));
+  EXPECT_EQ(176, Transceiver_GetBreakTime(kPort));
+  EXPECT_EQ(200, Transceiver_GetBreakTime(kOtherPort));
+
+  // And its own buffers.
+  unsigned int free_buffers = Transceiver_FreeBufferCount(kPort);
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 2,
+            Transceiver_FreeBufferCount(kOtherPort));
+  for (unsigned int i = 0; i < TRANSCEIVER_TX_QUEUE_SIZE; i++) {
+    EXPECT_TRUE(Transceiver_QueueDMX(kOtherPort, ++token, dmx,
+                                     arraysize(dmx)));
+  }
+  EXPECT_FALSE(Transceiver_QueueDMX(kOtherPort, token, dmx, arraysize(dmx)));
+  EXPECT_EQ(TRANSCEIVER_TX_QUEUE_SIZE + 2,
+            Transceiver_FreeBufferCount(kOtherPort));
+  EXPECT_EQ(free_buffers, Transceiver_FreeBufferCount(kPort));
+
+  // Frames queued on the other port are copied out of the loaned buffer.
+  unsigned int size = 0;
+  uint8_t *loan = Transceiver_LoanBuffer(&size);
+  ASSERT_THAT(loan, NotNull());
+  uint8_t *payload = loan + MESSAGE_HEADER_SIZE;
+  memcpy(payload, dmx, arraysize(dmx));
+  EXPECT_TRUE(Transceiver_QueueRDMDUB(kOtherPort, ++token, payload,
+                                      arraysize(dmx)));
+  EXPECT_EQ(loan, Transceiver_LoanBuffer(&size));
+
+  // Returning the other port to responder mode cancels its frames, and
+  // leaves the first port alone.
+  EXPECT_TRUE(Transceiver_SetMode(kOtherPort, T_MODE_RESPONDER, ++token));
+  {
+    testing::InSequence seq;
+    for (int16_t i = 3; i < TRANSCEIVER_TX_QUEUE_SIZE + 3; i++) {
+      EXPECT_CALL(m_event_handler,
+                  Run(PortEventIs(kOtherPort, i, T_OP_TX_ONLY,
+                                  T_RESULT_CANCELLED)))
+        .WillOnce(Return(true));
+    }
+    EXPECT_CALL(m_event_handler,
+                Run(PortEventIs(kOtherPort, token - 1, T_OP_RDM_DUB,
+                                T_RESULT_CANCELLED)))
+      .WillOnce(Return(true));
+    EXPECT_CALL(m_event_handler,
+                Run(PortEventIs(kOtherPort, token, T_OP_MODE_CHANGE,
+                                T_RESULT_OK)))
+      .WillOnce(Return(true));
+  }
+  Transceiver_Tasks();
+  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode(kPort));
+  ASSERT_EQ(T_MODE_RESPONDER, Transceiver_GetMode(kOtherPort));
+  EXPECT_EQ(2 * TRANSCEIVER_TX_QUEUE_SIZE + 2,
+            Transceiver_FreeBufferCount(kOtherPort));
 }
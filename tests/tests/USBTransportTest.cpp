@@ -34,7 +34,9 @@
 #include "usb_transport.h"
 
 using ::testing::Args;
+using ::testing::DoAll;
 using ::testing::InSequence;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Mock;
 using ::testing::NotNull;
 using ::testing::Pointee;
@@ -372,22 +374,121 @@ TEST_F(USBTransportTest, doubleSendResponse) {
   const uint8_t expected_message[] = {
     0x5a, kToken, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa5
   };
+  const uint8_t second_message[] = {
+    0x5a, kToken + 1, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa5
+  };
 
+  InSequence seq;
   EXPECT_CALL(
       m_usb_mock,
       EndpointWrite(m_usb_handle, _, 0x81, _, _,
                     USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
       .With(Args<3, 4>(DataIs(expected_message, arraysize(expected_message))))
       .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .With(Args<3, 4>(DataIs(second_message, arraysize(second_message))))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
 
   EXPECT_TRUE(USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
-  // Try to send a second message while the first is pending.
-  EXPECT_FALSE(
+  // Send a second message while the first is pending.
+  EXPECT_TRUE(
       USBTransport_SendResponse(kToken + 1, COMMAND_ECHO, RC_OK, NULL, 0));
   EXPECT_TRUE(USBTransport_WritePending());
 
+  CompleteWrite();
+  EXPECT_TRUE(USBTransport_WritePending());
+  CompleteWrite();
+  EXPECT_FALSE(USBTransport_WritePending());
+}
+
+TEST_F(USBTransportTest, fullTXQueue) {
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .Times(USB_TX_BUFFER_COUNT)
+      .WillRepeatedly(Return(USB_DEVICE_RESULT_OK));
+
+  for (unsigned int i = 0; i < USB_TX_BUFFER_COUNT; i++) {
+    EXPECT_TRUE(
+        USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
+  }
+  EXPECT_EQ(0u, USBTransport_GetTXQueueFullCount());
+
+  // All the buffers are in use, so this is dropped.
+  EXPECT_FALSE(USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
+  EXPECT_EQ(1u, USBTransport_GetTXQueueFullCount());
+  EXPECT_TRUE(Flags_HasChanged());
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  // Once a write completes, the next message carries the TX drop flag.
+  CompleteWrite();
+  const uint8_t expected_message[] = {
+    0x5a, kToken, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x02, 0xa5
+  };
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .With(Args<3, 4>(DataIs(expected_message, arraysize(expected_message))))
+      .WillOnce(Return(USB_DEVICE_RESULT_OK));
+  EXPECT_TRUE(USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
+
+  for (unsigned int i = 0; i < USB_TX_BUFFER_COUNT; i++) {
+    EXPECT_TRUE(USBTransport_WritePending());
+    CompleteWrite();
+  }
+  EXPECT_FALSE(USBTransport_WritePending());
+
+  Flags_Initialize(nullptr);
+}
+
+TEST_F(USBTransportTest, writeCompletesDuringSend) {
+  USBTransport_Initialize(StreamDecoder_Process);
+  ConfigureDevice();
+
+  // Keep one write pending.
+  const void *pending_data = nullptr;
+  EXPECT_CALL(
+      m_usb_mock,
+      EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+      .WillOnce(DoAll(SaveArg<3>(&pending_data),
+                      Return(USB_DEVICE_RESULT_OK)));
+  EXPECT_TRUE(USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
+  Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+  // The write complete event runs in the USB ISR, so the previous write can
+  // complete before USB_DEVICE_EndpointWrite() returns. Go around the ring a
+  // few times and check a buffer that's still being written is never reused.
+  for (unsigned int i = 0; i < 3 * USB_TX_BUFFER_COUNT; i++) {
+    const void *data = nullptr;
+    EXPECT_CALL(
+        m_usb_mock,
+        EndpointWrite(m_usb_handle, _, 0x81, _, _,
+                      USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE))
+        .WillOnce(DoAll(SaveArg<3>(&data),
+                        InvokeWithoutArgs(this,
+                                          &USBTransportTest::CompleteWrite),
+                        Return(USB_DEVICE_RESULT_OK)));
+    EXPECT_TRUE(
+        USBTransport_SendResponse(kToken, COMMAND_ECHO, RC_OK, NULL, 0));
+    Mock::VerifyAndClearExpectations(&m_usb_mock);
+
+    EXPECT_NE(pending_data, data);
+    EXPECT_TRUE(USBTransport_WritePending());
+    pending_data = data;
+  }
+
   CompleteWrite();
   EXPECT_FALSE(USBTransport_WritePending());
+  EXPECT_EQ(0u, USBTransport_GetTXQueueFullCount());
 }
 
 TEST_F(USBTransportTest, sendResponseWithData) {
@@ -20,4 +20,5 @@ user_manual_pid_gen_pid_gen_LDADD = $(OLA_LIBS) \
                                     firmware/src/libsensormodel.la \
                                     firmware/src/libcoarsetimer.la \
                                     tests/harmony/mocks/libharmonymock.la \
+                                    tests/mocks/libspirgbmock.la \
                                     $(GMOCK_LIBS) $(GTEST_LIBS)